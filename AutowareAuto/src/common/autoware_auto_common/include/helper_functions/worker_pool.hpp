@@ -0,0 +1,174 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/// \file
+/// \brief This file defines a fixed-size pool of worker threads for data parallel loops
+
+#ifndef HELPER_FUNCTIONS__WORKER_POOL_HPP_
+#define HELPER_FUNCTIONS__WORKER_POOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace helper_functions
+{
+/// \brief A fixed set of threads which repeatedly execute a batch of indexed tasks.
+///
+/// The calling thread takes part in every batch, so a pool of size 1 runs everything inline
+/// and spawns no threads. All threads are created in the constructor; running a batch does not
+/// allocate. Tasks are handed out dynamically, so callers that need reproducible results must
+/// make the result of each task independent of which thread ran it.
+class WorkerPool
+{
+public:
+  /// \brief Constructor
+  /// \param[in] num_threads The total number of threads taking part in a batch, including the
+  ///                        calling thread. 0 is treated as 1.
+  explicit WorkerPool(const std::size_t num_threads)
+  : m_num_threads{(num_threads > 0U) ? num_threads : 1U}
+  {
+    m_threads.reserve(m_num_threads - 1U);
+    for (std::size_t idx = 1U; idx < m_num_threads; ++idx) {
+      m_threads.emplace_back([this] {worker_loop();});
+    }
+  }
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool & operator=(const WorkerPool &) = delete;
+
+  ~WorkerPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock{m_mutex};
+      m_shutdown = true;
+    }
+    m_start_cv.notify_all();
+    for (auto & thread : m_threads) {
+      thread.join();
+    }
+  }
+
+  /// \brief Get the number of threads taking part in a batch, including the calling thread
+  std::size_t size() const noexcept
+  {
+    return m_num_threads;
+  }
+
+  /// \brief Call fn(task) for every task in [0, num_tasks) and block until all calls finished
+  /// \param[in] num_tasks The number of tasks in the batch
+  /// \param[in] fn A const callable taking the task index as std::size_t
+  /// \tparam FnT The callable type
+  /// \throw Rethrows the first exception thrown by any task, after the whole batch finished
+  template<typename FnT>
+  void run(const std::size_t num_tasks, FnT && fn)
+  {
+    if (0U == num_tasks) {
+      return;
+    }
+    if (m_threads.empty() || (1U == num_tasks)) {
+      for (std::size_t task = 0U; task < num_tasks; ++task) {
+        fn(task);
+      }
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock{m_mutex};
+      // Type erasure through a plain function pointer so that no std::function is allocated
+      m_context = static_cast<const void *>(&fn);
+      m_invoke = [](const void * context, const std::size_t task) {
+          (*static_cast<const typename std::remove_reference<FnT>::type *>(context))(task);
+        };
+      m_num_tasks = num_tasks;
+      m_next_task.store(0U);
+      m_active = m_threads.size();
+      m_error = nullptr;
+      ++m_generation;
+    }
+    m_start_cv.notify_all();
+    execute();
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_done_cv.wait(lock, [this] {return 0U == m_active;});
+    if (m_error) {
+      std::rethrow_exception(m_error);
+    }
+  }
+
+private:
+  /// \brief Take tasks from the current batch until there are none left
+  void execute()
+  {
+    for (std::size_t task = m_next_task.fetch_add(1U); task < m_num_tasks;
+      task = m_next_task.fetch_add(1U))
+    {
+      try {
+        m_invoke(m_context, task);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (!m_error) {
+          m_error = std::current_exception();
+        }
+      }
+    }
+  }
+
+  void worker_loop()
+  {
+    std::size_t generation = 0U;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        m_start_cv.wait(
+          lock, [this, generation] {return m_shutdown || (generation != m_generation);});
+        if (m_shutdown) {
+          return;
+        }
+        generation = m_generation;
+      }
+      execute();
+      {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        --m_active;
+      }
+      m_done_cv.notify_one();
+    }
+  }
+
+  const std::size_t m_num_threads;
+  std::vector<std::thread> m_threads{};
+  std::mutex m_mutex{};
+  std::condition_variable m_start_cv{};
+  std::condition_variable m_done_cv{};
+  const void * m_context{nullptr};
+  void (* m_invoke)(const void *, std::size_t) {nullptr};
+  std::size_t m_num_tasks{0U};
+  std::atomic<std::size_t> m_next_task{0U};
+  std::size_t m_active{0U};
+  std::size_t m_generation{0U};
+  bool m_shutdown{false};
+  std::exception_ptr m_error{nullptr};
+};  // class WorkerPool
+}  // namespace helper_functions
+}  // namespace common
+}  // namespace autoware
+
+#endif  // HELPER_FUNCTIONS__WORKER_POOL_HPP_
@@ -0,0 +1,65 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "helper_functions/worker_pool.hpp"
+
+using autoware::common::helper_functions::WorkerPool;
+
+TEST(WorkerPool, RunsEveryTaskOnce) {
+  for (std::size_t num_threads = 0U; num_threads < 5U; ++num_threads) {
+    WorkerPool pool{num_threads};
+    EXPECT_EQ(pool.size(), (num_threads > 0U) ? num_threads : 1U);
+    std::vector<std::size_t> hits(1000U, 0U);
+    // Repeated batches on the same pool
+    for (std::size_t batch = 0U; batch < 10U; ++batch) {
+      pool.run(hits.size(), [&hits](const std::size_t task) {++hits[task];});
+    }
+    for (const auto hit : hits) {
+      EXPECT_EQ(hit, 10U);
+    }
+  }
+}
+
+TEST(WorkerPool, EmptyBatch) {
+  WorkerPool pool{4U};
+  std::atomic<std::size_t> count{0U};
+  pool.run(0U, [&count](const std::size_t) {++count;});
+  EXPECT_EQ(count.load(), 0U);
+}
+
+TEST(WorkerPool, RethrowsTaskException) {
+  WorkerPool pool{4U};
+  std::atomic<std::size_t> count{0U};
+  EXPECT_THROW(
+    pool.run(
+      100U, [&count](const std::size_t task) {
+        ++count;
+        if (task == 42U) {
+          throw std::runtime_error{"task failed"};
+        }
+      }), std::runtime_error);
+  // The rest of the batch still ran
+  EXPECT_EQ(count.load(), 100U);
+  // The pool is still usable
+  count = 0U;
+  pool.run(100U, [&count](const std::size_t) {++count;});
+  EXPECT_EQ(count.load(), 100U);
+}
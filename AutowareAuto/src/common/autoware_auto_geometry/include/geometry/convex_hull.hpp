@@ -15,8 +15,8 @@
 // Co-developed by Tier IV, Inc. and Apex.AI, Inc.
 
 /// \file
-/// \brief This file implements the monotone chain algorithm to compute 2D convex hulls on linked
-///        lists of points
+/// \brief This file implements the monotone chain algorithm to compute 2D convex hulls on
+///        contiguous buffers and linked lists of points
 
 #ifndef GEOMETRY__CONVEX_HULL_HPP_
 #define GEOMETRY__CONVEX_HULL_HPP_
@@ -27,9 +27,10 @@
 //lint -e537 NOLINT pclint vs cpplint
 #include <algorithm>
 //lint -e537 NOLINT pclint vs cpplint
+#include <iterator>
 #include <list>
-#include <limits>
 #include <utility>
+#include <vector>
 
 using autoware::common::types::float32_t;
 
@@ -43,138 +44,97 @@ namespace geometry
 namespace details
 {
 
-/// \brief Moves points comprising the lower convex hull from points to hull.
-/// \param[inout] points A list of points, assumed to be sorted in lexical order
-/// \param[inout] hull An empty list of points, assumed to have same allocator as points
-///                    (for splice)
-/// \tparam PointT The point type for the points list
-/// \tparam HullT the point type for the hull list
-template<typename PointT, typename HullT>
-void form_lower_hull(std::list<PointT> & points, std::list<HullT> & hull)
+/// \brief Strict lexical order of points, i.e. by x and then by y
+/// \param[in] a The first point
+/// \param[in] b The second point
+/// \return Whether a comes before b
+/// \tparam PointT Type of a point, must have x and y float members
+template<typename PointT>
+bool8_t lexical_less(const PointT & a, const PointT & b)
 {
-  auto hull_it = hull.cbegin();
-  auto point_it = points.cbegin();
-  // This ensures that the points we splice to back to the end of list are not processed
-  const auto iters = points.size();
-  for (auto idx = decltype(iters) {0}; idx < iters; ++idx) {
-    // splice points from tail of hull to tail of list until point from head of list satisfies ccw
-    bool8_t is_ccw = true;
-    while ((hull.cbegin() != hull_it) && is_ccw) {
-      const auto current_hull_it = hull_it;
-      --hull_it;
-      is_ccw = ccw(*hull_it, *current_hull_it, *point_it);
-      if (!is_ccw) {
-        hull_it = current_hull_it;
-        break;
-      }
-      // return this node to list for consideration in upper hull
-      points.splice(points.end(), hull, current_hull_it);
-    }
-    const auto last_point_it = point_it;
-    ++point_it;
-    // Splice head of list to tail of (lower) hull
-    hull.splice(hull.end(), points, last_point_it);
-    // point_it has been advanced, hull_it has been advanced (to where point_it was previously)
-    hull_it = last_point_it;
-  }
-  // loop is guaranteed not to underflow because a node can be removed from points AT MOST once
-  // per loop iteration. The loop is upper bounded to the prior size of the point list
+  using point_adapter::x_;
+  using point_adapter::y_;
+  return (x_(a) < x_(b)) || ((x_(a) == x_(b)) && (y_(a) < y_(b)));
 }
-/// \brief Moves points comprising the lower convex hull from points to hull.
-/// \param[inout] points A list of points, assumed to be sorted in lexical order, and to contain
-///                      the leftmost point
-/// \param[inout] hull A list of points, assumed to have same allocator as points (for splice),
-///                    and to contain the lower hull (minus the left-most point)
-/// \tparam PointT The point type for the points list
-/// \tparam HullT the point type for the hull list
-template<typename PointT, typename HullT>
-void form_upper_hull(std::list<PointT> & points, std::list<HullT> & hull)
+
+/// \brief Push a point on a stack of hull points which lives at the start of the buffer, popping
+///        points from the top of the stack until the last two points and the new point are a
+///        strict ccw turn. The popped points are swapped to where the new point was.
+/// \param[in] bottom Iterator to the lowest point of the stack which can be popped
+/// \param[inout] top Iterator to one past the top of the stack, gets updated
+/// \param[in] it Iterator to the new point, not in the stack
+/// \tparam IT A random access iterator type
+template<typename IT>
+void push_hull_point(const IT bottom, IT & top, const IT it)
 {
-  // TODO(c.ho) consider reverse iterators, not sure if they work with splice()
-  auto hull_it = hull.cend();
-  --hull_it;
-  const auto lower_hull_end = hull_it;
-  auto point_it = points.cend();
-  --point_it;
-  // This ensures that the points we splice to back to the head of list are not processed
-  const auto iters = points.size();
-  for (auto idx = decltype(iters) {0}; idx < iters; ++idx) {
-    // splice points from tail of hull to head of list until ccw is satisfied with tail of list
-    bool8_t is_ccw = true;
-    while ((lower_hull_end != hull_it) && is_ccw) {
-      const auto current_hull_it = hull_it;
-      --hull_it;
-      is_ccw = ccw(*hull_it, *current_hull_it, *point_it);
-      if (!is_ccw) {
-        hull_it = current_hull_it;
-        break;
-      }
-      points.splice(points.begin(), hull, current_hull_it);
-    }
-    const auto last_point_it = point_it;
-    --point_it;
-    // Splice points from tail of lexically ordered point list to tail of hull
-    hull.splice(hull.end(), points, last_point_it);
-    hull_it = last_point_it;
+  // Pop while the top of the stack would form a clockwise or collinear turn
+  while (((top - bottom) >= 1) && ccw(*(top - 2), *(top - 1), *it)) {
+    --top;
   }
-  // loop is guaranteed not to underflow because a node can be removed from points AT MOST once
-  // per loop iteration. The loop is upper bounded to the prior size of the point list
+  std::iter_swap(top, it);
+  ++top;
 }
 
-/// \brief A static memory implementation of convex hull computation. Shuffles points around the
-///        deque such that the points of the convex hull of the deque of points are first in the
-///        deque, with the internal points following in an unspecified order.
-///        The head of the deque will be the point with the smallest x value, with the other
+/// \brief An in-place implementation of convex hull computation on a contiguous buffer, which does
+///        not allocate memory. Shuffles points around the buffer such that the points of the convex
+///        hull are first in the buffer, with the internal points following in an unspecified order.
+///        The first point will be the point with the smallest x value, with the other
 ///        points following in a counter-clockwise manner (from a top down view/facing -z direction)
-/// \param[inout] list A list of nodes that will be pruned down and reordered into a ccw convex hull
+/// \param[in] first Iterator to the first point of the buffer
+/// \param[in] last Iterator to one past the last point of the buffer, at least 2 points are assumed
 /// \return An iterator pointing to one after the last point contained in the hull
-/// \tparam PointT Type of a point, must have x and y float members
-template<typename PointT>
-typename std::list<PointT>::const_iterator convex_hull_impl(std::list<PointT> & list)
+/// \tparam IT A random access iterator type dereferencable into a point type with float members x
+///            and y
+template<typename IT>
+IT convex_hull_impl(const IT first, const IT last)
 {
-  // Functor that return whether a <= b in the lexical sense (a.x < b.x), sort by y if tied
-  const auto lexical_comparator = [](const PointT & a, const PointT & b) -> bool8_t
-    {
-      using point_adapter::x_;
-      using point_adapter::y_;
-      constexpr auto FEPS = std::numeric_limits<float32_t>::epsilon();
-      return (fabsf(x_(a) - x_(b)) > FEPS) ?
-             (x_(a) < x_(b)) : (y_(a) < y_(b));
-    };
-  list.sort(lexical_comparator);
-
-  // Temporary list to store points
-  std::list<PointT> tmp_hull_list{list.get_allocator()};
-
-  // Shuffle lower hull points over to tmp_hull_list
-  form_lower_hull(list, tmp_hull_list);
-
-  // Resort list since we can't guarantee the order TODO(c.ho) is this true?
-  list.sort(lexical_comparator);
-  // splice first hull point to beginning of list to ensure upper hull is properly closed
-  // This is done after sorting because we know exactly where it should go, and keeping it out of
-  // sorting reduces complexity somewhat
-  list.splice(list.begin(), tmp_hull_list, tmp_hull_list.begin());
-
-  // build upper hull
-  form_upper_hull(list, tmp_hull_list);
-  // Move hull to beginning of list, return iterator pointing to one after the convex hull
-  const auto ret = list.begin();
-  // first move left-most point to ensure it is first
-  auto tmp_it = tmp_hull_list.end();
-  --tmp_it;
-  list.splice(list.begin(), tmp_hull_list, tmp_it);
-  // Then move remainder of hull points
-  list.splice(ret, tmp_hull_list);
-  return ret;
+  using PointT = typename std::iterator_traits<IT>::value_type;
+  std::sort(first, last, lexical_less<PointT>);
+  // The lower hull is formed at the start of the buffer, ending with the right-most point
+  IT top = first;
+  for (IT it = first; it != last; ++it) {
+    push_hull_point(first + 1, top, it);
+  }
+  // The remaining points are not sorted anymore since popped points were swapped around. The upper
+  // hull is formed from right to left on top of the lower hull
+  const IT lower_hull_end = top;
+  std::sort(
+    lower_hull_end, last, [](const PointT & a, const PointT & b) {return lexical_less(b, a);});
+  for (IT it = lower_hull_end; it != last; ++it) {
+    push_hull_point(lower_hull_end, top, it);
+  }
+  // Close the hull with the left-most point, which is already the first point
+  while (((top - lower_hull_end) >= 1) && ccw(*(top - 2), *(top - 1), *first)) {
+    --top;
+  }
+  return top;
 }
 }  // namespace details
 
-/// \brief A static memory implementation of convex hull computation. Shuffles points around the
-///        deque such that the points of the convex hull of the deque of points are first in the
-///        deque, with the internal points following in an unspecified order.
+/// \brief A static memory implementation of convex hull computation on a contiguous buffer, e.g.
+///        a std::vector. Shuffles points around the buffer such that the points of the convex hull
+///        are first in the buffer, with the internal points following in an unspecified order.
+///
+///        The first point will be the point with the smallest x value, with the other
+///        points following in a counter-clockwise manner (from a top down view/facing -z
+///        direction). If the buffer has 3 or fewer points, nothing is done (e.g. the ordering
+///        result as previously stated does not hold).
+/// \param[in] first Iterator to the first point of the buffer
+/// \param[in] last Iterator to one past the last point of the buffer
+/// \return An iterator pointing to one after the last point contained in the hull
+/// \tparam IT A random access iterator type dereferencable into a point type with float members x
+///            and y
+template<typename IT>
+IT convex_hull(const IT first, const IT last)
+{
+  return ((last - first) <= 3) ? last : details::convex_hull_impl(first, last);
+}
+
+/// \brief Convex hull computation on a list of points. This is a wrapper around the contiguous
+///        buffer implementation, the points are copied into a temporary buffer and then copied
+///        back in order. Prefer the contiguous buffer overload where possible.
 ///
-///        The head of the deque will be the point with the smallest x value, with the other
+///        The head of the list will be the point with the smallest x value, with the other
 ///        points following in a counter-clockwise manner (from a top down view/facing -z
 ///        direction). If the point list is 3 or smaller, nothing is done (e.g. the ordering result
 ///        as previously stated does not hold).
@@ -184,7 +144,13 @@ typename std::list<PointT>::const_iterator convex_hull_impl(std::list<PointT> &
 template<typename PointT>
 typename std::list<PointT>::const_iterator convex_hull(std::list<PointT> & list)
 {
-  return (list.size() <= 3U) ? list.end() : details::convex_hull_impl(list);
+  if (list.size() <= 3U) {
+    return list.end();
+  }
+  std::vector<PointT> points{list.begin(), list.end()};
+  const auto hull_size = std::distance(points.begin(), convex_hull(points.begin(), points.end()));
+  (void)std::copy(points.begin(), points.end(), list.begin());
+  return std::next(list.cbegin(), hull_size);
 }
 
 }  // namespace geometry
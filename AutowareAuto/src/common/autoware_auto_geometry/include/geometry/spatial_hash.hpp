@@ -23,6 +23,9 @@
 #include <common/types.hpp>
 #include <geometry/spatial_hash_config.hpp>
 #include <geometry/visibility_control.hpp>
+#include <algorithm>
+#include <iterator>
+#include <limits>
 #include <vector>
 #include <unordered_map>
 #include <utility>
@@ -40,6 +43,255 @@ namespace geometry
 namespace spatial_hash
 {
 
+/// \brief Spatial hash functionality not intended to be used by an external user
+namespace details
+{
+/// \brief Flat storage backend for the spatial hash. Points live in preallocated contiguous slots
+///        and are chained per bin. Bins are located through an open-addressing table keyed on the
+///        composed bin index. Nothing is allocated after construction.
+/// \tparam PointT The point type stored in this data structure
+template<typename PointT>
+class GEOMETRY_PUBLIC FlatStorage
+{
+public:
+  /// \brief Sentinel value for an empty slot, bin or link
+  static constexpr Index NONE = std::numeric_limits<Index>::max();
+
+  /// \brief Constructor, allocates all memory up front
+  /// \param[in] capacity The maximum number of points that can be stored
+  explicit FlatStorage(const Index capacity)
+  : m_points(capacity),
+    m_slot_keys(capacity, NONE),
+    m_next(capacity, NONE),
+    m_prev(capacity, NONE),
+    m_bin_keys(table_size(capacity), NONE),
+    m_bin_heads(m_bin_keys.size(), NONE),
+    m_mask{m_bin_keys.size() - 1U},
+    m_bins_used{0U},
+    m_slot_end{0U},
+    m_free_head{NONE},
+    m_first_used{0U},
+    m_size{0U}
+  {
+  }
+
+  /// \brief Store a point in a bin, no capacity checking is done
+  /// \param[in] key The composed bin index of the point
+  /// \param[in] pt The point to store
+  /// \return The slot the point was stored in
+  Index insert(const Index key, const PointT & pt)
+  {
+    Index slot = m_free_head;
+    if (NONE != slot) {
+      m_free_head = m_next[slot];
+    } else {
+      slot = m_slot_end;
+      ++m_slot_end;
+    }
+    m_points[slot] = pt;
+    m_slot_keys[slot] = key;
+    link(slot);
+    m_first_used = (0U == m_size) ? slot : std::min(m_first_used, slot);
+    ++m_size;
+    return slot;
+  }
+
+  /// \brief Remove the point in a used slot, no validity checking is done
+  /// \param[in] slot The slot to release
+  void erase(const Index slot)
+  {
+    const Index prev = m_prev[slot];
+    const Index next = m_next[slot];
+    if (NONE != prev) {
+      m_next[prev] = next;
+    } else {
+      m_bin_heads[find_bin(m_slot_keys[slot])] = next;
+    }
+    if (NONE != next) {
+      m_prev[next] = prev;
+    }
+    m_slot_keys[slot] = NONE;
+    m_next[slot] = m_free_head;
+    m_free_head = slot;
+    --m_size;
+    if (slot == m_first_used) {
+      m_first_used = next_used(slot + 1U);
+    }
+  }
+
+  /// \brief Release all points and bins
+  void clear()
+  {
+    std::fill(m_slot_keys.begin(), m_slot_keys.begin() + static_cast<std::ptrdiff_t>(m_slot_end),
+      NONE);
+    std::fill(m_bin_keys.begin(), m_bin_keys.end(), NONE);
+    std::fill(m_bin_heads.begin(), m_bin_heads.end(), NONE);
+    m_bins_used = 0U;
+    m_slot_end = 0U;
+    m_free_head = NONE;
+    m_first_used = 0U;
+    m_size = 0U;
+  }
+
+  /// \brief Get the first slot of a bin
+  /// \param[in] key The composed bin index
+  /// \return The first slot in the bin, or NONE if the bin is empty
+  Index bin_begin(const Index key) const
+  {
+    const Index pos = find_bin(key);
+    return (NONE == pos) ? NONE : m_bin_heads[pos];
+  }
+
+  /// \brief Get the next slot in the same bin
+  /// \param[in] slot A used slot
+  /// \return The next slot in the bin, or NONE if slot was the last in its bin
+  Index bin_next(const Index slot) const
+  {
+    return m_next[slot];
+  }
+
+  /// \brief Get the first used slot at or after the given slot
+  /// \param[in] slot The slot to start searching from
+  /// \return A used slot, or end_slot() if there are none
+  Index next_used(Index slot) const
+  {
+    while ((slot < m_slot_end) && (NONE == m_slot_keys[slot])) {
+      ++slot;
+    }
+    return std::min(slot, m_slot_end);
+  }
+
+  /// \brief Get the first used slot
+  Index begin_slot() const
+  {
+    return (0U == m_size) ? m_slot_end : m_first_used;
+  }
+
+  /// \brief Get the one past the end slot for iteration
+  Index end_slot() const
+  {
+    return m_slot_end;
+  }
+
+  /// \brief Whether a slot currently holds a point
+  bool8_t is_used(const Index slot) const
+  {
+    return (slot < m_slot_end) && (NONE != m_slot_keys[slot]);
+  }
+
+  /// \brief Get the point stored in a slot
+  const PointT & point(const Index slot) const
+  {
+    return m_points[slot];
+  }
+
+  /// \brief Get the number of stored points
+  Index size() const
+  {
+    return m_size;
+  }
+
+private:
+  /// \brief Smallest power of two at least twice the capacity, so the table is at most half full
+  static Index table_size(const Index capacity)
+  {
+    Index ret = 2U;
+    while (ret < (capacity * 2U)) {
+      ret *= 2U;
+    }
+    return ret;
+  }
+
+  /// \brief Initial probe position of a bin
+  Index home(const Index key) const
+  {
+    // Fibonacci hashing; neighboring bins land in different cache lines
+    const uint64_t hash = static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<Index>(hash ^ (hash >> 32U)) & m_mask;
+  }
+
+  /// \brief Find the table position of a bin
+  /// \return The table position, or NONE if the bin was never added
+  Index find_bin(const Index key) const
+  {
+    Index pos = home(key);
+    while (NONE != m_bin_keys[pos]) {
+      if (key == m_bin_keys[pos]) {
+        return pos;
+      }
+      pos = (pos + 1U) & m_mask;
+    }
+    return NONE;
+  }
+
+  /// \brief Chain a slot to the head of its bin, adding the bin to the table if needed
+  void link(const Index slot)
+  {
+    const Index key = m_slot_keys[slot];
+    // Bins whose points have all been erased stay in the table as tombstones. The first one on
+    // the probe path is reused so that a long-lived table does not fill up
+    Index reuse = NONE;
+    Index pos = home(key);
+    while ((NONE != m_bin_keys[pos]) && (key != m_bin_keys[pos])) {
+      if ((NONE == reuse) && (NONE == m_bin_heads[pos])) {
+        reuse = pos;
+      }
+      pos = (pos + 1U) & m_mask;
+    }
+    if (NONE == m_bin_keys[pos]) {
+      if (NONE != reuse) {
+        pos = reuse;
+      } else if (((m_bins_used + 1U) * 4U) > (m_bin_keys.size() * 3U)) {
+        // Too many tombstones: rehash the live bins in place, then retry
+        rehash(slot);
+        return;
+      } else {
+        ++m_bins_used;
+      }
+      m_bin_keys[pos] = key;
+    }
+    const Index head = m_bin_heads[pos];
+    m_prev[slot] = NONE;
+    m_next[slot] = head;
+    if (NONE != head) {
+      m_prev[head] = slot;
+    }
+    m_bin_heads[pos] = slot;
+  }
+
+  /// \brief Rebuild the bin table from the used slots, dropping tombstones
+  /// \param[in] slot A used slot that is not yet linked into any bin
+  void rehash(const Index slot)
+  {
+    std::fill(m_bin_keys.begin(), m_bin_keys.end(), NONE);
+    std::fill(m_bin_heads.begin(), m_bin_heads.end(), NONE);
+    m_bins_used = 0U;
+    for (Index idx = 0U; idx < m_slot_end; ++idx) {
+      if ((NONE != m_slot_keys[idx]) && (idx != slot)) {
+        link(idx);
+      }
+    }
+    link(slot);
+  }
+
+  std::vector<PointT> m_points;
+  std::vector<Index> m_slot_keys;
+  std::vector<Index> m_next;
+  std::vector<Index> m_prev;
+  std::vector<Index> m_bin_keys;
+  std::vector<Index> m_bin_heads;
+  Index m_mask;
+  Index m_bins_used;
+  Index m_slot_end;
+  Index m_free_head;
+  Index m_first_used;
+  Index m_size;
+};  // class FlatStorage
+
+template<typename PointT>
+constexpr Index FlatStorage<PointT>::NONE;
+}  // namespace details
+
 /// \brief An implementation of the spatial hash or integer lattice data structure for efficient
 ///        (O(1)) near neighbor queries.
 /// \tparam PointT The point type stored in this data structure. Must have float members x, y, and z
@@ -47,10 +299,14 @@ namespace spatial_hash
 /// This implementation can support both 2D and 3D queries
 /// (though only one type per data structure), and can support queries of varying radius. This data
 /// structure cannot do near neighbor lookups for euclidean distance in arbitrary dimensions.
+///
+/// Points are stored either in a std::unordered_multimap or in preallocated flat storage, as
+/// selected by the storage method of the configuration object.
 template<typename PointT, typename ConfigT>
 class GEOMETRY_PUBLIC SpatialHashBase
 {
   using Index3 = details::Index3;
+  using Flat = details::FlatStorage<PointT>;
   //lint -e{9131} NOLINT There's no other way to make this work in a static assert
   static_assert(
     std::is_same<ConfigT, Config2d>::value || std::is_same<ConfigT, Config3d>::value,
@@ -58,7 +314,72 @@ class GEOMETRY_PUBLIC SpatialHashBase
 
 public:
   using Hash = std::unordered_multimap<Index, PointT>;
-  using IT = typename Hash::const_iterator;
+  /// \brief Constant forward iterator over the stored points, independent of the storage method
+  class ConstIterator
+  {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = PointT;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const PointT *;
+    using reference = const PointT &;
+
+    /// \brief Get the pointed-to point
+    reference operator*() const
+    {
+      return m_owner->m_is_flat ? m_owner->m_flat.point(m_slot) : m_map_it->second;
+    }
+    /// \brief Access members of the pointed-to point
+    pointer operator->() const
+    {
+      return &(operator*());
+    }
+    /// \brief Go to the next stored point
+    ConstIterator & operator++()
+    {
+      if (m_owner->m_is_flat) {
+        m_slot = m_owner->m_flat.next_used(m_slot + 1U);
+      } else {
+        ++m_map_it;
+      }
+      return *this;
+    }
+    /// \brief Go to the next stored point
+    ConstIterator operator++(int)
+    {
+      ConstIterator ret{*this};
+      (void)operator++();
+      return ret;
+    }
+    bool8_t operator==(const ConstIterator & rhs) const
+    {
+      return (m_map_it == rhs.m_map_it) && (m_slot == rhs.m_slot);
+    }
+    bool8_t operator!=(const ConstIterator & rhs) const
+    {
+      return !(*this == rhs);
+    }
+
+private:
+    friend class SpatialHashBase;
+    ConstIterator(const SpatialHashBase * const owner, const typename Hash::const_iterator it)
+    : m_owner{owner},
+      m_map_it{it},
+      m_slot{}
+    {
+    }
+    ConstIterator(const SpatialHashBase * const owner, const Index slot)
+    : m_owner{owner},
+      m_map_it{},
+      m_slot{slot}
+    {
+    }
+
+    const SpatialHashBase * m_owner;
+    typename Hash::const_iterator m_map_it;
+    Index m_slot;
+  };  // class ConstIterator
+  using IT = ConstIterator;
   /// \brief Wrapper around an iterator and a distance (from some query point)
   class Output
   {
@@ -75,7 +396,7 @@ public:
     /// \return A const reference to the stored point
     const PointT & get_point() const
     {
-      return m_iterator->second;
+      return *m_iterator;
     }
     /// \brief Get underlying iterator
     /// \return A copy of the underlying iterator
@@ -112,11 +433,17 @@ private:
   /// \param[in] cfg The configuration object for this class
   explicit SpatialHashBase(const ConfigT & cfg)
   : m_config{cfg},
+    m_is_flat{StorageMethod::FLAT == cfg.get_storage_method()},
     m_hash(),
+    m_flat{m_is_flat ? cfg.get_capacity() : Index{}},
     m_neighbors{},  // TODO(c.ho) reserve, but there's no default constructor for output
     m_bins_hit{},  // zero initialization (and below)
     m_neighbors_found{}
   {
+    if (m_is_flat) {
+      // A query can return at most every stored point
+      m_neighbors.reserve(cfg.get_capacity());
+    }
   }
 
   /// \brief Inserts point
@@ -159,22 +486,33 @@ private:
   /// should be used with care and only on valid iterators
   IT erase(const IT point)
   {
-    if (end() == m_hash.find(point->first)) {
+    if (m_is_flat) {
+      if ((this != point.m_owner) || (!m_flat.is_used(point.m_slot))) {
+        throw std::domain_error{"SpatialHash: Attempting to erase invalid iterator"};
+      }
+      m_flat.erase(point.m_slot);
+      return IT{this, m_flat.next_used(point.m_slot + 1U)};
+    }
+    if (m_hash.end() == m_hash.find(point.m_map_it->first)) {
       throw std::domain_error{"SpatialHash: Attempting to erase invalid iterator"};
     }
-    return m_hash.erase(point);
+    return IT{this, m_hash.erase(point.m_map_it)};
   }
 
   /// \brief Reset the state of the data structure
   void clear()
   {
-    m_hash.clear();
+    if (m_is_flat) {
+      m_flat.clear();
+    } else {
+      m_hash.clear();
+    }
   }
   /// \brief Get current number of element stored in this data structure
   /// \return Number of stored elements
   Index size() const
   {
-    return m_hash.size();
+    return m_is_flat ? m_flat.size() : m_hash.size();
   }
   /// \brief Get the maximum capacity of the data structure
   /// \return The capacity of the data structure
@@ -186,19 +524,19 @@ private:
   /// \return True if data structure is empty
   bool8_t empty() const
   {
-    return m_hash.empty();
+    return 0U == size();
   }
   /// \brief Get iterator to beginning of data structure
   /// \return Iterator
   IT begin() const
   {
-    return m_hash.begin();
+    return m_is_flat ? IT{this, m_flat.begin_slot()} : IT{this, m_hash.begin()};
   }
   /// \brief Get iterator to end of data structure
   /// \return Iterator
   IT end() const
   {
-    return m_hash.end();
+    return m_is_flat ? IT{this, m_flat.end_slot()} : IT{this, m_hash.end()};
   }
   /// \brief Get iterator to beginning of data structure
   /// \return Iterator
@@ -259,13 +597,16 @@ protected:
       if (m_config.is_candidate_bin(ref_idx, idx, radius2)) {
         // For point in bin
         const Index jdx = m_config.index(idx);
-        const auto range = m_hash.equal_range(jdx);
-        for (auto it = range.first; it != range.second; ++it) {
-          const auto & pt = it->second;
-          const float32_t dist2 = m_config.distance_squared(x, y, z, pt);
-          if (dist2 <= radius2) {
-            // Only compute true distance if necessary
-            m_neighbors.emplace_back(it, sqrtf(dist2));
+        if (m_is_flat) {
+          Index slot = m_flat.bin_begin(jdx);
+          while (Flat::NONE != slot) {
+            add_if_near(x, y, z, radius2, IT{this, slot});
+            slot = m_flat.bin_next(slot);
+          }
+        } else {
+          const auto range = m_hash.equal_range(jdx);
+          for (auto it = range.first; it != range.second; ++it) {
+            add_if_near(x, y, z, radius2, IT{this, it});
           }
         }
       }
@@ -284,11 +625,31 @@ private:
     const Index idx =
       m_config.bin(point_adapter::x_(pt), point_adapter::y_(pt), point_adapter::z_(pt));
     // Insert into bin
-    return m_hash.insert(std::make_pair(idx, pt));
+    if (m_is_flat) {
+      return IT{this, m_flat.insert(idx, pt)};
+    }
+    return IT{this, m_hash.insert(std::make_pair(idx, pt))};
+  }
+
+  /// \brief Add a candidate point to the output if it is within the query radius
+  GEOMETRY_LOCAL void add_if_near(
+    const float32_t x,
+    const float32_t y,
+    const float32_t z,
+    const float32_t radius2,
+    const IT it)
+  {
+    const float32_t dist2 = m_config.distance_squared(x, y, z, *it);
+    if (dist2 <= radius2) {
+      // Only compute true distance if necessary
+      m_neighbors.emplace_back(it, sqrtf(dist2));
+    }
   }
 
   const ConfigT m_config;
+  const bool8_t m_is_flat;
   Hash m_hash;
+  Flat m_flat;
   OutputVector m_neighbors;
   Index m_bins_hit;
   Index m_neighbors_found;
@@ -66,6 +66,16 @@ struct GEOMETRY_PUBLIC Index3
 using BinRange = std::pair<Index3, Index3>;
 }  // namespace details
 
+/// \brief Selects how the spatial hash stores its points internally
+enum class StorageMethod : uint8_t
+{
+  /// Node-based std::unordered_multimap keyed on the bin index
+  UNORDERED_MAP = 0U,
+  /// Preallocated open-addressing bin table with points chained in contiguous arrays. Nothing is
+  /// allocated after construction
+  FLAT
+};  // enum class StorageMethod
+
 /// \brief The base class for the configuration object for the SpatialHash class
 /// \tparam Derived The type of the derived class to support static polymorphism/CRTP
 template<typename Derived>
@@ -81,6 +91,7 @@ public:
   /// \param[in] max_z The maximum z value for the spatial hash
   /// \param[in] radius The look up radius
   /// \param[in] capacity The maximum number of points the spatial hash can store
+  /// \param[in] storage The internal storage backend of the spatial hash
   Config(
     const float32_t min_x,
     const float32_t max_x,
@@ -89,7 +100,8 @@ public:
     const float32_t min_z,
     const float32_t max_z,
     const float32_t radius,
-    const Index capacity)
+    const Index capacity,
+    const StorageMethod storage)
   : m_min_x{min_x},
     m_min_y{min_y},
     m_min_z{min_z},
@@ -100,6 +112,7 @@ public:
     m_side_length2{radius * radius},
     m_side_length_inv{1.0F / radius},
     m_capacity{capacity},
+    m_storage{storage},
     m_max_x_idx{check_basis_direction(min_x, max_x)},
     m_max_y_idx{check_basis_direction(min_y, max_y)},
     m_max_z_idx{check_basis_direction(min_z, max_z)},
@@ -181,6 +194,12 @@ public:
   {
     return m_capacity;
   }
+  /// \brief Get the storage backend of the spatial hash
+  /// \return The storage method
+  StorageMethod get_storage_method() const
+  {
+    return m_storage;
+  }
 
   /// \brief Getter for the side length, equivalently the lookup radius
   float32_t radius2() const
@@ -344,6 +363,7 @@ private:
   float32_t m_side_length2;
   float32_t m_side_length_inv;
   Index m_capacity;
+  StorageMethod m_storage;
   Index m_max_x_idx;
   Index m_max_y_idx;
   Index m_max_z_idx;
@@ -362,13 +382,15 @@ public:
   /// \param[in] max_y The maximum y value for the spatial hash
   /// \param[in] radius The lookup distance
   /// \param[in] capacity The maximum number of points the spatial hash can store
+  /// \param[in] storage The internal storage backend of the spatial hash
   Config2d(
     const float32_t min_x,
     const float32_t max_x,
     const float32_t min_y,
     const float32_t max_y,
     const float32_t radius,
-    const Index capacity);
+    const Index capacity,
+    const StorageMethod storage = StorageMethod::UNORDERED_MAP);
   /// \brief The index of a point given it's x, y and z values, 2d implementation
   /// \param[in] x The x value of a point
   /// \param[in] y the y value of a point
@@ -430,6 +452,7 @@ public:
   /// \param[in] max_z The maximum z value for the spatial hash
   /// \param[in] radius The lookup distance
   /// \param[in] capacity The maximum number of points the spatial hash can store
+  /// \param[in] storage The internal storage backend of the spatial hash
   Config3d(
     const float32_t min_x,
     const float32_t max_x,
@@ -438,7 +461,8 @@ public:
     const float32_t min_z,
     const float32_t max_z,
     const float32_t radius,
-    const Index capacity);
+    const Index capacity,
+    const StorageMethod storage = StorageMethod::UNORDERED_MAP);
   /// \brief The index of a point given it's x, y and z values, 3d implementation
   /// \param[in] x The x value of a point
   /// \param[in] y the y value of a point
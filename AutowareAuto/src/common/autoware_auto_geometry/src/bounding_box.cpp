@@ -103,6 +103,8 @@ autoware_auto_msgs::msg::DetectedObject make_detected_object(const BoundingBox &
 using autoware::common::types::PointXYZIF;
 template BoundingBox minimum_area_bounding_box<PointXYZIF>(std::list<PointXYZIF> & list);
 template BoundingBox minimum_perimeter_bounding_box<PointXYZIF>(std::list<PointXYZIF> & list);
+template BoundingBox minimum_area_bounding_box<PointXYZIF>(std::vector<PointXYZIF> & points);
+template BoundingBox minimum_perimeter_bounding_box<PointXYZIF>(std::vector<PointXYZIF> & points);
 using PointXYZIFVIT = std::vector<PointXYZIF>::iterator;
 template BoundingBox eigenbox_2d<PointXYZIFVIT>(const PointXYZIFVIT begin, const PointXYZIFVIT end);
 template BoundingBox lfit_bounding_box_2d<PointXYZIFVIT>(
@@ -110,6 +112,8 @@ template BoundingBox lfit_bounding_box_2d<PointXYZIFVIT>(
 using geometry_msgs::msg::Point32;
 template BoundingBox minimum_area_bounding_box<Point32>(std::list<Point32> & list);
 template BoundingBox minimum_perimeter_bounding_box<Point32>(std::list<Point32> & list);
+template BoundingBox minimum_area_bounding_box<Point32>(std::vector<Point32> & points);
+template BoundingBox minimum_perimeter_bounding_box<Point32>(std::vector<Point32> & points);
 using Point32VIT = std::vector<Point32>::iterator;
 template BoundingBox eigenbox_2d<Point32VIT>(const Point32VIT begin, const Point32VIT end);
 template BoundingBox lfit_bounding_box_2d<Point32VIT>(const Point32VIT begin, const Point32VIT end);
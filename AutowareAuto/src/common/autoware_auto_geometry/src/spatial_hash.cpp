@@ -36,9 +36,10 @@ Config2d::Config2d(
   const float32_t min_y,
   const float32_t max_y,
   const float32_t radius,
-  const Index capacity)
+  const Index capacity,
+  const StorageMethod storage)
 : Config(min_x, max_x, min_y, max_y, {}, std::numeric_limits<float32_t>::min(),
-    radius, capacity)
+    radius, capacity, storage)
 {
 }
 ////////////////////////////////////////////////////////////////////////////////
@@ -78,8 +79,9 @@ Config3d::Config3d(
   const float32_t min_z,
   const float32_t max_z,
   const float32_t radius,
-  const Index capacity)
-: Config(min_x, max_x, min_y, max_y, min_z, max_z, radius, capacity)
+  const Index capacity,
+  const StorageMethod storage)
+: Config(min_x, max_x, min_y, max_y, min_z, max_z, radius, capacity, storage)
 {
 }
 ////////////////////////////////////////////////////////////////////////////////
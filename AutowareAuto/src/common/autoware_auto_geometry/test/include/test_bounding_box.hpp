@@ -272,6 +272,37 @@ TYPED_TEST(BoxTest, Hull)
   ASSERT_FLOAT_EQ(this->box.value, this->box.size.x * this->box.size.y);
 }
 
+// The contiguous buffer overloads give the same boxes as the list overloads
+TYPED_TEST(BoxTest, ContiguousBuffer)
+{
+  const uint32_t FUZZ_SIZE = 256U;
+  for (uint32_t idx = 0U; idx < FUZZ_SIZE; ++idx) {
+    const float th = (idx * autoware::common::types::TAU) / FUZZ_SIZE;
+    // Shuffle the angles so that the points are not sorted
+    const float r = ((idx % 3U) == 0U) ? 4.0F : 5.0F;
+    this->points.push_back(this->make(r * cosf(3.0F * th) + 1.0F, 2.0F * r * sinf(3.0F * th)));
+  }
+  std::vector<TypeParam> buffer{this->points.begin(), this->points.end()};
+
+  this->minimum_area_bounding_box();
+  auto expect = this->box;
+  this->box = autoware::common::geometry::bounding_box::minimum_area_bounding_box(buffer);
+  ASSERT_FLOAT_EQ(this->box.value, expect.value);
+  for (uint32_t idx = 0U; idx < 4U; ++idx) {
+    ASSERT_FLOAT_EQ(this->box.corners[idx].x, expect.corners[idx].x);
+    ASSERT_FLOAT_EQ(this->box.corners[idx].y, expect.corners[idx].y);
+  }
+
+  this->minimum_perimeter_bounding_box();
+  expect = this->box;
+  this->box = autoware::common::geometry::bounding_box::minimum_perimeter_bounding_box(buffer);
+  ASSERT_FLOAT_EQ(this->box.value, expect.value);
+  for (uint32_t idx = 0U; idx < 4U; ++idx) {
+    ASSERT_FLOAT_EQ(this->box.corners[idx].x, expect.corners[idx].x);
+    ASSERT_FLOAT_EQ(this->box.corners[idx].y, expect.corners[idx].y);
+  }
+}
+
 //
 TYPED_TEST(BoxTest, Collinear)
 {
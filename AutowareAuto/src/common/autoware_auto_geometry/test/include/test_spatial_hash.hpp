@@ -230,6 +230,67 @@ TYPED_TEST(TypedSpatialHashTest, 3d)
   EXPECT_EQ(count, 0U);
 }
 
+/// flat storage backend should behave the same as the default backend
+TYPED_TEST(TypedSpatialHashTest, FlatStorage)
+{
+  using PointT = TypeParam;
+  using autoware::common::geometry::spatial_hash::StorageMethod;
+  const float32_t dr = 1.0F;
+  const uint32_t PTS_PER_RING = 16U;
+  const uint32_t NUM_RINGS = 4U;
+  Config2d cfg{-10.0F, 10.0F, -10.0F, 10.0F, 1.0F, PTS_PER_RING * NUM_RINGS, StorageMethod::FLAT};
+  Config2d ref_cfg{-10.0F, 10.0F, -10.0F, 10.0F, 1.0F, PTS_PER_RING * NUM_RINGS};
+  SpatialHash2d<PointT> hash{cfg};
+  SpatialHash2d<PointT> ref_hash{ref_cfg};
+  EXPECT_TRUE(hash.empty());
+  this->add_points(hash, PTS_PER_RING, NUM_RINGS, dr);
+  this->add_points(ref_hash, PTS_PER_RING, NUM_RINGS, dr);
+  EXPECT_EQ(hash.size(), ref_hash.size());
+  // full
+  EXPECT_THROW(hash.insert(this->ref), std::length_error);
+
+  // same number of neighbors as the default backend for all radii
+  float32_t r = dr - this->EPS;
+  for (uint32_t rdx = 0U; rdx < NUM_RINGS + 1U; ++rdx) {
+    const auto & neighbors = hash.near(this->ref, r);
+    for (const auto & itd : neighbors) {
+      const PointT & pt = itd;
+      const float32_t dist = sqrtf((pt.x * pt.x) + (pt.y * pt.y));
+      ASSERT_LT(dist, r);
+      ASSERT_FLOAT_EQ(dist, itd.get_distance());
+    }
+    ASSERT_EQ(neighbors.size(), rdx * PTS_PER_RING);
+    ASSERT_EQ(neighbors.size(), ref_hash.near(this->ref, r).size());
+    r += dr;
+  }
+
+  // erase the innermost ring through the query output
+  const auto inner = hash.near(this->ref, dr + this->EPS);
+  for (const auto & itd : inner) {
+    (void)hash.erase(itd);
+  }
+  EXPECT_EQ(hash.size(), (NUM_RINGS - 1U) * PTS_PER_RING);
+  EXPECT_EQ(hash.near(this->ref, dr + this->EPS).size(), 0U);
+  uint32_t count = 0U;
+  for (auto iter = hash.cbegin(); iter != hash.cend(); ++iter) {
+    ++count;
+  }
+  EXPECT_EQ(count, hash.size());
+  // erased slots are reused
+  this->add_points(hash, PTS_PER_RING, 1U, dr);
+  EXPECT_EQ(hash.near(this->ref, dr + this->EPS).size(), PTS_PER_RING);
+  // erase everything by iterating from the front
+  auto it = hash.begin();
+  while (it != hash.end()) {
+    it = hash.erase(it);
+  }
+  EXPECT_TRUE(hash.empty());
+  this->add_points(hash, PTS_PER_RING, NUM_RINGS, dr);
+  hash.clear();
+  EXPECT_TRUE(hash.empty());
+  EXPECT_EQ(hash.begin(), hash.end());
+}
+
 /// edge cases
 TEST(SpatialHashConfig, BadCases)
 {
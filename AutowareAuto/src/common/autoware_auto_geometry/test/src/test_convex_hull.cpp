@@ -369,4 +369,68 @@ TYPED_TEST(TypedConvexHullTest, Root)
   EXPECT_EQ(last->z, 6);
 }
 
-// TODO(c.ho) random input, fuzzing, stress tests
+// Same as Root, on a contiguous buffer
+TYPED_TEST(TypedConvexHullTest, Contiguous)
+{
+  std::vector<TypeParam> data({
+    this->make(0, 0, 1),
+    this->make(1, -1, 2),
+    this->make(3, -2, 3),
+    this->make(4, 0, 4),
+    this->make(3, 1, 5),
+    this->make(1, 0, 6),
+  });
+
+  const auto last = autoware::common::geometry::convex_hull(data.begin(), data.end());
+
+  ASSERT_EQ(std::distance(data.begin(), last), 5);
+  auto it = data.begin();
+  ASSERT_FLOAT_EQ(it->z, 1); ++it;
+  ASSERT_FLOAT_EQ(it->z, 2); ++it;
+  ASSERT_FLOAT_EQ(it->z, 3); ++it;
+  ASSERT_FLOAT_EQ(it->z, 4); ++it;
+  ASSERT_FLOAT_EQ(it->z, 5); ++it;
+  ASSERT_EQ(it, last);
+  EXPECT_EQ(last->z, 6);
+}
+
+// Points on a coarse grid, with many collinear and overlapping points
+TYPED_TEST(TypedConvexHullTest, ContiguousFuzz)
+{
+  using autoware::common::geometry::ccw;
+  uint32_t seed = 1U;
+  const auto next_coordinate = [&seed]() -> float32_t {
+      seed = (seed * 1103515245U) + 12345U;
+      return static_cast<float32_t>((seed >> 16U) % 11U) - 5.0F;
+    };
+  for (uint32_t iter = 0U; iter < 200U; ++iter) {
+    std::vector<TypeParam> data;
+    for (uint32_t idx = 0U; idx < 4U + (iter % 50U); ++idx) {
+      const auto x = next_coordinate();
+      data.push_back(this->make(x, next_coordinate(), 0.0F));
+    }
+    const auto points = data;
+    const auto last = autoware::common::geometry::convex_hull(data.begin(), data.end());
+    const auto hull_size = static_cast<std::size_t>(std::distance(data.begin(), last));
+    ASSERT_GE(hull_size, 2U);
+    // The first point is the left-most point
+    for (const auto & pt : points) {
+      ASSERT_LE(data.front().x, pt.x);
+    }
+    for (std::size_t idx = 0U; idx < hull_size; ++idx) {
+      const auto & p = data[idx];
+      const auto & q = data[(idx + 1U) % hull_size];
+      // Strictly convex, in counter-clockwise order
+      if (hull_size > 2U) {
+        ASSERT_FALSE(ccw(p, q, data[(idx + 2U) % hull_size]));
+      }
+      // No point is outside of the hull
+      for (const auto & pt : points) {
+        const auto cross = ((q.x - p.x) * (pt.y - p.y)) - ((q.y - p.y) * (pt.x - p.x));
+        ASSERT_GE(cross, 0.0F);
+      }
+    }
+  }
+}
+
+// TODO(c.ho) stress tests
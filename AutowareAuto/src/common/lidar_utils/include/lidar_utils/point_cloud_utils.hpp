@@ -75,6 +75,13 @@ struct SafeCloudIndices
 /// {memcpy(&pt, msg.data[idx], ret.point_step);}`
 LIDAR_UTILS_PUBLIC SafeCloudIndices sanitize_point_cloud(const sensor_msgs::msg::PointCloud2 & msg);
 
+/// \brief Move the points of a point cloud into a new message, e.g. to publish it as a
+///        std::unique_ptr through intra-process communication without copying the points
+/// \param[inout] cloud The point cloud to take the points from. Its header and point layout are
+///                     kept, but it is left without any points and without capacity.
+/// \return A point cloud with the header, layout and points of the input point cloud
+LIDAR_UTILS_PUBLIC std::unique_ptr<PointCloud2> take_point_cloud(PointCloud2 & cloud);
+
 /// \brief Get cluster from clusters based on the cluster id
 /// \param[in] clusters The clusters object
 /// \param[in] cls_id The id of the target cluster
@@ -158,6 +158,18 @@ SafeCloudIndices sanitize_point_cloud(const sensor_msgs::msg::PointCloud2 & msg)
   return SafeCloudIndices{num_floats * sizeof(float32_t), index_after_last_safe_byte_index(msg)};
 }
 
+std::unique_ptr<PointCloud2> take_point_cloud(PointCloud2 & cloud)
+{
+  // Swap the points out first so that only the layout is copied
+  std::vector<uint8_t> data;
+  data.swap(cloud.data);
+  auto ret = std::make_unique<PointCloud2>(cloud);
+  ret->data.swap(data);
+  cloud.width = 0U;
+  cloud.row_step = 0U;
+  return ret;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 
 DistanceFilter::DistanceFilter(float32_t min_radius, float32_t max_radius)
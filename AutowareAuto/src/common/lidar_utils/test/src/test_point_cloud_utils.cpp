@@ -62,6 +62,31 @@ TEST(TestPointCloudUtils, HasIntensityAndThrowIfNoXyzTest)
   EXPECT_TRUE(has_intensity_and_throw_if_no_xyz(five_fields_pc));
 }
 
+TEST(TestPointCloudUtils, TakePointCloud)
+{
+  using autoware::common::lidar_utils::create_custom_pcl;
+  using autoware::common::lidar_utils::take_point_cloud;
+
+  const auto cloud = create_custom_pcl<float32_t>({"x", "y", "z", "intensity"}, 10U);
+  cloud->header.frame_id = "lidar";
+  const auto expected = *cloud;
+  const auto * const points = cloud->data.data();
+
+  const auto taken = take_point_cloud(*cloud);
+  ASSERT_NE(taken, nullptr);
+  EXPECT_EQ(*taken, expected);
+  // The points are moved, not copied
+  EXPECT_EQ(taken->data.data(), points);
+  // The remaining point cloud is empty but keeps its layout
+  EXPECT_TRUE(cloud->data.empty());
+  EXPECT_EQ(cloud->width, 0U);
+  EXPECT_EQ(cloud->row_step, 0U);
+  EXPECT_EQ(cloud->height, expected.height);
+  EXPECT_EQ(cloud->point_step, expected.point_step);
+  EXPECT_EQ(cloud->fields, expected.fields);
+  EXPECT_EQ(cloud->header, expected.header);
+}
+
 TEST(TestStaticTransformer, TransformPoint)
 {
   Eigen::Quaternionf rotation;
@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "eigen3/Eigen/Core"
+#include "eigen3/Eigen/SparseCore"
 #include "osqp/glob_opts.h"  // for 'c_int' type ('long' or 'long long')
 #include "osqp_interface/visibility_control.hpp"
 
@@ -42,6 +43,13 @@ struct OSQP_INTERFACE_PUBLIC CSC_Matrix
 OSQP_INTERFACE_PUBLIC CSC_Matrix calCSCMatrix(const Eigen::MatrixXd & mat);
 /// \brief Calculate upper trapezoidal CSC matrix from square Eigen matrix
 OSQP_INTERFACE_PUBLIC CSC_Matrix calCSCMatrixTrapezoidal(const Eigen::MatrixXd & mat);
+/// \brief Calculate CSC matrix from Eigen sparse matrix
+/// \details All stored elements are kept, including explicit zeros, so the sparsity pattern does
+/// \details not depend on the values.
+OSQP_INTERFACE_PUBLIC CSC_Matrix calCSCMatrix(const Eigen::SparseMatrix<c_float> & mat);
+/// \brief Calculate upper trapezoidal CSC matrix from square Eigen sparse matrix
+/// \details All stored elements of the upper triangle are kept, including explicit zeros.
+OSQP_INTERFACE_PUBLIC CSC_Matrix calCSCMatrixTrapezoidal(const Eigen::SparseMatrix<c_float> & mat);
 /// \brief Print the given CSC matrix to the standard output
 OSQP_INTERFACE_PUBLIC void printCSCMatrix(const CSC_Matrix & csc_mat);
 
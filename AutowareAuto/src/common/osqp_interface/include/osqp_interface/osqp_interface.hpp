@@ -23,6 +23,7 @@
 
 #include "common/types.hpp"
 #include "eigen3/Eigen/Core"
+#include "eigen3/Eigen/SparseCore"
 #include "osqp/osqp.h"
 #include "osqp_interface/visibility_control.hpp"
 #include "osqp_interface/csc_matrix_conv.hpp"
@@ -52,13 +53,33 @@ private:
   OSQPInfo m_latest_work_info;
   // Number of parameters to optimize
   int64_t m_param_n;
+  // Number of constraints
+  int64_t m_constr_m = 0;
+  // Matrices of the problem in the workspace, to detect whether the sparsity pattern changed
+  CSC_Matrix m_P_csc;
+  CSC_Matrix m_A_csc;
   // Flag to check if the current work exists
   bool8_t m_work_initialized = false;
+  // Whether the solution in the workspace is a good starting point for the next problem, i.e. it
+  // is from a solve which converged or was given to setWarmStart()
+  bool8_t m_warm_start_valid = false;
   // Exitflag
   int64_t m_exitflag;
 
   // Runs the solver on the stored problem.
   std::tuple<std::vector<float64_t>, std::vector<float64_t>, int64_t, int64_t> solve();
+  // Sets up a new workspace for the given problem, replacing the current one. If warm_start is set,
+  // the dimensions are unchanged and the last solve converged, the solver starts from its solution.
+  int64_t setupWorkspace(
+    CSC_Matrix && P_csc, CSC_Matrix && A_csc, int64_t param_n, int64_t constr_m,
+    const std::vector<float64_t> & q, const std::vector<float64_t> & l,
+    const std::vector<float64_t> & u, bool8_t warm_start);
+  // Updates the workspace in place if the problem has the same dimensions and sparsity patterns,
+  // otherwise sets up a new warm started workspace.
+  int64_t updateWorkspace(
+    CSC_Matrix && P_csc, CSC_Matrix && A_csc, int64_t param_n, int64_t constr_m,
+    const std::vector<float64_t> & q, const std::vector<float64_t> & l,
+    const std::vector<float64_t> & u);
 
 public:
   /// \brief Constructor without problem formulation
@@ -76,6 +97,10 @@ public:
     const std::vector<float64_t> & l, const std::vector<float64_t> & u, const c_float eps_abs);
   ~OSQPInterface();
 
+  // The workspace is owned by the interface
+  OSQPInterface(const OSQPInterface &) = delete;
+  OSQPInterface & operator=(const OSQPInterface &) = delete;
+
   /****************
    * OPTIMIZATION
    ****************/
@@ -115,11 +140,21 @@ public:
   /// \details        std::vector<float> param = std::get<0>(result);
   /// \details        float64_t x_0 = param[0];
   /// \details        float64_t x_1 = param[1];
+  /// \details The workspace is kept between calls, see updateProblem().
   std::tuple<std::vector<float64_t>, std::vector<float64_t>, int64_t, int64_t> optimize(
     const Eigen::MatrixXd & P, const Eigen::MatrixXd & A, const std::vector<float64_t> & q,
     const std::vector<float64_t> & l, const std::vector<float64_t> & u);
 
-  /// \brief Converts the input data and sets up the workspace object.
+  /// \brief Solves convex quadratic programs (QPs) given as sparse matrices using the OSQP solver.
+  /// \details Same as the dense version, but the sparsity patterns are taken from the stored
+  /// \details elements of P and A, so they stay the same as long as the structure of the problem
+  /// \details does. Only the upper triangle of P is used.
+  std::tuple<std::vector<float64_t>, std::vector<float64_t>, int64_t, int64_t> optimize(
+    const Eigen::SparseMatrix<float64_t> & P, const Eigen::SparseMatrix<float64_t> & A,
+    const std::vector<float64_t> & q, const std::vector<float64_t> & l,
+    const std::vector<float64_t> & u);
+
+  /// \brief Converts the input data and sets up a new workspace object.
   /// \param P (n,n) matrix defining relations between parameters.
   /// \param A (m,n) matrix defining parameter constraints relative to the lower and upper bound.
   /// \param q (n) vector defining the linear cost of the problem.
@@ -129,6 +164,51 @@ public:
     const Eigen::MatrixXd & P, const Eigen::MatrixXd & A, const std::vector<float64_t> & q,
     const std::vector<float64_t> & l, const std::vector<float64_t> & u);
 
+  /// \brief Converts the sparse input data and sets up a new workspace object.
+  /// \details All stored elements are used, only the upper triangle of P.
+  int64_t initializeProblem(
+    const Eigen::SparseMatrix<float64_t> & P, const Eigen::SparseMatrix<float64_t> & A,
+    const std::vector<float64_t> & q, const std::vector<float64_t> & l,
+    const std::vector<float64_t> & u);
+
+  /// \brief Updates the problem, keeping the current workspace if possible.
+  /// \details If the dimensions and the sparsity patterns of P and A are unchanged, only the
+  /// \details changed values are copied into the workspace and the factorization is reused when
+  /// \details P and A did not change. Otherwise a new workspace is set up. In both cases the
+  /// \details solver is warm started from the previous solution if the dimensions are unchanged
+  /// \details and the previous solve converged, otherwise it starts from zero.
+  /// \details Elements of the dense matrices below 1e-9 are not stored, so their sparsity pattern
+  /// \details changes when an element becomes zero; prefer the sparse version for such problems.
+  /// \param P (n,n) matrix defining relations between parameters.
+  /// \param A (m,n) matrix defining parameter constraints relative to the lower and upper bound.
+  /// \param q (n) vector defining the linear cost of the problem.
+  /// \param l (m) vector defining the lower bound problem constraint.
+  /// \param u (m) vector defining the upper bound problem constraint.
+  int64_t updateProblem(
+    const Eigen::MatrixXd & P, const Eigen::MatrixXd & A, const std::vector<float64_t> & q,
+    const std::vector<float64_t> & l, const std::vector<float64_t> & u);
+
+  /// \brief Updates the problem given as sparse matrices, keeping the current workspace if
+  /// \brief possible. See the dense version for details.
+  int64_t updateProblem(
+    const Eigen::SparseMatrix<float64_t> & P, const Eigen::SparseMatrix<float64_t> & A,
+    const std::vector<float64_t> & q, const std::vector<float64_t> & l,
+    const std::vector<float64_t> & u);
+
+  /// \brief Updates the linear cost of the problem in the workspace.
+  /// \param q (n) vector defining the linear cost of the problem.
+  int64_t updateQ(const std::vector<float64_t> & q);
+
+  /// \brief Updates the constraint bounds of the problem in the workspace.
+  /// \param l (m) vector defining the lower bound problem constraint.
+  /// \param u (m) vector defining the upper bound problem constraint.
+  int64_t updateBounds(const std::vector<float64_t> & l, const std::vector<float64_t> & u);
+
+  /// \brief Sets the starting point of the next optimization.
+  /// \param primal (n) initial primal solution.
+  /// \param dual (m) initial lagrange multipliers.
+  int64_t setWarmStart(const std::vector<float64_t> & primal, const std::vector<float64_t> & dual);
+
   /// \brief Get the number of iteration taken to solve the problem
   inline int64_t getTakenIter() const {return static_cast<int64_t>(m_latest_work_info.iter);}
   /// \brief Get the status message for the latest problem solved
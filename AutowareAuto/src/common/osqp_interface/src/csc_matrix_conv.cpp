@@ -114,6 +114,56 @@ CSC_Matrix calCSCMatrixTrapezoidal(const Eigen::MatrixXd & mat)
   return csc_matrix;
 }
 
+CSC_Matrix calCSCMatrix(const Eigen::SparseMatrix<c_float> & mat)
+{
+  const size_t elem = static_cast<size_t>(mat.nonZeros());
+
+  CSC_Matrix csc_matrix;
+  csc_matrix.m_vals.reserve(elem);
+  csc_matrix.m_row_idxs.reserve(elem);
+  csc_matrix.m_col_idxs.reserve(static_cast<size_t>(mat.outerSize() + 1));
+
+  csc_matrix.m_col_idxs.push_back(0);
+  for (Eigen::Index j = 0; j < mat.outerSize(); j++) {  // col iteration
+    for (Eigen::SparseMatrix<c_float>::InnerIterator it(mat, j); it; ++it) {  // row iteration
+      csc_matrix.m_vals.push_back(it.value());
+      csc_matrix.m_row_idxs.push_back(static_cast<c_int>(it.row()));
+    }
+    csc_matrix.m_col_idxs.push_back(static_cast<c_int>(csc_matrix.m_vals.size()));
+  }
+
+  return csc_matrix;
+}
+
+CSC_Matrix calCSCMatrixTrapezoidal(const Eigen::SparseMatrix<c_float> & mat)
+{
+  if (mat.rows() != mat.cols()) {
+    throw std::invalid_argument("Matrix must be square (n, n)");
+  }
+
+  const size_t elem = static_cast<size_t>(mat.nonZeros());
+
+  CSC_Matrix csc_matrix;
+  csc_matrix.m_vals.reserve(elem);
+  csc_matrix.m_row_idxs.reserve(elem);
+  csc_matrix.m_col_idxs.reserve(static_cast<size_t>(mat.outerSize() + 1));
+
+  csc_matrix.m_col_idxs.push_back(0);
+  for (Eigen::Index j = 0; j < mat.outerSize(); j++) {  // col iteration
+    for (Eigen::SparseMatrix<c_float>::InnerIterator it(mat, j); it; ++it) {  // row iteration
+      // Row indices are sorted, so the rest of the column is in the lower triangle
+      if (it.row() > j) {
+        break;
+      }
+      csc_matrix.m_vals.push_back(it.value());
+      csc_matrix.m_row_idxs.push_back(static_cast<c_int>(it.row()));
+    }
+    csc_matrix.m_col_idxs.push_back(static_cast<c_int>(csc_matrix.m_vals.size()));
+  }
+
+  return csc_matrix;
+}
+
 void printCSCMatrix(const CSC_Matrix & csc_mat)
 {
   std::cout << "[";
@@ -16,8 +16,10 @@
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "osqp/osqp.h"
@@ -62,48 +64,198 @@ int64_t OSQPInterface::initializeProblem(
   const Eigen::MatrixXd & P, const Eigen::MatrixXd & A, const std::vector<float64_t> & q,
   const std::vector<float64_t> & l, const std::vector<float64_t> & u)
 {
-  /*******************
-   * SET UP MATRICES
-   *******************/
-  CSC_Matrix P_csc = calCSCMatrixTrapezoidal(P);
-  CSC_Matrix A_csc = calCSCMatrix(A);
+  return setupWorkspace(
+    calCSCMatrixTrapezoidal(P), calCSCMatrix(A), P.rows(), A.rows(), q, l, u, false);
+}
+
+int64_t OSQPInterface::initializeProblem(
+  const Eigen::SparseMatrix<float64_t> & P, const Eigen::SparseMatrix<float64_t> & A,
+  const std::vector<float64_t> & q, const std::vector<float64_t> & l,
+  const std::vector<float64_t> & u)
+{
+  return setupWorkspace(
+    calCSCMatrixTrapezoidal(P), calCSCMatrix(A), P.rows(), A.rows(), q, l, u, false);
+}
+
+int64_t OSQPInterface::updateProblem(
+  const Eigen::MatrixXd & P, const Eigen::MatrixXd & A, const std::vector<float64_t> & q,
+  const std::vector<float64_t> & l, const std::vector<float64_t> & u)
+{
+  return updateWorkspace(
+    calCSCMatrixTrapezoidal(P), calCSCMatrix(A), P.rows(), A.rows(), q, l, u);
+}
+
+int64_t OSQPInterface::updateProblem(
+  const Eigen::SparseMatrix<float64_t> & P, const Eigen::SparseMatrix<float64_t> & A,
+  const std::vector<float64_t> & q, const std::vector<float64_t> & l,
+  const std::vector<float64_t> & u)
+{
+  return updateWorkspace(
+    calCSCMatrixTrapezoidal(P), calCSCMatrix(A), P.rows(), A.rows(), q, l, u);
+}
+
+int64_t OSQPInterface::setupWorkspace(
+  CSC_Matrix && P_csc, CSC_Matrix && A_csc, const int64_t param_n, const int64_t constr_m,
+  const std::vector<float64_t> & q, const std::vector<float64_t> & l,
+  const std::vector<float64_t> & u, const bool8_t warm_start)
+{
+  // Keep the previous solution, the workspace holding it is replaced
+  std::vector<float64_t> prev_primal;
+  std::vector<float64_t> prev_dual;
+  if (m_work) {
+    if (warm_start && m_warm_start_valid && (param_n == m_param_n) && (constr_m == m_constr_m)) {
+      prev_primal.assign(m_work->solution->x, m_work->solution->x + m_param_n);
+      prev_dual.assign(m_work->solution->y, m_work->solution->y + m_constr_m);
+    }
+    osqp_cleanup(m_work);
+    m_work = nullptr;
+    m_work_initialized = false;
+  }
+
+  m_P_csc = std::move(P_csc);
+  m_A_csc = std::move(A_csc);
+  m_param_n = param_n;
+  m_constr_m = constr_m;
+
+  // OSQP copies the data during the setup, so the matrices only need to live until then
+  csc P_mat{};
+  P_mat.nzmax = static_cast<c_int>(m_P_csc.m_vals.size());
+  P_mat.m = static_cast<c_int>(m_param_n);
+  P_mat.n = static_cast<c_int>(m_param_n);
+  P_mat.p = m_P_csc.m_col_idxs.data();
+  P_mat.i = m_P_csc.m_row_idxs.data();
+  P_mat.x = m_P_csc.m_vals.data();
+  P_mat.nz = -1;
+  csc A_mat{};
+  A_mat.nzmax = static_cast<c_int>(m_A_csc.m_vals.size());
+  A_mat.m = static_cast<c_int>(m_constr_m);
+  A_mat.n = static_cast<c_int>(m_param_n);
+  A_mat.p = m_A_csc.m_col_idxs.data();
+  A_mat.i = m_A_csc.m_row_idxs.data();
+  A_mat.x = m_A_csc.m_vals.data();
+  A_mat.nz = -1;
   // Dynamic float arrays
   std::vector<float64_t> q_tmp(q.begin(), q.end());
   std::vector<float64_t> l_tmp(l.begin(), l.end());
   std::vector<float64_t> u_tmp(u.begin(), u.end());
-  float64_t * q_dyn = q_tmp.data();
-  float64_t * l_dyn = l_tmp.data();
-  float64_t * u_dyn = u_tmp.data();
-
-  /**********************
-   * OBJECTIVE FUNCTION
-   **********************/
-  // Number of constraints
-  c_int constr_m = A.rows();
-  // Number of parameters
-  m_param_n = P.rows();
 
   /*****************
    * POPULATE DATA
    *****************/
-  m_data->m = constr_m;
-  m_data->n = m_param_n;
-  m_data->P = csc_matrix(
-    m_data->n, m_data->n, static_cast<c_int>(P_csc.m_vals.size()), P_csc.m_vals.data(),
-    P_csc.m_row_idxs.data(),
-    P_csc.m_col_idxs.data());
-  m_data->q = q_dyn;
-  m_data->A = csc_matrix(
-    m_data->m, m_data->n, static_cast<c_int>(A_csc.m_vals.size()), A_csc.m_vals.data(),
-    A_csc.m_row_idxs.data(),
-    A_csc.m_col_idxs.data());
-  m_data->l = l_dyn;
-  m_data->u = u_dyn;
+  m_data->m = static_cast<c_int>(m_constr_m);
+  m_data->n = static_cast<c_int>(m_param_n);
+  m_data->P = &P_mat;
+  m_data->q = q_tmp.data();
+  m_data->A = &A_mat;
+  m_data->l = l_tmp.data();
+  m_data->u = u_tmp.data();
 
   // Setup workspace
   m_exitflag = osqp_setup(&m_work, m_data.get(), m_settings.get());
-  m_work_initialized = true;
+  m_data->P = nullptr;
+  m_data->q = nullptr;
+  m_data->A = nullptr;
+  m_data->l = nullptr;
+  m_data->u = nullptr;
+  m_work_initialized = (m_exitflag == 0);
+  m_warm_start_valid = false;
+
+  if (m_work_initialized && !prev_primal.empty()) {
+    m_exitflag = osqp_warm_start(m_work, prev_primal.data(), prev_dual.data());
+    m_warm_start_valid = (m_exitflag == 0);
+  }
+  return m_exitflag;
+}
+
+int64_t OSQPInterface::updateWorkspace(
+  CSC_Matrix && P_csc, CSC_Matrix && A_csc, const int64_t param_n, const int64_t constr_m,
+  const std::vector<float64_t> & q, const std::vector<float64_t> & l,
+  const std::vector<float64_t> & u)
+{
+  const auto same_pattern = [](const CSC_Matrix & lhs, const CSC_Matrix & rhs) {
+      return (lhs.m_row_idxs == rhs.m_row_idxs) && (lhs.m_col_idxs == rhs.m_col_idxs);
+    };
+  if (!m_work_initialized || (param_n != m_param_n) || (constr_m != m_constr_m) ||
+    !same_pattern(P_csc, m_P_csc) || !same_pattern(A_csc, m_A_csc))
+  {
+    return setupWorkspace(std::move(P_csc), std::move(A_csc), param_n, constr_m, q, l, u, true);
+  }
+
+  // The solution of the previous problem stays in the workspace and is used as warm start, unless
+  // that solve did not converge. Unchanged matrices keep the current factorization.
+  if (!m_warm_start_valid) {
+    const std::vector<float64_t> zero_primal(static_cast<std::size_t>(m_param_n), 0.0);
+    const std::vector<float64_t> zero_dual(static_cast<std::size_t>(m_constr_m), 0.0);
+    m_exitflag = osqp_warm_start(m_work, zero_primal.data(), zero_dual.data());
+    if (m_exitflag != 0) {
+      return m_exitflag;
+    }
+  }
+  const bool8_t P_changed = (P_csc.m_vals != m_P_csc.m_vals);
+  const bool8_t A_changed = (A_csc.m_vals != m_A_csc.m_vals);
+  m_P_csc.m_vals = std::move(P_csc.m_vals);
+  m_A_csc.m_vals = std::move(A_csc.m_vals);
+  m_exitflag = 0;
+  if (P_changed && A_changed) {
+    m_exitflag = osqp_update_P_A(
+      m_work, m_P_csc.m_vals.data(), OSQP_NULL, static_cast<c_int>(m_P_csc.m_vals.size()),
+      m_A_csc.m_vals.data(), OSQP_NULL, static_cast<c_int>(m_A_csc.m_vals.size()));
+  } else if (P_changed) {
+    m_exitflag = osqp_update_P(
+      m_work, m_P_csc.m_vals.data(), OSQP_NULL, static_cast<c_int>(m_P_csc.m_vals.size()));
+  } else if (A_changed) {
+    m_exitflag = osqp_update_A(
+      m_work, m_A_csc.m_vals.data(), OSQP_NULL, static_cast<c_int>(m_A_csc.m_vals.size()));
+  }
+  if (m_exitflag == 0) {
+    m_exitflag = updateQ(q);
+  }
+  if (m_exitflag == 0) {
+    m_exitflag = updateBounds(l, u);
+  }
+  return m_exitflag;
+}
+
+int64_t OSQPInterface::updateQ(const std::vector<float64_t> & q)
+{
+  if (!m_work_initialized) {
+    throw std::runtime_error("OSQPInterface: no problem was set up");
+  }
+  if (static_cast<int64_t>(q.size()) < m_param_n) {
+    throw std::invalid_argument("OSQPInterface: q must have n elements");
+  }
+  m_exitflag = osqp_update_lin_cost(m_work, q.data());
+  return m_exitflag;
+}
 
+int64_t OSQPInterface::updateBounds(
+  const std::vector<float64_t> & l, const std::vector<float64_t> & u)
+{
+  if (!m_work_initialized) {
+    throw std::runtime_error("OSQPInterface: no problem was set up");
+  }
+  if ((static_cast<int64_t>(l.size()) < m_constr_m) ||
+    (static_cast<int64_t>(u.size()) < m_constr_m))
+  {
+    throw std::invalid_argument("OSQPInterface: l and u must have m elements");
+  }
+  m_exitflag = osqp_update_bounds(m_work, l.data(), u.data());
+  return m_exitflag;
+}
+
+int64_t OSQPInterface::setWarmStart(
+  const std::vector<float64_t> & primal, const std::vector<float64_t> & dual)
+{
+  if (!m_work_initialized) {
+    throw std::runtime_error("OSQPInterface: no problem was set up");
+  }
+  if ((static_cast<int64_t>(primal.size()) < m_param_n) ||
+    (static_cast<int64_t>(dual.size()) < m_constr_m))
+  {
+    throw std::invalid_argument("OSQPInterface: primal and dual must have n and m elements");
+  }
+  m_exitflag = osqp_warm_start(m_work, primal.data(), dual.data());
+  m_warm_start_valid = (m_exitflag == 0);
   return m_exitflag;
 }
 
@@ -136,6 +288,8 @@ std::tuple<std::vector<float64_t>, std::vector<float64_t>, int64_t, int64_t> OSQ
     std::make_tuple(sol_primal, sol_lagrange_multiplier, status_polish, status_solution);
 
   m_latest_work_info = *(m_work->info);
+  // The iterate of a solve which did not converge is a poor starting point for the next problem
+  m_warm_start_valid = (status_solution == OSQP_SOLVED);
 
   return result;
 }
@@ -153,8 +307,23 @@ std::tuple<std::vector<float64_t>, std::vector<float64_t>, int64_t,
   const Eigen::MatrixXd & P, const Eigen::MatrixXd & A, const std::vector<float64_t> & q,
   const std::vector<float64_t> & l, const std::vector<float64_t> & u)
 {
-  // Allocate memory for problem
-  initializeProblem(P, A, q, l, u);
+  // Reuse the workspace of the previous problem if possible
+  updateProblem(P, A, q, l, u);
+
+  // Run the solver on the stored problem representation.
+  std::tuple<std::vector<float64_t>, std::vector<float64_t>, int64_t, int64_t> result = solve();
+
+  return result;
+}
+
+std::tuple<std::vector<float64_t>, std::vector<float64_t>, int64_t,
+  int64_t> OSQPInterface::optimize(
+  const Eigen::SparseMatrix<float64_t> & P, const Eigen::SparseMatrix<float64_t> & A,
+  const std::vector<float64_t> & q, const std::vector<float64_t> & l,
+  const std::vector<float64_t> & u)
+{
+  // Reuse the workspace of the previous problem if possible
+  updateProblem(P, A, q, l, u);
 
   // Run the solver on the stored problem representation.
   std::tuple<std::vector<float64_t>, std::vector<float64_t>, int64_t, int64_t> result = solve();
@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "eigen3/Eigen/Core"
+#include "eigen3/Eigen/SparseCore"
 #include "gtest/gtest.h"
 #include "osqp_interface/csc_matrix_conv.hpp"
 
@@ -169,6 +170,55 @@ TEST(TestCscMatrixConv, Trapezoidal) {
     EXPECT_EQ(e.what(), std::string("Matrix must be square (n, n)"));
   }
 }
+TEST(TestCscMatrixConv, Sparse) {
+  using autoware::common::osqp::CSC_Matrix;
+  using autoware::common::osqp::calCSCMatrix;
+  using autoware::common::osqp::calCSCMatrixTrapezoidal;
+
+  Eigen::SparseMatrix<c_float> square1(3, 3);
+  square1.insert(0, 0) = 1.0;
+  square1.insert(1, 0) = 2.0;
+  square1.insert(0, 1) = 0.0;  // explicit zero
+  square1.insert(2, 2) = 3.0;
+  square1.makeCompressed();
+
+  // Explicit zeros are part of the pattern
+  const CSC_Matrix square_m1 = calCSCMatrix(square1);
+  ASSERT_EQ(square_m1.m_vals.size(), size_t(4));
+  EXPECT_EQ(square_m1.m_vals[0], 1.0);
+  EXPECT_EQ(square_m1.m_vals[1], 2.0);
+  EXPECT_EQ(square_m1.m_vals[2], 0.0);
+  EXPECT_EQ(square_m1.m_vals[3], 3.0);
+  ASSERT_EQ(square_m1.m_row_idxs.size(), size_t(4));
+  EXPECT_EQ(square_m1.m_row_idxs[0], c_int(0));
+  EXPECT_EQ(square_m1.m_row_idxs[1], c_int(1));
+  EXPECT_EQ(square_m1.m_row_idxs[2], c_int(0));
+  EXPECT_EQ(square_m1.m_row_idxs[3], c_int(2));
+  ASSERT_EQ(square_m1.m_col_idxs.size(), size_t(4));
+  EXPECT_EQ(square_m1.m_col_idxs[0], c_int(0));
+  EXPECT_EQ(square_m1.m_col_idxs[1], c_int(2));
+  EXPECT_EQ(square_m1.m_col_idxs[2], c_int(3));
+  EXPECT_EQ(square_m1.m_col_idxs[3], c_int(4));
+
+  // Trapezoidal: skip the lower left triangle (2.0 in this example)
+  const CSC_Matrix square_m2 = calCSCMatrixTrapezoidal(square1);
+  ASSERT_EQ(square_m2.m_vals.size(), size_t(3));
+  EXPECT_EQ(square_m2.m_vals[0], 1.0);
+  EXPECT_EQ(square_m2.m_vals[1], 0.0);
+  EXPECT_EQ(square_m2.m_vals[2], 3.0);
+  ASSERT_EQ(square_m2.m_row_idxs.size(), size_t(3));
+  EXPECT_EQ(square_m2.m_row_idxs[0], c_int(0));
+  EXPECT_EQ(square_m2.m_row_idxs[1], c_int(0));
+  EXPECT_EQ(square_m2.m_row_idxs[2], c_int(2));
+  ASSERT_EQ(square_m2.m_col_idxs.size(), size_t(4));
+  EXPECT_EQ(square_m2.m_col_idxs[0], c_int(0));
+  EXPECT_EQ(square_m2.m_col_idxs[1], c_int(1));
+  EXPECT_EQ(square_m2.m_col_idxs[2], c_int(2));
+  EXPECT_EQ(square_m2.m_col_idxs[3], c_int(3));
+
+  Eigen::SparseMatrix<c_float> rect1(1, 2);
+  EXPECT_THROW(calCSCMatrixTrapezoidal(rect1), std::invalid_argument);
+}
 TEST(TestCscMatrixConv, Print) {
   using autoware::common::osqp::CSC_Matrix;
   using autoware::common::osqp::printCSCMatrix;
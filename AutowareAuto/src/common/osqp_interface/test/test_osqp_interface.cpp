@@ -12,10 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <stdexcept>
 #include <tuple>
 #include <vector>
 
 #include "eigen3/Eigen/Core"
+#include "eigen3/Eigen/SparseCore"
 #include "gtest/gtest.h"
 #include "osqp_interface/osqp_interface.hpp"
 
@@ -88,4 +90,66 @@ TEST(TestOsqpInterface, BasicQp) {
     check_result(result);
   }
 }
+
+// Same problem as above with a proper constraint matrix, solved repeatedly in one workspace
+TEST(TestOsqpInterface, UpdateProblem) {
+  using autoware::common::osqp::INF;
+  auto check_primal =
+    [](const std::tuple<std::vector<float64_t>, std::vector<float64_t>, int, int> & result,
+      const float64_t x_0, const float64_t x_1) {
+      EXPECT_EQ(std::get<3>(result), 1);
+      ASSERT_EQ(std::get<0>(result).size(), size_t(2));
+      EXPECT_NEAR(std::get<0>(result)[0], x_0, 1e-6);
+      EXPECT_NEAR(std::get<0>(result)[1], x_1, 1e-6);
+    };
+
+  autoware::common::osqp::OSQPInterface osqp;
+  EXPECT_THROW(osqp.updateQ({1.0, 1.0}), std::runtime_error);
+
+  Eigen::MatrixXd P(2, 2);
+  P << 4, 1, 1, 2;
+  Eigen::MatrixXd A(3, 2);
+  A << 1, 1, 1, 0, 0, 1;
+  std::vector<float64_t> q = {1.0, 1.0};
+  std::vector<float64_t> l = {1.0, 0.0, 0.0};
+  std::vector<float64_t> u = {1.0, 0.7, 0.7};
+  check_primal(osqp.optimize(P, A, q, l, u), 0.3, 0.7);
+  // Same pattern: the workspace is updated in place and warm started
+  q = {1.0, 2.0};
+  check_primal(osqp.optimize(P, A, q, l, u), 0.5, 0.5);
+  EXPECT_EQ(osqp.getExitFlag(), 0);
+  // Changed pattern: a new workspace is set up
+  P << 4, 0, 0, 2;
+  q = {1.0, 1.0};
+  check_primal(osqp.optimize(P, A, q, l, u), 1.0 / 3.0, 2.0 / 3.0);
+  EXPECT_EQ(osqp.getExitFlag(), 0);
+
+  EXPECT_THROW(osqp.updateQ({1.0}), std::invalid_argument);
+  EXPECT_THROW(osqp.updateBounds({1.0, 0.0}, {1.0, 0.7}), std::invalid_argument);
+  EXPECT_THROW(osqp.setWarmStart({0.0, 0.0}, {0.0}), std::invalid_argument);
+
+  // Sparse input keeps explicitly stored zeros in the pattern
+  Eigen::SparseMatrix<float64_t> P_sparse(2, 2);
+  P_sparse.insert(0, 0) = 4.0;
+  P_sparse.insert(0, 1) = 1.0;
+  P_sparse.insert(1, 1) = 2.0;
+  Eigen::SparseMatrix<float64_t> A_sparse = A.sparseView();
+  check_primal(osqp.optimize(P_sparse, A_sparse, q, l, u), 0.3, 0.7);
+  P_sparse.coeffRef(0, 1) = 0.0;
+  ASSERT_EQ(P_sparse.nonZeros(), 3);
+  check_primal(osqp.optimize(P_sparse, A_sparse, q, l, u), 1.0 / 3.0, 2.0 / 3.0);
+
+  // Bounds and linear cost can be updated separately
+  EXPECT_EQ(osqp.updateBounds(l, {1.0, 0.9, 0.2}), 0);
+  check_primal(osqp.optimize(), 0.8, 0.2);
+  EXPECT_EQ(osqp.setWarmStart({0.8, 0.2}, {0.0, 0.0, 0.0}), 0);
+  EXPECT_EQ(osqp.updateQ({2.0, 1.0}), 0);
+  check_primal(osqp.optimize(), 0.8, 0.2);
+
+  // A problem which is not solved does not prevent solving the next one in the same workspace
+  EXPECT_EQ(osqp.updateBounds(l, {1.0, 0.4, 0.4}), 0);
+  EXPECT_NE(std::get<3>(osqp.optimize()), 1);
+  check_primal(osqp.optimize(P_sparse, A_sparse, q, l, u), 1.0 / 3.0, 2.0 / 3.0);
+  EXPECT_EQ(osqp.getExitFlag(), 0);
+}
 }  // namespace
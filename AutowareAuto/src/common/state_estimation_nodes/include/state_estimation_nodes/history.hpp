@@ -27,11 +27,14 @@
 
 #include <Eigen/Cholesky>
 #include <Eigen/Core>
+#include <Eigen/StdVector>
 
+#include <algorithm>
 #include <chrono>
-#include <map>
 #include <memory>
+#include <stdexcept>
 #include <utility>
+#include <vector>
 
 namespace autoware
 {
@@ -91,11 +94,13 @@ struct ResetEvent
 ///
 /// @brief      This class encapsulates a history of events used with EKF.
 ///
-///             The class handles adding events to a history of a specified size. It models the
-///             behavior of a circular buffer, meaning that as new events come in, the oldest ones
-///             are removed. The events can be either measurement types or specific events like
-///             reset or prediction. Whenever an event is added to the middle of the history all the
-///             following events get rolled on top of this event to produce a new state.
+///             The class handles adding events to a history of a specified size. It is stored in a
+///             circular buffer sorted by time, meaning that as new events come in, the oldest ones
+///             are removed. The buffer is allocated once on construction, so adding events does not
+///             allocate unless the history size is unlimited. The events can be either measurement
+///             types or specific events like reset or prediction. Whenever an event is added to the
+///             middle of the history all the following events get rolled on top of this event to
+///             produce a new state.
 ///
 /// @tparam     FilterT       Type of EKF filter used.
 /// @tparam     kNumOfStates  Dimensionality of the state in the filter.
@@ -116,15 +121,24 @@ class History
 
   /// Typedef for timestamps.
   using Timestamp = std::chrono::system_clock::time_point;
-  /// Typedef for history map type.
-  using HistoryMap = std::multimap<Timestamp, HistoryEntry>;
+  ///
+  /// @brief      A history entry together with its timestamp.
+  ///
+  struct TimestampedEntry
+  {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    Timestamp timestamp;
+    HistoryEntry entry;
+  };
+  /// Typedef for the storage of the circular buffer.
+  using Buffer = std::vector<TimestampedEntry, Eigen::aligned_allocator<TimestampedEntry>>;
 
 public:
   ///
   /// @brief      Construct history from a filter pointer with a specific size.
   ///
   /// @param      filter                 The filter pointer to be used internally.
-  /// @param[in]  max_history_size       The maximum history size.
+  /// @param[in]  max_history_size       The maximum history size, 0 for an unlimited size.
   /// @param[in]  mahalanobis_threshold  The mahalanobis threshold
   ///
   explicit History(
@@ -133,7 +147,11 @@ public:
     const common::types::float32_t mahalanobis_threshold)
   : m_filter{filter},
     m_max_history_size{max_history_size},
-    m_mahalanobis_threshold{mahalanobis_threshold} {}
+    m_capacity{max_history_size},
+    m_mahalanobis_threshold{mahalanobis_threshold}
+  {
+    m_buffer.reserve(m_capacity);
+  }
 
   ///
   /// @brief      Add an event to history. If it is added to the middle the following ones are
@@ -144,13 +162,13 @@ public:
   ///
   void emplace_event(const Timestamp & timestamp, const HistoryEntry & entry);
   /// @brief      Check if the history is empty.
-  inline bool empty() const noexcept {return m_history.empty();}
+  inline bool empty() const noexcept {return 0U == m_size;}
   /// @brief      Get size of history.
-  inline std::size_t size() const noexcept {return m_history.size();}
+  inline std::size_t size() const noexcept {return m_size;}
   /// @brief      Get last timestamp in history.
-  inline const Timestamp & get_last_timestamp() const noexcept {return m_history.rbegin()->first;}
+  inline const Timestamp & get_last_timestamp() const noexcept {return at(m_size - 1U).timestamp;}
   /// @brief      Get last event in history.
-  inline const HistoryEntry & get_last_event() const noexcept {return m_history.rbegin()->second;}
+  inline const HistoryEntry & get_last_event() const noexcept {return at(m_size - 1U).entry;}
   /// @brief      Get the filter as a const ref.
   const FilterT & get_filter() const noexcept {return m_filter;}
   /// @brief      Get the filter.
@@ -162,21 +180,48 @@ private:
   ///
   inline void drop_oldest_event_if_needed()
   {
-    if ((m_history.size() >= m_max_history_size) && (m_max_history_size > 0U)) {
-      (void) m_history.erase(m_history.begin());
+    if ((m_size >= m_max_history_size) && (m_max_history_size > 0U)) {
+      m_first = ((m_first + 1U) == m_capacity) ? 0U : (m_first + 1U);
+      --m_size;
     }
   }
 
+  /// @brief      Get the entry at the given position in time order, 0 being the oldest one.
+  inline TimestampedEntry & at(const std::size_t position) noexcept
+  {
+    const auto index = m_first + position;
+    return m_buffer[(index < m_capacity) ? index : (index - m_capacity)];
+  }
+  /// @brief      Get the entry at the given position in time order, 0 being the oldest one.
+  inline const TimestampedEntry & at(const std::size_t position) const noexcept
+  {
+    const auto index = m_first + position;
+    return m_buffer[(index < m_capacity) ? index : (index - m_capacity)];
+  }
+
+  ///
+  /// @brief      Find the position after all the events which are not later than the timestamp.
+  ///
+  std::size_t upper_bound(const Timestamp & timestamp) const noexcept;
+
+  ///
+  /// @brief      Insert an entry at the given position, moving the later entries back by one.
+  ///
+  void insert(const std::size_t position, const Timestamp & timestamp, const HistoryEntry & entry);
+
   ///
   /// @brief      Update all the following events as their state is based on the current one.
   ///
-  /// @param[in]  start_iter  The current iterator with the new state.
+  /// @param[in]  start_position  The position of the entry with the new state.
   ///
-  void update_impacted_events(const typename HistoryMap::iterator & start_iter);
+  void update_impacted_events(const std::size_t start_position);
 
-  HistoryMap m_history{};  ///< history of events.
+  Buffer m_buffer{};  ///< circular buffer of events, sorted by time starting at m_first.
+  std::size_t m_first{0U};  ///< Index of the oldest event in the buffer.
+  std::size_t m_size{0U};  ///< Number of events in history.
   FilterT & m_filter{};  ///< pointer to the filter implementation.
   std::size_t m_max_history_size{};  ///< Maximum number of events in history.
+  std::size_t m_capacity{};  ///< Number of entries the buffer can hold without a reallocation.
   common::types::float32_t m_mahalanobis_threshold{};  ///< Mahalanobis distance threshold.
 };
 
@@ -279,40 +324,87 @@ void History<FilterT, EventT...>::emplace_event(
   const Timestamp & timestamp, const HistoryEntry & entry)
 {
   drop_oldest_event_if_needed();
-  const auto iterator_to_inserted_position = m_history.emplace(timestamp, entry);
-  update_impacted_events(iterator_to_inserted_position);
+  // Events with the same timestamp are kept in the order in which they were added
+  const auto position = upper_bound(timestamp);
+  if ((0U == position) && !mpark::holds_alternative<ResetEvent<FilterT>>(entry.event())) {
+    throw std::runtime_error(
+            "Non-reset event inserted to the beginning of history. This might "
+            "happen if a very old event is inserted into the queue. Consider "
+            "increasing the queue size or debug program latencies.");
+  }
+  insert(position, timestamp, entry);
+  update_impacted_events(position);
 }
 
 template<typename FilterT, typename ... EventT>
-void History<FilterT, EventT...>::update_impacted_events(
-  const typename HistoryMap::iterator & start_iter)
+std::size_t History<FilterT, EventT...>::upper_bound(const Timestamp & timestamp) const noexcept
 {
-  Timestamp previous_timestamp{};
-  if (start_iter == m_history.begin()) {
-    if (!mpark::holds_alternative<ResetEvent<FilterT>>(start_iter->second.event())) {
-      (void) m_history.erase(start_iter);
-      throw std::runtime_error(
-              "Non-reset event inserted to the beginning of history. This might "
-              "happen if a very old event is inserted into the queue. Consider "
-              "increasing the queue size or debug program latencies.");
+  // Most events arrive in order, so check the end of the history first
+  if ((0U == m_size) || !(timestamp < at(m_size - 1U).timestamp)) {
+    return m_size;
+  }
+  std::size_t first = 0U;
+  std::size_t count = m_size - 1U;
+  while (count > 0U) {
+    const auto step = count / 2U;
+    if (timestamp < at(first + step).timestamp) {
+      count = step;
+    } else {
+      first += step + 1U;
+      count -= step + 1U;
     }
-  } else {
-    const auto prev_iter = std::prev(start_iter);
-    previous_timestamp = prev_iter->first;
-    const auto & prev_entry = prev_iter->second;
+  }
+  return first;
+}
+
+template<typename FilterT, typename ... EventT>
+void History<FilterT, EventT...>::insert(
+  const std::size_t position, const Timestamp & timestamp, const HistoryEntry & entry)
+{
+  if (m_size == m_capacity) {
+    // Only reached if the history size is unlimited, reallocate in time order
+    Buffer buffer{};
+    buffer.reserve(std::max<std::size_t>(2U * m_capacity, 16U));
+    for (std::size_t idx = 0U; idx < m_size; ++idx) {
+      buffer.push_back(std::move(at(idx)));
+    }
+    m_buffer.swap(buffer);
+    m_capacity = m_buffer.capacity();
+    m_first = 0U;
+  }
+  ++m_size;
+  if (m_buffer.size() < m_capacity) {
+    // The buffer is not full yet, so the oldest event is at index 0 and the new slot at the end
+    m_buffer.push_back(TimestampedEntry{timestamp, entry});
+    if (position == (m_size - 1U)) {
+      return;
+    }
+  }
+  for (std::size_t idx = m_size - 1U; idx > position; --idx) {
+    at(idx) = std::move(at(idx - 1U));
+  }
+  at(position) = TimestampedEntry{timestamp, entry};
+}
+
+template<typename FilterT, typename ... EventT>
+void History<FilterT, EventT...>::update_impacted_events(const std::size_t start_position)
+{
+  Timestamp previous_timestamp{};
+  if (start_position > 0U) {
+    const auto & prev = at(start_position - 1U);
+    previous_timestamp = prev.timestamp;
     m_filter.reset(
-      typename FilterT::State{prev_entry.stored_state()},
-      prev_entry.stored_covariance());
+      typename FilterT::State{prev.entry.stored_state()},
+      prev.entry.stored_covariance());
   }
-  for (auto iter = start_iter; iter != m_history.end(); ++iter) {
-    const auto current_timestamp = iter->first;
-    auto & entry = iter->second;
+  for (auto position = start_position; position < m_size; ++position) {
+    auto & current = at(position);
     mpark::visit(
-      EkfStateUpdater{m_filter, m_mahalanobis_threshold, current_timestamp - previous_timestamp},
-      entry.event());
-    entry.update_stored_state(m_filter.state());
-    entry.update_stored_covariance(m_filter.covariance());
-    previous_timestamp = iter->first;
+      EkfStateUpdater{m_filter, m_mahalanobis_threshold, current.timestamp - previous_timestamp},
+      current.entry.event());
+    current.entry.update_stored_state(m_filter.state());
+    current.entry.update_stored_covariance(m_filter.covariance());
+    previous_timestamp = current.timestamp;
   }
 }
 
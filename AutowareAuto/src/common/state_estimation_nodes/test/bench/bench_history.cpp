@@ -0,0 +1,91 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <common/types.hpp>
+#include <measurement_conversion/measurement_typedefs.hpp>
+#include <state_estimation_nodes/filter_typedefs.hpp>
+#include <state_estimation_nodes/history.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+namespace
+{
+
+using autoware::common::state_estimation::ConstAccelerationKalmanFilterXYZRPY;
+using autoware::common::state_estimation::History;
+using autoware::common::state_estimation::PoseMeasurementXYZRPY32;
+using autoware::common::state_estimation::PredictionEvent;
+using autoware::common::state_estimation::ResetEvent;
+using autoware::common::types::float32_t;
+
+using FilterT = ConstAccelerationKalmanFilterXYZRPY;
+using HistoryT = History<FilterT, PredictionEvent, ResetEvent<FilterT>, PoseMeasurementXYZRPY32>;
+
+// 5 s of history at the 100 Hz prediction rate, like the default of the state estimation node
+constexpr std::size_t kHistorySize = 500U;
+constexpr std::chrono::milliseconds kPredictionPeriod{10};
+// Delayed poses, e.g. from NDT or GNSS, are this much older than the latest prediction
+constexpr std::chrono::milliseconds kMinDelay{50};
+constexpr std::chrono::milliseconds kMaxDelay{150};
+
+FilterT make_filter()
+{
+  using State = FilterT::State;
+  return FilterT{
+    FilterT::MotionModel{},
+    FilterT::NoiseModel{{1.0F, 1.0F, 1.0F, 1.0F, 1.0F, 1.0F}},
+    State{},
+    State::Matrix::Identity()};
+}
+
+}  // namespace
+
+// Adds predictions at 100 Hz and every 100 ms a burst of state.range(0) delayed poses, each of
+// which replays the history after it
+static void BenchHistoryDelayedPoses(benchmark::State & state)
+{
+  const auto burst_size = static_cast<std::int64_t>(state.range(0));
+  auto filter = make_filter();
+  HistoryT history{filter, kHistorySize, std::numeric_limits<float32_t>::max()};
+  std::chrono::system_clock::time_point timestamp{};
+  history.emplace_event(
+    timestamp,
+    ResetEvent<FilterT>{FilterT::State{}, FilterT::State::Matrix::Identity()});
+  for (std::size_t idx = 1U; idx < kHistorySize; ++idx) {
+    timestamp += kPredictionPeriod;
+    history.emplace_event(timestamp, PredictionEvent{});
+  }
+  const PoseMeasurementXYZRPY32 pose{
+    PoseMeasurementXYZRPY32::State::Vector::Ones(),
+    PoseMeasurementXYZRPY32::State::Matrix::Identity()};
+  const auto delay_step = (kMaxDelay - kMinDelay) / std::max<std::int64_t>(burst_size, 1);
+
+  for (auto _ : state) {
+    for (std::int32_t idx = 0; idx < 10; ++idx) {
+      timestamp += kPredictionPeriod;
+      history.emplace_event(timestamp, PredictionEvent{});
+    }
+    for (std::int64_t idx = 0; idx < burst_size; ++idx) {
+      history.emplace_event(timestamp - kMaxDelay + (idx * delay_step), pose);
+    }
+    benchmark::DoNotOptimize(history.get_last_event());
+  }
+  state.SetItemsProcessed(state.iterations() * (10 + burst_size));
+}
+
+BENCHMARK(BenchHistoryDelayedPoses)->Arg(1)->Arg(4)->Arg(16);
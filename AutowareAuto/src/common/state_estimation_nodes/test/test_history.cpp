@@ -216,3 +216,75 @@ TEST(HistoryTest, ExhaustHistory) {
   }
   ASSERT_EQ(history_size, history.size());
 }
+
+/// @test Test that events are inserted in time order after the history wrapped around.
+TEST(HistoryTest, InsertOutOfOrderAfterWrapAround) {
+  using HistoryT = History<MockFilter, PredictionEvent, ResetEvent<MockFilter>, Measurement>;
+
+  const auto history_size = 4U;
+  const std::chrono::system_clock::time_point timestamp{std::chrono::system_clock::now()};
+  const std::chrono::system_clock::duration dt{std::chrono::milliseconds{10}};
+  const FilterState state{FilterState::Vector{23.0F}};
+  const FilterState::Matrix covariance{23.0F * FilterState::Matrix::Identity()};
+  auto filter = std::make_unique<MockFilter>();
+  HistoryT history{*filter, history_size, 100};
+  EXPECT_CALL(history.get_filter(), reset(_, _)).Times(::testing::AnyNumber());
+  EXPECT_CALL(history.get_filter(), state()).WillRepeatedly(Return(state));
+  EXPECT_CALL(history.get_filter(), covariance()).WillRepeatedly(Return(covariance));
+  EXPECT_CALL(history.get_filter(), predict(_)).Times(::testing::AnyNumber());
+  EXPECT_CALL(history.get_filter(), correct(_)).Times(::testing::AnyNumber());
+
+  // The history holds the events at 3 * dt to 6 * dt afterwards.
+  history.emplace_event(timestamp, ResetEvent<MockFilter>{state, covariance});
+  for (std::int32_t i = 1; i <= 6; ++i) {
+    history.emplace_event(timestamp + i * dt, Measurement{state.vector(), covariance});
+  }
+  ASSERT_EQ(history_size, history.size());
+  ::testing::Mock::VerifyAndClearExpectations(&history.get_filter());
+
+  // The event at 3 * dt is dropped and the event is inserted after the one at 4 * dt, so the
+  // filter is reset to the state at 4 * dt and the remaining events are replayed.
+  EXPECT_CALL(history.get_filter(), state()).WillRepeatedly(Return(state));
+  EXPECT_CALL(history.get_filter(), covariance()).WillRepeatedly(Return(covariance));
+  EXPECT_CALL(history.get_filter(), reset(state, covariance)).Times(1);
+  EXPECT_CALL(history.get_filter(), predict(dt / 2)).Times(2);
+  EXPECT_CALL(history.get_filter(), predict(dt)).Times(1);
+  EXPECT_CALL(history.get_filter(), correct(_)).Times(3);
+  history.emplace_event(timestamp + 4 * dt + dt / 2, Measurement{state.vector(), covariance});
+  EXPECT_EQ(history_size, history.size());
+  EXPECT_EQ(timestamp + 6 * dt, history.get_last_timestamp());
+  ::testing::Mock::VerifyAndClearExpectations(&history.get_filter());
+
+  // An event older than the whole history is rejected.
+  EXPECT_THROW(
+    history.emplace_event(timestamp + 3 * dt, Measurement{state.vector(), covariance}),
+    std::runtime_error);
+  EXPECT_EQ(timestamp + 6 * dt, history.get_last_timestamp());
+}
+
+/// @test Test that a history of unlimited size keeps all events.
+TEST(HistoryTest, UnlimitedSize) {
+  using HistoryT = History<MockFilter, PredictionEvent, ResetEvent<MockFilter>, Measurement>;
+
+  const std::int32_t number_of_measurements = 100;
+  const std::chrono::system_clock::time_point timestamp{std::chrono::system_clock::now()};
+  const std::chrono::system_clock::duration dt{std::chrono::milliseconds{10}};
+  const FilterState state{FilterState::Vector{23.0F}};
+  const FilterState::Matrix covariance{23.0F * FilterState::Matrix::Identity()};
+  auto filter = std::make_unique<MockFilter>();
+  HistoryT history{*filter, 0U, 100};
+  EXPECT_CALL(history.get_filter(), reset(_, _)).Times(::testing::AnyNumber());
+  EXPECT_CALL(history.get_filter(), state()).WillRepeatedly(Return(state));
+  EXPECT_CALL(history.get_filter(), covariance()).WillRepeatedly(Return(covariance));
+  EXPECT_CALL(history.get_filter(), predict(_)).Times(::testing::AnyNumber());
+  EXPECT_CALL(history.get_filter(), correct(_)).Times(::testing::AnyNumber());
+
+  history.emplace_event(timestamp, ResetEvent<MockFilter>{state, covariance});
+  // Every other measurement arrives late
+  for (std::int32_t i = 1; i <= number_of_measurements; i += 2) {
+    history.emplace_event(timestamp + (i + 1) * dt, Measurement{state.vector(), covariance});
+    history.emplace_event(timestamp + i * dt, Measurement{state.vector(), covariance});
+  }
+  EXPECT_EQ(static_cast<std::size_t>(number_of_measurements + 1), history.size());
+  EXPECT_EQ(timestamp + number_of_measurements * dt, history.get_last_timestamp());
+}
@@ -129,19 +129,89 @@ struct MPCData
 };
 /**
  * Matrices used for MPC optimization
+ *
+ * The prediction model is kept per step instead of as the dense prediction matrices
+ * Xex = Aex * x0 + Bex * Uex + Wex, so that the memory and the construction of the QP only grow
+ * quadratically with the prediction horizon:
+ * x(i) = Ad[i] * x(i - 1) + Bd[i] * u(i) + Wd[i], y(i) = Cd[i] * x(i), with x(-1) = x0.
  */
 struct MPCMatrix
 {
-  Eigen::MatrixXd Aex;
-  Eigen::MatrixXd Bex;
-  Eigen::MatrixXd Wex;
-  Eigen::MatrixXd Cex;
-  Eigen::MatrixXd Qex;
+  //!< @brief discrete state matrix of each step
+  std::vector<Eigen::MatrixXd> Ad;
+  //!< @brief discrete input matrix of each step
+  std::vector<Eigen::MatrixXd> Bd;
+  //!< @brief discrete disturbance vector of each step
+  std::vector<Eigen::MatrixXd> Wd;
+  //!< @brief discrete output matrix of each step
+  std::vector<Eigen::MatrixXd> Cd;
+  //!< @brief output weight of each step, i.e. the diagonal blocks of Qex
+  std::vector<Eigen::MatrixXd> Qd;
   Eigen::MatrixXd R1ex;
   Eigen::MatrixXd R2ex;
   Eigen::MatrixXd Urefex;
-  Eigen::MatrixXd Yrefex;
+  //!< @brief reference input of a single step, as calculated by the vehicle model
+  Eigen::MatrixXd Uref;
 };
+/**
+ * Buffers of the QP built from the MPC matrices, reused across control cycles
+ */
+struct MPCQPBuffer
+{
+  //!< @brief hessian of the QP
+  Eigen::MatrixXd H;
+  //!< @brief gradient of the QP as a row vector
+  Eigen::MatrixXd f;
+  //!< @brief gradient of the QP as a column vector, as passed to the solver
+  Eigen::MatrixXd f_vec;
+  //!< @brief constraint matrix of the QP
+  Eigen::MatrixXd A;
+  //!< @brief lower bound of the input
+  Eigen::VectorXd lb;
+  //!< @brief upper bound of the input
+  Eigen::VectorXd ub;
+  //!< @brief lower bound of the constraints
+  Eigen::VectorXd lbA;
+  //!< @brief upper bound of the constraints
+  Eigen::VectorXd ubA;
+  //!< @brief predicted state without input, i.e. Aex * x0 + Wex
+  Eigen::VectorXd Xfree;
+  //!< @brief output weight propagated backwards: S(k) = C'QC(k) + Ad(k+1)' * S(k+1) * Ad(k+1)
+  Eigen::MatrixXd S;
+  //!< @brief weighted free state propagated backwards: g(k) = C'QC(k) * Xfree(k) + Ad(k+1)'g(k+1)
+  Eigen::VectorXd g;
+  //!< @brief output weight of the current step C' * Q * C
+  Eigen::MatrixXd CQC;
+  //!< @brief temporary output x state matrix
+  Eigen::MatrixXd tmp_yx;
+  //!< @brief S(k) * Bd(k) propagated backwards to the previous inputs
+  Eigen::MatrixXd SB;
+  //!< @brief temporary state x state matrix
+  Eigen::MatrixXd tmp_xx;
+  //!< @brief temporary state x input matrix
+  Eigen::MatrixXd tmp_xu;
+  //!< @brief temporary state vector
+  Eigen::VectorXd tmp_x;
+};
+/**
+ * @brief predict the state over the horizon: Xex = Aex * x0 + Bex * Uex + Wex
+ * @param [in] mpc_matrix parameters matrix to use for prediction
+ * @param [in] x0 initial state vector
+ * @param [in] Uex input vector, the input is ignored if it is null
+ * @param [out] Xex predicted state vector
+ */
+TRAJECTORY_FOLLOWER_PUBLIC void predictState(
+  const MPCMatrix & mpc_matrix, const Eigen::VectorXd & x0, const Eigen::VectorXd * Uex,
+  Eigen::VectorXd * Xex);
+/**
+ * @brief build the output cost of the condensed QP without the dense prediction matrices:
+ *        H = Bex' * Cex' * Qex * Cex * Bex and f = (Cex * (Aex * x0 + Wex))' * Qex * Cex * Bex
+ * @param [in] mpc_matrix parameters matrix to use for optimization
+ * @param [in] x0 initial state vector
+ * @param [inout] qp_buffer buffers of the QP, H and f are set and the others are used as scratch
+ */
+TRAJECTORY_FOLLOWER_PUBLIC void calculateOutputCost(
+  const MPCMatrix & mpc_matrix, const Eigen::VectorXd & x0, MPCQPBuffer * qp_buffer);
 /**
  * MPC-based waypoints follower class
  * @brief calculate control command to follow reference waypoints
@@ -181,6 +251,14 @@ private:
   float64_t m_sign_vx = 0.0;
   //!< @brief buffer of sent command
   std::vector<autoware_auto_msgs::msg::AckermannLateralCommand> m_ctrl_cmd_vec;
+  //!< @brief MPC matrices, reused across cycles to avoid reallocations
+  MPCMatrix m_mpc_matrix;
+  //!< @brief QP buffers, reused across cycles to avoid reallocations
+  MPCQPBuffer m_qp_buffer;
+  //!< @brief optimized input
+  Eigen::VectorXd m_Uex;
+  //!< @brief predicted state for the optimized input
+  Eigen::VectorXd m_Xex;
 
   /**
    * @brief get variables for mpc calculation
@@ -221,10 +299,12 @@ private:
   /**
    * @brief generate MPC matrix with trajectory and vehicle model
    * @param [in] reference_trajectory used for linearization around reference trajectory
+   * @param [out] mpc_matrix generated matrices, only reallocated when their size changes
    */
-  MPCMatrix generateMPCMatrix(const trajectory_follower::MPCTrajectory & reference_trajectory);
+  void generateMPCMatrix(
+    const trajectory_follower::MPCTrajectory & reference_trajectory, MPCMatrix * mpc_matrix);
   /**
-   * @brief generate MPC matrix with trajectory and vehicle model
+   * @brief build the QP from the MPC matrices and solve it
    * @param [in] mpc_matrix parameters matrix to use for optimization
    * @param [in] x0 initial state vector
    * @param [out] Uex optimized input vector
@@ -80,7 +80,7 @@ TRAJECTORY_FOLLOWER_PUBLIC bool8_t convertToMPCTrajectory(
 /**
  * @brief convert the given MPCTrajectory to a Trajectory msg
  * @param [in] input MPCTrajectory to convert
- * @param [out] output resulting Trajectory msg
+ * @param [out] output resulting Trajectory msg, truncated to its capacity
  * @return true if the conversion was successful
  */
 TRAJECTORY_FOLLOWER_PUBLIC bool8_t convertToAutowareTrajectory(
@@ -76,11 +76,11 @@ bool8_t MPC::calculateMPC(
   }
 
   /* generate mpc matrix : predict equation Xec = Aex * x0 + Bex * Uex + Wex */
-  MPCMatrix mpc_matrix = generateMPCMatrix(mpc_resampled_ref_traj);
+  generateMPCMatrix(mpc_resampled_ref_traj, &m_mpc_matrix);
 
   /* solve quadratic optimization */
-  Eigen::VectorXd Uex;
-  if (!executeOptimization(mpc_matrix, x0, &Uex)) {
+  const Eigen::VectorXd & Uex = m_Uex;
+  if (!executeOptimization(m_mpc_matrix, x0, &m_Uex)) {
     RCLCPP_WARN_THROTTLE(m_logger, *m_clock, 1000 /*ms*/, "optimization failed.");
     return false;
   }
@@ -105,7 +105,8 @@ bool8_t MPC::calculateMPC(
   m_raw_steer_cmd_prev = Uex(0);
 
   /* calculate predicted trajectory */
-  Eigen::VectorXd Xex = mpc_matrix.Aex * x0 + mpc_matrix.Bex * Uex + mpc_matrix.Wex;
+  predictState(m_mpc_matrix, x0, &Uex, &m_Xex);
+  const Eigen::VectorXd & Xex = m_Xex;
   trajectory_follower::MPCTrajectory mpc_predicted_traj;
   const auto & traj = mpc_resampled_ref_traj;
   for (size_t i = 0; i < static_cast<size_t>(m_param.prediction_horizon); ++i) {
@@ -140,7 +141,7 @@ bool8_t MPC::calculateMPC(
   // [1] mpc calculation result
   append_diag_data(Uex(0));
   // [2] feedforward steering value
-  append_diag_data(mpc_matrix.Urefex(0));
+  append_diag_data(m_mpc_matrix.Urefex(0));
   // [3] feedforward steering value raw
   append_diag_data(std::atan(nearest_smooth_k * wb));
   // [4] current steering angle
@@ -515,102 +516,77 @@ trajectory_follower::MPCTrajectory MPC::applyVelocityDynamicsFilter(
  * predict equation: Xec = Aex * x0 + Bex * Uex + Wex
  * cost function: J = Xex' * Qex * Xex + (Uex - Uref)' * R1ex * (Uex - Urefex) + Uex' * R2ex * Uex
  * Qex = diag([Q,Q,...]), R1ex = diag([R,R,...])
+ *
+ * The prediction matrices are not built explicitly, only the discrete model of each step:
+ * Aex = [Ad0; Ad1*Ad0; ...], Bex(i, j) = Ad(i)*...*Ad(j+1)*Bd(j), Wex = [Wd0; Ad1*Wd0 + Wd1; ...]
  */
-MPCMatrix MPC::generateMPCMatrix(
-  const trajectory_follower::MPCTrajectory & reference_trajectory)
+void MPC::generateMPCMatrix(
+  const trajectory_follower::MPCTrajectory & reference_trajectory, MPCMatrix * mpc_matrix)
 {
-  using Eigen::MatrixXd;
-
   const int64_t N = m_param.prediction_horizon;
   const float64_t DT = m_param.prediction_dt;
   const int64_t DIM_X = m_vehicle_model_ptr->getDimX();
   const int64_t DIM_U = m_vehicle_model_ptr->getDimU();
   const int64_t DIM_Y = m_vehicle_model_ptr->getDimY();
 
-  MPCMatrix m;
-  m.Aex = MatrixXd::Zero(DIM_X * N, DIM_X);
-  m.Bex = MatrixXd::Zero(DIM_X * N, DIM_U * N);
-  m.Wex = MatrixXd::Zero(DIM_X * N, 1);
-  m.Cex = MatrixXd::Zero(DIM_Y * N, DIM_X * N);
-  m.Qex = MatrixXd::Zero(DIM_Y * N, DIM_Y * N);
-  m.R1ex = MatrixXd::Zero(DIM_U * N, DIM_U * N);
-  m.R2ex = MatrixXd::Zero(DIM_U * N, DIM_U * N);
-  m.Urefex = MatrixXd::Zero(DIM_U * N, 1);
-
-  /* weight matrix depends on the vehicle model */
-  MatrixXd Q = MatrixXd::Zero(DIM_Y, DIM_Y);
-  MatrixXd R = MatrixXd::Zero(DIM_U, DIM_U);
-  MatrixXd Q_adaptive = MatrixXd::Zero(DIM_Y, DIM_Y);
-  MatrixXd R_adaptive = MatrixXd::Zero(DIM_U, DIM_U);
-
-  MatrixXd Ad(DIM_X, DIM_X);
-  MatrixXd Bd(DIM_X, DIM_U);
-  MatrixXd Wd(DIM_X, 1);
-  MatrixXd Cd(DIM_Y, DIM_X);
-  MatrixXd Uref(DIM_U, 1);
+  // the matrices are only reallocated when the horizon or the vehicle model changes
+  auto & m = *mpc_matrix;
+  const auto resize = [N](
+    std::vector<Eigen::MatrixXd> & v, const int64_t rows, const int64_t cols) {
+      v.resize(static_cast<size_t>(N));
+      for (auto & mat : v) {
+        mat.resize(rows, cols);
+      }
+    };
+  resize(m.Ad, DIM_X, DIM_X);
+  resize(m.Bd, DIM_X, DIM_U);
+  resize(m.Wd, DIM_X, 1);
+  resize(m.Cd, DIM_Y, DIM_X);
+  resize(m.Qd, DIM_Y, DIM_Y);
+  m.R1ex.setZero(DIM_U * N, DIM_U * N);
+  m.R2ex.setZero(DIM_U * N, DIM_U * N);
+  m.Urefex.setZero(DIM_U * N, 1);
+  m.Uref.resize(DIM_U, 1);
 
   constexpr float64_t ep = 1.0e-3;  // large enough to ignore velocity noise
 
   /* predict dynamics for N times */
   for (int64_t i = 0; i < N; ++i) {
-    const float64_t ref_vx = reference_trajectory.vx[static_cast<size_t>(i)];
+    const auto idx = static_cast<size_t>(i);
+    const float64_t ref_vx = reference_trajectory.vx[idx];
     const float64_t ref_vx_squared = ref_vx * ref_vx;
 
     // curvature will be 0 when vehicle stops
-    const float64_t ref_k = reference_trajectory.k[static_cast<size_t>(i)] * m_sign_vx;
-    const float64_t ref_smooth_k = reference_trajectory.smooth_k[static_cast<size_t>(i)] *
-      m_sign_vx;
+    const float64_t ref_k = reference_trajectory.k[idx] * m_sign_vx;
+    const float64_t ref_smooth_k = reference_trajectory.smooth_k[idx] * m_sign_vx;
 
     /* get discrete state matrix A, B, C, W */
     m_vehicle_model_ptr->setVelocity(ref_vx);
     m_vehicle_model_ptr->setCurvature(ref_k);
-    m_vehicle_model_ptr->calculateDiscreteMatrix(Ad, Bd, Cd, Wd, DT);
+    m_vehicle_model_ptr->calculateDiscreteMatrix(m.Ad[idx], m.Bd[idx], m.Cd[idx], m.Wd[idx], DT);
 
-    Q = Eigen::MatrixXd::Zero(DIM_Y, DIM_Y);
-    R = Eigen::MatrixXd::Zero(DIM_U, DIM_U);
-    Q(0, 0) = getWeightLatError(ref_k);
-    Q(1, 1) = getWeightHeadingError(ref_k);
-    R(0, 0) = getWeightSteerInput(ref_k);
-
-    Q_adaptive = Q;
-    R_adaptive = R;
+    /* weight matrix depends on the vehicle model */
+    auto & Q = m.Qd[idx];
+    Q.setZero();
     if (i == N - 1) {
-      Q_adaptive(0, 0) = m_param.weight_terminal_lat_error;
-      Q_adaptive(1, 1) = m_param.weight_terminal_heading_error;
-    }
-    Q_adaptive(1, 1) += ref_vx_squared * getWeightHeadingErrorSqVel(ref_k);
-    R_adaptive(0, 0) += ref_vx_squared * getWeightSteerInputSqVel(ref_k);
-
-    /* update mpc matrix */
-    int64_t idx_x_i = i * DIM_X;
-    int64_t idx_x_i_prev = (i - 1) * DIM_X;
-    int64_t idx_u_i = i * DIM_U;
-    int64_t idx_y_i = i * DIM_Y;
-    if (i == 0) {
-      m.Aex.block(0, 0, DIM_X, DIM_X) = Ad;
-      m.Bex.block(0, 0, DIM_X, DIM_U) = Bd;
-      m.Wex.block(0, 0, DIM_X, 1) = Wd;
+      Q(0, 0) = m_param.weight_terminal_lat_error;
+      Q(1, 1) = m_param.weight_terminal_heading_error;
     } else {
-      m.Aex.block(idx_x_i, 0, DIM_X, DIM_X) = Ad * m.Aex.block(idx_x_i_prev, 0, DIM_X, DIM_X);
-      for (int64_t j = 0; j < i; ++j) {
-        int64_t idx_u_j = j * DIM_U;
-        m.Bex.block(idx_x_i, idx_u_j, DIM_X, DIM_U) =
-          Ad * m.Bex.block(idx_x_i_prev, idx_u_j, DIM_X, DIM_U);
-      }
-      m.Wex.block(idx_x_i, 0, DIM_X, 1) = Ad * m.Wex.block(idx_x_i_prev, 0, DIM_X, 1) + Wd;
+      Q(0, 0) = getWeightLatError(ref_k);
+      Q(1, 1) = getWeightHeadingError(ref_k);
     }
-    m.Bex.block(idx_x_i, idx_u_i, DIM_X, DIM_U) = Bd;
-    m.Cex.block(idx_y_i, idx_x_i, DIM_Y, DIM_X) = Cd;
-    m.Qex.block(idx_y_i, idx_y_i, DIM_Y, DIM_Y) = Q_adaptive;
-    m.R1ex.block(idx_u_i, idx_u_i, DIM_U, DIM_U) = R_adaptive;
+    Q(1, 1) += ref_vx_squared * getWeightHeadingErrorSqVel(ref_k);
+    const int64_t idx_u_i = i * DIM_U;
+    m.R1ex(idx_u_i, idx_u_i) =
+      getWeightSteerInput(ref_k) + ref_vx_squared * getWeightSteerInputSqVel(ref_k);
 
     /* get reference input (feed-forward) */
     m_vehicle_model_ptr->setCurvature(ref_smooth_k);
-    m_vehicle_model_ptr->calculateReferenceInput(Uref);
-    if (std::fabs(Uref(0, 0)) < DEG2RAD * m_param.zero_ff_steer_deg) {
-      Uref(0, 0) = 0.0;  // ignore curvature noise
+    m_vehicle_model_ptr->calculateReferenceInput(m.Uref);
+    if (std::fabs(m.Uref(0, 0)) < DEG2RAD * m_param.zero_ff_steer_deg) {
+      m.Uref(0, 0) = 0.0;  // ignore curvature noise
     }
-    m.Urefex.block(i * DIM_U, 0, DIM_U, 1) = Uref;
+    m.Urefex.block(idx_u_i, 0, DIM_U, 1) = m.Uref;
   }
 
   /* add lateral jerk : weight for (v * {u(i) - u(i-1)} )^2 */
@@ -624,8 +600,6 @@ MPCMatrix MPC::generateMPCMatrix(
   }
 
   addSteerWeightR(&m.R1ex);
-
-  return m;
 }
 
 /*
@@ -653,9 +627,6 @@ MPCMatrix MPC::generateMPCMatrix(
 bool8_t MPC::executeOptimization(
   const MPCMatrix & m, const Eigen::VectorXd & x0, Eigen::VectorXd * Uex)
 {
-  using Eigen::MatrixXd;
-  using Eigen::VectorXd;
-
   if (!isValid(m)) {
     RCLCPP_WARN_SKIPFIRST_THROTTLE(
       m_logger, *m_clock, 1000 /*ms*/, "model matrix is invalid. stop MPC.");
@@ -665,30 +636,31 @@ bool8_t MPC::executeOptimization(
   const int64_t DIM_U_N = m_param.prediction_horizon * m_vehicle_model_ptr->getDimU();
 
   // cost function: 1/2 * Uex' * H * Uex + f' * Uex,  H = B' * C' * Q * C * B + R
-  const MatrixXd CB = m.Cex * m.Bex;
-  const MatrixXd QCB = m.Qex * CB;
-  // MatrixXd H = CB.transpose() * QCB + m.R1ex + m.R2ex; // This calculation is heavy. looking for a good way.  //NOLINT
-  MatrixXd H = MatrixXd::Zero(DIM_U_N, DIM_U_N);
-  H.triangularView<Eigen::Upper>() = CB.transpose() * QCB;
-  H.triangularView<Eigen::Upper>() += m.R1ex + m.R2ex;
-  H.triangularView<Eigen::Lower>() = H.transpose();
-  MatrixXd f = (m.Cex * (m.Aex * x0 + m.Wex)).transpose() * QCB - m.Urefex.transpose() * m.R1ex;
-  addSteerWeightF(&f);
-
-  MatrixXd A = MatrixXd::Identity(DIM_U_N, DIM_U_N);
-  for (int64_t i = 1; i < DIM_U_N; i++) {
-    A(i, i - 1) = -1.0;
-  }
-
-  VectorXd lb = VectorXd::Constant(DIM_U_N, -m_steer_lim);  // min steering angle
-  VectorXd ub = VectorXd::Constant(DIM_U_N, m_steer_lim);   // max steering angle
-  VectorXd lbA = VectorXd::Constant(DIM_U_N, -m_steer_rate_lim * m_param.prediction_dt);
-  VectorXd ubA = VectorXd::Constant(DIM_U_N, m_steer_rate_lim * m_param.prediction_dt);
-  lbA(0, 0) = m_raw_steer_cmd_prev - m_steer_rate_lim * m_ctrl_period;
-  ubA(0, 0) = m_raw_steer_cmd_prev + m_steer_rate_lim * m_ctrl_period;
+  auto & b = m_qp_buffer;
+  calculateOutputCost(m, x0, &b);
+  b.H.triangularView<Eigen::Upper>() += m.R1ex + m.R2ex;
+  b.H.triangularView<Eigen::Lower>() = b.H.transpose();
+  b.f.noalias() -= m.Urefex.transpose() * m.R1ex;
+  addSteerWeightF(&b.f);
+  b.f_vec = b.f.transpose();
+
+  if ((b.A.rows() != DIM_U_N) || (b.A.cols() != DIM_U_N)) {
+    b.A.setIdentity(DIM_U_N, DIM_U_N);
+    for (int64_t i = 1; i < DIM_U_N; i++) {
+      b.A(i, i - 1) = -1.0;
+    }
+  }
+
+  b.lb.setConstant(DIM_U_N, -m_steer_lim);  // min steering angle
+  b.ub.setConstant(DIM_U_N, m_steer_lim);   // max steering angle
+  b.lbA.setConstant(DIM_U_N, -m_steer_rate_lim * m_param.prediction_dt);
+  b.ubA.setConstant(DIM_U_N, m_steer_rate_lim * m_param.prediction_dt);
+  b.lbA(0, 0) = m_raw_steer_cmd_prev - m_steer_rate_lim * m_ctrl_period;
+  b.ubA(0, 0) = m_raw_steer_cmd_prev + m_steer_rate_lim * m_ctrl_period;
 
   auto t_start = std::chrono::system_clock::now();
-  bool8_t solve_result = m_qpsolver_ptr->solve(H, f.transpose(), A, lb, ub, lbA, ubA, *Uex);
+  bool8_t solve_result =
+    m_qpsolver_ptr->solve(b.H, b.f_vec, b.A, b.lb, b.ub, b.lbA, b.ubA, *Uex);
   auto t_end = std::chrono::system_clock::now();
   if (!solve_result) {
     RCLCPP_WARN_SKIPFIRST_THROTTLE(m_logger, *m_clock, 1000 /*ms*/, "qp solver error");
@@ -709,6 +681,93 @@ bool8_t MPC::executeOptimization(
   return true;
 }
 
+void predictState(
+  const MPCMatrix & m, const Eigen::VectorXd & x0, const Eigen::VectorXd * Uex,
+  Eigen::VectorXd * Xex)
+{
+  const int64_t N = static_cast<int64_t>(m.Ad.size());
+  const int64_t DIM_X = x0.size();
+  auto & X = *Xex;
+  X.resize(N * DIM_X);
+  for (int64_t i = 0; i < N; ++i) {
+    const auto idx = static_cast<size_t>(i);
+    auto x_i = X.segment(i * DIM_X, DIM_X);
+    if (i == 0) {
+      x_i.noalias() = m.Ad[idx] * x0;
+    } else {
+      x_i.noalias() = m.Ad[idx] * X.segment((i - 1) * DIM_X, DIM_X);
+    }
+    if (Uex != nullptr) {
+      const int64_t DIM_U = m.Bd[idx].cols();
+      x_i.noalias() += m.Bd[idx] * Uex->segment(i * DIM_U, DIM_U);
+    }
+    x_i += m.Wd[idx];
+  }
+}
+
+void calculateOutputCost(
+  const MPCMatrix & m, const Eigen::VectorXd & x0, MPCQPBuffer * qp_buffer)
+{
+  const int64_t N = static_cast<int64_t>(m.Ad.size());
+  const int64_t DIM_X = x0.size();
+  const int64_t DIM_U = (N > 0) ? m.Bd.front().cols() : 0;
+  const int64_t DIM_Y = (N > 0) ? m.Cd.front().rows() : 0;
+  const int64_t DIM_U_N = N * DIM_U;
+
+  // the buffers are only reallocated when the horizon or the vehicle model changes
+  auto & b = *qp_buffer;
+  b.H.resize(DIM_U_N, DIM_U_N);
+  b.f.resize(1, DIM_U_N);
+  b.f_vec.resize(DIM_U_N, 1);
+  b.S.resize(DIM_X, DIM_X);
+  b.g.resize(DIM_X);
+  b.CQC.resize(DIM_X, DIM_X);
+  b.tmp_yx.resize(DIM_Y, DIM_X);
+  b.SB.resize(DIM_X, DIM_U);
+  b.tmp_xx.resize(DIM_X, DIM_X);
+  b.tmp_xu.resize(DIM_X, DIM_U);
+  b.tmp_x.resize(DIM_X);
+  predictState(m, x0, nullptr, &b.Xfree);
+
+  // Bex is block lower triangular with Bex(i, j) = Phi(i, j) * Bd(j), where
+  // Phi(i, j) = Ad(i)*...*Ad(j+1), so the blocks of the upper triangle of B' * C' * Q * C * B are
+  //   H(j, k) = sum_{i >= k} Bex(i, j)' * C'QC(i) * Bex(i, k) = Bd(j)' * Phi(k, j)' * S(k) * Bd(k)
+  // with S(k) = sum_{i >= k} Phi(i, k)' * C'QC(i) * Phi(i, k), computed backwards like a Riccati
+  // recursion. Likewise f(k) = Bd(k)' * g(k) with the free state propagated backwards:
+  //   g(k) = sum_{i >= k} Phi(i, k)' * C'QC(i) * Xfree(i)
+  // This builds the QP in O(N^2) operations instead of the O(N^3) dense matrix products.
+  for (int64_t k = N - 1; k >= 0; --k) {
+    const auto idx = static_cast<size_t>(k);
+    b.tmp_yx.noalias() = m.Qd[idx] * m.Cd[idx];
+    b.CQC.noalias() = m.Cd[idx].transpose() * b.tmp_yx;
+    if (k == N - 1) {
+      b.S = b.CQC;
+      b.g.noalias() = b.CQC * b.Xfree.segment(k * DIM_X, DIM_X);
+    } else {
+      const auto & Ad_next = m.Ad[idx + 1];
+      b.tmp_xx.noalias() = b.S * Ad_next;
+      b.S.noalias() = Ad_next.transpose() * b.tmp_xx;
+      b.S += b.CQC;
+      b.tmp_x.noalias() = Ad_next.transpose() * b.g;
+      b.g = b.tmp_x;
+      b.g.noalias() += b.CQC * b.Xfree.segment(k * DIM_X, DIM_X);
+    }
+
+    // propagate S(k) * Bd(k) back to the previous inputs: Phi(k, j - 1)' = Ad(j)' * Phi(k, j)'
+    b.SB.noalias() = b.S * m.Bd[idx];
+    for (int64_t j = k; j >= 0; --j) {
+      const auto jdx = static_cast<size_t>(j);
+      b.H.block(j * DIM_U, k * DIM_U, DIM_U, DIM_U).noalias() = m.Bd[jdx].transpose() * b.SB;
+      if (j > 0) {
+        b.tmp_xu.noalias() = m.Ad[jdx].transpose() * b.SB;
+        b.SB.swap(b.tmp_xu);
+      }
+    }
+    b.f.block(0, k * DIM_U, 1, DIM_U).noalias() = b.g.transpose() * m.Bd[idx];
+  }
+  b.H.triangularView<Eigen::StrictlyLower>() = b.H.transpose();
+}
+
 void MPC::addSteerWeightR(Eigen::MatrixXd * R_ptr) const
 {
   const int64_t N = m_param.prediction_horizon;
@@ -789,23 +848,13 @@ float64_t MPC::getPredictionTime() const
 
 bool8_t MPC::isValid(const MPCMatrix & m) const
 {
-  if (
-    m.Aex.array().isNaN().any() || m.Bex.array().isNaN().any() || m.Cex.array().isNaN().any() ||
-    m.Wex.array().isNaN().any() || m.Qex.array().isNaN().any() || m.R1ex.array().isNaN().any() ||
-    m.R2ex.array().isNaN().any() || m.Urefex.array().isNaN().any())
-  {
-    return false;
-  }
-
-  if (
-    m.Aex.array().isInf().any() || m.Bex.array().isInf().any() || m.Cex.array().isInf().any() ||
-    m.Wex.array().isInf().any() || m.Qex.array().isInf().any() || m.R1ex.array().isInf().any() ||
-    m.R2ex.array().isInf().any() || m.Urefex.array().isInf().any())
-  {
-    return false;
-  }
-
-  return true;
+  // a matrix is valid if it contains neither NaN nor Inf
+  const auto is_finite = [](const Eigen::MatrixXd & mat) {return mat.allFinite();};
+  const auto are_finite = [&is_finite](const std::vector<Eigen::MatrixXd> & mats) {
+      return std::all_of(mats.begin(), mats.end(), is_finite);
+    };
+  return are_finite(m.Ad) && are_finite(m.Bd) && are_finite(m.Cd) && are_finite(m.Wd) &&
+         are_finite(m.Qd) && is_finite(m.R1ex) && is_finite(m.R2ex) && is_finite(m.Urefex);
 }
 }  // namespace trajectory_follower
 }  // namespace control
@@ -246,7 +246,10 @@ bool8_t convertToAutowareTrajectory(
 {
   output.points.clear();
   autoware_auto_msgs::msg::TrajectoryPoint p;
-  for (size_t i = 0; i < input.size(); ++i) {
+  // the points of the message are bounded, whereas the MPC horizon is not
+  const size_t size =
+    std::min(input.size(), static_cast<size_t>(autoware_auto_msgs::msg::Trajectory::CAPACITY));
+  for (size_t i = 0; i < size; ++i) {
     p.x = static_cast<decltype(p.x)>(input.x.at(i));
     p.y = static_cast<decltype(p.y)>(input.y.at(i));
     p.z = static_cast<decltype(p.z)>(input.z.at(i));
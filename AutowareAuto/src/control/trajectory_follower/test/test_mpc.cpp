@@ -13,6 +13,8 @@
 // limitations under the License.
 
 
+#include <algorithm>
+#include <cstdlib>
 #include <memory>
 #include <string>
 #include <vector>
@@ -307,6 +309,41 @@ TEST_F(MPCTest, OsqpCalculateRightTurn) {
   EXPECT_LT(ctrl_cmd.steering_tire_rotation_rate, 0.0f);
 }
 
+TEST_F(MPCTest, LongHorizonCalculateRightTurn) {
+  trajectory_follower::MPC mpc;
+  initializeMPC(mpc);
+  mpc.setReferenceTrajectory(
+    dummy_right_turn_trajectory, traj_resample_dist, enable_path_smoothing,
+    path_filter_moving_ave_num, enable_yaw_recalculation,
+    curvature_smoothing_num);
+
+  const std::string vehicle_model_type = "kinematics";
+  std::shared_ptr<trajectory_follower::VehicleModelInterface> vehicle_model_ptr =
+    std::make_shared<trajectory_follower::KinematicsBicycleModel>(
+    wheelbase, steer_limit, steer_tau);
+  mpc.setVehicleModel(vehicle_model_ptr, vehicle_model_type);
+  std::shared_ptr<trajectory_follower::QPSolverInterface> qpsolver_ptr =
+    std::make_shared<trajectory_follower::QPSolverEigenLeastSquareLLT>();
+  mpc.setQPSolver(qpsolver_ptr);
+
+  // The buffers of the MPC are resized when the horizon changes between calls
+  AckermannLateralCommand ctrl_cmd;
+  Trajectory pred_traj;
+  Float32MultiArrayDiagnostic diag;
+  for (const int64_t horizon : {150, 50, 150}) {
+    mpc.m_param.prediction_horizon = horizon;
+    ASSERT_TRUE(
+      mpc.calculateMPC(
+        neutral_steer, default_velocity, pose_zero, ctrl_cmd, pred_traj,
+        diag));
+    EXPECT_LT(ctrl_cmd.steering_tire_angle, 0.0f);
+    // The predicted trajectory is truncated to the capacity of the message
+    EXPECT_EQ(
+      pred_traj.points.size(),
+      std::min(static_cast<size_t>(horizon), static_cast<size_t>(Trajectory::CAPACITY)));
+  }
+}
+
 TEST_F(MPCTest, KinematicsNoDelayCalculate) {
   trajectory_follower::MPC mpc;
   initializeMPC(mpc);
@@ -493,4 +530,107 @@ TEST_F(MPCTest, FailureCases) {
       neutral_steer, default_velocity, pose_zero, ctrl_cmd, pred_traj,
       diag));
 }
+
+// Random per-step prediction model of a small horizon, together with its dense form
+// Xex = Aex * x0 + Bex * Uex + Wex, Yex = Cex * Xex weighted by Qex as the QP was built before
+struct SmallHorizonModel
+{
+  trajectory_follower::MPCMatrix m;
+  Eigen::VectorXd x0;
+  Eigen::MatrixXd Aex, Bex, Wex, Cex, Qex;
+
+  SmallHorizonModel(const int64_t N, const int64_t DIM_X, const int64_t DIM_U, const int64_t DIM_Y)
+  {
+    std::srand(42);
+    x0 = Eigen::VectorXd::Random(DIM_X);
+    Aex = Eigen::MatrixXd::Zero(DIM_X * N, DIM_X);
+    Bex = Eigen::MatrixXd::Zero(DIM_X * N, DIM_U * N);
+    Wex = Eigen::MatrixXd::Zero(DIM_X * N, 1);
+    Cex = Eigen::MatrixXd::Zero(DIM_Y * N, DIM_X * N);
+    Qex = Eigen::MatrixXd::Zero(DIM_Y * N, DIM_Y * N);
+    for (int64_t i = 0; i < N; ++i) {
+      const Eigen::MatrixXd Ad = Eigen::MatrixXd::Identity(DIM_X, DIM_X) +
+        0.1 * Eigen::MatrixXd::Random(DIM_X, DIM_X);
+      const Eigen::MatrixXd Bd = Eigen::MatrixXd::Random(DIM_X, DIM_U);
+      const Eigen::MatrixXd Wd = Eigen::MatrixXd::Random(DIM_X, 1);
+      const Eigen::MatrixXd Cd = Eigen::MatrixXd::Random(DIM_Y, DIM_X);
+      const Eigen::MatrixXd Qd =
+        (Eigen::VectorXd::Random(DIM_Y).array() + 2.0).matrix().asDiagonal();
+      m.Ad.push_back(Ad);
+      m.Bd.push_back(Bd);
+      m.Wd.push_back(Wd);
+      m.Cd.push_back(Cd);
+      m.Qd.push_back(Qd);
+
+      if (i == 0) {
+        Aex.block(0, 0, DIM_X, DIM_X) = Ad;
+        Wex.block(0, 0, DIM_X, 1) = Wd;
+      } else {
+        const int64_t idx_x_i = i * DIM_X;
+        const int64_t idx_x_i_prev = (i - 1) * DIM_X;
+        Aex.block(idx_x_i, 0, DIM_X, DIM_X) = Ad * Aex.block(idx_x_i_prev, 0, DIM_X, DIM_X);
+        for (int64_t j = 0; j < i; ++j) {
+          Bex.block(idx_x_i, j * DIM_U, DIM_X, DIM_U) =
+            Ad * Bex.block(idx_x_i_prev, j * DIM_U, DIM_X, DIM_U);
+        }
+        Wex.block(idx_x_i, 0, DIM_X, 1) = Ad * Wex.block(idx_x_i_prev, 0, DIM_X, 1) + Wd;
+      }
+      Bex.block(i * DIM_X, i * DIM_U, DIM_X, DIM_U) = Bd;
+      Cex.block(i * DIM_Y, i * DIM_X, DIM_Y, DIM_X) = Cd;
+      Qex.block(i * DIM_Y, i * DIM_Y, DIM_Y, DIM_Y) = Qd;
+    }
+  }
+};
+
+TEST(MPCCondensedQP, MatchesDenseCost) {
+  const int64_t N = 5;
+  const SmallHorizonModel model(N, 3, 1, 2);
+
+  trajectory_follower::MPCQPBuffer qp_buffer;
+  trajectory_follower::calculateOutputCost(model.m, model.x0, &qp_buffer);
+
+  const Eigen::MatrixXd CB = model.Cex * model.Bex;
+  const Eigen::MatrixXd QCB = model.Qex * CB;
+  const Eigen::MatrixXd H = CB.transpose() * QCB;
+  const Eigen::MatrixXd f = (model.Cex * (model.Aex * model.x0 + model.Wex)).transpose() * QCB;
+
+  ASSERT_EQ(qp_buffer.H.rows(), H.rows());
+  ASSERT_EQ(qp_buffer.H.cols(), H.cols());
+  ASSERT_EQ(qp_buffer.f.rows(), f.rows());
+  ASSERT_EQ(qp_buffer.f.cols(), f.cols());
+  for (int64_t i = 0; i < H.rows(); ++i) {
+    for (int64_t j = 0; j < H.cols(); ++j) {
+      EXPECT_NEAR(qp_buffer.H(i, j), H(i, j), 1e-9) << "H(" << i << ", " << j << ")";
+    }
+    EXPECT_NEAR(qp_buffer.f(0, i), f(0, i), 1e-9) << "f(" << i << ")";
+  }
+}
+
+TEST(MPCCondensedQP, MatchesDenseTrajectory) {
+  const int64_t N = 5;
+  const SmallHorizonModel model(N, 3, 1, 2);
+  const Eigen::MatrixXd R = 0.1 * Eigen::MatrixXd::Identity(N, N);
+
+  trajectory_follower::MPCQPBuffer qp_buffer;
+  trajectory_follower::calculateOutputCost(model.m, model.x0, &qp_buffer);
+  const Eigen::VectorXd U = -(qp_buffer.H + R).ldlt().solve(qp_buffer.f.transpose());
+  Eigen::VectorXd Xex;
+  trajectory_follower::predictState(model.m, model.x0, &U, &Xex);
+
+  const Eigen::MatrixXd CB = model.Cex * model.Bex;
+  const Eigen::MatrixXd QCB = model.Qex * CB;
+  const Eigen::MatrixXd H = CB.transpose() * QCB + R;
+  const Eigen::MatrixXd f = (model.Cex * (model.Aex * model.x0 + model.Wex)).transpose() * QCB;
+  const Eigen::VectorXd U_dense = -H.ldlt().solve(f.transpose());
+  const Eigen::VectorXd Xex_dense = model.Aex * model.x0 + model.Bex * U_dense + model.Wex;
+
+  ASSERT_EQ(U.size(), U_dense.size());
+  for (int64_t i = 0; i < U.size(); ++i) {
+    EXPECT_NEAR(U(i), U_dense(i), 1e-9) << "U(" << i << ")";
+  }
+  ASSERT_EQ(Xex.size(), Xex_dense.size());
+  for (int64_t i = 0; i < Xex.size(); ++i) {
+    EXPECT_NEAR(Xex(i), Xex_dense(i), 1e-9) << "Xex(" << i << ")";
+  }
+}
 }  // namespace
@@ -0,0 +1,100 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief This file defines the conversion of a velodyne data block into cartesian points
+
+#ifndef VELODYNE_DRIVER__BLOCK_DECODER_HPP_
+#define VELODYNE_DRIVER__BLOCK_DECODER_HPP_
+
+#include <velodyne_driver/common.hpp>
+#include <velodyne_driver/visibility_control.hpp>
+
+namespace autoware
+{
+namespace drivers
+{
+namespace velodyne_driver
+{
+
+/// \brief Instruction set used to decode a data block
+enum class BlockDecoderIsa : uint8_t
+{
+  SCALAR = 0U,
+  AVX2
+};
+
+/// \brief Lookup tables of a translator, which are shared by all blocks
+struct VELODYNE_DRIVER_PUBLIC BlockDecoderTables
+{
+  /// sine of each azimuth index, AZIMUTH_ROTATION_RESOLUTION entries
+  const float32_t * sin_table;
+  /// cosine of each azimuth index, AZIMUTH_ROTATION_RESOLUTION entries
+  const float32_t * cos_table;
+  /// intensity of each raw intensity value, NUM_INTENSITY_VALUES entries
+  const float32_t * intensity_table;
+  /// meters per unit of the raw distance
+  float32_t distance_resolution;
+};
+
+/// \brief Unpacked channels of a data block, one array per field so that they can be processed
+///        by SIMD instructions
+struct VELODYNE_DRIVER_PUBLIC BlockChannels
+{
+  /// raw distance, in units of the distance resolution
+  uint32_t distance[NUM_POINTS_PER_BLOCK];
+  /// azimuth index, in [0, AZIMUTH_ROTATION_RESOLUTION)
+  uint32_t azimuth[NUM_POINTS_PER_BLOCK];
+  /// altitude index, in [0, AZIMUTH_ROTATION_RESOLUTION)
+  uint32_t altitude[NUM_POINTS_PER_BLOCK];
+  /// raw intensity, in [0, NUM_INTENSITY_VALUES)
+  uint32_t intensity[NUM_POINTS_PER_BLOCK];
+};
+
+/// \brief Cartesian points of a data block, one array per field
+struct VELODYNE_DRIVER_PUBLIC DecodedBlock
+{
+  float32_t x[NUM_POINTS_PER_BLOCK];
+  float32_t y[NUM_POINTS_PER_BLOCK];
+  float32_t z[NUM_POINTS_PER_BLOCK];
+  float32_t intensity[NUM_POINTS_PER_BLOCK];
+};
+
+/// \brief Check whether the AVX2 decoder was compiled in and the CPU supports it
+/// \return True if BlockDecoderIsa::AVX2 can be used
+VELODYNE_DRIVER_PUBLIC bool8_t block_decoder_avx2_available() noexcept;
+
+/// \brief Convert the channels of a data block into cartesian points with the fastest instruction
+///        set available. All instruction sets give bitwise identical points.
+/// \param[in] tables Lookup tables of the translator
+/// \param[in] channels Unpacked channels of the block
+/// \param[out] output Gets filled with the points of the block
+VELODYNE_DRIVER_PUBLIC void decode_block(
+  const BlockDecoderTables & tables, const BlockChannels & channels, DecodedBlock & output);
+
+/// \brief Convert the channels of a data block into cartesian points
+/// \param[in] isa Instruction set to use
+/// \param[in] tables Lookup tables of the translator
+/// \param[in] channels Unpacked channels of the block
+/// \param[out] output Gets filled with the points of the block
+/// \throw std::domain_error If the instruction set is not available
+VELODYNE_DRIVER_PUBLIC void decode_block(
+  const BlockDecoderIsa isa, const BlockDecoderTables & tables, const BlockChannels & channels,
+  DecodedBlock & output);
+
+}  // namespace velodyne_driver
+}  // namespace drivers
+}  // namespace autoware
+
+#endif  // VELODYNE_DRIVER__BLOCK_DECODER_HPP_
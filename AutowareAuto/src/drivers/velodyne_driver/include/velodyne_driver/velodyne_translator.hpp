@@ -23,6 +23,7 @@
 
 #include <velodyne_driver/visibility_control.hpp>
 #include <geometry_msgs/msg/point32.hpp>
+#include <velodyne_driver/block_decoder.hpp>
 #include <velodyne_driver/common.hpp>
 #include <velodyne_driver/vlp16_data.hpp>
 #include <velodyne_driver/vlp32c_data.hpp>
@@ -102,14 +103,17 @@ private:
   {
     init_trig_tables();
     init_intensity_table();
+    init_channel_tables();
   }
 
   /// \brief Convert a packet into a block of cartesian points
   /// \param[in] pkt A packet from a VLP16 HiRes sensor for conversion
   /// \param[out] output Gets filled with cartesian points and any additional flags
+  /// \note Not thread safe: the blocks are decoded in preallocated workspace member variables
   void convert(const Packet & pkt, std::vector<autoware::common::types::PointXYZIF> & output)
   {
     output.clear();
+    const BlockDecoderTables decoder_tables = get_decoder_tables();
 
     for (uint32_t block_id = 0U; block_id < NUM_BLOCKS_PER_PACKET; ++block_id, ++m_block_counter) {
       const DataBlock & block = pkt.blocks[block_id];
@@ -121,18 +125,25 @@ private:
       // Number of points from the sequence that has already been delivered in previous blocks.
       const auto num_banked_pts = flag_check_result.second;
       const uint32_t azimuth_base = to_uint32(block.azimuth_bytes[1U], block.azimuth_bytes[0U]);
+      const ChannelTable & channel_table = get_channel_table(num_banked_pts, block_id);
 
+      // Unpack the block, then convert all of its points at once
       for (uint16_t pt_id = 0U; pt_id < NUM_POINTS_PER_BLOCK; ++pt_id) {
         const DataChannel & channel = block.channels[pt_id];
-        const uint32_t th = (azimuth_base + m_sensor_data.azimuth_offset(
-            num_banked_pts, block_id, pt_id)) % AZIMUTH_ROTATION_RESOLUTION;
-        const float32_t r = compute_distance_m(channel.data[1U], channel.data[0U]);
-        const uint32_t phi = m_sensor_data.altitude(num_banked_pts, block_id, pt_id);
+        m_channels.distance[pt_id] = to_uint32(channel.data[1U], channel.data[0U]);
+        m_channels.azimuth[pt_id] =
+          (azimuth_base + channel_table.azimuth[pt_id]) % AZIMUTH_ROTATION_RESOLUTION;
+        m_channels.altitude[pt_id] = channel_table.altitude[pt_id];
+        m_channels.intensity[pt_id] = channel.data[2U];
+      }
+      decode_block(decoder_tables, m_channels, m_decoded_block);
 
-        // Compute the point
+      for (uint16_t pt_id = 0U; pt_id < NUM_POINTS_PER_BLOCK; ++pt_id) {
         PointXYZIF pt;
-        polar_to_xyz(pt, r, th, phi);
-        pt.intensity = m_intensity_table[channel.data[2U]];
+        pt.x = m_decoded_block.x[pt_id];
+        pt.y = m_decoded_block.y[pt_id];
+        pt.z = m_decoded_block.z[pt_id];
+        pt.intensity = m_decoded_block.intensity[pt_id];
         pt.id = m_sensor_data.seq_id(m_block_counter, pt_id);
 
         output.push_back(pt);
@@ -160,32 +171,63 @@ private:
     ((NUM_POINTS_PER_BLOCK * NUM_BLOCKS_PER_PACKET) + 1U),
     "Number of points from one VLP16 packet cannot fit into a point block");
 
-  /// \brief converts polar coordinates into cartesian (xyz), not threadsafe: modifies a
-  ///        preallocated workspace member variable (m_point)
-  /// \param[out] pt Gets filled with the requisite cartesian information
-  /// \param[in] r_m the radius in meters
-  /// \param[in] th_ind the index of the azimuth in lookup tables (angle about the z-axis)
-  /// \param[in] phi_ind the altitude angle index from lookup tables(angle orthogonal to z-axis)
-  inline void polar_to_xyz(
-    autoware::common::types::PointXYZIF & pt,
-    const float32_t r_m,
-    const uint32_t th_ind,
-    const uint32_t phi_ind) const
+  /// \brief azimuth offsets and altitudes of the channels of a block
+  struct ChannelTable
+  {
+    std::array<uint32_t, NUM_POINTS_PER_BLOCK> azimuth;
+    std::array<uint32_t, NUM_POINTS_PER_BLOCK> altitude;
+  };
+
+  /// number of banks of a firing sequence, e.g. a VLS128 fires its 128 lasers over 4 blocks
+  static constexpr uint32_t NUM_BANKS =
+    (SensorData::NUM_LASERS > NUM_POINTS_PER_BLOCK) ?
+    (SensorData::NUM_LASERS / NUM_POINTS_PER_BLOCK) : 1U;
+
+  /// \brief fills a channel table from the sensor data
+  VELODYNE_DRIVER_LOCAL void fill_channel_table(
+    ChannelTable & table, const uint16_t num_banked_pts, const uint32_t block_id) const
+  {
+    for (uint32_t pt_id = 0U; pt_id < NUM_POINTS_PER_BLOCK; ++pt_id) {
+      table.azimuth[pt_id] = m_sensor_data.azimuth_offset(num_banked_pts, block_id, pt_id);
+      table.altitude[pt_id] = m_sensor_data.altitude(num_banked_pts, block_id, pt_id);
+    }
+  }
+
+  /// \brief initializes the channel tables of all banks and blocks of a packet, so that the
+  ///        sensor data is not queried per point
+  VELODYNE_DRIVER_LOCAL void init_channel_tables()
+  {
+    for (uint32_t bank = 0U; bank < NUM_BANKS; ++bank) {
+      for (uint32_t block_id = 0U; block_id < NUM_BLOCKS_PER_PACKET; ++block_id) {
+        fill_channel_table(
+          m_channel_tables[(bank * NUM_BLOCKS_PER_PACKET) + block_id],
+          static_cast<uint16_t>(bank * NUM_POINTS_PER_BLOCK), block_id);
+      }
+    }
+  }
+
+  /// \brief gets the lookup tables for the block decoder, they are not stored as pointers to the
+  ///        members would dangle when the translator is copied
+  inline BlockDecoderTables get_decoder_tables() const
   {
-    const float32_t r_xy = r_m * m_cos_table[phi_ind];
-    pt.x = r_xy * m_cos_table[th_ind];  // y (vlp-frame)
-    pt.y = -r_xy * m_sin_table[th_ind];  // -x (vlp-frame)
-    pt.z = r_m * m_sin_table[phi_ind];
+    return BlockDecoderTables{
+      m_sin_table.data(), m_cos_table.data(), m_intensity_table.data(),
+      m_sensor_data.distance_resolution()};
   }
 
-  /// \brief converts the two byte representation of distance into meters
-  /// \param[in] first the byte representing the most significant bits
-  /// \param[in] second the byte representing the least significant bits
-  /// \return the radial distance in meters
-  inline float32_t compute_distance_m(const uint8_t first, const uint8_t second) const
+  /// \brief gets the channel table of a block
+  /// \param[in] num_banked_pts number of points of the sequence delivered in previous blocks
+  /// \param[in] block_id index of the block in the packet
+  /// \return the precomputed table, or a table computed into a workspace if the bank is unknown
+  inline const ChannelTable & get_channel_table(
+    const uint16_t num_banked_pts, const uint32_t block_id)
   {
-    const uint32_t dist_scaled = to_uint32(first, second);
-    return static_cast<float32_t>(dist_scaled) * m_sensor_data.distance_resolution();
+    const uint32_t bank = num_banked_pts / NUM_POINTS_PER_BLOCK;
+    if (((num_banked_pts % NUM_POINTS_PER_BLOCK) == 0U) && (bank < NUM_BANKS)) {
+      return m_channel_tables[(bank * NUM_BLOCKS_PER_PACKET) + block_id];
+    }
+    fill_channel_table(m_channel_table_workspace, num_banked_pts, block_id);
+    return m_channel_table_workspace;
   }
 
   template<typename T>
@@ -223,6 +265,14 @@ private:
   std::array<float32_t, AZIMUTH_ROTATION_RESOLUTION> m_cos_table;
   /// lookup table for intensity
   std::array<float32_t, AZIMUTH_ROTATION_RESOLUTION> m_intensity_table;
+  /// azimuth offset and altitude of each channel, per bank and block
+  std::array<ChannelTable, NUM_BANKS * NUM_BLOCKS_PER_PACKET> m_channel_tables;
+  /// channel table of a block from an unexpected bank
+  ChannelTable m_channel_table_workspace;
+  /// workspace: unpacked channels of the current block
+  BlockChannels m_channels;
+  /// workspace: points of the current block
+  DecodedBlock m_decoded_block;
 
   /// mask to avoid modulo: packet id can go up to 3617: 0000 1111 1111 1111 = 4096
   uint16_t m_block_counter{0U};
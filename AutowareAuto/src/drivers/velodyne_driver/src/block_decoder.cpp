@@ -0,0 +1,87 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdexcept>
+#include "block_decoder_impl.hpp"
+
+namespace autoware
+{
+namespace drivers
+{
+namespace velodyne_driver
+{
+namespace
+{
+// Same arithmetic as VelodyneTranslator::polar_to_xyz() used to do per point. There are only
+// products, so nothing can be contracted into a fused multiply-add and the loop vectorizes to the
+// same results where the compiler supports gathers.
+void decode_block_scalar(
+  const BlockDecoderTables & tables, const BlockChannels & channels, DecodedBlock & output)
+{
+  for (uint32_t pt_id = 0U; pt_id < NUM_POINTS_PER_BLOCK; ++pt_id) {
+    const float32_t r_m =
+      static_cast<float32_t>(channels.distance[pt_id]) * tables.distance_resolution;
+    const uint32_t th_ind = channels.azimuth[pt_id];
+    const uint32_t phi_ind = channels.altitude[pt_id];
+    const float32_t r_xy = r_m * tables.cos_table[phi_ind];
+    output.x[pt_id] = r_xy * tables.cos_table[th_ind];  // y (vlp-frame)
+    output.y[pt_id] = -r_xy * tables.sin_table[th_ind];  // -x (vlp-frame)
+    output.z[pt_id] = r_m * tables.sin_table[phi_ind];
+    output.intensity[pt_id] = tables.intensity_table[channels.intensity[pt_id]];
+  }
+}
+}  // namespace
+
+bool8_t block_decoder_avx2_available() noexcept
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  static const bool8_t available =
+    detail::block_decoder_avx2_compiled() && __builtin_cpu_supports("avx2");
+  return available;
+#else
+  return false;
+#endif
+}
+
+void decode_block(
+  const BlockDecoderTables & tables, const BlockChannels & channels, DecodedBlock & output)
+{
+  if (block_decoder_avx2_available()) {
+    detail::decode_block_avx2(tables, channels, output);
+  } else {
+    decode_block_scalar(tables, channels, output);
+  }
+}
+
+void decode_block(
+  const BlockDecoderIsa isa, const BlockDecoderTables & tables, const BlockChannels & channels,
+  DecodedBlock & output)
+{
+  switch (isa) {
+    case BlockDecoderIsa::SCALAR:
+      decode_block_scalar(tables, channels, output);
+      break;
+    case BlockDecoderIsa::AVX2:
+      if (!block_decoder_avx2_available()) {
+        throw std::domain_error{"BlockDecoder: AVX2 is not available"};
+      }
+      detail::decode_block_avx2(tables, channels, output);
+      break;
+    default:
+      throw std::domain_error{"BlockDecoder: unknown instruction set"};
+  }
+}
+}  // namespace velodyne_driver
+}  // namespace drivers
+}  // namespace autoware
@@ -0,0 +1,85 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// This translation unit is compiled with AVX2 enabled on x86 targets. It must not use any inline
+// function which is also used by the other translation units, since the linker could pick the
+// AVX2 version for them. Only call it after checking block_decoder_avx2_available().
+// FMA is deliberately not enabled: the points have to be bitwise identical to the scalar decoder.
+
+#include <stdexcept>
+#include "block_decoder_impl.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace autoware
+{
+namespace drivers
+{
+namespace velodyne_driver
+{
+namespace detail
+{
+#if defined(__AVX2__)
+bool8_t block_decoder_avx2_compiled() noexcept
+{
+  return true;
+}
+
+void decode_block_avx2(
+  const BlockDecoderTables & tables, const BlockChannels & channels, DecodedBlock & output)
+{
+  static_assert(NUM_POINTS_PER_BLOCK % 8U == 0U, "Block must be a multiple of the AVX2 width");
+  // The tables have less than 2^31 entries, so the indices are valid signed 32 bit integers
+  const __m256 resolution = _mm256_set1_ps(tables.distance_resolution);
+  const __m256 sign = _mm256_set1_ps(-0.0F);
+  for (uint32_t pt_id = 0U; pt_id < NUM_POINTS_PER_BLOCK; pt_id += 8U) {
+    const __m256i distance =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&channels.distance[pt_id]));
+    const __m256i th_ind =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&channels.azimuth[pt_id]));
+    const __m256i phi_ind =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&channels.altitude[pt_id]));
+    const __m256i intensity_ind =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&channels.intensity[pt_id]));
+    // The raw distance has 16 bits, so the conversion is exact
+    const __m256 r_m = _mm256_mul_ps(_mm256_cvtepi32_ps(distance), resolution);
+    const __m256 cos_phi = _mm256_i32gather_ps(tables.cos_table, phi_ind, 4);
+    const __m256 sin_phi = _mm256_i32gather_ps(tables.sin_table, phi_ind, 4);
+    const __m256 cos_th = _mm256_i32gather_ps(tables.cos_table, th_ind, 4);
+    const __m256 sin_th = _mm256_i32gather_ps(tables.sin_table, th_ind, 4);
+    const __m256 r_xy = _mm256_mul_ps(r_m, cos_phi);
+    _mm256_storeu_ps(&output.x[pt_id], _mm256_mul_ps(r_xy, cos_th));
+    _mm256_storeu_ps(&output.y[pt_id], _mm256_mul_ps(_mm256_xor_ps(r_xy, sign), sin_th));
+    _mm256_storeu_ps(&output.z[pt_id], _mm256_mul_ps(r_m, sin_phi));
+    _mm256_storeu_ps(
+      &output.intensity[pt_id], _mm256_i32gather_ps(tables.intensity_table, intensity_ind, 4));
+  }
+}
+#else
+bool8_t block_decoder_avx2_compiled() noexcept
+{
+  return false;
+}
+
+void decode_block_avx2(const BlockDecoderTables &, const BlockChannels &, DecodedBlock &)
+{
+  throw std::domain_error{"BlockDecoder: the AVX2 decoder was not compiled"};
+}
+#endif
+}  // namespace detail
+}  // namespace velodyne_driver
+}  // namespace drivers
+}  // namespace autoware
@@ -0,0 +1,47 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Declarations of the instruction set specific block decoders. This header is private to
+///        the velodyne_driver library.
+
+#ifndef BLOCK_DECODER_IMPL_HPP_
+#define BLOCK_DECODER_IMPL_HPP_
+
+#include <velodyne_driver/block_decoder.hpp>
+
+namespace autoware
+{
+namespace drivers
+{
+namespace velodyne_driver
+{
+namespace detail
+{
+/// Whether the AVX2 translation unit was compiled with AVX2 enabled
+bool8_t block_decoder_avx2_compiled() noexcept;
+
+/// AVX2 decoder, only to be called if block_decoder_avx2_compiled() is true and the CPU
+/// supports AVX2
+/// \param tables Lookup tables of the translator
+/// \param channels Unpacked channels of the block
+/// \param output Gets filled with the points of the block
+void decode_block_avx2(
+  const BlockDecoderTables & tables, const BlockChannels & channels, DecodedBlock & output);
+}  // namespace detail
+}  // namespace velodyne_driver
+}  // namespace drivers
+}  // namespace autoware
+
+#endif  // BLOCK_DECODER_IMPL_HPP_
@@ -0,0 +1,191 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <velodyne_driver/block_decoder.hpp>
+#include <velodyne_driver/velodyne_translator.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using autoware::common::types::PointXYZIF;
+using autoware::common::types::float32_t;
+using autoware::drivers::velodyne_driver::AZIMUTH_ROTATION_RESOLUTION;
+using autoware::drivers::velodyne_driver::BlockChannels;
+using autoware::drivers::velodyne_driver::BlockDecoderIsa;
+using autoware::drivers::velodyne_driver::BlockDecoderTables;
+using autoware::drivers::velodyne_driver::DecodedBlock;
+using autoware::drivers::velodyne_driver::NUM_BLOCKS_PER_PACKET;
+using autoware::drivers::velodyne_driver::NUM_INTENSITY_VALUES;
+using autoware::drivers::velodyne_driver::NUM_POINTS_PER_BLOCK;
+using autoware::drivers::velodyne_driver::VLP16Data;
+using autoware::drivers::velodyne_driver::VLP32CData;
+using autoware::drivers::velodyne_driver::VLS128Data;
+using autoware::drivers::velodyne_driver::VelodyneTranslator;
+using autoware::drivers::velodyne_driver::block_decoder_avx2_available;
+using autoware::drivers::velodyne_driver::decode_block;
+using autoware::drivers::velodyne_driver::to_uint32;
+
+namespace
+{
+constexpr float32_t TAU = 6.283185307179586476925286766559F;
+
+// Lookup tables built the same way as in the translator
+struct Tables
+{
+  Tables()
+  : sin_table(AZIMUTH_ROTATION_RESOLUTION), cos_table(AZIMUTH_ROTATION_RESOLUTION),
+    intensity_table(NUM_INTENSITY_VALUES)
+  {
+    constexpr float32_t IDX2RAD = TAU / static_cast<float32_t>(AZIMUTH_ROTATION_RESOLUTION);
+    for (uint32_t idx = 0U; idx < AZIMUTH_ROTATION_RESOLUTION; ++idx) {
+      cos_table[idx] = cosf((static_cast<float32_t>(idx)) * IDX2RAD);
+      sin_table[idx] = sinf((static_cast<float32_t>(idx)) * IDX2RAD);
+    }
+    for (uint32_t idx = 0U; idx < NUM_INTENSITY_VALUES; ++idx) {
+      intensity_table[idx] = static_cast<float32_t>(idx);
+    }
+  }
+
+  std::vector<float32_t> sin_table;
+  std::vector<float32_t> cos_table;
+  std::vector<float32_t> intensity_table;
+};
+
+template<typename SensorData>
+typename VelodyneTranslator<SensorData>::Packet random_packet(std::mt19937 & gen)
+{
+  // Cycle through the flags of all banks, a VLS128 has four of them
+  constexpr uint8_t bank_flags[4U] = {0xEEU, 0xDDU, 0xCCU, 0xBBU};
+  std::uniform_int_distribution<uint32_t> byte{0U, 255U};
+  std::uniform_int_distribution<uint32_t> azimuth{0U, AZIMUTH_ROTATION_RESOLUTION - 1U};
+  typename VelodyneTranslator<SensorData>::Packet pkt;
+  for (uint32_t block_id = 0U; block_id < NUM_BLOCKS_PER_PACKET; ++block_id) {
+    auto & block = pkt.blocks[block_id];
+    block.flag[0U] = 0xFFU;
+    block.flag[1U] = (SensorData::NUM_LASERS > NUM_POINTS_PER_BLOCK) ?
+      bank_flags[block_id % 4U] : bank_flags[0U];
+    const auto az = azimuth(gen);
+    block.azimuth_bytes[0U] = static_cast<uint8_t>(az & 0xFFU);
+    block.azimuth_bytes[1U] = static_cast<uint8_t>(az >> 8U);
+    for (auto & channel : block.channels) {
+      for (auto & data : channel.data) {
+        data = static_cast<uint8_t>(byte(gen));
+      }
+    }
+  }
+  return pkt;
+}
+
+// The per point conversion the translator did before it decoded whole blocks
+template<typename SensorData>
+std::vector<PointXYZIF> reference_convert(
+  const typename VelodyneTranslator<SensorData>::Packet & pkt, SensorData & sensor_data,
+  const Tables & tables)
+{
+  std::vector<PointXYZIF> output;
+  for (uint32_t block_id = 0U; block_id < NUM_BLOCKS_PER_PACKET; ++block_id) {
+    const auto & block = pkt.blocks[block_id];
+    const auto num_banked_pts = sensor_data.check_flag(block.flag).second;
+    const uint32_t azimuth_base = to_uint32(block.azimuth_bytes[1U], block.azimuth_bytes[0U]);
+    for (uint16_t pt_id = 0U; pt_id < NUM_POINTS_PER_BLOCK; ++pt_id) {
+      const auto & channel = block.channels[pt_id];
+      const uint32_t th = (azimuth_base + sensor_data.azimuth_offset(
+          num_banked_pts, block_id, pt_id)) % AZIMUTH_ROTATION_RESOLUTION;
+      const float32_t r = static_cast<float32_t>(to_uint32(channel.data[1U], channel.data[0U])) *
+        sensor_data.distance_resolution();
+      const uint32_t phi = sensor_data.altitude(num_banked_pts, block_id, pt_id);
+      const float32_t r_xy = r * tables.cos_table[phi];
+      PointXYZIF pt;
+      pt.x = r_xy * tables.cos_table[th];
+      pt.y = -r_xy * tables.sin_table[th];
+      pt.z = r * tables.sin_table[phi];
+      pt.intensity = tables.intensity_table[channel.data[2U]];
+      output.push_back(pt);
+    }
+  }
+  return output;
+}
+
+template<typename SensorData>
+void expect_same_as_reference()
+{
+  std::mt19937 gen{42U};
+  const Tables tables;
+  SensorData sensor_data{600.0F};
+  using TranslatorT = VelodyneTranslator<SensorData>;
+  TranslatorT translator{typename TranslatorT::Config{600.0F}};
+  std::vector<PointXYZIF> output;
+  for (uint32_t packet = 0U; packet < 10U; ++packet) {
+    const auto pkt = random_packet<SensorData>(gen);
+    translator.convert(pkt, output);
+    const auto expected = reference_convert(pkt, sensor_data, tables);
+    ASSERT_GE(output.size(), expected.size());
+    for (std::size_t idx = 0U; idx < expected.size(); ++idx) {
+      // Bitwise equality, the tests of the translator rely on the exact values
+      EXPECT_EQ(std::memcmp(&output[idx].x, &expected[idx].x, sizeof(float32_t)), 0) << idx;
+      EXPECT_EQ(std::memcmp(&output[idx].y, &expected[idx].y, sizeof(float32_t)), 0) << idx;
+      EXPECT_EQ(std::memcmp(&output[idx].z, &expected[idx].z, sizeof(float32_t)), 0) << idx;
+      EXPECT_EQ(output[idx].intensity, expected[idx].intensity) << idx;
+    }
+  }
+}
+}  // namespace
+
+/// The AVX2 decoder gives the same points as the scalar one, or throws if it is not available
+TEST(BlockDecoder, Avx2SameAsScalar)
+{
+  const Tables tables;
+  const BlockDecoderTables decoder_tables{
+    tables.sin_table.data(), tables.cos_table.data(), tables.intensity_table.data(), 0.004F};
+  std::mt19937 gen{1234U};
+  std::uniform_int_distribution<uint32_t> distance{0U, 65535U};
+  std::uniform_int_distribution<uint32_t> angle{0U, AZIMUTH_ROTATION_RESOLUTION - 1U};
+  std::uniform_int_distribution<uint32_t> intensity{0U, NUM_INTENSITY_VALUES - 1U};
+  BlockChannels channels;
+  for (uint32_t pt_id = 0U; pt_id < NUM_POINTS_PER_BLOCK; ++pt_id) {
+    channels.distance[pt_id] = distance(gen);
+    channels.azimuth[pt_id] = angle(gen);
+    channels.altitude[pt_id] = angle(gen);
+    channels.intensity[pt_id] = intensity(gen);
+  }
+  DecodedBlock scalar;
+  decode_block(BlockDecoderIsa::SCALAR, decoder_tables, channels, scalar);
+  DecodedBlock avx2;
+  if (block_decoder_avx2_available()) {
+    decode_block(BlockDecoderIsa::AVX2, decoder_tables, channels, avx2);
+    EXPECT_EQ(std::memcmp(&scalar, &avx2, sizeof(DecodedBlock)), 0);
+  } else {
+    EXPECT_THROW(
+      decode_block(BlockDecoderIsa::AVX2, decoder_tables, channels, avx2), std::domain_error);
+  }
+}
+
+TEST(BlockDecoder, VLP16SameAsPerPoint)
+{
+  expect_same_as_reference<VLP16Data>();
+}
+
+TEST(BlockDecoder, VLP32CSameAsPerPoint)
+{
+  expect_same_as_reference<VLP32CData>();
+}
+
+TEST(BlockDecoder, VLS128SameAsPerPoint)
+{
+  expect_same_as_reference<VLS128Data>();
+}
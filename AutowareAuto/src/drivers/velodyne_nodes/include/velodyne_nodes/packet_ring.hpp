@@ -0,0 +1,125 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief This file defines a lock-free ring buffer which passes packets from a receiver thread to
+///        a decoder thread
+
+#ifndef VELODYNE_NODES__PACKET_RING_HPP_
+#define VELODYNE_NODES__PACKET_RING_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace autoware
+{
+namespace drivers
+{
+namespace velodyne_nodes
+{
+
+/// \brief Wait-free single producer single consumer ring buffer of preallocated slots.
+///
+/// The producer writes into the free slots in place, e.g. by receiving datagrams directly into
+/// them, and then commits them. The consumer reads the committed slots in place and then
+/// releases them. Nothing is allocated after construction.
+/// \tparam SlotT Type of a slot, default constructible
+template<typename SlotT>
+class PacketRing
+{
+public:
+  /// \brief Constructor
+  /// \param[in] capacity Number of slots, rounded up to the next power of two
+  /// \throw std::domain_error If the capacity is zero
+  explicit PacketRing(const std::size_t capacity)
+  {
+    if (capacity == 0U) {
+      throw std::domain_error{"PacketRing: capacity must be positive"};
+    }
+    std::size_t size = 1U;
+    while (size < capacity) {
+      size *= 2U;
+    }
+    m_slots.resize(size);
+    m_mask = size - 1U;
+  }
+
+  /// \brief Number of slots
+  std::size_t capacity() const noexcept
+  {
+    return m_slots.size();
+  }
+
+  /// \brief Producer: number of slots which can be written
+  std::size_t writable() const noexcept
+  {
+    const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    return capacity() - (tail - m_head.load(std::memory_order_acquire));
+  }
+
+  /// \brief Producer: get a free slot to write into
+  /// \param[in] idx Index of the slot after the last committed one, less than writable()
+  SlotT & write_slot(const std::size_t idx) noexcept
+  {
+    return m_slots[(m_tail.load(std::memory_order_relaxed) + idx) & m_mask];
+  }
+
+  /// \brief Producer: hand the first free slots over to the consumer
+  /// \param[in] count Number of written slots, at most writable()
+  /// \return Number of slots which are readable after the commit
+  std::size_t commit(const std::size_t count) noexcept
+  {
+    const std::size_t tail = m_tail.load(std::memory_order_relaxed) + count;
+    m_tail.store(tail, std::memory_order_release);
+    return tail - m_head.load(std::memory_order_acquire);
+  }
+
+  /// \brief Consumer: number of slots which can be read
+  std::size_t readable() const noexcept
+  {
+    const std::size_t head = m_head.load(std::memory_order_relaxed);
+    return m_tail.load(std::memory_order_acquire) - head;
+  }
+
+  /// \brief Consumer: get a committed slot
+  /// \param[in] idx Index of the slot after the last released one, less than readable()
+  const SlotT & read_slot(const std::size_t idx) const noexcept
+  {
+    return m_slots[(m_head.load(std::memory_order_relaxed) + idx) & m_mask];
+  }
+
+  /// \brief Consumer: hand the first committed slots back to the producer
+  /// \param[in] count Number of read slots, at most readable()
+  void release(const std::size_t count) noexcept
+  {
+    m_head.store(m_head.load(std::memory_order_relaxed) + count, std::memory_order_release);
+  }
+
+private:
+  std::vector<SlotT> m_slots;
+  std::size_t m_mask{0U};
+  // Both indices only grow, the slot is the index modulo the capacity. They are padded apart so
+  // that the producer and consumer do not keep invalidating each other's cache line.
+  std::atomic<std::size_t> m_head{0U};
+  uint8_t m_padding[64U];
+  std::atomic<std::size_t> m_tail{0U};
+};  // class PacketRing
+}  // namespace velodyne_nodes
+}  // namespace drivers
+}  // namespace autoware
+
+#endif  // VELODYNE_NODES__PACKET_RING_HPP_
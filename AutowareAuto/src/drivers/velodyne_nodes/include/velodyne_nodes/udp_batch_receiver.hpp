@@ -0,0 +1,77 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief This file defines a UDP receiver which receives several datagrams per system call
+
+#ifndef VELODYNE_NODES__UDP_BATCH_RECEIVER_HPP_
+#define VELODYNE_NODES__UDP_BATCH_RECEIVER_HPP_
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "velodyne_nodes/visibility_control.hpp"
+
+namespace autoware
+{
+namespace drivers
+{
+namespace velodyne_nodes
+{
+
+/// \brief Receives UDP datagrams in batches with recvmmsg, directly into buffers provided by the
+///        caller. Linux only.
+class VELODYNE_NODES_PUBLIC UdpBatchReceiver
+{
+public:
+  /// \brief Constructor, opens and binds the socket
+  /// \param[in] ip IPv4 address to bind to
+  /// \param[in] port Port to bind to
+  /// \param[in] max_batch_size Maximum number of datagrams received per call
+  /// \param[in] timeout Maximum time a call blocks if no datagram arrives
+  /// \throw std::runtime_error If the socket cannot be opened or bound
+  UdpBatchReceiver(
+    const std::string & ip, const uint16_t port, const std::size_t max_batch_size,
+    const std::chrono::milliseconds timeout);
+  ~UdpBatchReceiver();
+  UdpBatchReceiver(const UdpBatchReceiver &) = delete;
+  UdpBatchReceiver & operator=(const UdpBatchReceiver &) = delete;
+
+  /// \brief Receive datagrams, blocks until at least one is received or the timeout expires
+  /// \param[in] buffers Buffers to receive the datagrams into, one per datagram
+  /// \param[in] buffer_size Size of each buffer, longer datagrams are truncated
+  /// \param[out] sizes Gets the size of each received datagram, before truncation
+  /// \param[in] count Number of buffers, at most max_batch_size
+  /// \return Number of received datagrams, 0 if the timeout expired
+  /// \throw std::runtime_error If receiving fails
+  std::size_t receive(
+    uint8_t * const * buffers, const std::size_t buffer_size, std::size_t * sizes,
+    const std::size_t count);
+
+private:
+  int m_socket;
+  // Workspace of the system call, preallocated for max_batch_size datagrams
+  std::vector<iovec> m_iovecs;
+  std::vector<mmsghdr> m_headers;
+};  // class UdpBatchReceiver
+}  // namespace velodyne_nodes
+}  // namespace drivers
+}  // namespace autoware
+
+#endif  // VELODYNE_NODES__UDP_BATCH_RECEIVER_HPP_
@@ -23,13 +23,20 @@
 #ifndef VELODYNE_NODES__VELODYNE_CLOUD_NODE_HPP_
 #define VELODYNE_NODES__VELODYNE_CLOUD_NODE_HPP_
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include "common/types.hpp"
 #include "lidar_utils/point_cloud_utils.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "udp_driver/udp_driver.hpp"
 #include "velodyne_driver/velodyne_translator.hpp"
+#include "velodyne_nodes/packet_ring.hpp"
+#include "velodyne_nodes/udp_batch_receiver.hpp"
 #include "velodyne_nodes/visibility_control.hpp"
 #include "sensor_msgs/msg/point_cloud2.hpp"
 
@@ -43,8 +50,28 @@ namespace drivers
 namespace velodyne_nodes
 {
 
+/// Counters of the batched packet ingestion of a VelodyneCloudNode
+struct VELODYNE_NODES_PUBLIC IngestionStatistics
+{
+  /// Packets put into the ring
+  uint64_t received_packets{0U};
+  /// Packets dropped because the ring was full
+  uint64_t dropped_packets{0U};
+  /// Datagrams skipped because their size is not the one of a packet
+  uint64_t invalid_packets{0U};
+  /// Packets in the ring which are not decoded yet
+  std::size_t queue_depth{0U};
+  /// Maximum of the queue depth since the node was started
+  std::size_t max_queue_depth{0U};
+};
+
 /// Template class for the velodyne driver node that receives veldyne `packet`s via
 /// UDP, converts the packet into a PointCloud2 message and publishes this cloud.
+///
+/// If the parameter `ingestion.batch_size` is positive, the packets are not received one per
+/// callback from the udp driver. Instead a receiver thread receives up to that many packets per
+/// system call into a preallocated ring of `ingestion.ring_capacity` packets, and a decoder
+/// thread drains the ring. Packets which arrive while the ring is full are dropped and counted.
 /// \tparam SensorData SensorData implementation for the specific velodyne sensor model.
 template<typename SensorData>
 class VELODYNE_NODES_PUBLIC VelodyneCloudNode : public rclcpp::Node
@@ -55,11 +82,17 @@ public:
   using Packet = typename VelodyneTranslatorT::Packet;
 
   VelodyneCloudNode(const std::string & node_name, const rclcpp::NodeOptions & options);
+  /// Stops the ingestion threads
+  ~VelodyneCloudNode() override;
 
   /// Handle data packet from the udp driver
   /// \param buffer Data from the udp driver
   void receiver_callback(const std::vector<uint8_t> & buffer);
 
+  /// Get the counters of the batched ingestion, all zero if it is not used
+  /// \return Current values of the counters
+  IngestionStatistics get_ingestion_statistics() const;
+
 protected:
   void init_output(sensor_msgs::msg::PointCloud2 & output);
   bool8_t convert(
@@ -68,7 +101,25 @@ protected:
   bool8_t get_output_remainder(sensor_msgs::msg::PointCloud2 & output);
 
 private:
+  /// A packet in the ingestion ring
+  struct PacketSlot
+  {
+    Packet packet;
+    /// Size of the received datagram
+    std::size_t size;
+  };
+
   void init_udp_driver();
+  /// Start the receiver and decoder threads of the batched ingestion
+  void init_batch_ingestion(const std::size_t ring_capacity);
+  /// Receiver thread: receive packets in batches into the ring
+  void receive_packets();
+  /// Decoder thread: convert and publish the packets in the ring
+  void decode_packets();
+  /// Convert a packet and publish the cloud once it is complete
+  void handle_packet(const Packet & pkt);
+  /// Log the ingestion statistics if packets were dropped
+  void check_ingestion_statistics();
 
   IoContext m_io_cxt;
   ::drivers::udp_driver::UdpDriver m_udp_driver;
@@ -87,6 +138,28 @@ private:
   uint32_t m_point_cloud_idx;
   const std::string m_frame_id;
   const std::uint32_t m_cloud_size;
+
+  // Batched ingestion, only used if m_batch_size is positive
+  const std::size_t m_batch_size;
+  std::unique_ptr<PacketRing<PacketSlot>> m_ring;
+  std::unique_ptr<UdpBatchReceiver> m_batch_receiver;
+  // Buffers and sizes of the current batch, preallocated
+  std::vector<uint8_t *> m_batch_buffers;
+  std::vector<std::size_t> m_batch_sizes;
+  // Packets arriving while the ring is full are received into this buffer and dropped
+  Packet m_drop_packet;
+  std::vector<uint8_t *> m_drop_buffers;
+  std::atomic<bool8_t> m_running{false};
+  std::mutex m_decode_mutex;
+  std::condition_variable m_decode_cv;
+  std::thread m_receive_thread;
+  std::thread m_decode_thread;
+  std::atomic<uint64_t> m_received_packets{0U};
+  std::atomic<uint64_t> m_dropped_packets{0U};
+  std::atomic<uint64_t> m_invalid_packets{0U};
+  std::atomic<std::size_t> m_max_queue_depth{0U};
+  uint64_t m_reported_dropped_packets{0U};
+  rclcpp::TimerBase::SharedPtr m_statistics_timer;
 };  // class VelodyneCloudNode
 
 using VLP16DriverNode = VelodyneCloudNode<velodyne_driver::VLP16Data>;
@@ -0,0 +1,90 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief This file defines a ROS 2 velodyne driver that classifies the points of each packet
+///        into ground and nonground points while a scan is received
+
+#ifndef VELODYNE_NODES__VELODYNE_GROUND_CLASSIFIER_NODE_HPP_
+#define VELODYNE_NODES__VELODYNE_GROUND_CLASSIFIER_NODE_HPP_
+
+#include <string>
+#include <vector>
+#include "common/types.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "ray_ground_classifier/streaming_ray_ground_classifier.hpp"
+#include "sensor_msgs/msg/point_cloud2.hpp"
+#include "udp_driver/udp_driver.hpp"
+#include "velodyne_driver/velodyne_translator.hpp"
+#include "velodyne_nodes/visibility_control.hpp"
+
+namespace autoware
+{
+namespace drivers
+{
+namespace velodyne_nodes
+{
+
+/// Template class for a velodyne driver node which feeds the points of each `packet` received
+/// via UDP straight into a ray ground classifier, and publishes the ground and nonground points
+/// once the end of a scan is received. Compared to a `VelodyneCloudNode` followed by a ray ground
+/// classifier node, most rays are already partitioned while the scan is received, so the
+/// classified point clouds are published right after the last packet of a scan.
+/// \tparam SensorData SensorData implementation for the specific velodyne sensor model.
+template<typename SensorData>
+class VELODYNE_NODES_PUBLIC VelodyneGroundClassifierNode : public rclcpp::Node
+{
+public:
+  using VelodyneTranslatorT = velodyne_driver::VelodyneTranslator<SensorData>;
+  using Config = typename VelodyneTranslatorT::Config;
+  using Packet = typename VelodyneTranslatorT::Packet;
+
+  VelodyneGroundClassifierNode(const std::string & node_name, const rclcpp::NodeOptions & options);
+
+  /// Handle data packet from the udp driver
+  /// \param buffer Data from the udp driver
+  void receiver_callback(const std::vector<uint8_t> & buffer);
+
+private:
+  void init_udp_driver();
+  /// Publish the classified point clouds of the completed scan
+  void publish_scan();
+  /// Drop the current scan, e.g. after an error
+  void reset();
+
+  IoContext m_io_cxt;
+  ::drivers::udp_driver::UdpDriver m_udp_driver;
+  VelodyneTranslatorT m_translator;
+  const std::string m_frame_id;
+  // Maximum number of points of a scan
+  const std::uint32_t m_cloud_size;
+  perception::filters::ray_ground_classifier::StreamingRayGroundClassifier m_classifier;
+  std::vector<autoware::common::types::PointXYZIF> m_point_block;
+
+  std::string m_ip;
+  uint16_t m_port;
+  rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr m_ground_pub_ptr;
+  rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr m_nonground_pub_ptr;
+  sensor_msgs::msg::PointCloud2 m_ground_msg{};
+  sensor_msgs::msg::PointCloud2 m_nonground_msg{};
+};  // class VelodyneGroundClassifierNode
+
+using VLP16GroundClassifierNode = VelodyneGroundClassifierNode<velodyne_driver::VLP16Data>;
+using VLP32CGroundClassifierNode = VelodyneGroundClassifierNode<velodyne_driver::VLP32CData>;
+using VLS128GroundClassifierNode = VelodyneGroundClassifierNode<velodyne_driver::VLS128Data>;
+}  // namespace velodyne_nodes
+}  // namespace drivers
+}  // namespace autoware
+
+#endif  // VELODYNE_NODES__VELODYNE_GROUND_CLASSIFIER_NODE_HPP_
@@ -0,0 +1,107 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "velodyne_nodes/udp_batch_receiver.hpp"
+
+namespace autoware
+{
+namespace drivers
+{
+namespace velodyne_nodes
+{
+
+UdpBatchReceiver::UdpBatchReceiver(
+  const std::string & ip, const uint16_t port, const std::size_t max_batch_size,
+  const std::chrono::milliseconds timeout)
+: m_socket(::socket(AF_INET, SOCK_DGRAM, 0)),
+  m_iovecs(max_batch_size),
+  m_headers(max_batch_size)
+{
+  if (m_socket < 0) {
+    throw std::runtime_error{
+            "UdpBatchReceiver: cannot open socket: " + std::string{strerror(errno)}};
+  }
+  if (max_batch_size == 0U) {
+    (void)::close(m_socket);
+    throw std::domain_error{"UdpBatchReceiver: batch size must be positive"};
+  }
+  // The timeout lets the receiving thread check regularly whether it should stop
+  timeval tv{};
+  tv.tv_sec = static_cast<decltype(tv.tv_sec)>(timeout.count() / 1000);
+  tv.tv_usec = static_cast<decltype(tv.tv_usec)>((timeout.count() % 1000) * 1000);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  if ((::setsockopt(m_socket, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) != 0) ||
+    (::inet_pton(AF_INET, ip.c_str(), &addr.sin_addr) != 1) ||
+    (::bind(m_socket, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0))
+  {
+    const std::string error{strerror(errno)};
+    (void)::close(m_socket);
+    throw std::runtime_error{"UdpBatchReceiver: cannot bind to " + ip + ":" +
+            std::to_string(port) + ": " + error};
+  }
+}
+
+UdpBatchReceiver::~UdpBatchReceiver()
+{
+  (void)::close(m_socket);
+}
+
+std::size_t UdpBatchReceiver::receive(
+  uint8_t * const * buffers, const std::size_t buffer_size, std::size_t * sizes,
+  const std::size_t count)
+{
+  if (count > m_iovecs.size()) {
+    throw std::domain_error{"UdpBatchReceiver: more buffers than the batch size"};
+  }
+  if (count == 0U) {
+    return 0U;
+  }
+  for (std::size_t idx = 0U; idx < count; ++idx) {
+    m_iovecs[idx].iov_base = buffers[idx];
+    m_iovecs[idx].iov_len = buffer_size;
+    m_headers[idx] = mmsghdr{};
+    m_headers[idx].msg_hdr.msg_iov = &m_iovecs[idx];
+    m_headers[idx].msg_hdr.msg_iovlen = 1U;
+  }
+  // Block for the first datagram only, then take whatever else is already queued. MSG_TRUNC
+  // reports the real size of datagrams which do not fit into their buffer.
+  const int received = ::recvmmsg(
+    m_socket, m_headers.data(), static_cast<unsigned int>(count), MSG_WAITFORONE | MSG_TRUNC,
+    nullptr);
+  if (received < 0) {
+    if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)) {
+      return 0U;
+    }
+    throw std::runtime_error{"UdpBatchReceiver: receive failed: " + std::string{strerror(errno)}};
+  }
+  for (int idx = 0; idx < received; ++idx) {
+    sizes[idx] = m_headers[static_cast<std::size_t>(idx)].msg_len;
+  }
+  return static_cast<std::size_t>(received);
+}
+}  // namespace velodyne_nodes
+}  // namespace drivers
+}  // namespace autoware
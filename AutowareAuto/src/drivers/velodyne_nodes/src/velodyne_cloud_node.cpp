@@ -14,6 +14,9 @@
 //
 // Co-developed by Tier IV, Inc. and Apex.AI, Inc.
 
+#include <algorithm>
+#include <cinttypes>
+#include <stdexcept>
 #include <string>
 #include <chrono>
 #include <vector>
@@ -33,6 +36,16 @@ namespace drivers
 {
 namespace velodyne_nodes
 {
+namespace
+{
+std::size_t to_batch_size(const int batch_size)
+{
+  if (batch_size < 0) {
+    throw std::domain_error{"VelodyneCloudNode: ingestion.batch_size must not be negative"};
+  }
+  return static_cast<std::size_t>(batch_size);
+}
+}  // namespace
 
 template<typename T>
 VelodyneCloudNode<T>::VelodyneCloudNode(
@@ -51,17 +64,39 @@ VelodyneCloudNode<T>::VelodyneCloudNode(
   m_point_cloud_idx(0),
   m_frame_id(this->declare_parameter("frame_id").template get<std::string>().c_str()),
   m_cloud_size(static_cast<std::uint32_t>(
-      this->declare_parameter("cloud_size").template get<std::uint32_t>()))
+      this->declare_parameter("cloud_size").template get<std::uint32_t>())),
+  m_batch_size(to_batch_size(this->declare_parameter("ingestion.batch_size", 0)))
 {
   m_point_block.reserve(VelodyneTranslatorT::POINT_BLOCK_CAPACITY);
   // If your preallocated cloud size is too small, the node really won't operate well at all
   if (static_cast<uint32_t>(m_point_block.capacity()) >= m_cloud_size) {
     throw std::runtime_error("VelodyneCloudNode: cloud_size must be > PointBlock::CAPACITY");
   }
+  const auto ring_capacity = this->declare_parameter("ingestion.ring_capacity", 1024);
+  if (ring_capacity < 1) {
+    throw std::domain_error{"VelodyneCloudNode: ingestion.ring_capacity must be positive"};
+  }
 
-
-  init_udp_driver();
   init_output(m_pc2_msg);
+  if (m_batch_size > 0U) {
+    init_batch_ingestion(static_cast<std::size_t>(ring_capacity));
+  } else {
+    init_udp_driver();
+  }
+}
+
+template<typename T>
+VelodyneCloudNode<T>::~VelodyneCloudNode()
+{
+  m_running = false;
+  m_decode_cv.notify_one();
+  // The receiver thread notices within the receive timeout
+  if (m_receive_thread.joinable()) {
+    m_receive_thread.join();
+  }
+  if (m_decode_thread.joinable()) {
+    m_decode_thread.join();
+  }
 }
 
 template<typename T>
@@ -74,11 +109,123 @@ void VelodyneCloudNode<T>::init_udp_driver()
     std::bind(&VelodyneCloudNode<T>::receiver_callback, this, std::placeholders::_1));
 }
 
+template<typename T>
+void VelodyneCloudNode<T>::init_batch_ingestion(const std::size_t ring_capacity)
+{
+  // Wake up regularly to check whether the node is destroyed
+  constexpr std::chrono::milliseconds receive_timeout{100};
+  m_ring = std::make_unique<PacketRing<PacketSlot>>(ring_capacity);
+  m_batch_receiver =
+    std::make_unique<UdpBatchReceiver>(m_ip, m_port, m_batch_size, receive_timeout);
+  m_batch_buffers.resize(m_batch_size);
+  m_batch_sizes.resize(m_batch_size);
+  m_drop_buffers.assign(m_batch_size, reinterpret_cast<uint8_t *>(&m_drop_packet));
+
+  m_running = true;
+  m_receive_thread = std::thread{[this] {receive_packets();}};
+  m_decode_thread = std::thread{[this] {decode_packets();}};
+  m_statistics_timer = this->create_wall_timer(
+    std::chrono::seconds{1}, [this] {check_ingestion_statistics();});
+}
+
+template<typename T>
+void VelodyneCloudNode<T>::receive_packets()
+{
+  while (m_running) {
+    try {
+      const std::size_t count = std::min(m_ring->writable(), m_batch_size);
+      if (count == 0U) {
+        // Keep draining the socket so that the packets received once there is space are recent
+        m_dropped_packets += m_batch_receiver->receive(
+          m_drop_buffers.data(), sizeof(Packet), m_batch_sizes.data(), m_batch_size);
+        continue;
+      }
+      for (std::size_t idx = 0U; idx < count; ++idx) {
+        m_batch_buffers[idx] = reinterpret_cast<uint8_t *>(&m_ring->write_slot(idx).packet);
+      }
+      const std::size_t received = m_batch_receiver->receive(
+        m_batch_buffers.data(), sizeof(Packet), m_batch_sizes.data(), count);
+      if (received > 0U) {
+        for (std::size_t idx = 0U; idx < received; ++idx) {
+          m_ring->write_slot(idx).size = m_batch_sizes[idx];
+        }
+        const std::size_t depth = m_ring->commit(received);
+        m_received_packets += received;
+        if (depth > m_max_queue_depth) {
+          m_max_queue_depth = depth;
+        }
+        m_decode_cv.notify_one();
+      }
+    } catch (const std::exception & e) {
+      RCLCPP_WARN(this->get_logger(), e.what());
+      // And then just continue running
+    }
+  }
+}
+
+template<typename T>
+void VelodyneCloudNode<T>::decode_packets()
+{
+  // Bounds the delay of a lost wakeup, the producer notifies without taking the lock
+  constexpr std::chrono::milliseconds wait_timeout{10};
+  while (m_running) {
+    const std::size_t count = m_ring->readable();
+    if (count == 0U) {
+      std::unique_lock<std::mutex> lock{m_decode_mutex};
+      (void)m_decode_cv.wait_for(
+        lock, wait_timeout, [this] {return !m_running || (m_ring->readable() > 0U);});
+      continue;
+    }
+    for (std::size_t idx = 0U; idx < count; ++idx) {
+      const PacketSlot & slot = m_ring->read_slot(idx);
+      if (slot.size != sizeof(Packet)) {
+        ++m_invalid_packets;
+      } else {
+        handle_packet(slot.packet);
+      }
+    }
+    m_ring->release(count);
+  }
+}
+
+template<typename T>
+IngestionStatistics VelodyneCloudNode<T>::get_ingestion_statistics() const
+{
+  IngestionStatistics statistics;
+  statistics.received_packets = m_received_packets;
+  statistics.dropped_packets = m_dropped_packets;
+  statistics.invalid_packets = m_invalid_packets;
+  statistics.queue_depth = m_ring ? m_ring->readable() : 0U;
+  statistics.max_queue_depth = m_max_queue_depth;
+  return statistics;
+}
+
+template<typename T>
+void VelodyneCloudNode<T>::check_ingestion_statistics()
+{
+  const auto statistics = get_ingestion_statistics();
+  if (statistics.dropped_packets > m_reported_dropped_packets) {
+    RCLCPP_WARN(
+      this->get_logger(),
+      "Dropped %" PRIu64 " of %" PRIu64 " packets, the maximum queue depth is %zu of %zu",
+      statistics.dropped_packets - m_reported_dropped_packets,
+      statistics.received_packets + statistics.dropped_packets,
+      statistics.max_queue_depth, m_ring->capacity());
+    m_reported_dropped_packets = statistics.dropped_packets;
+  }
+}
+
 template<typename T>
 void VelodyneCloudNode<T>::receiver_callback(const std::vector<uint8_t> & buffer)
 {
   Packet pkt{};
   std::memcpy(&pkt, &buffer[0], buffer.size());
+  handle_packet(pkt);
+}
+
+template<typename T>
+void VelodyneCloudNode<T>::handle_packet(const Packet & pkt)
+{
   try {
     // message received, convert and publish
     if (this->convert(pkt, m_pc2_msg)) {
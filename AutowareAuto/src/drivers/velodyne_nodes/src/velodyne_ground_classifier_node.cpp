@@ -0,0 +1,151 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "common/types.hpp"
+#include "point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp"
+#include "velodyne_nodes/velodyne_ground_classifier_node.hpp"
+
+using autoware::common::types::PointXYZI;
+using autoware::common::types::PointXYZIF;
+using autoware::common::types::float32_t;
+
+namespace autoware
+{
+namespace drivers
+{
+namespace velodyne_nodes
+{
+namespace ray_ground_classifier = perception::filters::ray_ground_classifier;
+
+template<typename T>
+VelodyneGroundClassifierNode<T>::VelodyneGroundClassifierNode(
+  const std::string & node_name,
+  const rclcpp::NodeOptions & options)
+: rclcpp::Node(node_name, options),
+  m_io_cxt(),
+  m_udp_driver(m_io_cxt),
+  m_translator(Config{static_cast<float32_t>(this->declare_parameter("rpm").template get<int>())}),
+  m_frame_id(this->declare_parameter("frame_id").template get<std::string>().c_str()),
+  m_cloud_size(static_cast<std::uint32_t>(
+      this->declare_parameter("cloud_size").template get<std::uint32_t>())),
+  m_classifier(
+    ray_ground_classifier::Config{
+          this->declare_parameter("classifier.sensor_height_m").template get<float32_t>(),
+          this->declare_parameter("classifier.max_local_slope_deg").template get<float32_t>(),
+          this->declare_parameter("classifier.max_global_slope_deg").template get<float32_t>(),
+          this->declare_parameter(
+            "classifier.nonground_retro_thresh_deg").template get<float32_t>(),
+          this->declare_parameter("classifier.min_height_thresh_m").template get<float32_t>(),
+          this->declare_parameter(
+            "classifier.max_global_height_thresh_m").template get<float32_t>(),
+          this->declare_parameter(
+            "classifier.max_last_local_ground_thresh_m").template get<float32_t>(),
+          this->declare_parameter(
+            "classifier.max_provisional_ground_distance_m").template get<float32_t>()
+        },
+    ray_ground_classifier::RayAggregator::Config{
+          this->declare_parameter("aggregator.min_ray_angle_rad").template get<float32_t>(),
+          this->declare_parameter("aggregator.max_ray_angle_rad").template get<float32_t>(),
+          this->declare_parameter("aggregator.ray_width_rad").template get<float32_t>(),
+          this->declare_parameter("aggregator.max_ray_points").template get<std::size_t>()
+        },
+    m_cloud_size),
+  m_ip(this->declare_parameter("ip").template get<std::string>().c_str()),
+  m_port(static_cast<uint16_t>(this->declare_parameter("port").template get<uint16_t>())),
+  m_ground_pub_ptr(create_publisher<sensor_msgs::msg::PointCloud2>(
+      "points_ground", rclcpp::QoS{10})),
+  m_nonground_pub_ptr(create_publisher<sensor_msgs::msg::PointCloud2>(
+      "points_nonground", rclcpp::QoS{10}))
+{
+  m_point_block.reserve(VelodyneTranslatorT::POINT_BLOCK_CAPACITY);
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>{
+    m_ground_msg, m_frame_id}.reserve(m_cloud_size);
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>{
+    m_nonground_msg, m_frame_id}.reserve(m_cloud_size);
+
+  init_udp_driver();
+}
+
+template<typename T>
+void VelodyneGroundClassifierNode<T>::init_udp_driver()
+{
+  m_udp_driver.init_receiver(m_ip, m_port);
+  m_udp_driver.receiver()->open();
+  m_udp_driver.receiver()->bind();
+  m_udp_driver.receiver()->asyncReceive(
+    std::bind(&VelodyneGroundClassifierNode<T>::receiver_callback, this, std::placeholders::_1));
+}
+
+template<typename T>
+void VelodyneGroundClassifierNode<T>::receiver_callback(const std::vector<uint8_t> & buffer)
+{
+  Packet pkt{};
+  std::memcpy(&pkt, &buffer[0], buffer.size());
+  try {
+    m_translator.convert(pkt, m_point_block);
+    point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> ground_modifier{m_ground_msg};
+    point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> nonground_modifier{m_nonground_msg};
+    // A packet can hold the end of a scan followed by the first points of the next scan
+    const PointXYZIF * it = m_point_block.data();
+    const PointXYZIF * const last = it + m_point_block.size();
+    while (it != last) {
+      it = m_classifier.insert(it, last, ground_modifier, nonground_modifier);
+      if (m_classifier.is_scan_complete()) {
+        publish_scan();
+        // Start the next scan, the capacity of the messages is kept
+        m_classifier.reset();
+        ground_modifier.clear();
+        nonground_modifier.clear();
+      }
+    }
+  } catch (const std::exception & e) {
+    RCLCPP_WARN(this->get_logger(), e.what());
+    // Drop the scan and then just continue running
+    reset();
+  } catch (...) {
+    // Something really weird happened and I can't handle it here
+    RCLCPP_WARN(
+      this->get_logger(), "Unknown exception occured in VelodyneGroundClassifierNode");
+    throw;
+  }
+}
+
+template<typename T>
+void VelodyneGroundClassifierNode<T>::publish_scan()
+{
+  const auto stamp = this->now();
+  m_ground_msg.header.stamp = stamp;
+  m_nonground_msg.header.stamp = stamp;
+  m_ground_pub_ptr->publish(m_ground_msg);
+  m_nonground_pub_ptr->publish(m_nonground_msg);
+}
+
+template<typename T>
+void VelodyneGroundClassifierNode<T>::reset()
+{
+  m_classifier.reset();
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>{m_ground_msg}.clear();
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>{m_nonground_msg}.clear();
+}
+
+template class VelodyneGroundClassifierNode<velodyne_driver::VLP16Data>;
+template class VelodyneGroundClassifierNode<velodyne_driver::VLP32CData>;
+template class VelodyneGroundClassifierNode<velodyne_driver::VLS128Data>;
+}  // namespace velodyne_nodes
+}  // namespace drivers
+}  // namespace autoware
@@ -0,0 +1,129 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <velodyne_nodes/packet_ring.hpp>
+#include <velodyne_nodes/udp_batch_receiver.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using autoware::drivers::velodyne_nodes::PacketRing;
+using autoware::drivers::velodyne_nodes::UdpBatchReceiver;
+
+TEST(PacketRing, Basic)
+{
+  EXPECT_THROW(PacketRing<uint32_t>{0U}, std::domain_error);
+  PacketRing<uint32_t> ring{5U};
+  ASSERT_EQ(ring.capacity(), 8U);
+  EXPECT_EQ(ring.writable(), 8U);
+  EXPECT_EQ(ring.readable(), 0U);
+  // Wrap around a few times
+  uint32_t value = 0U;
+  for (uint32_t round = 0U; round < 5U; ++round) {
+    for (std::size_t idx = 0U; idx < 6U; ++idx) {
+      ring.write_slot(idx) = value + static_cast<uint32_t>(idx);
+    }
+    EXPECT_EQ(ring.commit(6U), 6U);
+    EXPECT_EQ(ring.writable(), 2U);
+    ASSERT_EQ(ring.readable(), 6U);
+    for (std::size_t idx = 0U; idx < 6U; ++idx) {
+      EXPECT_EQ(ring.read_slot(idx), value + idx);
+    }
+    ring.release(6U);
+    value += 6U;
+    EXPECT_EQ(ring.readable(), 0U);
+    EXPECT_EQ(ring.writable(), 8U);
+  }
+}
+
+// A producer and a consumer thread see all values in order
+TEST(PacketRing, Threads)
+{
+  PacketRing<uint64_t> ring{16U};
+  constexpr uint64_t num_values = 100000U;
+  std::thread producer{[&ring] {
+      uint64_t value = 0U;
+      while (value < num_values) {
+        const std::size_t count = ring.writable();
+        std::size_t idx = 0U;
+        for (; (idx < count) && ((value + idx) < num_values); ++idx) {
+          ring.write_slot(idx) = value + idx;
+        }
+        (void)ring.commit(idx);
+        value += idx;
+        std::this_thread::yield();
+      }
+    }};
+  uint64_t expected = 0U;
+  bool ordered = true;
+  while (expected < num_values) {
+    const std::size_t count = ring.readable();
+    for (std::size_t idx = 0U; idx < count; ++idx) {
+      ordered = ordered && (ring.read_slot(idx) == (expected + idx));
+    }
+    ring.release(count);
+    expected += count;
+    std::this_thread::yield();
+  }
+  producer.join();
+  EXPECT_TRUE(ordered);
+  EXPECT_EQ(expected, num_values);
+}
+
+// Datagrams sent before the call are received in one batch
+TEST(UdpBatchReceiver, Receive)
+{
+  const uint16_t port = 9997U;
+  UdpBatchReceiver receiver{"127.0.0.1", port, 4U, std::chrono::milliseconds{100}};
+  const int sender = ::socket(AF_INET, SOCK_DGRAM, 0);
+  ASSERT_GE(sender, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  ASSERT_EQ(::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr), 1);
+  for (uint8_t idx = 0U; idx < 3U; ++idx) {
+    const std::vector<uint8_t> datagram(10U + idx, idx);
+    ASSERT_EQ(
+      ::sendto(
+        sender, datagram.data(), datagram.size(), 0, reinterpret_cast<const sockaddr *>(&addr),
+        sizeof(addr)),
+      static_cast<ssize_t>(datagram.size()));
+  }
+  (void)::close(sender);
+
+  std::array<std::array<uint8_t, 11U>, 4U> buffers{};
+  std::array<uint8_t *, 4U> buffer_ptrs{};
+  for (std::size_t idx = 0U; idx < buffers.size(); ++idx) {
+    buffer_ptrs[idx] = buffers[idx].data();
+  }
+  std::array<std::size_t, 4U> sizes{};
+  ASSERT_EQ(receiver.receive(buffer_ptrs.data(), 11U, sizes.data(), 4U), 3U);
+  for (uint8_t idx = 0U; idx < 3U; ++idx) {
+    // The last datagram is truncated, but its real size is reported
+    EXPECT_EQ(sizes[idx], 10U + idx);
+    EXPECT_EQ(buffers[idx][0U], idx);
+  }
+  // Nothing left, times out
+  EXPECT_EQ(receiver.receive(buffer_ptrs.data(), 11U, sizes.data(), 4U), 0U);
+  EXPECT_THROW(receiver.receive(buffer_ptrs.data(), 11U, sizes.data(), 5U), std::domain_error);
+}
@@ -17,6 +17,7 @@
 #include <common/types.hpp>
 #include <gtest/gtest.h>
 #include <velodyne_nodes/velodyne_cloud_node.hpp>
+#include <velodyne_nodes/velodyne_ground_classifier_node.hpp>
 #include <lidar_integration/lidar_integration.hpp>
 #include <lidar_integration/udp_sender.hpp>
 #include <memory>
@@ -52,6 +53,18 @@ TEST(VelodyneNode, Constructor)
   }
   EXPECT_NO_THROW(VelodyneCloudNode(name, velodyne_options));
 
+  auto batch_params = velodyne_params;
+  batch_params.emplace_back("ingestion.batch_size", -1);
+  EXPECT_THROW(
+    VelodyneCloudNode(name, rclcpp::NodeOptions{}.parameter_overrides(batch_params)),
+    std::domain_error
+  );
+  batch_params.back() = rclcpp::Parameter{"ingestion.ring_capacity", 0};
+  EXPECT_THROW(
+    VelodyneCloudNode(name, rclcpp::NodeOptions{}.parameter_overrides(batch_params)),
+    std::domain_error
+  );
+
   velodyne_params.pop_back();
   velodyne_options.parameter_overrides(velodyne_params);
   EXPECT_THROW(
@@ -62,12 +75,55 @@ TEST(VelodyneNode, Constructor)
   rclcpp::shutdown();
 }
 
+TEST(VelodyneGroundClassifierNode, Constructor)
+{
+  rclcpp::init(0, nullptr);
+
+  const auto name = "test_node";
+
+  std::vector<rclcpp::Parameter> velodyne_params;
+  velodyne_params.emplace_back("ip", "127.0.0.1");
+  velodyne_params.emplace_back("port", 9998);
+  velodyne_params.emplace_back("frame_id", "base_link");
+  velodyne_params.emplace_back("cloud_size", 10000);
+  velodyne_params.emplace_back("classifier.sensor_height_m", 0.368);
+  velodyne_params.emplace_back("classifier.max_local_slope_deg", 20.0);
+  velodyne_params.emplace_back("classifier.max_global_slope_deg", 7.0);
+  velodyne_params.emplace_back("classifier.nonground_retro_thresh_deg", 70.0);
+  velodyne_params.emplace_back("classifier.min_height_thresh_m", 0.05);
+  velodyne_params.emplace_back("classifier.max_global_height_thresh_m", 0.3);
+  velodyne_params.emplace_back("classifier.max_last_local_ground_thresh_m", 0.6);
+  velodyne_params.emplace_back("classifier.max_provisional_ground_distance_m", 5.0);
+  velodyne_params.emplace_back("aggregator.min_ray_angle_rad", -3.14159);
+  velodyne_params.emplace_back("aggregator.max_ray_angle_rad", 3.14159);
+  velodyne_params.emplace_back("aggregator.ray_width_rad", 0.01);
+  velodyne_params.emplace_back("aggregator.max_ray_points", 16);
+  velodyne_params.emplace_back("rpm", 600);
+  rclcpp::NodeOptions velodyne_options = rclcpp::NodeOptions();
+  velodyne_options.parameter_overrides(velodyne_params);
+
+  using VelodyneGroundClassifierNode =
+    autoware::drivers::velodyne_nodes::VLP16GroundClassifierNode;
+  EXPECT_NO_THROW(VelodyneGroundClassifierNode(name, velodyne_options));
+
+  velodyne_params.pop_back();
+  velodyne_options.parameter_overrides(velodyne_params);
+  EXPECT_THROW(
+    VelodyneGroundClassifierNode(name, velodyne_options),
+    std::runtime_error
+  );
+
+  rclcpp::shutdown();
+}
+
 struct VelodyneNodeTestParam
 {
   uint32_t reserved_size;
   uint32_t expected_size;
   float32_t expected_period_ms;
   bool8_t is_cloud;
+  // Packets received per recvmmsg call, zero for one packet per callback
+  int64_t batch_size;
 };  // VelodyneNodeTestParam
 
 class VelodyneNodeIntegration : public ::testing::TestWithParam<VelodyneNodeTestParam>
@@ -95,6 +151,7 @@ TEST_P(VelodyneNodeIntegration, Test)
   velodyne_params.emplace_back("cloud_size", static_cast<int64_t>(param.reserved_size));
   velodyne_params.emplace_back("rpm", static_cast<int>(config.get_rpm()));
   velodyne_params.emplace_back("topic", topic);
+  velodyne_params.emplace_back("ingestion.batch_size", param.batch_size);
   rclcpp::NodeOptions velodyne_options = rclcpp::NodeOptions();
   velodyne_options.parameter_overrides(velodyne_params);
 
@@ -148,16 +205,26 @@ TEST_P(VelodyneNodeIntegration, Test)
   if (velodyne_node_thread.joinable()) {
     velodyne_node_thread.join();
   }
+
+  if (param.batch_size > 0) {
+    EXPECT_GT(nd_ptr->get_ingestion_statistics().received_packets, 0U);
+  }
 }
 
 INSTANTIATE_TEST_CASE_P(
   Cloud,
   VelodyneNodeIntegration,
   // cppcheck-suppress syntaxError
-  ::testing::Values(VelodyneNodeTestParam{55000U, 30000U, 100.0F, true}), );
+  ::testing::Values(VelodyneNodeTestParam{55000U, 30000U, 100.0F, true, 0}), );
 
 INSTANTIATE_TEST_CASE_P(
   HalfCloud,
   VelodyneNodeIntegration,
   // cppcheck-suppress syntaxError
-  ::testing::Values(VelodyneNodeTestParam{10700U, 10700U, 50.0F, true}), );
+  ::testing::Values(VelodyneNodeTestParam{10700U, 10700U, 50.0F, true, 0}), );
+
+INSTANTIATE_TEST_CASE_P(
+  BatchedCloud,
+  VelodyneNodeIntegration,
+  // cppcheck-suppress syntaxError
+  ::testing::Values(VelodyneNodeTestParam{55000U, 30000U, 100.0F, true, 16}), );
@@ -0,0 +1,144 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+/// \copyright Copyright 2021 the Autoware Foundation
+/// \file
+/// \brief Header for a sparse Jonker-Volgenant solver for optimal linear assignment
+#ifndef HUNGARIAN_ASSIGNER__JV_ASSIGNER_HPP_
+#define HUNGARIAN_ASSIGNER__JV_ASSIGNER_HPP_
+
+#include <hungarian_assigner/visibility_control.hpp>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "common/types.hpp"
+
+namespace autoware
+{
+namespace fusion
+{
+namespace hungarian_assigner
+{
+
+/// \brief implementation of the shortest augmenting path algorithm of Jonker and Volgenant for
+/// the minimum weight assignment problem on sparse weights. Only the weights which were set are
+/// stored and visited, so that the memory is O(rows + cols + weights) instead of O(Capacity^2),
+/// and each row is assigned by a Dijkstra search over the weights reachable from it. Each row
+/// may also stay unassigned at a cost of MAX_WEIGHT, so that the matrix can have any shape and
+/// rows without any weight do not fail the assignment of the other rows.
+/// Has the same interface as hungarian_assigner_c, but the capacity is set on construction.
+class HUNGARIAN_ASSIGNER_PUBLIC jv_assigner_c
+{
+public:
+  using float32_t = autoware::common::types::float32_t;
+  using float64_t = autoware::common::types::float64_t;
+  using bool8_t = autoware::common::types::bool8_t;
+  /// \brief same as the index of hungarian_assigner_c
+  using index_t = std::ptrdiff_t;
+
+  /// \brief This index denotes a worker for which no job assignment was possible
+  static constexpr index_t UNASSIGNED = std::numeric_limits<index_t>::max();
+  /// \brief weights must be smaller than this, it is also the cost of leaving a row unassigned
+  static constexpr float32_t MAX_WEIGHT = 10000.F;
+  /// \brief number of weights per row for which memory is reserved on construction
+  static constexpr std::size_t RESERVED_WEIGHTS_PER_ROW = 16U;
+
+  /// \brief constructor, reserves the memory for the given capacity
+  /// \param[in] max_num_rows maximum number of rows/jobs
+  /// \param[in] max_num_cols maximum number of columns/workers
+  jv_assigner_c(const index_t max_num_rows, const index_t max_num_cols);
+
+  /// \brief set the size of the matrix. Must be less than capacity. This should be done before
+  ///        set_weight() calls
+  /// \param[in] num_rows number of rows/jobs
+  /// \param[in] num_cols number of columns/workers
+  /// \throw std::length_error if num_rows or num_cols is bigger than capacity
+  void set_size(const index_t num_rows, const index_t num_cols);
+
+  /// \brief set weight. Weights which are not set are impossible assignments. If a weight is set
+  ///        several times for the same index pair, the lowest one is used
+  /// \param[in] weight the weight for assignment of job idx to worker jdx
+  /// \param[in] idx the index of the job
+  /// \param[in] jdx the index of the worker
+  /// \throw std::out_of_range if idx or jdx are outside of range specified by set_size(), or if
+  ///        weight is not in [0, MAX_WEIGHT)
+  void set_weight(const float32_t weight, const index_t idx, const index_t jdx);
+
+  /// \brief reset weights and size, must be called after assign(), and before set_weight()
+  void reset();
+
+  /// \brief reset and set_size, equivalent to reset(); set_size(num_rows, num_cols);
+  /// \param[in] num_rows number of rows/jobs
+  /// \param[in] num_cols number of columns/workers
+  void reset(const index_t num_rows, const index_t num_cols);
+
+  /// \brief compute minimum cost assignment, where each unassigned row costs MAX_WEIGHT
+  /// \return true if every row/job was assigned a worker/column, false if some rows are
+  ///         UNASSIGNED
+  bool8_t assign();
+
+  /// \brief dictate what the assignment for a given row/task is, should be called after assign().
+  /// \param[in] idx the index for the task, starting at 0
+  /// \return the index for the assigned job, starting at 0, or UNASSIGNED
+  /// \throw std::range_error if idx is out of bounds
+  index_t get_assignment(const index_t idx) const;
+
+  /// \brief says what workers/columns have not been assigned a job, should be called after
+  ///        assign()
+  /// \param[in] idx the i'th unassigned column, starting at 0
+  /// \return the index of the i'th unassigned column
+  /// \throw std::range_error if idx is out of bounds (i.e. there are no more unassigned columns)
+  index_t get_unassigned(const index_t idx) const;
+
+private:
+  /// \brief assign the given free row by a Dijkstra search for the closest free column
+  HUNGARIAN_ASSIGNER_LOCAL void augment(const index_t row);
+
+  /// \brief lower the tentative distance of a column, if that is shorter
+  HUNGARIAN_ASSIGNER_LOCAL void relax(
+    const index_t col, const float64_t dist, const index_t from_row);
+
+  index_t m_max_num_rows;
+  index_t m_max_num_cols;
+  index_t m_num_rows;
+  index_t m_num_cols;
+  // Weights as set, sorted into m_row_start/m_cols/m_weights by row in assign()
+  std::vector<std::pair<index_t, index_t>> m_links;
+  std::vector<float32_t> m_link_weights;
+  // Compressed sparse rows: the weights of row i are in [m_row_start[i], m_row_start[i + 1])
+  std::vector<std::size_t> m_row_start;
+  std::vector<index_t> m_cols;
+  std::vector<float32_t> m_weights;
+  // Columns num_cols + i is the column for leaving row i unassigned, at a cost of MAX_WEIGHT
+  std::vector<index_t> m_row_to_col;
+  std::vector<index_t> m_col_to_row;
+  // Dual variables of the rows and columns, reduced weights w - u - v are never negative
+  std::vector<float64_t> m_row_potential;
+  std::vector<float64_t> m_col_potential;
+  // Book-keeping of the Dijkstra search, only touched columns are reset
+  std::vector<float64_t> m_col_dist;
+  std::vector<index_t> m_col_pred;
+  std::vector<bool8_t> m_col_done;
+  std::vector<index_t> m_touched_cols;
+  std::vector<index_t> m_done_cols;
+  std::vector<std::pair<float64_t, index_t>> m_heap;
+  std::vector<index_t> m_unassigned_cols;
+};  // class jv_assigner_c
+
+}  // namespace hungarian_assigner
+}  // namespace fusion
+}  // namespace autoware
+#endif  // HUNGARIAN_ASSIGNER__JV_ASSIGNER_HPP_
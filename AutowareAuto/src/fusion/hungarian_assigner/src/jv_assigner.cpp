@@ -0,0 +1,288 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+/// \copyright Copyright 2021 the Autoware Foundation
+/// \file
+/// \brief source file for a sparse Jonker-Volgenant solver for optimal linear assignment
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include "hungarian_assigner/jv_assigner.hpp"
+
+namespace autoware
+{
+namespace fusion
+{
+namespace hungarian_assigner
+{
+
+constexpr jv_assigner_c::index_t jv_assigner_c::UNASSIGNED;
+constexpr jv_assigner_c::float32_t jv_assigner_c::MAX_WEIGHT;
+constexpr std::size_t jv_assigner_c::RESERVED_WEIGHTS_PER_ROW;
+
+namespace
+{
+constexpr jv_assigner_c::float64_t INF = std::numeric_limits<jv_assigner_c::float64_t>::max();
+}  // namespace
+
+///
+jv_assigner_c::jv_assigner_c(const index_t max_num_rows, const index_t max_num_cols)
+: m_max_num_rows(max_num_rows),
+  m_max_num_cols(max_num_cols),
+  m_num_rows(),
+  m_num_cols()
+{
+  if ((max_num_rows < index_t()) || (max_num_cols < index_t())) {
+    throw std::domain_error("Capacity of jv assigner must not be negative");
+  }
+  const auto num_rows = static_cast<std::size_t>(max_num_rows);
+  // each row has a column for leaving it unassigned
+  const auto num_cols = static_cast<std::size_t>(max_num_cols) + num_rows;
+  const auto num_links = num_rows * RESERVED_WEIGHTS_PER_ROW;
+  m_links.reserve(num_links);
+  m_link_weights.reserve(num_links);
+  m_row_start.reserve(num_rows + 1U);
+  m_cols.reserve(num_links);
+  m_weights.reserve(num_links);
+  m_row_to_col.reserve(num_rows);
+  m_col_to_row.reserve(num_cols);
+  m_row_potential.reserve(num_rows);
+  m_col_potential.reserve(num_cols);
+  m_col_dist.reserve(num_cols);
+  m_col_pred.reserve(num_cols);
+  m_col_done.reserve(num_cols);
+  m_touched_cols.reserve(num_cols);
+  m_done_cols.reserve(num_cols);
+  m_heap.reserve(num_links + num_rows);
+  m_unassigned_cols.reserve(static_cast<std::size_t>(max_num_cols));
+}
+
+///
+void jv_assigner_c::set_size(const index_t num_rows, const index_t num_cols)
+{
+  if ((num_rows > m_max_num_rows) || (num_cols > m_max_num_cols)) {
+    throw std::length_error("Cannot make jv assigner bigger than capacity");
+  }
+  m_num_rows = num_rows;
+  m_num_cols = num_cols;
+  m_row_to_col.assign(static_cast<std::size_t>(num_rows), UNASSIGNED);
+  m_unassigned_cols.clear();
+}
+
+///
+void jv_assigner_c::set_weight(const float32_t weight, const index_t idx, const index_t jdx)
+{
+  if ((idx >= m_num_rows) || (jdx >= m_num_cols) || (idx < index_t()) || (jdx < index_t())) {
+    throw std::out_of_range("Cannot set weight outside of range");
+  }
+  // also catches NaN
+  if (!((weight >= 0.0F) && (weight < MAX_WEIGHT))) {
+    throw std::out_of_range("Weight must be in [0, MAX_WEIGHT)");
+  }
+  m_links.emplace_back(idx, jdx);
+  m_link_weights.push_back(weight);
+}
+
+///
+void jv_assigner_c::reset()
+{
+  m_links.clear();
+  m_link_weights.clear();
+  m_num_rows = index_t();
+  m_num_cols = index_t();
+  m_row_to_col.clear();
+  m_unassigned_cols.clear();
+}
+
+///
+void jv_assigner_c::reset(const index_t num_rows, const index_t num_cols)
+{
+  reset();
+  set_size(num_rows, num_cols);
+}
+
+///
+jv_assigner_c::bool8_t jv_assigner_c::assign()
+{
+  const auto num_rows = static_cast<std::size_t>(m_num_rows);
+  const auto num_cols = static_cast<std::size_t>(m_num_cols) + num_rows;
+  // Sort the weights by row with a counting sort
+  m_row_start.assign(num_rows + 1U, 0U);
+  for (const auto & link : m_links) {
+    ++m_row_start[static_cast<std::size_t>(link.first) + 1U];
+  }
+  for (std::size_t idx = 0U; idx < num_rows; ++idx) {
+    m_row_start[idx + 1U] += m_row_start[idx];
+  }
+  m_cols.resize(m_links.size());
+  m_weights.resize(m_links.size());
+  for (std::size_t idx = 0U; idx < m_links.size(); ++idx) {
+    // m_row_start[row] is used as the insertion point, and ends up at the start of the next row
+    auto & pos = m_row_start[static_cast<std::size_t>(m_links[idx].first)];
+    m_cols[pos] = m_links[idx].second;
+    m_weights[pos] = m_link_weights[idx];
+    ++pos;
+  }
+  std::rotate(m_row_start.rbegin(), m_row_start.rbegin() + 1, m_row_start.rend());
+  m_row_start[0U] = 0U;
+
+  m_row_to_col.assign(num_rows, UNASSIGNED);
+  m_col_to_row.assign(num_cols, UNASSIGNED);
+  m_row_potential.assign(num_rows, 0.0);
+  m_col_potential.assign(num_cols, 0.0);
+  m_col_dist.assign(num_cols, INF);
+  m_col_pred.assign(num_cols, UNASSIGNED);
+  m_col_done.assign(num_cols, false);
+  for (index_t row = index_t(); row < m_num_rows; ++row) {
+    augment(row);
+  }
+
+  bool8_t ret = true;
+  for (const auto col : m_row_to_col) {
+    ret = (col < m_num_cols) && ret;
+  }
+  m_unassigned_cols.clear();
+  for (index_t col = index_t(); col < m_num_cols; ++col) {
+    if (m_col_to_row[static_cast<std::size_t>(col)] == UNASSIGNED) {
+      m_unassigned_cols.push_back(col);
+    }
+  }
+  return ret;
+}
+
+///
+jv_assigner_c::index_t jv_assigner_c::get_assignment(const index_t idx) const
+{
+  if ((idx >= m_num_rows) || (idx < index_t())) {
+    throw std::range_error("Querying out of bounds assignment index");
+  }
+  const auto ret = m_row_to_col[static_cast<std::size_t>(idx)];
+  return (ret < m_num_cols) ? ret : UNASSIGNED;
+}
+
+///
+jv_assigner_c::index_t jv_assigner_c::get_unassigned(const index_t idx) const
+{
+  if ((idx >= static_cast<index_t>(m_unassigned_cols.size())) || (idx < index_t())) {
+    throw std::range_error("Querying out of bounds assignment index");
+  }
+  return m_unassigned_cols[static_cast<std::size_t>(idx)];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private methods
+////////////////////////////////////////////////////////////////////////////////
+void jv_assigner_c::augment(const index_t row)
+{
+  // Distances are reduced weights relative to the potential of the row they were reached from,
+  // which are not negative except for the weights of the start row, which are only used first
+  const auto scan_row = [this](const index_t from_row, const float64_t from_dist) {
+      const auto from = static_cast<std::size_t>(from_row);
+      const float64_t base = from_dist - m_row_potential[from];
+      for (std::size_t link = m_row_start[from]; link < m_row_start[from + 1U]; ++link) {
+        const auto col = m_cols[link];
+        relax(
+          col, base + static_cast<float64_t>(m_weights[link]) -
+          m_col_potential[static_cast<std::size_t>(col)], from_row);
+      }
+      const auto unassigned_col = m_num_cols + from_row;
+      relax(
+        unassigned_col, base + static_cast<float64_t>(MAX_WEIGHT) -
+        m_col_potential[static_cast<std::size_t>(unassigned_col)], from_row);
+    };
+
+  m_heap.clear();
+  m_touched_cols.clear();
+  m_done_cols.clear();
+  // Start with a potential of 0 for the free row, its potential is set once it is assigned
+  m_row_potential[static_cast<std::size_t>(row)] = 0.0;
+  scan_row(row, 0.0);
+  // The column for leaving the row unassigned is free, so a free column is always found
+  index_t free_col = UNASSIGNED;
+  float64_t free_dist = 0.0;
+  while (!m_heap.empty()) {
+    std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<std::pair<float64_t, index_t>>());
+    const auto entry = m_heap.back();
+    m_heap.pop_back();
+    const auto col = static_cast<std::size_t>(entry.second);
+    if (m_col_done[col] || (entry.first > m_col_dist[col])) {
+      continue;  // outdated entry
+    }
+    m_col_done[col] = true;
+    if (m_col_to_row[col] == UNASSIGNED) {
+      free_col = entry.second;
+      free_dist = entry.first;
+      break;
+    }
+    m_done_cols.push_back(entry.second);
+    scan_row(m_col_to_row[col], entry.first);
+  }
+  if (free_col == UNASSIGNED) {
+    // should never hit
+    throw std::runtime_error("Guaranteed to find a free column!");
+  }
+
+  // Update the potentials so that the reduced weights stay nonnegative and the weights along the
+  // shortest path become 0
+  for (const auto col : m_done_cols) {
+    const auto col_idx = static_cast<std::size_t>(col);
+    const float64_t delta = free_dist - m_col_dist[col_idx];
+    m_col_potential[col_idx] -= delta;
+    m_row_potential[static_cast<std::size_t>(m_col_to_row[col_idx])] += delta;
+  }
+  m_row_potential[static_cast<std::size_t>(row)] += free_dist;
+
+  // Flip the assignments along the path
+  index_t col = free_col;
+  for (index_t idx = index_t(); idx <= m_num_rows; ++idx) {
+    const auto path_row = m_col_pred[static_cast<std::size_t>(col)];
+    const auto next_col = m_row_to_col[static_cast<std::size_t>(path_row)];
+    m_row_to_col[static_cast<std::size_t>(path_row)] = col;
+    m_col_to_row[static_cast<std::size_t>(col)] = path_row;
+    if (path_row == row) {
+      break;
+    }
+    col = next_col;
+  }
+
+  for (const auto touched : m_touched_cols) {
+    const auto col_idx = static_cast<std::size_t>(touched);
+    m_col_dist[col_idx] = INF;
+    m_col_pred[col_idx] = UNASSIGNED;
+    m_col_done[col_idx] = false;
+  }
+}
+
+///
+void jv_assigner_c::relax(const index_t col, const float64_t dist, const index_t from_row)
+{
+  const auto col_idx = static_cast<std::size_t>(col);
+  if ((!m_col_done[col_idx]) && (dist < m_col_dist[col_idx])) {
+    if (m_col_dist[col_idx] == INF) {
+      m_touched_cols.push_back(col);
+    }
+    m_col_dist[col_idx] = dist;
+    m_col_pred[col_idx] = from_row;
+    m_heap.emplace_back(dist, col);
+    std::push_heap(m_heap.begin(), m_heap.end(), std::greater<std::pair<float64_t, index_t>>());
+  }
+}
+
+}  // namespace hungarian_assigner
+}  // namespace fusion
+}  // namespace autoware
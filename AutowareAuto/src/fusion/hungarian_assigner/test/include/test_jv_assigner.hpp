@@ -0,0 +1,177 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TEST_JV_ASSIGNER_HPP_
+#define TEST_JV_ASSIGNER_HPP_
+
+#include <hungarian_assigner/jv_assigner.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "common/types.hpp"
+
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using autoware::fusion::hungarian_assigner::jv_assigner_c;
+
+// Smallest total weight by brute force, where weights < 0 are impossible assignments and each
+// unassigned row costs MAX_WEIGHT
+float64_t brute_force_cost(
+  const std::vector<std::vector<float32_t>> & weights, const std::size_t row,
+  std::vector<bool> & col_taken)
+{
+  if (row == weights.size()) {
+    return 0.0;
+  }
+  float64_t best = static_cast<float64_t>(jv_assigner_c::MAX_WEIGHT) +
+    brute_force_cost(weights, row + 1U, col_taken);
+  for (std::size_t col = 0U; col < col_taken.size(); ++col) {
+    if ((!col_taken[col]) && (weights[row][col] >= 0.0F)) {
+      col_taken[col] = true;
+      best = std::min(
+        best,
+        static_cast<float64_t>(weights[row][col]) + brute_force_cost(weights, row + 1U, col_taken));
+      col_taken[col] = false;
+    }
+  }
+  return best;
+}
+
+// absolutely minimal example, same as for the hungarian assigner
+TEST(JvAssigner, Minimal)
+{
+  jv_assigner_c assign{16, 16};
+  ASSERT_THROW(assign.set_size(15, 17), std::length_error);
+  assign.set_size(3U, 3U);
+  ASSERT_THROW(assign.set_weight(1.0F, 3U, 0U), std::out_of_range);
+  ASSERT_THROW(assign.set_weight(jv_assigner_c::MAX_WEIGHT, 0U, 0U), std::out_of_range);
+  for (auto iteration = 0U; iteration < 2U; ++iteration) {
+    assign.set_weight(1.0F, 0U, 1U);
+    assign.set_weight(1.0F, 1U, 2U);
+    assign.set_weight(1.0F, 2U, 0U);
+    ASSERT_TRUE(assign.assign());
+    EXPECT_EQ(assign.get_assignment(0U), 1U);
+    EXPECT_EQ(assign.get_assignment(1U), 2U);
+    EXPECT_EQ(assign.get_assignment(2U), 0U);
+    EXPECT_THROW(assign.get_unassigned(0U), std::range_error);
+    ASSERT_NO_THROW(assign.reset());
+    EXPECT_THROW(assign.get_assignment(0U), std::range_error);
+    assign.set_size(3U, 3U);
+  }
+}
+
+// Rows can outnumber columns, and rows without weights stay unassigned
+TEST(JvAssigner, Tall)
+{
+  jv_assigner_c assign{4, 4};
+  assign.set_size(4U, 2U);
+  assign.set_weight(1.0F, 0U, 0U);
+  assign.set_weight(2.0F, 1U, 0U);
+  assign.set_weight(5.0F, 1U, 1U);
+  assign.set_weight(1.0F, 2U, 1U);
+  EXPECT_FALSE(assign.assign());
+  EXPECT_EQ(assign.get_assignment(0U), 0U);
+  EXPECT_EQ(assign.get_assignment(1U), jv_assigner_c::UNASSIGNED);
+  EXPECT_EQ(assign.get_assignment(2U), 1U);
+  EXPECT_EQ(assign.get_assignment(3U), jv_assigner_c::UNASSIGNED);
+  EXPECT_THROW(assign.get_unassigned(0U), std::range_error);
+  // A longer augmenting path: row 0 gives up column 0 for row 1
+  assign.reset(2U, 3U);
+  assign.set_weight(1.0F, 0U, 0U);
+  assign.set_weight(2.0F, 0U, 2U);
+  assign.set_weight(1.0F, 1U, 0U);
+  EXPECT_TRUE(assign.assign());
+  EXPECT_EQ(assign.get_assignment(0U), 2U);
+  EXPECT_EQ(assign.get_assignment(1U), 0U);
+  EXPECT_EQ(assign.get_unassigned(0U), 1U);
+  EXPECT_THROW(assign.get_unassigned(1U), std::range_error);
+}
+
+// The total weight is optimal for random sparse problems of any shape
+TEST(JvAssigner, SameAsBruteForce)
+{
+  std::mt19937 gen{1234U};
+  std::uniform_real_distribution<float32_t> weight_dist{0.0F, 10.0F};
+  std::bernoulli_distribution link_dist{0.5};
+  jv_assigner_c assign{7, 7};
+  for (auto iteration = 0U; iteration < 500U; ++iteration) {
+    const std::size_t num_rows = 1U + (iteration % 6U);
+    const std::size_t num_cols = 1U + ((iteration / 6U) % 7U);
+    std::vector<std::vector<float32_t>> weights(num_rows, std::vector<float32_t>(num_cols, -1.0F));
+    assign.reset(static_cast<int64_t>(num_rows), static_cast<int64_t>(num_cols));
+    for (std::size_t row = 0U; row < num_rows; ++row) {
+      for (std::size_t col = 0U; col < num_cols; ++col) {
+        if (link_dist(gen)) {
+          // Integral weights give ties
+          weights[row][col] = std::floor(weight_dist(gen));
+          assign.set_weight(
+            weights[row][col], static_cast<int64_t>(row), static_cast<int64_t>(col));
+        }
+      }
+    }
+    const auto all_assigned = assign.assign();
+
+    std::vector<bool> col_taken(num_cols, false);
+    const float64_t expected_cost = brute_force_cost(weights, 0U, col_taken);
+    float64_t cost = 0.0;
+    bool all_assigned_expected = true;
+    std::vector<bool> col_used(num_cols, false);
+    for (std::size_t row = 0U; row < num_rows; ++row) {
+      const auto col = assign.get_assignment(static_cast<int64_t>(row));
+      if (col == jv_assigner_c::UNASSIGNED) {
+        cost += static_cast<float64_t>(jv_assigner_c::MAX_WEIGHT);
+        all_assigned_expected = false;
+      } else {
+        ASSERT_LT(col, static_cast<int64_t>(num_cols));
+        ASSERT_GE(weights[row][static_cast<std::size_t>(col)], 0.0F);
+        ASSERT_FALSE(col_used[static_cast<std::size_t>(col)]);
+        col_used[static_cast<std::size_t>(col)] = true;
+        cost += static_cast<float64_t>(weights[row][static_cast<std::size_t>(col)]);
+      }
+    }
+    EXPECT_NEAR(cost, expected_cost, 1.0e-6) << iteration;
+    EXPECT_EQ(all_assigned, all_assigned_expected);
+    const auto num_unassigned = static_cast<std::size_t>(
+      std::count(col_used.begin(), col_used.end(), false));
+    for (std::size_t idx = 0U; idx < num_unassigned; ++idx) {
+      EXPECT_FALSE(col_used[static_cast<std::size_t>(assign.get_unassigned(
+          static_cast<int64_t>(idx)))]);
+    }
+    EXPECT_THROW(
+      assign.get_unassigned(static_cast<int64_t>(num_unassigned)), std::range_error);
+  }
+}
+
+// Thousands of rows with a few gated weights each
+TEST(JvAssigner, Large)
+{
+  constexpr int64_t N = 4000;
+  jv_assigner_c assign{N, N};
+  assign.set_size(N, N);
+  // Each row prefers its own column, but its neighbors are almost as good
+  for (int64_t row = 0; row < N; ++row) {
+    for (int64_t col = std::max(row - 2, int64_t{0}); col <= std::min(row + 2, N - 1); ++col) {
+      assign.set_weight(
+        (row == col) ? 1.0F : 1.5F + (0.01F * static_cast<float32_t>(col - row)), row, col);
+    }
+  }
+  ASSERT_TRUE(assign.assign());
+  for (int64_t row = 0; row < N; ++row) {
+    EXPECT_EQ(assign.get_assignment(row), row);
+  }
+}
+
+#endif  // TEST_JV_ASSIGNER_HPP_
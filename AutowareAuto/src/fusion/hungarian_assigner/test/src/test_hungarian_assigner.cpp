@@ -15,6 +15,7 @@
 // Co-developed by Tier IV, Inc. and Apex.AI, Inc.
 #include "gtest/gtest.h"
 #include "test_hungarian_assigner.hpp"
+#include "test_jv_assigner.hpp"
 
 int32_t main(int32_t argc, char ** argv)
 {
@@ -18,6 +18,7 @@
 #define NDT__CONSTRAINTS_HPP_
 
 #include <helper_functions/template_utils.hpp>
+#include <iterator>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -68,14 +69,15 @@ struct P2DNDTOptimizationMapConstraint
 {
   /// \brief The map type should expose the voxel type.
   using Voxel = typename MapT::Voxel;
-  using VoxelViewVector = std::vector<VoxelView<Voxel>>;
   using Point = Eigen::Vector3d;
 
 
   /// \brief  This expression requires a method that looks up the cells at the given location.
-  /// \return Map frame ID.
+  /// The result can be any range of voxel views, such as a vector or a VoxelViewSpan.
+  /// \return The first cell of the result.
   template<typename Map>
-  using call_cell = decltype(std::declval<Map>().cell(std::declval<const Point &>()));
+  using call_cell =
+    decltype(*std::begin(std::declval<Map>().cell(std::declval<const Point &>())));
 
   /// \brief  This expression requires a method that returns the (std::chrono) timestamp of the
   /// \return Map frame ID.
@@ -84,7 +86,7 @@ struct P2DNDTOptimizationMapConstraint
 
   static_assert(
     common::helper_functions::expression_valid_with_return<call_cell, MapT,
-    const VoxelViewVector &>::value,
+    const VoxelView<Voxel> &>::value,
     "The map should provide a `cell(...)` method");
 
   static_assert(
@@ -19,6 +19,8 @@
 
 #include <ndt/ndt_common.hpp>
 #include <voxel_grid/config.hpp>
+#include <helper_functions/worker_pool.hpp>
+#include <memory>
 #include <utility>
 
 namespace autoware
@@ -54,18 +56,36 @@ private:
 class NDT_PUBLIC P2DNDTOptimizationConfig
 {
 public:
+  using WorkerPool = common::helper_functions::WorkerPool;
+
   /// Constructor
   /// \param outlier_ratio Outlier ratio to be used in the gaussian distribution variation used
   /// in (eq. 6.7) [Magnusson 2009]
-  explicit P2DNDTOptimizationConfig(Real outlier_ratio)
-  : m_outlier_ratio{outlier_ratio} {}
+  /// \param num_threads Number of threads evaluating the optimization problem, including the
+  /// calling thread. 0 and 1 evaluate on the calling thread only. The threads are owned by this
+  /// config and shared by its copies, so problems using copies of the same config must not be
+  /// evaluated concurrently.
+  explicit P2DNDTOptimizationConfig(Real outlier_ratio, std::size_t num_threads = 0U)
+  : m_outlier_ratio{outlier_ratio},
+    m_num_threads{num_threads},
+    m_worker_pool{(num_threads > 1U) ? std::make_shared<WorkerPool>(num_threads) : nullptr} {}
 
   /// Get outlier ratio.
   /// \return outlier ratio.
   Real outlier_ratio() const noexcept {return m_outlier_ratio;}
 
+  /// Get the number of threads.
+  /// \return number of threads.
+  std::size_t num_threads() const noexcept {return m_num_threads;}
+
+  /// Get the worker pool evaluating the optimization problem.
+  /// \return worker pool, or nullptr if the problem is evaluated on the calling thread only.
+  const std::shared_ptr<WorkerPool> & worker_pool() const noexcept {return m_worker_pool;}
+
 private:
   Real m_outlier_ratio;
+  std::size_t m_num_threads;
+  std::shared_ptr<WorkerPool> m_worker_pool;
 };
 
 
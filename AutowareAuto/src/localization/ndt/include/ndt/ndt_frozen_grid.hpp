@@ -0,0 +1,218 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NDT__NDT_FROZEN_GRID_HPP_
+#define NDT__NDT_FROZEN_GRID_HPP_
+
+#include <ndt/ndt_common.hpp>
+#include <ndt/ndt_grid.hpp>
+#include <ndt/ndt_voxel_view.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace autoware
+{
+namespace localization
+{
+namespace ndt
+{
+/// \brief Read-only storage and lookup structure for NDT voxels which do not change after being
+/// set. The voxels are kept in a contiguous array ordered by voxel index, so that neighbouring
+/// voxels are close in memory. Each usable voxel has a precomputed view, and is located through an
+/// open-addressing table with linear probing that is at most half full. The longest probe sequence
+/// is recorded while building, so lookups touch a bounded number of slots and never allocate.
+/// \tparam VoxelT Voxel type
+template<typename VoxelT>
+class FrozenNDTGrid
+{
+public:
+  using Point = Eigen::Vector3d;
+  using Config = typename NDTGrid<VoxelT>::Config;
+  using ConfigPoint = typename NDTGrid<VoxelT>::ConfigPoint;
+  using View = VoxelView<VoxelT>;
+  using ViewSpan = VoxelViewSpan<VoxelT>;
+  using Voxels = std::vector<std::pair<uint64_t, VoxelT>>;
+
+  /// Constructor
+  /// \param config Configuration of the voxel grid the voxel indices belong to.
+  /// \param voxels Voxels and their indices, which are moved into the grid. If an index occurs
+  /// more than once, the last voxel with that index is kept.
+  /// \throw std::length_error If there are more usable voxels than can be indexed.
+  FrozenNDTGrid(const Config & config, Voxels voxels)
+  : m_config(config), m_voxels(std::move(voxels))
+  {
+    std::stable_sort(
+      m_voxels.begin(), m_voxels.end(), [](const auto & a, const auto & b) {
+        return a.first < b.first;
+      });
+    auto out_it = m_voxels.begin();
+    std::size_t num_usable = 0U;
+    for (auto vx_it = m_voxels.begin(); vx_it != m_voxels.end(); ++vx_it) {
+      const auto next_it = std::next(vx_it);
+      if ((next_it != m_voxels.end()) && (next_it->first == vx_it->first)) {
+        continue;
+      }
+      if (out_it != vx_it) {
+        *out_it = std::move(*vx_it);
+      }
+      if (out_it->second.usable()) {
+        ++num_usable;
+      }
+      ++out_it;
+    }
+    m_voxels.erase(out_it, m_voxels.end());
+    if (num_usable >= static_cast<std::size_t>(NONE)) {
+      throw std::length_error{"FrozenNDTGrid: too many voxels"};
+    }
+
+    // Views refer to the voxels, which are not moved anymore
+    m_views.reserve(num_usable);
+    m_slots.assign(table_size(num_usable), Slot{0U, NONE});
+    m_mask = m_slots.size() - 1U;
+    for (const auto & vx : m_voxels) {
+      if (!vx.second.usable()) {
+        continue;
+      }
+      std::size_t pos = home(vx.first);
+      std::size_t probe = 0U;
+      while (NONE != m_slots[pos].view) {
+        pos = (pos + 1U) & m_mask;
+        ++probe;
+      }
+      m_slots[pos] = Slot{vx.first, static_cast<uint32_t>(m_views.size())};
+      m_views.emplace_back(vx.second);
+      m_max_probe = std::max(m_max_probe, probe);
+    }
+  }
+
+  // Views refer to the owned voxels, so the grid can only be moved.
+  FrozenNDTGrid(const FrozenNDTGrid &) = delete;
+
+  FrozenNDTGrid & operator=(const FrozenNDTGrid &) = delete;
+
+  FrozenNDTGrid(FrozenNDTGrid &&) = default;
+
+  FrozenNDTGrid & operator=(FrozenNDTGrid &&) = default;
+
+  /// Lookup the cell at location. Lookups may be done concurrently from different threads.
+  /// \param pt point to lookup
+  /// \return A span containing the cell at given coordinates, or an empty span if there is no
+  /// usable cell. It is valid as long as this grid exists.
+  ViewSpan cell(const Point & pt) const
+  {
+    const uint64_t key = m_config.index(pt);
+    std::size_t pos = home(key);
+    for (std::size_t probe = 0U; probe <= m_max_probe; ++probe) {
+      const Slot & slot = m_slots[pos];
+      if (NONE == slot.view) {
+        break;
+      }
+      if (key == slot.key) {
+        return ViewSpan{&m_views[slot.view], 1U};
+      }
+      pos = (pos + 1U) & m_mask;
+    }
+    return ViewSpan{};
+  }
+
+  /// Get the number of voxels.
+  /// \return Number of voxels, including the ones which are not usable.
+  std::size_t size() const noexcept
+  {
+    return m_voxels.size();
+  }
+
+  /// Get the voxel grid configuration.
+  /// \return Voxel grid configuration.
+  const Config & config() const noexcept
+  {
+    return m_config;
+  }
+
+  /// Get size of the cell.
+  /// \return A point representing the dimensions of the cell.
+  const ConfigPoint & cell_size() const noexcept
+  {
+    return m_config.get_voxel_size();
+  }
+
+  /// \brief Returns a const iterator to the first voxel, in the order of voxel indices
+  /// \return Iterator to a pair of voxel index and voxel
+  typename Voxels::const_iterator begin() const noexcept
+  {
+    return m_voxels.cbegin();
+  }
+
+  /// \brief Returns a const iterator to one past the last voxel
+  /// \return Iterator
+  typename Voxels::const_iterator end() const noexcept
+  {
+    return m_voxels.cend();
+  }
+
+  /// Get the longest probe sequence of the lookup table.
+  /// \return Number of slots after the initial one a lookup inspects at most.
+  std::size_t max_probe() const noexcept
+  {
+    return m_max_probe;
+  }
+
+private:
+  /// Sentinel value for an empty slot
+  static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+  struct Slot
+  {
+    uint64_t key;
+    uint32_t view;
+  };
+
+  static std::size_t table_size(const std::size_t num_voxels)
+  {
+    std::size_t ret = 2U;
+    while (ret < (num_voxels * 2U)) {
+      ret *= 2U;
+    }
+    return ret;
+  }
+
+  /// Initial probe position of a voxel index
+  std::size_t home(const uint64_t key) const noexcept
+  {
+    // Fibonacci hashing, as voxel indices of neighbouring voxels only differ in the lower bits
+    const uint64_t hash = key * 0x9E3779B97F4A7C15ULL;
+    return static_cast<std::size_t>(hash ^ (hash >> 32U)) & m_mask;
+  }
+
+  Config m_config;
+  Voxels m_voxels{};
+  std::vector<View> m_views{};
+  std::vector<Slot> m_slots{};
+  std::size_t m_mask{0U};
+  std::size_t m_max_probe{0U};
+};
+
+template<typename VoxelT>
+constexpr uint32_t FrozenNDTGrid<VoxelT>::NONE;
+
+}  // namespace ndt
+}  // namespace localization
+}  // namespace autoware
+
+#endif  // NDT__NDT_FROZEN_GRID_HPP_
@@ -75,20 +75,31 @@ public:
     return cell(Point({x, y, z}));
   }
 
-  /// Lookup the cell at location.
+  /// Lookup the cell at location. The result is kept in a buffer of this grid, so this must not
+  /// be called concurrently. Use the overload with an output vector for concurrent lookups.
   /// \param pt point to lookup
   /// \return A vector containing the cell at given coordinates. A vector is used to support
-  /// near-neighbour cell queries in the future.
+  /// near-neighbour cell queries in the future. It is valid until the next lookup on this grid.
   const VoxelViewVector & cell(const Point & pt) const
+  {
+    cell(pt, m_output_vector);
+    return m_output_vector;
+  }
+
+  /// Lookup the cell at location into a caller owned vector. Lookups may be done concurrently
+  /// from different threads, as long as each uses its own output vector.
+  /// \param pt point to lookup
+  /// \param output_vector Vector to be filled with the cell at given coordinates. It is cleared
+  /// first, and reusing it across lookups avoids allocations.
+  void cell(const Point & pt, VoxelViewVector & output_vector) const
   {
     // TODO(yunus.caliskan): revisit after multi-cell lookup support. #985
-    m_output_vector.clear();
+    output_vector.clear();
     const auto vx_it = m_map.find(m_config.index(pt));
     // Only return a voxel if it's occupied (i.e. has enough points to compute covariance.)
     if (vx_it != m_map.end() && vx_it->second.usable()) {
-      m_output_vector.emplace_back(vx_it->second);
+      output_vector.emplace_back(vx_it->second);
     }
-    return m_output_vector;
   }
 
   /// Get size of the map
@@ -171,6 +182,14 @@ public:
     return m_map.emplace(std::forward<Args>(args)...);
   }
 
+  /// \brief Remove a voxel from the grid.
+  /// \param it Iterator to the voxel to remove.
+  /// \return Iterator following the removed voxel.
+  typename Grid::iterator erase(typename Grid::const_iterator it)
+  {
+    return m_map.erase(it);
+  }
+
   /// \brief Add a point to its corresponding voxel in the grid.
   /// \param pt Point to be added
   void add_observation(const Point & pt)
@@ -246,13 +246,20 @@ public:
   using PoseWithCovarianceStamped = typename ParentT::PoseWithCovarianceStamped;
   using ScanT = P2DNDTScan;
 
+  /// Constructor
+  /// \param config Localizer config.
+  /// \param optimizer Optimizer to use during optimization.
+  /// \param outlier_ratio Outlier ratio of the optimization problem.
+  /// \param num_threads Number of threads evaluating the optimization problem, 0 and 1 evaluate
+  /// it on the calling thread.
   explicit P2DNDTLocalizer(
     const P2DNDTLocalizerConfig & config,
     const OptimizerT & optimizer,
-    const Real outlier_ratio)
+    const Real outlier_ratio,
+    const std::size_t num_threads = 0U)
   : ParentT{
       config,
-      P2DNDTOptimizationConfig{outlier_ratio},
+      P2DNDTOptimizationConfig{outlier_ratio, num_threads},
       optimizer,
       ScanT{config.scan_capacity()}} {}
 
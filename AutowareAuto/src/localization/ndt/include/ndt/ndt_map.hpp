@@ -21,10 +21,15 @@
 #include <ndt/ndt_voxel.hpp>
 #include <ndt/ndt_voxel_view.hpp>
 #include <ndt/ndt_grid.hpp>
+#include <ndt/ndt_frozen_grid.hpp>
+#include <ndt/ndt_map_file.hpp>
+#include <ndt/ndt_map_tiles.hpp>
 #include <sensor_msgs/point_cloud2_iterator.hpp>
 #include <time_utils/time_utils.hpp>
 #include <vector>
+#include <iterator>
 #include <limits>
+#include <map>
 #include <unordered_map>
 #include <utility>
 #include <string>
@@ -73,11 +78,11 @@ public:
   template<typename DeserializingMapT>
   void serialize_as(sensor_msgs::msg::PointCloud2 & msg_out) const;
 
-  /// Lookup the cell at location.
+  /// Lookup the cell at location. Lookups may be done concurrently from different threads.
   /// \param pt point to lookup
   /// \return A vector containing the cell at given coordinates. A vector is used to support
   /// near-neighbour cell queries in the future.
-  const VoxelViewVector & cell(const Point & pt) const;
+  VoxelViewVector cell(const Point & pt) const;
 
   /// Lookup the cell at location.
   /// \param x x coordinate
@@ -85,7 +90,7 @@ public:
   /// \param z z coordinate
   /// \return A vector containing the cell at given coordinates. A vector is used to support
   /// near-neighbour cell queries in the future.
-  const VoxelViewVector & cell(float32_t x, float32_t y, float32_t z) const;
+  VoxelViewVector cell(float32_t x, float32_t y, float32_t z) const;
 
   /// Get map's frame id.
   /// \return Frame id of the map.
@@ -135,9 +140,40 @@ public:
   using Config = autoware::perception::filters::voxel_grid::Config;
   using TimePoint = std::chrono::system_clock::time_point;
   using Point = Eigen::Vector3d;
-  using VoxelViewVector = std::vector<VoxelView<Voxel>>;
-  using VoxelGrid = NDTGrid<Voxel>::Grid;
+  using VoxelViewSpan = ndt::VoxelViewSpan<Voxel>;
   using ConfigPoint = NDTGrid<Voxel>::ConfigPoint;
+  using TileGrids = std::map<MapTileIndex, FrozenNDTGrid<Voxel>>;
+
+  /// Forward iterator over the voxels of all tiles of the map, as pairs of voxel index and voxel.
+  class NDT_PUBLIC const_iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = FrozenNDTGrid<Voxel>::Voxels::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type *;
+    using reference = const value_type &;
+
+    /// Constructor
+    /// \param grid_it Tile to start at.
+    /// \param grid_end One past the last tile.
+    const_iterator(TileGrids::const_iterator grid_it, TileGrids::const_iterator grid_end);
+
+    reference operator*() const {return *m_voxel_it;}
+    pointer operator->() const {return &(*m_voxel_it);}
+    const_iterator & operator++();
+    const_iterator operator++(int);
+    bool8_t operator==(const const_iterator & other) const noexcept;
+    bool8_t operator!=(const const_iterator & other) const noexcept {return !(*this == other);}
+
+  private:
+    /// Move to the first voxel of the next tile which has voxels, if the current tile is done.
+    void skip_finished_grids();
+
+    TileGrids::const_iterator m_grid_it;
+    TileGrids::const_iterator m_grid_end;
+    FrozenNDTGrid<Voxel>::Voxels::const_iterator m_voxel_it{};
+  };
 
   /// Set point cloud message representing the map to the map representation instance.
   /// Map is assumed to have correct format (see `validate_pcl_map(...)`) and was generated
@@ -147,21 +183,36 @@ public:
   /// message which is expected to be equal to the voxel grid ID in the map's voxel grid. Since
   /// the grid's index will be a long value to avoid overflows, `cell_id` field should be an array
   /// of 2 unsigned integers. That is because there is no direct long support as a PointField.
+  /// Since the map does not change afterwards, the voxels are stored directly in a flat lookup
+  /// structure which is built once here.
+  /// Messages of single map tiles (see `read_map_tile_header(...)`) replace the voxels of their
+  /// tile and keep the other voxels, so that a tiled map can be updated incrementally. Each tile
+  /// has its own lookup structure, so that setting a tile only costs as much as the tile. The
+  /// voxels of a tile message are expected to belong to that tile. An empty tile message removes
+  /// the tile.
   void set(const sensor_msgs::msg::PointCloud2 & msg);
 
-  /// Lookup the cell at location.
+  /// Set the map from a memory mapped ndt map file, as written from a serialized map message by
+  /// `write_ndt_map_file(...)`. This is equivalent to setting the message, without copying the
+  /// voxels into a message first. The stamp of the map is set to the current time.
+  /// \param map_file Mapped ndt map file. It is not referenced after the call.
+  /// \param frame_id Frame of the map.
+  void set(const NDTMapFile & map_file, const std::string & frame_id);
+
+  /// Lookup the cell at location. This does not allocate, and lookups may be done concurrently
+  /// from different threads.
   /// \param pt point to lookup
-  /// \return A vector containing the cell at given coordinates. A vector is used to support
-  /// near-neighbour cell queries in the future.
-  const VoxelViewVector & cell(const Point & pt) const;
+  /// \return A span containing the cell at given coordinates. A span is used to support
+  /// near-neighbour cell queries in the future. It is valid until the map is modified.
+  VoxelViewSpan cell(const Point & pt) const;
 
   /// Lookup the cell at location.
   /// \param x x coordinate
   /// \param y y coordinate
   /// \param z z coordinate
-  /// \return A vector containing the cell at given coordinates. A vector is used to support
-  /// near-neighbour cell queries in the future.
-  const VoxelViewVector & cell(float32_t x, float32_t y, float32_t z) const;
+  /// \return A span containing the cell at given coordinates. A span is used to support
+  /// near-neighbour cell queries in the future. It is valid until the map is modified.
+  VoxelViewSpan cell(float32_t x, float32_t y, float32_t z) const;
 
   /// Get map's frame id.
   /// \return Frame id of the map.
@@ -186,20 +237,44 @@ public:
 
   /// \brief Returns an const iterator to the first element of the map
   /// \return Iterator
-  typename VoxelGrid::const_iterator begin() const;
+  const_iterator begin() const;
 
   /// \brief Returns a const iterator to one past the last element of the map
   /// \return Iterator
-  typename VoxelGrid::const_iterator end() const;
+  const_iterator end() const;
 
   /// Clear all voxels in the map
   void clear();
 
 private:
-  /// Deserialize the given serialized point cloud map.
-  /// \param msg PointCloud2 message containing the deserialized data.
-  void deserialize_from(const sensor_msgs::msg::PointCloud2 & msg);
-  std::experimental::optional<NDTGrid<StaticNDTVoxel>> m_grid{};
+  /// Set the points of a serialized map, either from a message or from an ndt map file.
+  /// \param map_points Random access range of PointWithCovariances, starting with the
+  /// configuration points.
+  template<typename MapPoints>
+  void set_points(const MapPoints & map_points);
+  /// Deserialize the given serialized map.
+  /// \param map_points Points of the serialized map.
+  /// \param config Configuration read from the configuration points.
+  template<typename MapPoints>
+  void deserialize_from(const MapPoints & map_points, const Config & config);
+  /// Replace the voxels of a map tile with the voxels of the given serialized tile.
+  /// \param map_points Points of the serialized map tile.
+  /// \param config Configuration read from the configuration points.
+  /// \param tile Index of the tile.
+  /// \param tile_size Tile size of the tiled map.
+  template<typename MapPoints>
+  void set_tile(
+    const MapPoints & map_points, const Config & config, const MapTileIndex & tile,
+    float64_t tile_size);
+  /// Split the voxels of the map into the tiles of a new layout.
+  /// \param layout Tile layout of the map.
+  void split_into_tiles(const MapTileLayout & layout);
+  // Configuration of the voxel grid, set once a map or tile was set
+  std::experimental::optional<Config> m_config{};
+  // Layout of a tiled map, empty if a whole map was set
+  std::experimental::optional<MapTileLayout> m_tile_layout{};
+  // Voxels of each tile. A whole map is stored as a single tile.
+  TileGrids m_grids{};
   TimePoint m_stamp{};
   std::string m_frame_id{};
 };
@@ -0,0 +1,109 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief This file defines a binary file format for serialized ndt maps which can be memory
+///        mapped
+
+#ifndef NDT__NDT_MAP_FILE_HPP_
+#define NDT__NDT_MAP_FILE_HPP_
+
+#include <ndt/ndt_common.hpp>
+#include <ndt/utils.hpp>
+#include <ndt/visibility_control.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace autoware
+{
+namespace localization
+{
+namespace ndt
+{
+
+/// Read-only, memory mapped ndt map file. The file holds the points of a serialized ndt map
+/// message (see `DynamicNDTMap::serialize_as(...)`), i.e. the configuration points followed by a
+/// point per voxel with its centroid and inverse covariance. This way a map can be loaded without
+/// parsing a point cloud and computing the voxels again.
+///
+/// The file consists of a 16 byte header, followed by the points as consecutive
+/// PointWithCovariances records:
+/// - 4 bytes: magic number "NDTM"
+/// - uint32: format version
+/// - uint64: number of points
+///
+/// Values are stored in native byte order. Files written on a machine with another byte order are
+/// rejected, as their version does not match.
+class NDT_PUBLIC NDTMapFile
+{
+public:
+  /// Current version of the file format
+  static constexpr uint32_t kVersion = 1U;
+
+  /// Constructor. Maps the file into memory and validates its header.
+  /// \param file_name Name of the file.
+  /// \throw std::runtime_error If the file cannot be mapped or is not a valid ndt map file.
+  explicit NDTMapFile(const std::string & file_name);
+
+  /// Destructor. Unmaps the file.
+  ~NDTMapFile();
+
+  // The points refer to the mapped memory, so the file can be neither copied nor moved.
+  NDTMapFile(const NDTMapFile &) = delete;
+  NDTMapFile & operator=(const NDTMapFile &) = delete;
+
+  /// Get the first point of the map.
+  /// \return Pointer to the first point.
+  const PointWithCovariances * begin() const noexcept;
+
+  /// Get one past the last point of the map.
+  /// \return Pointer to one past the last point.
+  const PointWithCovariances * end() const noexcept;
+
+  /// Get the number of points, including the configuration points.
+  /// \return Number of points.
+  std::size_t size() const noexcept;
+
+  /// Access a point.
+  /// \param idx Index of the point.
+  /// \return Point at the index.
+  const PointWithCovariances & operator[](std::size_t idx) const noexcept;
+
+  /// Copy the map into a serialized ndt map message.
+  /// \param frame_id Frame of the map.
+  /// \param[out] msg Serialized ndt map message.
+  void to_message(const std::string & frame_id, sensor_msgs::msg::PointCloud2 & msg) const;
+
+private:
+  void * m_data{nullptr};
+  std::size_t m_length{0U};
+  const PointWithCovariances * m_points{nullptr};
+  std::size_t m_size{0U};
+};
+
+/// Write a serialized ndt map message into an ndt map file.
+/// \param file_name Name of the file.
+/// \param msg Serialized ndt map message, as created by `DynamicNDTMap::serialize_as(...)`.
+/// \throw std::runtime_error If the message is not a serialized ndt map or the file cannot be
+/// written.
+NDT_PUBLIC void write_ndt_map_file(
+  const std::string & file_name, const sensor_msgs::msg::PointCloud2 & msg);
+
+}  // namespace ndt
+}  // namespace localization
+}  // namespace autoware
+
+#endif  // NDT__NDT_MAP_FILE_HPP_
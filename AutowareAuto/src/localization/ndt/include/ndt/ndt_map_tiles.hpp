@@ -0,0 +1,232 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief This file defines the tiled on-disk ndt map and a loader keeping the tiles around the
+///        vehicle resident
+
+#ifndef NDT__NDT_MAP_TILES_HPP_
+#define NDT__NDT_MAP_TILES_HPP_
+
+#include <ndt/ndt_common.hpp>
+#include <ndt/utils.hpp>
+#include <ndt/visibility_control.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <voxel_grid/config.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace autoware
+{
+namespace localization
+{
+namespace ndt
+{
+
+/// Index of a square map tile in the x-y plane. Tile (0, 0) starts at the minimum point of the map.
+struct NDT_PUBLIC MapTileIndex
+{
+  int32_t x;
+  int32_t y;
+};
+
+NDT_PUBLIC bool8_t operator==(const MapTileIndex & lhs, const MapTileIndex & rhs) noexcept;
+NDT_PUBLIC bool8_t operator<(const MapTileIndex & lhs, const MapTileIndex & rhs) noexcept;
+
+/// Partition of a voxel grid into square tiles, each spanning the whole z range of the grid. Tile
+/// borders coincide with voxel borders, so every voxel belongs to exactly one tile and a tiled map
+/// contains the same voxels as the untiled map.
+class NDT_PUBLIC MapTileLayout
+{
+public:
+  using Config = autoware::perception::filters::voxel_grid::Config;
+  using Point = Eigen::Vector3d;
+
+  /// Constructor
+  /// \param config Configuration of the voxel grid of the whole map.
+  /// \param tile_size Edge length of a tile.
+  /// \throw std::domain_error If the tile size is not a positive multiple of the voxel size in x
+  /// and y.
+  MapTileLayout(const Config & config, float64_t tile_size);
+
+  /// Get the configuration of the voxel grid of the whole map.
+  /// \return Voxel grid configuration.
+  const Config & config() const noexcept;
+
+  /// Get the edge length of a tile.
+  /// \return Tile size.
+  float64_t tile_size() const noexcept;
+
+  /// Get the tile of the voxel containing a point.
+  /// \param pt Point to look up.
+  /// \return Tile index.
+  MapTileIndex tile_of(const Point & pt) const;
+
+  /// Get the distance in the x-y plane between a position and the closest point of a tile.
+  /// \param tile Tile index.
+  /// \param x x coordinate of the position.
+  /// \param y y coordinate of the position.
+  /// \return Distance, zero if the position is inside the tile.
+  float64_t distance(const MapTileIndex & tile, float64_t x, float64_t y) const noexcept;
+
+private:
+  Config m_config;
+  float64_t m_tile_size;
+};
+
+/// Marks the voxel size point of a serialized ndt map message as the header of a single tile.
+static constexpr float64_t kMapTileMarker = -1.0;
+
+/// Serialized ndt map messages of single tiles use the configuration of the whole map in the
+/// first three points, so that voxel indices are the same in every tile. The otherwise unused
+/// fields of the voxel size point identify the tile: `icov_zz` is set to kMapTileMarker,
+/// `icov_xx` holds the tile size, `icov_xy` and `icov_xz` the tile index. A tile message without
+/// voxels removes the tile from the receiving map.
+/// \param msg Serialized ndt map message.
+/// \param[out] tile Index of the tile if the message is a tile message.
+/// \param[out] tile_size Tile size if the message is a tile message.
+/// \return True if the message is a tile message.
+/// \throw std::runtime_error If the message does not contain the configuration points.
+NDT_PUBLIC bool8_t read_map_tile_header(
+  const sensor_msgs::msg::PointCloud2 & msg, MapTileIndex & tile, float64_t & tile_size);
+
+/// Read the tile index from the voxel size configuration point of a serialized ndt map.
+/// \param voxel_size Third configuration point of the serialized map.
+/// \param[out] tile Index of the tile if the point belongs to a tile.
+/// \param[out] tile_size Tile size if the point belongs to a tile.
+/// \return True if the point belongs to a tile.
+NDT_PUBLIC bool8_t read_map_tile_header(
+  const PointWithCovariances & voxel_size, MapTileIndex & tile, float64_t & tile_size) noexcept;
+
+/// Create a message removing a tile from the receiving map.
+/// \param layout Layout of the tiled map.
+/// \param tile Tile to remove.
+/// \param frame_id Frame of the map.
+/// \param[out] msg Serialized ndt map message without voxels.
+NDT_PUBLIC void make_map_tile_removal(
+  const MapTileLayout & layout, const MapTileIndex & tile, const std::string & frame_id,
+  sensor_msgs::msg::PointCloud2 & msg);
+
+/// Cut a dense point cloud into ndt map tiles and write them into a directory, together with a
+/// `tiles.yaml` file describing the layout and listing the tiles. Each tile is converted with
+/// DynamicNDTMap and stored as an ndt map file (see NDTMapFile). Only tiles containing
+/// usable voxels are written.
+/// \param cloud Dense point cloud with x, y, z and intensity fields.
+/// \param layout Layout of the tiled map.
+/// \param directory Output directory, created if it does not exist.
+/// \return Number of tiles written.
+/// \throw std::runtime_error If a file cannot be written.
+NDT_PUBLIC std::size_t write_map_tiles(
+  const sensor_msgs::msg::PointCloud2 & cloud, const MapTileLayout & layout,
+  const std::string & directory);
+
+/// Read the layout and the list of tiles written by write_map_tiles().
+/// \param directory Directory containing the tiles.
+/// \param[out] tiles Indices of all tiles in the directory.
+/// \return Layout of the tiled map.
+/// \throw std::runtime_error If the `tiles.yaml` file cannot be read.
+NDT_PUBLIC MapTileLayout read_map_tile_layout(
+  const std::string & directory, std::vector<MapTileIndex> & tiles);
+
+/// Read a tile written by write_map_tiles() into a serialized ndt map message.
+/// \param directory Directory containing the tiles.
+/// \param tile Tile to read.
+/// \param frame_id Frame of the map.
+/// \param[out] msg Serialized ndt map message of the tile.
+/// \throw std::runtime_error If the tile cannot be read.
+NDT_PUBLIC void read_map_tile(
+  const std::string & directory, const MapTileIndex & tile, const std::string & frame_id,
+  sensor_msgs::msg::PointCloud2 & msg);
+
+/// Keeps the tiles of a tiled map around a position resident. Tiles within the load radius of the
+/// position are read on a background thread, closest first. Tiles are evicted once they are
+/// farther than the load radius plus half a tile size, so that moving along a tile border does not
+/// load and evict the same tiles repeatedly. All changes are returned as serialized ndt map
+/// messages which can be applied to a StaticNDTMap one by one.
+class NDT_PUBLIC MapTileLoader
+{
+public:
+  /// Constructor. Reads the layout and starts the background thread.
+  /// \param directory Directory written by write_map_tiles().
+  /// \param radius Load radius around the position.
+  /// \param frame_id Frame of the map.
+  /// \throw std::runtime_error If the layout cannot be read.
+  /// \throw std::domain_error If the radius is negative.
+  MapTileLoader(const std::string & directory, float64_t radius, const std::string & frame_id);
+
+  /// Destructor. Stops the background thread after the tile being read, if any.
+  ~MapTileLoader();
+
+  MapTileLoader(const MapTileLoader &) = delete;
+  MapTileLoader & operator=(const MapTileLoader &) = delete;
+
+  /// Set the current position. Queues the missing tiles within the load radius and evicts the
+  /// tiles out of range.
+  /// \param x x coordinate in the map frame.
+  /// \param y y coordinate in the map frame.
+  void update(float64_t x, float64_t y);
+
+  /// Get the changes since the last call, in the order they have to be applied.
+  /// \param[out] messages Appended with a message per loaded or evicted tile.
+  /// \param[out] errors Appended with a description per tile which could not be read. Such tiles
+  /// are not retried.
+  void take_updates(
+    std::vector<sensor_msgs::msg::PointCloud2> & messages, std::vector<std::string> & errors);
+
+  /// Get the layout of the tiled map.
+  /// \return Layout.
+  const MapTileLayout & layout() const noexcept;
+
+  /// Get the largest number of tiles which can be resident at the same time.
+  /// \return Number of tiles.
+  std::size_t max_resident_tiles() const noexcept;
+
+private:
+  enum class TileState : uint8_t
+  {
+    QUEUED,
+    LOADING,
+    CANCELLED,
+    RESIDENT,
+    FAILED
+  };
+
+  void run();
+
+  const std::string m_directory;
+  const float64_t m_radius;
+  const std::string m_frame_id;
+  std::vector<MapTileIndex> m_tiles{};
+  MapTileLayout m_layout;
+  std::mutex m_mutex{};
+  std::condition_variable m_condition{};
+  std::map<MapTileIndex, TileState> m_states{};
+  std::deque<MapTileIndex> m_queue{};
+  std::vector<sensor_msgs::msg::PointCloud2> m_messages{};
+  std::vector<std::string> m_errors{};
+  bool8_t m_stop{false};
+  std::thread m_thread{};
+};
+
+}  // namespace ndt
+}  // namespace localization
+}  // namespace autoware
+
+#endif  // NDT__NDT_MAP_TILES_HPP_
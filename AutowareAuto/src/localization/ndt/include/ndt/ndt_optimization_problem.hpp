@@ -60,6 +60,7 @@
 #include <ndt/ndt_map.hpp>
 #include <ndt/ndt_scan.hpp>
 #include <ndt/ndt_config.hpp>
+#include <ndt/p2d_ndt_kernel.hpp>
 #include <optimization/optimization_problem.hpp>
 #include <optimization/utils.hpp>
 #include <ndt/utils.hpp>
@@ -67,8 +68,11 @@
 #include <experimental/optional>
 #include <Eigen/Core>
 #include <Eigen/Geometry>
+#include <algorithm>
 #include <limits>
+#include <memory>
 #include <tuple>
+#include <vector>
 #include "common/types.hpp"
 
 using autoware::common::types::bool8_t;
@@ -127,7 +131,7 @@ public:
   ///
   P2DNDTObjective(
     const P2DNDTScan & scan, const Map & map, const P2DNDTOptimizationConfig config)
-  : m_scan_ref(scan), m_map_ref(map)
+  : m_scan_ref(scan), m_map_ref(map), m_worker_pool(config.worker_pool())
   {
     init(config.outlier_ratio());
   }
@@ -135,12 +139,10 @@ public:
   void evaluate_(const DomainValue & x, const ComputeMode & mode)
   {
     // Convert pose vector to transform matrix for easy point transformation
-    Eigen::Transform<float64_t, 3, Eigen::Affine, Eigen::ColMajor> transform;
+    Transform transform;
     transform.setIdentity();
     transform_adapters::pose_to_transform(x, transform);
 
-    Value score{0.0};
-
     Jacobian jacobian;
     std::experimental::optional<GradientAngleParameters> grad_params;
 
@@ -161,71 +163,64 @@ public:
       }
     }
 
-    for (const auto & pt : m_scan_ref) {
-      PointGrad point_gradient;
-      PointHessian point_hessian;
-
-      if (mode.jacobian() || mode.hessian()) {
-        point_gradient.setZero();
-        point_gradient.block<3, 3>(0, 0).setIdentity();
-        compute_point_gradients(grad_params.value(), pt, point_gradient);
+    P2DNDTKernelParameters kernel_params;
+    kernel_params.gauss_d1 = m_gauss_d1;
+    kernel_params.gauss_d2 = m_gauss_d2;
+    kernel_params.compute_jacobian = mode.jacobian();
+    kernel_params.compute_hessian = mode.hessian();
+    if (grad_params) {
+      set_kernel_parameters(grad_params.value(), kernel_params);
+    }
+    if (hessian_params) {
+      set_kernel_parameters(hessian_params.value(), kernel_params);
+    }
 
-        if (mode.hessian()) {
-          point_hessian.setZero();
-          compute_point_hessians(hessian_params.value(), pt, point_hessian);
-        }
+    // The scan is split into fixed chunks, each evaluated into its own partial result. The
+    // partial results are summed in chunk order, so the result does not depend on the number of
+    // threads or on which thread evaluated which chunk.
+    const auto num_chunks = (m_scan_ref.size() + SCAN_CHUNK_SIZE - 1U) / SCAN_CHUNK_SIZE;
+    if (m_chunk_batches.size() < num_chunks) {
+      m_chunk_batches.resize(num_chunks);
+    }
+    m_chunk_results.resize(num_chunks);
+    const auto evaluate_chunk = [this, &transform, &kernel_params](const std::size_t chunk) {
+        evaluate_chunk_(chunk, transform, kernel_params);
+      };
+    if (m_worker_pool != nullptr) {
+      m_worker_pool->run(num_chunks, evaluate_chunk);
+    } else {
+      for (auto chunk = 0U; chunk < num_chunks; ++chunk) {
+        evaluate_chunk(chunk);
       }
+    }
+    P2DNDTKernelResult result;
+    for (const auto & chunk_result : m_chunk_results) {
+      result.score += chunk_result.score;
+      for (auto i = 0U; i < 6U; ++i) {
+        result.jacobian[i] += chunk_result.jacobian[i];
+      }
+      for (auto i = 0U; i < P2DNDTKernelResult::NUM_HESSIAN_ENTRIES; ++i) {
+        result.hessian[i] += chunk_result.hessian[i];
+      }
+    }
 
-      const Point pt_trans = transform * pt;
-      const auto & cells = m_map_ref.cell(pt_trans);
-
-      for (const auto & cell : cells) {
-        const Point pt_trans_norm = pt_trans - cell.centroid();
-        // Cell iteration used for compatibility with maps with multi-cell lookup
-        if (!cell.usable()) {
-          continue;
-        }
-        const auto & inv_cov = cell.inverse_covariance();
-        // e^(-d_2/2 * (x_k - mu_k)^T Sigma_k^-1 (x_k - mu_k)) Equation 6.9 [Magnusson 2009]
-        Real e_minus_half_d2_x_cov_x =
-          std::exp(-m_gauss_d2 * pt_trans_norm.dot(inv_cov * pt_trans_norm) / 2.0);
-
-        if (mode.score()) {
-          score += -m_gauss_d1 * e_minus_half_d2_x_cov_x;
-        }
-
-        if (!mode.jacobian() && !mode.hessian()) {
-          continue;
-        }
-        const auto d2_e_minus_half_d2_x_cov_x = m_gauss_d2 * e_minus_half_d2_x_cov_x;
-
-        // Error checking for invalid values.
-        if (!is_valid_probability(d2_e_minus_half_d2_x_cov_x)) {
-          continue;
-        }
-
-        // Reusable portion of Equation 6.12 and 6.13 [Magnusson 2009]
-        const auto d1_d2_e_minus_half_d2_x_cov_x = m_gauss_d1 * d2_e_minus_half_d2_x_cov_x;
-
-        for (auto i = 0U; i < jacobian.rows(); ++i) {
-          const Point cov_dxd_pi = inv_cov * point_gradient.col(i);
-          if (mode.jacobian()) {
-            jacobian(i) += pt_trans_norm.dot(cov_dxd_pi) * d1_d2_e_minus_half_d2_x_cov_x;
-          }
-          if (mode.hessian()) {
-            for (auto j = 0U; j < hessian.cols(); ++j) {
-              hessian(i, j) += d1_d2_e_minus_half_d2_x_cov_x *
-                (-m_gauss_d2 * pt_trans_norm.dot(cov_dxd_pi) *
-                pt_trans_norm.dot(inv_cov * point_gradient.col(j)) +
-                pt_trans_norm.dot(inv_cov * point_hessian.block<3, 1>(3 * i, j)) +
-                point_gradient.col(j).dot(cov_dxd_pi));
-            }
-          }
+    if (mode.jacobian()) {
+      for (auto i = 0U; i < jacobian.rows(); ++i) {
+        jacobian(i) = result.jacobian[i];
+      }
+    }
+    if (mode.hessian()) {
+      auto idx = 0U;
+      for (auto i = 0U; i < hessian.rows(); ++i) {
+        for (auto j = i; j < hessian.cols(); ++j) {
+          hessian(i, j) = result.hessian[idx];
+          hessian(j, i) = result.hessian[idx];
+          ++idx;
         }
       }
     }
     if (mode.score()) {
-      this->set_score(score);
+      this->set_score(result.score);
     }
     if (mode.jacobian()) {
       this->set_jacobian(jacobian);
@@ -396,45 +391,69 @@ public:
       h_ang_f1, h_ang_f2, h_ang_f3;
   };
 
-  void compute_point_gradients(
+  static void set_row(const Point & row, float64_t (& out)[3U])
+  {
+    out[0U] = row(0);
+    out[1U] = row(1);
+    out[2U] = row(2);
+  }
+
+  /// Copy the angle parameters used by the point gradient (eq. 6.18) into the kernel parameters
+  static void set_kernel_parameters(
     const GradientAngleParameters & params,
-    const Point & x,
-    PointGrad & point_gradient)
+    P2DNDTKernelParameters & kernel_params)
   {
-    point_gradient(1, 3) = x.dot(params.j_ang_a);
-    point_gradient(2, 3) = x.dot(params.j_ang_b);
-    point_gradient(0, 4) = x.dot(params.j_ang_c);
-    point_gradient(1, 4) = x.dot(params.j_ang_d);
-    point_gradient(2, 4) = x.dot(params.j_ang_e);
-    point_gradient(0, 5) = x.dot(params.j_ang_f);
-    point_gradient(1, 5) = x.dot(params.j_ang_g);
-    point_gradient(2, 5) = x.dot(params.j_ang_h);
+    const Point * const rows[] = {&params.j_ang_a, &params.j_ang_b, &params.j_ang_c,
+      &params.j_ang_d, &params.j_ang_e, &params.j_ang_f, &params.j_ang_g, &params.j_ang_h};
+    for (auto i = 0U; i < 8U; ++i) {
+      set_row(*rows[i], kernel_params.gradient[i]);
+    }
   }
 
-  void compute_point_hessians(
+  /// Copy the angle parameters used by the point hessian (eq. 6.20) into the kernel parameters
+  static void set_kernel_parameters(
     const HessianAngleParameters & params,
-    const Point & x,
-    PointHessian & point_hessian)
+    P2DNDTKernelParameters & kernel_params)
   {
-    const Point a{0.0, x.dot(params.h_ang_a2), x.dot(params.h_ang_a3)};
-    const Point b{0.0, x.dot(params.h_ang_b2), x.dot(params.h_ang_b3)};
-    const Point c{0.0, x.dot(params.h_ang_c2), x.dot(params.h_ang_c3)};
-    const Point d{x.dot(params.h_ang_d1), x.dot(params.h_ang_d2),
-      x.dot(params.h_ang_d3)};
-    const Point e{x.dot(params.h_ang_e1), x.dot(params.h_ang_e2),
-      x.dot(params.h_ang_e3)};
-    const Point f{x.dot(params.h_ang_f1), x.dot(params.h_ang_f2),
-      x.dot(params.h_ang_f3)};
-
-    point_hessian.block<3, 1>(9, 3) = a;
-    point_hessian.block<3, 1>(12, 3) = b;
-    point_hessian.block<3, 1>(15, 3) = c;
-    point_hessian.block<3, 1>(9, 4) = b;
-    point_hessian.block<3, 1>(12, 4) = d;
-    point_hessian.block<3, 1>(15, 4) = e;
-    point_hessian.block<3, 1>(9, 5) = c;
-    point_hessian.block<3, 1>(12, 5) = e;
-    point_hessian.block<3, 1>(15, 5) = f;
+    const Point * const rows[] = {&params.h_ang_a2, &params.h_ang_a3, &params.h_ang_b2,
+      &params.h_ang_b3, &params.h_ang_c2, &params.h_ang_c3, &params.h_ang_d1, &params.h_ang_d2,
+      &params.h_ang_d3, &params.h_ang_e1, &params.h_ang_e2, &params.h_ang_e3, &params.h_ang_f1,
+      &params.h_ang_f2, &params.h_ang_f3};
+    for (auto i = 0U; i < 15U; ++i) {
+      set_row(*rows[i], kernel_params.hessian[i]);
+    }
+  }
+
+  using Transform = Eigen::Transform<float64_t, 3, Eigen::Affine, Eigen::ColMajor>;
+
+  /// Gather the point/cell pairs of one chunk of the scan into a structure of arrays and evaluate
+  /// them in bulk.
+  /// \param chunk Index of the chunk, covering the points starting at chunk * SCAN_CHUNK_SIZE.
+  /// \param transform Transform of the current pose.
+  /// \param kernel_params Kernel parameters of the current pose.
+  void evaluate_chunk_(
+    const std::size_t chunk, const Transform & transform,
+    const P2DNDTKernelParameters & kernel_params)
+  {
+    const auto begin = chunk * SCAN_CHUNK_SIZE;
+    const auto end = std::min(begin + SCAN_CHUNK_SIZE, m_scan_ref.size());
+    auto & batch = m_chunk_batches[chunk];
+    batch.clear();
+    for (auto pt_it = m_scan_ref.begin() + begin; pt_it != m_scan_ref.begin() + end; ++pt_it) {
+      const Point & pt = *pt_it;
+      const Point pt_trans = transform * pt;
+      const auto & cells = m_map_ref.cell(pt_trans);
+      for (const auto & cell : cells) {
+        // Cell iteration used for compatibility with maps with multi-cell lookup
+        if (!cell.usable()) {
+          continue;
+        }
+        batch.push_back(
+          pt.data(), pt_trans.data(), cell.centroid().data(), cell.inverse_covariance().data());
+      }
+    }
+    m_chunk_results[chunk] = P2DNDTKernelResult{};
+    evaluate_p2d_ndt_kernel(batch, 0U, batch.size(), kernel_params, m_chunk_results[chunk]);
   }
 
   /// Initializes the guassian fitting parameters (eq. 6.8) [Magnusson 2009]
@@ -463,8 +482,17 @@ public:
   // States:
   Real m_gauss_d1{0.0};
   Real m_gauss_d2{0.0};
+  // Number of scan points evaluated together, in a single task if multi threaded
+  static constexpr std::size_t SCAN_CHUNK_SIZE = 256U;
+  std::shared_ptr<common::helper_functions::WorkerPool> m_worker_pool;
+  // Point/cell pairs of the last evaluation per chunk, kept to reuse the memory
+  std::vector<P2DNDTBatch> m_chunk_batches{};
+  std::vector<P2DNDTKernelResult> m_chunk_results{};
 };
 
+template<typename MapT, Requires Req>
+constexpr std::size_t P2DNDTObjective<MapT, Req>::SCAN_CHUNK_SIZE;
+
 template<typename MapT>
 using P2DNDTOptimizationProblem =
   common::optimization::UnconstrainedOptimizationProblem<P2DNDTObjective<MapT>, EigenPose<Real>,
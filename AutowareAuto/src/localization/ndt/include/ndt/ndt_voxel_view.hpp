@@ -18,6 +18,7 @@
 #define NDT__NDT_VOXEL_VIEW_HPP_
 
 #include <ndt/ndt_voxel.hpp>
+#include <cstddef>
 
 namespace autoware
 {
@@ -110,6 +111,37 @@ private:
   bool8_t m_usable{true};
 };
 
+/// Read-only view over contiguous voxel views, as returned by allocation free cell lookups. It
+/// can be used like a const vector of views, and it is valid as long as the map it was obtained
+/// from is not modified.
+/// \tparam VoxelT Type of voxel to view.
+template<typename VoxelT>
+class VoxelViewSpan
+{
+public:
+  using value_type = VoxelView<VoxelT>;
+  using const_iterator = const value_type *;
+
+  /// Construct an empty span
+  VoxelViewSpan() = default;
+
+  /// Construct a span over existing views
+  /// \param data Pointer to the first view
+  /// \param size Number of views
+  VoxelViewSpan(const value_type * const data, const std::size_t size) noexcept
+  : m_data{data}, m_size{size} {}
+
+  const_iterator begin() const noexcept {return m_data;}
+  const_iterator end() const noexcept {return m_data + m_size;}
+  std::size_t size() const noexcept {return m_size;}
+  bool8_t empty() const noexcept {return 0U == m_size;}
+  const value_type & operator[](const std::size_t idx) const noexcept {return m_data[idx];}
+
+private:
+  const value_type * m_data{nullptr};
+  std::size_t m_size{0U};
+};
+
 
 }  // namespace ndt
 }  // namespace localization
@@ -0,0 +1,180 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief This file defines a batched kernel computing the P2D NDT score, jacobian and hessian
+
+#ifndef NDT__P2D_NDT_KERNEL_HPP_
+#define NDT__P2D_NDT_KERNEL_HPP_
+
+#include <ndt/visibility_control.hpp>
+#include <common/types.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using autoware::common::types::bool8_t;
+using autoware::common::types::float64_t;
+
+namespace autoware
+{
+namespace localization
+{
+namespace ndt
+{
+
+/// Instruction set used to evaluate the P2D NDT kernel.
+enum class P2DNDTKernelIsa : uint8_t
+{
+  SCALAR = 0U,
+  AVX2
+};
+
+/// Angle dependent parameters shared by all points of a single pose evaluation:
+/// (eq. 6.19) and (eq. 6.21) [Magnusson 2009]. Each row is a 3 vector dotted with the point.
+struct NDT_PUBLIC P2DNDTKernelParameters
+{
+  float64_t gauss_d1{0.0};
+  float64_t gauss_d2{0.0};
+  bool8_t compute_jacobian{false};
+  bool8_t compute_hessian{false};
+  /// Rows are j_ang_a to j_ang_h
+  float64_t gradient[8U][3U]{};
+  /// Rows are h_ang_a2, h_ang_a3, h_ang_b2, h_ang_b3, h_ang_c2, h_ang_c3, h_ang_d1 to h_ang_d3,
+  /// h_ang_e1 to h_ang_e3 and h_ang_f1 to h_ang_f3
+  float64_t hessian[15U][3U]{};
+};
+
+/// Sums of the per point contributions of a batch. Only the upper triangle of the hessian is
+/// computed, in row major order.
+struct NDT_PUBLIC P2DNDTKernelResult
+{
+  static constexpr std::size_t NUM_HESSIAN_ENTRIES = 21U;
+  float64_t score{0.0};
+  float64_t jacobian[6U]{};
+  float64_t hessian[NUM_HESSIAN_ENTRIES]{};
+};
+
+/// Structure of arrays holding all point/cell pairs of a scan for one pose evaluation. Each pair
+/// stores the untransformed scan point, the transformed scan point, the cell centroid and the
+/// unique entries of the symmetric inverse covariance of the cell, each in its own contiguous
+/// array so that consecutive pairs can be loaded into SIMD lanes directly.
+class NDT_PUBLIC P2DNDTBatch
+{
+public:
+  /// Indices of the arrays
+  enum Field : uint8_t
+  {
+    POINT_X = 0U, POINT_Y, POINT_Z,
+    TRANSFORMED_X, TRANSFORMED_Y, TRANSFORMED_Z,
+    MEAN_X, MEAN_Y, MEAN_Z,
+    INV_COV_XX, INV_COV_XY, INV_COV_XZ, INV_COV_YY, INV_COV_YZ, INV_COV_ZZ,
+    NUM_FIELDS
+  };
+
+  /// Preallocate space for a number of pairs
+  /// \param capacity Number of pairs
+  void reserve(const std::size_t capacity)
+  {
+    for (auto & field : m_fields) {
+      field.reserve(capacity);
+    }
+  }
+
+  /// Remove all pairs, keeping the allocated memory
+  void clear() noexcept
+  {
+    for (auto & field : m_fields) {
+      field.clear();
+    }
+  }
+
+  /// Add a point/cell pair
+  /// \param point Scan point before the transformation, as x, y, z
+  /// \param transformed Scan point after the transformation, as x, y, z
+  /// \param mean Cell centroid, as x, y, z
+  /// \param inv_cov 3x3 inverse covariance of the cell. It is assumed to be symmetric, so either
+  ///                storage order can be used
+  void push_back(
+    const float64_t * const point, const float64_t * const transformed,
+    const float64_t * const mean, const float64_t * const inv_cov)
+  {
+    m_fields[POINT_X].push_back(point[0U]);
+    m_fields[POINT_Y].push_back(point[1U]);
+    m_fields[POINT_Z].push_back(point[2U]);
+    m_fields[TRANSFORMED_X].push_back(transformed[0U]);
+    m_fields[TRANSFORMED_Y].push_back(transformed[1U]);
+    m_fields[TRANSFORMED_Z].push_back(transformed[2U]);
+    m_fields[MEAN_X].push_back(mean[0U]);
+    m_fields[MEAN_Y].push_back(mean[1U]);
+    m_fields[MEAN_Z].push_back(mean[2U]);
+    m_fields[INV_COV_XX].push_back(inv_cov[0U]);
+    m_fields[INV_COV_XY].push_back(inv_cov[1U]);
+    m_fields[INV_COV_XZ].push_back(inv_cov[2U]);
+    m_fields[INV_COV_YY].push_back(inv_cov[4U]);
+    m_fields[INV_COV_YZ].push_back(inv_cov[5U]);
+    m_fields[INV_COV_ZZ].push_back(inv_cov[8U]);
+  }
+
+  /// Number of pairs in the batch
+  std::size_t size() const noexcept
+  {
+    return m_fields[0U].size();
+  }
+
+  /// Get the contiguous array of a field
+  /// \param field Field to access
+  /// \return Pointer to the first element, valid until the batch is modified
+  const float64_t * data(const Field field) const noexcept
+  {
+    return m_fields[field].data();
+  }
+
+private:
+  std::vector<float64_t> m_fields[NUM_FIELDS];
+};
+
+/// Check whether the AVX2 kernel was compiled in and the CPU supports it
+/// \return True if P2DNDTKernelIsa::AVX2 can be used
+NDT_PUBLIC bool8_t p2d_ndt_kernel_avx2_available() noexcept;
+
+/// Evaluate the pairs [begin, end) of a batch with the best available instruction set, and add
+/// their contributions to the result. The summation order only depends on begin and end.
+/// \param batch Batch of point/cell pairs
+/// \param begin Index of the first pair to evaluate
+/// \param end Index one past the last pair to evaluate
+/// \param params Parameters of the current pose
+/// \param result Result to accumulate into
+NDT_PUBLIC void evaluate_p2d_ndt_kernel(
+  const P2DNDTBatch & batch, std::size_t begin, std::size_t end,
+  const P2DNDTKernelParameters & params, P2DNDTKernelResult & result);
+
+/// Evaluate the pairs [begin, end) of a batch with the given instruction set, and add their
+/// contributions to the result.
+/// \param isa Instruction set to use
+/// \param batch Batch of point/cell pairs
+/// \param begin Index of the first pair to evaluate
+/// \param end Index one past the last pair to evaluate
+/// \param params Parameters of the current pose
+/// \param result Result to accumulate into
+/// \throw std::domain_error If the instruction set is not available
+NDT_PUBLIC void evaluate_p2d_ndt_kernel(
+  P2DNDTKernelIsa isa, const P2DNDTBatch & batch, std::size_t begin, std::size_t end,
+  const P2DNDTKernelParameters & params, P2DNDTKernelResult & result);
+
+}  // namespace ndt
+}  // namespace localization
+}  // namespace autoware
+
+#endif  // NDT__P2D_NDT_KERNEL_HPP_
@@ -15,10 +15,14 @@
 // Co-developed by Tier IV, Inc. and Apex.AI, Inc.
 
 #include <ndt/ndt_map.hpp>
+#include <ndt/ndt_map_file.hpp>
+#include <ndt/ndt_map_tiles.hpp>
 #include <ndt/utils.hpp>
 #include <sensor_msgs/point_cloud2_iterator.hpp>
 #include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
 #include <algorithm>
+#include <chrono>
+#include <iterator>
 #include <string>
 
 namespace autoware
@@ -27,6 +31,66 @@ namespace localization
 {
 namespace ndt
 {
+namespace
+{
+template<typename MapPoints>
+StaticNDTMap::Config read_config(const MapPoints & map_points)
+{
+  using PointXYZ = geometry_msgs::msg::Point32;
+  if (map_points.size() < DynamicNDTMap::kNumConfigPoints) {
+    throw std::runtime_error("StaticNDTMap: Point cloud representing the ndt map is empty.");
+  }
+
+  const auto map_size = map_points.size() - DynamicNDTMap::kNumConfigPoints;
+  const auto & min_point = map_points[0U];
+  const auto & max_point = map_points[1U];
+  const auto & voxel_size = map_points[2U];
+
+  return StaticNDTMap::Config{
+    PointXYZ{}.set__x(static_cast<float>(min_point.x)).set__y(static_cast<float>(min_point.y)).
+    set__z(static_cast<float>(min_point.z)),
+    PointXYZ{}.set__x(static_cast<float>(max_point.x)).set__y(static_cast<float>(max_point.y)).
+    set__z(static_cast<float>(max_point.z)),
+    PointXYZ{}.set__x(static_cast<float>(voxel_size.x)).set__y(static_cast<float>(voxel_size.y)).
+    set__z(static_cast<float>(voxel_size.z)),
+    map_size};
+}
+
+bool8_t same_dimensions(
+  const StaticNDTMap::Config & lhs, const StaticNDTMap::Config & rhs) noexcept
+{
+  const auto same_point = [](const auto & p1, const auto & p2) {
+      return (p1.x == p2.x) && (p1.y == p2.y) && (p1.z == p2.z);
+    };
+  return same_point(lhs.get_min_point(), rhs.get_min_point()) &&
+         same_point(lhs.get_max_point(), rhs.get_max_point()) &&
+         same_point(lhs.get_voxel_size(), rhs.get_voxel_size());
+}
+
+using FrozenVoxels = FrozenNDTGrid<StaticNDTVoxel>::Voxels;
+
+template<typename MapPoints>
+void append_voxels(
+  const MapPoints & map_points, const StaticNDTMap::Config & config, FrozenVoxels & voxels)
+{
+  for (auto it = std::next(map_points.begin(), DynamicNDTMap::kNumConfigPoints);
+    it != map_points.end(); ++it)
+  {
+    const auto & voxel_point = *it;
+    const Eigen::Vector3d centroid{voxel_point.x, voxel_point.y, voxel_point.z};
+    const auto voxel_idx = config.index(centroid);
+
+    Eigen::Matrix3d inv_covariance;
+    inv_covariance <<
+      voxel_point.icov_xx, voxel_point.icov_xy, voxel_point.icov_xz,
+      voxel_point.icov_xy, voxel_point.icov_yy, voxel_point.icov_yz,
+      voxel_point.icov_xz, voxel_point.icov_yz, voxel_point.icov_zz;
+    // If a voxel already exists at this point, the frozen grid keeps the last one.
+    voxels.emplace_back(voxel_idx, StaticNDTVoxel{centroid, inv_covariance});
+  }
+}
+}  // namespace
+
 DynamicNDTMap::DynamicNDTMap(const Config & voxel_grid_config)
 : m_grid{voxel_grid_config} {}
 
@@ -129,13 +193,14 @@ void DynamicNDTMap::serialize_as<StaticNDTMap>(sensor_msgs::msg::PointCloud2 & m
   }
 }
 
-const DynamicNDTMap::VoxelViewVector & DynamicNDTMap::cell(const Point & pt) const
+DynamicNDTMap::VoxelViewVector DynamicNDTMap::cell(const Point & pt) const
 {
-  return m_grid.cell(pt);
+  VoxelViewVector output_vector;
+  m_grid.cell(pt, output_vector);
+  return output_vector;
 }
 
-const DynamicNDTMap::VoxelViewVector & DynamicNDTMap::cell(float32_t x, float32_t y, float32_t z)
-const
+DynamicNDTMap::VoxelViewVector DynamicNDTMap::cell(float32_t x, float32_t y, float32_t z) const
 {
   return cell(Point({x, y, z}));
 }
@@ -172,120 +237,191 @@ StaticNDTMap::TimePoint StaticNDTMap::stamp() const noexcept
 
 bool StaticNDTMap::valid() const noexcept
 {
-  return m_grid && (m_grid->size() > 0U) && (!m_frame_id.empty());
+  return m_config && (size() > 0U) && (!m_frame_id.empty());
 }
 
 const StaticNDTMap::ConfigPoint & StaticNDTMap::cell_size() const
 {
-  if (!m_grid) {
+  if (!m_config) {
     throw std::runtime_error("Static ndt map was attempted to be used before a map was set.");
   }
-  return m_grid->cell_size();
+  return m_config->get_voxel_size();
 }
 
 void StaticNDTMap::set(const sensor_msgs::msg::PointCloud2 & msg)
 {
-  if (m_grid) {
-    m_grid->clear();
-  }
-  deserialize_from(msg);
+  set_points(NdtMapCloudView{msg});
   m_stamp = ::time_utils::from_message(msg.header.stamp);
   m_frame_id = msg.header.frame_id;
 }
 
-void StaticNDTMap::deserialize_from(const sensor_msgs::msg::PointCloud2 & msg)
+void StaticNDTMap::set(const NDTMapFile & map_file, const std::string & frame_id)
 {
-  using PointXYZ = geometry_msgs::msg::Point32;
-  constexpr auto num_config_fields = 3U;
-  NdtMapCloudView msg_view{msg};
-  if (msg_view.size() < num_config_fields) {
-    throw std::runtime_error("StaticNDTMap: Point cloud representing the ndt map is empty.");
-  }
-
-  const auto map_size = msg_view.size() - num_config_fields;
-  const auto & min_point = msg_view[0U];
-  const auto & max_point = msg_view[1U];
-  const auto & voxel_size = msg_view[2U];
-
-  const Config config{
-    PointXYZ{}.set__x(static_cast<float>(min_point.x)).set__y(static_cast<float>(min_point.y)).
-    set__z(static_cast<float>(min_point.z)),
-    PointXYZ{}.set__x(static_cast<float>(max_point.x)).set__y(static_cast<float>(max_point.y)).
-    set__z(static_cast<float>(max_point.z)),
-    PointXYZ{}.set__x(static_cast<float>(voxel_size.x)).set__y(static_cast<float>(voxel_size.y)).
-    set__z(static_cast<float>(voxel_size.z)),
-    map_size};
+  set_points(map_file);
+  m_stamp = std::chrono::system_clock::now();
+  m_frame_id = frame_id;
+}
 
-  // Either update the map config or initialize the map.
-  if (m_grid) {
-    m_grid->set_config(config);
+template<typename MapPoints>
+void StaticNDTMap::set_points(const MapPoints & map_points)
+{
+  const auto config = read_config(map_points);
+  MapTileIndex tile{};
+  float64_t tile_size{0.0};
+  if (read_map_tile_header(map_points[2U], tile, tile_size)) {
+    set_tile(map_points, config, tile, tile_size);
   } else {
-    m_grid.emplace(config);
+    deserialize_from(map_points, config);
   }
+}
 
-  for (auto it = std::next(msg_view.begin(), num_config_fields); it != msg_view.end(); ++it) {
-    const auto & voxel_point = *it;
-    const Point centroid{voxel_point.x, voxel_point.y, voxel_point.z};
-    const auto voxel_idx = m_grid->index(centroid);
-
-    Eigen::Matrix3d inv_covariance;
-    inv_covariance <<
-      voxel_point.icov_xx, voxel_point.icov_xy, voxel_point.icov_xz,
-      voxel_point.icov_xy, voxel_point.icov_yy, voxel_point.icov_yz,
-      voxel_point.icov_xz, voxel_point.icov_yz, voxel_point.icov_zz;
-    const Voxel vx{centroid, inv_covariance};
+template<typename MapPoints>
+void StaticNDTMap::set_tile(
+  const MapPoints & map_points, const Config & config, const MapTileIndex & tile,
+  const float64_t tile_size)
+{
+  const MapTileLayout layout{config, tile_size};
+  if (!m_config || !same_dimensions(*m_config, config)) {
+    // Tiles of another map can not be combined with the current voxels
+    m_grids.clear();
+    m_config.emplace(config);
+  } else if (!m_tile_layout || (m_tile_layout->tile_size() != tile_size)) {
+    split_into_tiles(layout);
+  }
+  m_tile_layout.emplace(layout);
+
+  // Only the lookup structure of this tile is rebuilt
+  m_grids.erase(tile);
+  FrozenVoxels voxels;
+  voxels.reserve(map_points.size() - DynamicNDTMap::kNumConfigPoints);
+  append_voxels(map_points, config, voxels);
+  if (!voxels.empty()) {
+    m_grids.emplace(tile, FrozenNDTGrid<StaticNDTVoxel>{config, std::move(voxels)});
+  }
+}
 
-    const auto insert_res = m_grid->emplace_voxel(voxel_idx, Voxel{centroid, inv_covariance});
-    if (!insert_res.second) {
-      // if a voxel already exist at this point, replace.
-      insert_res.first->second = vx;
+void StaticNDTMap::split_into_tiles(const MapTileLayout & layout)
+{
+  std::map<MapTileIndex, FrozenVoxels> tile_voxels;
+  // Release each grid once its voxels are copied, so that the map is not held twice
+  while (!m_grids.empty()) {
+    const auto grid_it = m_grids.begin();
+    for (const auto & vx : grid_it->second) {
+      tile_voxels[layout.tile_of(m_config->centroid<Point>(vx.first))].push_back(vx);
     }
+    m_grids.erase(grid_it);
+  }
+  for (auto & tile_it : tile_voxels) {
+    m_grids.emplace(
+      tile_it.first, FrozenNDTGrid<StaticNDTVoxel>{*m_config, std::move(tile_it.second)});
   }
 }
-const StaticNDTMap::VoxelViewVector & StaticNDTMap::cell(const Point & pt) const
+
+template<typename MapPoints>
+void StaticNDTMap::deserialize_from(const MapPoints & map_points, const Config & config)
+{
+  // Release the current voxels first, so that only one map is kept in memory at a time
+  m_grids.clear();
+  m_tile_layout = std::experimental::nullopt;
+  m_config.emplace(config);
+  FrozenVoxels voxels;
+  voxels.reserve(map_points.size() - DynamicNDTMap::kNumConfigPoints);
+  append_voxels(map_points, config, voxels);
+  m_grids.emplace(MapTileIndex{0, 0}, FrozenNDTGrid<StaticNDTVoxel>{config, std::move(voxels)});
+}
+
+StaticNDTMap::VoxelViewSpan StaticNDTMap::cell(const Point & pt) const
 {
-  if (!m_grid) {
+  if (!m_config) {
     throw std::runtime_error("Static ndt map was attempted to be used before a map was set.");
   }
-  return m_grid->cell(pt);
+  const auto grid_it = m_tile_layout ? m_grids.find(m_tile_layout->tile_of(pt)) : m_grids.begin();
+  if (grid_it == m_grids.end()) {
+    return VoxelViewSpan{};
+  }
+  return grid_it->second.cell(pt);
 }
 
-const StaticNDTMap::VoxelViewVector & StaticNDTMap::cell(float32_t x, float32_t y, float32_t z)
-const
+StaticNDTMap::VoxelViewSpan StaticNDTMap::cell(float32_t x, float32_t y, float32_t z) const
 {
   return cell(Point({x, y, z}));
 }
 
 std::size_t StaticNDTMap::size() const
 {
-  if (!m_grid) {
+  if (!m_config) {
     throw std::runtime_error("Static ndt map was attempted to be used before a map was set.");
   }
-  return m_grid->size();
+  std::size_t ret = 0U;
+  for (const auto & grid_it : m_grids) {
+    ret += grid_it.second.size();
+  }
+  return ret;
 }
 
-typename StaticNDTMap::VoxelGrid::const_iterator StaticNDTMap::begin() const
+StaticNDTMap::const_iterator StaticNDTMap::begin() const
 {
-  if (!m_grid) {
+  if (!m_config) {
     throw std::runtime_error("Static ndt map was attempted to be used before a map was set.");
   }
-  return m_grid->cbegin();
+  return const_iterator{m_grids.begin(), m_grids.end()};
 }
 
-typename StaticNDTMap::VoxelGrid::const_iterator StaticNDTMap::end() const
+StaticNDTMap::const_iterator StaticNDTMap::end() const
 {
-  if (!m_grid) {
+  if (!m_config) {
     throw std::runtime_error("Static ndt map was attempted to be used before a map was set.");
   }
-  return m_grid->cend();
+  return const_iterator{m_grids.end(), m_grids.end()};
 }
 
 void StaticNDTMap::clear()
 {
-  if (!m_grid) {
+  if (!m_config) {
     throw std::runtime_error("Static ndt map was attempted to be used before a map was set.");
   }
-  m_grid->clear();
+  m_grids.clear();
+}
+
+StaticNDTMap::const_iterator::const_iterator(
+  TileGrids::const_iterator grid_it, TileGrids::const_iterator grid_end)
+: m_grid_it{grid_it}, m_grid_end{grid_end}
+{
+  if (m_grid_it != m_grid_end) {
+    m_voxel_it = m_grid_it->second.begin();
+    skip_finished_grids();
+  }
+}
+
+StaticNDTMap::const_iterator & StaticNDTMap::const_iterator::operator++()
+{
+  ++m_voxel_it;
+  skip_finished_grids();
+  return *this;
+}
+
+StaticNDTMap::const_iterator StaticNDTMap::const_iterator::operator++(int)
+{
+  const auto ret = *this;
+  ++(*this);
+  return ret;
+}
+
+bool8_t StaticNDTMap::const_iterator::operator==(const const_iterator & other) const noexcept
+{
+  return (m_grid_it == other.m_grid_it) &&
+         ((m_grid_it == m_grid_end) || (m_voxel_it == other.m_voxel_it));
+}
+
+void StaticNDTMap::const_iterator::skip_finished_grids()
+{
+  while (m_voxel_it == m_grid_it->second.end()) {
+    ++m_grid_it;
+    if (m_grid_it == m_grid_end) {
+      return;
+    }
+    m_voxel_it = m_grid_it->second.begin();
+  }
 }
 }  // namespace ndt
 }  // namespace localization
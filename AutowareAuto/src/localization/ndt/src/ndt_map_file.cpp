@@ -0,0 +1,143 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <ndt/ndt_map_file.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace autoware
+{
+namespace localization
+{
+namespace ndt
+{
+namespace
+{
+constexpr char kMagic[4U] = {'N', 'D', 'T', 'M'};
+
+struct FileHeader
+{
+  char magic[4U];
+  uint32_t version;
+  uint64_t num_points;
+};
+static_assert(sizeof(FileHeader) == 16U, "Unexpected padding in the ndt map file header");
+static_assert(
+  sizeof(PointWithCovariances) == 9U * sizeof(float64_t),
+  "Unexpected padding in the ndt map file points");
+}  // namespace
+
+constexpr uint32_t NDTMapFile::kVersion;
+
+NDTMapFile::NDTMapFile(const std::string & file_name)
+{
+  const auto fd = ::open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("NDT map file " + file_name + " could not be opened.");
+  }
+  struct stat file_stat {};
+  if ((::fstat(fd, &file_stat) != 0) ||
+    (static_cast<std::size_t>(file_stat.st_size) < sizeof(FileHeader)))
+  {
+    (void) ::close(fd);
+    throw std::runtime_error("NDT map file " + file_name + " is too short.");
+  }
+  m_length = static_cast<std::size_t>(file_stat.st_size);
+  m_data = ::mmap(nullptr, m_length, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after closing the file
+  (void) ::close(fd);
+  if (MAP_FAILED == m_data) {
+    m_data = nullptr;
+    throw std::runtime_error("NDT map file " + file_name + " could not be mapped.");
+  }
+
+  FileHeader header{};
+  std::memcpy(&header, m_data, sizeof(header));
+  const auto data_length = m_length - sizeof(FileHeader);
+  if ((std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) || (header.version != kVersion) ||
+    (header.num_points != data_length / sizeof(PointWithCovariances)) ||
+    (data_length % sizeof(PointWithCovariances) != 0U))
+  {
+    (void) ::munmap(m_data, m_length);
+    throw std::runtime_error("NDT map file " + file_name + " is not a valid ndt map file.");
+  }
+  // The mapping is page aligned, so the points are aligned as well
+  m_points = reinterpret_cast<const PointWithCovariances *>(
+    static_cast<const uint8_t *>(m_data) + sizeof(FileHeader));
+  m_size = static_cast<std::size_t>(header.num_points);
+}
+
+NDTMapFile::~NDTMapFile()
+{
+  (void) ::munmap(m_data, m_length);
+}
+
+const PointWithCovariances * NDTMapFile::begin() const noexcept
+{
+  return m_points;
+}
+
+const PointWithCovariances * NDTMapFile::end() const noexcept
+{
+  return m_points + m_size;
+}
+
+std::size_t NDTMapFile::size() const noexcept
+{
+  return m_size;
+}
+
+const PointWithCovariances & NDTMapFile::operator[](const std::size_t idx) const noexcept
+{
+  return m_points[idx];
+}
+
+void NDTMapFile::to_message(
+  const std::string & frame_id, sensor_msgs::msg::PointCloud2 & msg) const
+{
+  NdtMapCloudModifier modifier{msg, frame_id};
+  modifier.resize(m_size);
+  // The message stores the points with the same layout
+  std::memcpy(msg.data.data(), m_points, m_size * sizeof(PointWithCovariances));
+}
+
+void write_ndt_map_file(const std::string & file_name, const sensor_msgs::msg::PointCloud2 & msg)
+{
+  const NdtMapCloudView msg_view{msg};
+  FileHeader header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = NDTMapFile::kVersion;
+  header.num_points = msg_view.size();
+
+  std::ofstream file{file_name, std::ios::binary};
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  for (const auto & point : msg_view) {
+    file.write(reinterpret_cast<const char *>(&point), sizeof(point));
+  }
+  if (!file) {
+    throw std::runtime_error("NDT map file " + file_name + " could not be written.");
+  }
+}
+
+}  // namespace ndt
+}  // namespace localization
+}  // namespace autoware
@@ -130,13 +130,8 @@ void read_from_pcd(const std::string & file_name, sensor_msgs::msg::PointCloud2
   *msg = std::move(adjusted_cloud);
 }
 
-geocentric_pose_t load_map(
-  const std::string & yaml_file_name,
-  const std::string & pcl_file_name,
-  sensor_msgs::msg::PointCloud2 & pc_out)
+geocentric_pose_t read_map_origin(const std::string & yaml_file_name)
 {
-  using autoware::common::types::PointXYZI;
-  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>{pc_out}.clear();
   geodetic_pose_t geodetic_pose{0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
 
   if (!yaml_file_name.empty()) {
@@ -145,12 +140,6 @@ geocentric_pose_t load_map(
     throw std::runtime_error("YAML file name empty\n");
   }
 
-  if (!pcl_file_name.empty()) {
-    read_from_pcd(pcl_file_name, &pc_out);
-  } else {
-    throw std::runtime_error("PCD file name empty\n");
-  }
-
   float64_t x(0.0), y(0.0), z(0.0);
 
   GeographicLib::Geocentric earth(
@@ -165,6 +154,25 @@ geocentric_pose_t load_map(
 
   return {x, y, z, geodetic_pose.roll, geodetic_pose.pitch, geodetic_pose.yaw};
 }
+
+geocentric_pose_t load_map(
+  const std::string & yaml_file_name,
+  const std::string & pcl_file_name,
+  sensor_msgs::msg::PointCloud2 & pc_out)
+{
+  using autoware::common::types::PointXYZI;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>{pc_out}.clear();
+
+  const auto origin = read_map_origin(yaml_file_name);
+
+  if (!pcl_file_name.empty()) {
+    read_from_pcd(pcl_file_name, &pc_out);
+  } else {
+    throw std::runtime_error("PCD file name empty\n");
+  }
+
+  return origin;
+}
 }  // namespace ndt
 }  // namespace localization
 }  // namespace autoware
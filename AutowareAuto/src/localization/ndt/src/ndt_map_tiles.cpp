@@ -0,0 +1,446 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <common/filesystem.hpp>
+#include <ndt/ndt_map.hpp>
+#include <ndt/ndt_map_file.hpp>
+#include <ndt/ndt_map_tiles.hpp>
+#include <ndt/utils.hpp>
+#include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
+#include <yaml-cpp/yaml.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace autoware
+{
+namespace localization
+{
+namespace ndt
+{
+namespace
+{
+// Tiles are stored as ndt map files, with the tile index in the configuration points
+constexpr auto kTilesYamlFile = "tiles.yaml";
+
+using PointXYZ = geometry_msgs::msg::Point32;
+
+std::string tile_file_name(const std::string & directory, const MapTileIndex & tile)
+{
+  const auto file_name =
+    "tile_" + std::to_string(tile.x) + "_" + std::to_string(tile.y) + ".bin";
+  return (ghc::filesystem::path{directory} / file_name).string();
+}
+
+void push_config_points(
+  NdtMapCloudModifier & modifier, const MapTileLayout & layout, const MapTileIndex & tile)
+{
+  const auto & min_point = layout.config().get_min_point();
+  const auto & max_point = layout.config().get_max_point();
+  const auto & size = layout.config().get_voxel_size();
+  modifier.push_back(
+    PointWithCovariances{min_point.x, min_point.y, min_point.z,
+      0.0, 0.0, 0.0, 0.0, 0.0, 0.0});
+  modifier.push_back(
+    PointWithCovariances{max_point.x, max_point.y, max_point.z,
+      0.0, 0.0, 0.0, 0.0, 0.0, 0.0});
+  modifier.push_back(
+    PointWithCovariances{size.x, size.y, size.z,
+      layout.tile_size(), static_cast<float64_t>(tile.x), static_cast<float64_t>(tile.y),
+      0.0, 0.0, kMapTileMarker});
+}
+
+YAML::Node to_yaml(const PointXYZ & pt)
+{
+  YAML::Node node;
+  node.push_back(pt.x);
+  node.push_back(pt.y);
+  node.push_back(pt.z);
+  return node;
+}
+
+PointXYZ point_from_yaml(const YAML::Node & node)
+{
+  if (!node.IsSequence() || (node.size() != 3U)) {
+    throw std::runtime_error("Tiles yaml file: expected a point with 3 coordinates\n");
+  }
+  return PointXYZ{}.set__x(node[0U].as<float32_t>()).set__y(node[1U].as<float32_t>()).
+         set__z(node[2U].as<float32_t>());
+}
+}  // namespace
+
+bool8_t operator==(const MapTileIndex & lhs, const MapTileIndex & rhs) noexcept
+{
+  return (lhs.x == rhs.x) && (lhs.y == rhs.y);
+}
+
+bool8_t operator<(const MapTileIndex & lhs, const MapTileIndex & rhs) noexcept
+{
+  return (lhs.x < rhs.x) || ((lhs.x == rhs.x) && (lhs.y < rhs.y));
+}
+
+MapTileLayout::MapTileLayout(const Config & config, const float64_t tile_size)
+: m_config{config}, m_tile_size{tile_size}
+{
+  const auto is_multiple = [tile_size](const float32_t voxel_size) {
+      const auto num_voxels = tile_size / static_cast<float64_t>(voxel_size);
+      return (std::round(num_voxels) >= 1.0) &&
+             (std::fabs(num_voxels - std::round(num_voxels)) < 1.0e-3);
+    };
+  if (!std::isfinite(tile_size) || !is_multiple(config.get_voxel_size().x) ||
+    !is_multiple(config.get_voxel_size().y))
+  {
+    throw std::domain_error(
+            "MapTileLayout: tile size must be a positive multiple of the voxel size");
+  }
+}
+
+const MapTileLayout::Config & MapTileLayout::config() const noexcept
+{
+  return m_config;
+}
+
+float64_t MapTileLayout::tile_size() const noexcept
+{
+  return m_tile_size;
+}
+
+MapTileIndex MapTileLayout::tile_of(const Point & pt) const
+{
+  // Use the center of the voxel, so that points at tile borders end up in the tile of their voxel
+  const auto center = m_config.centroid<Point>(m_config.index(pt));
+  const auto & min_point = m_config.get_min_point();
+  return MapTileIndex{
+    static_cast<int32_t>(std::floor((center(0U) - min_point.x) / m_tile_size)),
+    static_cast<int32_t>(std::floor((center(1U) - min_point.y) / m_tile_size))};
+}
+
+float64_t MapTileLayout::distance(
+  const MapTileIndex & tile, const float64_t x, const float64_t y) const noexcept
+{
+  const auto min_x = m_config.get_min_point().x + (tile.x * m_tile_size);
+  const auto min_y = m_config.get_min_point().y + (tile.y * m_tile_size);
+  const auto dx = std::max(0.0, std::max(min_x - x, x - (min_x + m_tile_size)));
+  const auto dy = std::max(0.0, std::max(min_y - y, y - (min_y + m_tile_size)));
+  return std::hypot(dx, dy);
+}
+
+bool8_t read_map_tile_header(
+  const sensor_msgs::msg::PointCloud2 & msg, MapTileIndex & tile, float64_t & tile_size)
+{
+  NdtMapCloudView msg_view{msg};
+  if (msg_view.size() < DynamicNDTMap::kNumConfigPoints) {
+    throw std::runtime_error("Point cloud representing the ndt map is empty.");
+  }
+  return read_map_tile_header(msg_view[2U], tile, tile_size);
+}
+
+bool8_t read_map_tile_header(
+  const PointWithCovariances & voxel_size, MapTileIndex & tile, float64_t & tile_size) noexcept
+{
+  if (voxel_size.icov_zz != kMapTileMarker) {
+    return false;
+  }
+  tile_size = voxel_size.icov_xx;
+  tile = MapTileIndex{static_cast<int32_t>(voxel_size.icov_xy),
+    static_cast<int32_t>(voxel_size.icov_xz)};
+  return true;
+}
+
+void make_map_tile_removal(
+  const MapTileLayout & layout, const MapTileIndex & tile, const std::string & frame_id,
+  sensor_msgs::msg::PointCloud2 & msg)
+{
+  NdtMapCloudModifier modifier{msg, frame_id};
+  push_config_points(modifier, layout, tile);
+}
+
+std::size_t write_map_tiles(
+  const sensor_msgs::msg::PointCloud2 & cloud, const MapTileLayout & layout,
+  const std::string & directory)
+{
+  using autoware::common::types::PointXYZI;
+  std::map<MapTileIndex, std::vector<PointXYZI>> tile_points;
+  for (const auto & point : point_cloud_msg_wrapper::PointCloud2View<PointXYZI>{cloud}) {
+    tile_points[layout.tile_of({point.x, point.y, point.z})].push_back(point);
+  }
+
+  std::error_code error;
+  ghc::filesystem::create_directories(directory, error);
+  if (error) {
+    throw std::runtime_error("Could not create the map tile directory " + directory);
+  }
+
+  YAML::Node tile_list;
+  for (const auto & tile_it : tile_points) {
+    const auto & tile = tile_it.first;
+    sensor_msgs::msg::PointCloud2 tile_cloud;
+    point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> cloud_modifier{
+      tile_cloud, cloud.header.frame_id};
+    cloud_modifier.reserve(tile_it.second.size());
+    for (const auto & point : tile_it.second) {
+      cloud_modifier.push_back(point);
+    }
+    // All tiles share the configuration of the whole map, so that voxel indices match
+    DynamicNDTMap tile_map{layout.config()};
+    tile_map.insert(tile_cloud);
+    sensor_msgs::msg::PointCloud2 serialized_tile;
+    tile_map.serialize_as<StaticNDTMap>(serialized_tile);
+
+    NdtMapCloudView serialized_view{serialized_tile};
+    if (serialized_view.size() <= DynamicNDTMap::kNumConfigPoints) {
+      // No usable voxels in this tile
+      continue;
+    }
+    sensor_msgs::msg::PointCloud2 tile_msg;
+    NdtMapCloudModifier tile_modifier{tile_msg, cloud.header.frame_id};
+    tile_modifier.reserve(serialized_view.size());
+    push_config_points(tile_modifier, layout, tile);
+    for (auto it = std::next(serialized_view.begin(), DynamicNDTMap::kNumConfigPoints);
+      it != serialized_view.end(); ++it)
+    {
+      tile_modifier.push_back(*it);
+    }
+
+    write_ndt_map_file(tile_file_name(directory, tile), tile_msg);
+
+    YAML::Node tile_node;
+    tile_node.push_back(tile.x);
+    tile_node.push_back(tile.y);
+    tile_list.push_back(tile_node);
+  }
+
+  YAML::Node tiles_info;
+  tiles_info["tile_size"] = layout.tile_size();
+  tiles_info["min_point"] = to_yaml(layout.config().get_min_point());
+  tiles_info["max_point"] = to_yaml(layout.config().get_max_point());
+  tiles_info["voxel_size"] = to_yaml(layout.config().get_voxel_size());
+  tiles_info["tiles"] = tile_list;
+  const auto yaml_file_name = (ghc::filesystem::path{directory} / kTilesYamlFile).string();
+  std::ofstream yaml_file{yaml_file_name};
+  yaml_file << tiles_info;
+  if (!yaml_file) {
+    throw std::runtime_error("Could not write the map tile file " + yaml_file_name);
+  }
+  return tile_list.size();
+}
+
+MapTileLayout read_map_tile_layout(
+  const std::string & directory, std::vector<MapTileIndex> & tiles)
+{
+  try {
+    const auto tiles_info =
+      YAML::LoadFile((ghc::filesystem::path{directory} / kTilesYamlFile).string());
+    if (!tiles_info["tile_size"] || !tiles_info["min_point"] || !tiles_info["max_point"] ||
+      !tiles_info["voxel_size"] || !tiles_info["tiles"])
+    {
+      throw std::runtime_error("Tiles yaml file: tile layout not found\n");
+    }
+    tiles.clear();
+    for (const auto & tile_node : tiles_info["tiles"]) {
+      tiles.push_back({tile_node[0U].as<int32_t>(), tile_node[1U].as<int32_t>()});
+    }
+    std::sort(tiles.begin(), tiles.end());
+    // Only the dimensions of the grid are used, no voxels are allocated for the layout
+    const MapTileLayout::Config config{
+      point_from_yaml(tiles_info["min_point"]),
+      point_from_yaml(tiles_info["max_point"]),
+      point_from_yaml(tiles_info["voxel_size"]),
+      1U};
+    return MapTileLayout{config, tiles_info["tile_size"].as<float64_t>()};
+  } catch (const YAML::BadFile & ex) {
+    throw std::runtime_error("Tiles yaml file not found\n");
+  } catch (const YAML::Exception & ex) {
+    throw std::runtime_error("Tiles yaml syntax error\n");
+  }
+}
+
+void read_map_tile(
+  const std::string & directory, const MapTileIndex & tile, const std::string & frame_id,
+  sensor_msgs::msg::PointCloud2 & msg)
+{
+  const auto file_name = tile_file_name(directory, tile);
+  const NDTMapFile map_file{file_name};
+  MapTileIndex file_tile{};
+  float64_t tile_size{0.0};
+  if ((map_file.size() < DynamicNDTMap::kNumConfigPoints) ||
+    !read_map_tile_header(map_file[2U], file_tile, tile_size) || !(file_tile == tile))
+  {
+    throw std::runtime_error("Map tile file " + file_name + " could not be loaded.");
+  }
+  map_file.to_message(frame_id, msg);
+}
+
+MapTileLoader::MapTileLoader(
+  const std::string & directory, const float64_t radius, const std::string & frame_id)
+: m_directory{directory},
+  m_radius{radius},
+  m_frame_id{frame_id},
+  m_layout{read_map_tile_layout(directory, m_tiles)}
+{
+  if (!(radius >= 0.0)) {
+    throw std::domain_error("MapTileLoader: load radius must not be negative");
+  }
+  m_thread = std::thread{[this] {run();}};
+}
+
+MapTileLoader::~MapTileLoader()
+{
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_stop = true;
+  }
+  m_condition.notify_all();
+  m_thread.join();
+}
+
+void MapTileLoader::update(const float64_t x, const float64_t y)
+{
+  const auto tile_size = m_layout.tile_size();
+  const auto evict_radius = m_radius + (0.5 * tile_size);
+  std::vector<std::pair<float64_t, MapTileIndex>> queued;
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    for (auto it = m_states.begin(); it != m_states.end(); ) {
+      const auto tile = it->first;
+      auto & state = it->second;
+      if ((TileState::FAILED == state) || (m_layout.distance(tile, x, y) <= evict_radius)) {
+        ++it;
+        continue;
+      }
+      if (TileState::LOADING == state) {
+        // The background thread drops the tile once it is read
+        state = TileState::CANCELLED;
+        ++it;
+        continue;
+      }
+      if (TileState::RESIDENT == state) {
+        sensor_msgs::msg::PointCloud2 msg;
+        make_map_tile_removal(m_layout, tile, m_frame_id, msg);
+        m_messages.push_back(std::move(msg));
+      }
+      if (TileState::CANCELLED != state) {
+        it = m_states.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    // Candidates are looked up in the sorted tile list, rather than checking every tile
+    const auto & min_point = m_layout.config().get_min_point();
+    const auto first_x = static_cast<int32_t>(std::floor((x - m_radius - min_point.x) / tile_size));
+    const auto last_x = static_cast<int32_t>(std::floor((x + m_radius - min_point.x) / tile_size));
+    const auto first_y = static_cast<int32_t>(std::floor((y - m_radius - min_point.y) / tile_size));
+    const auto last_y = static_cast<int32_t>(std::floor((y + m_radius - min_point.y) / tile_size));
+    for (auto tile_x = first_x; tile_x <= last_x; ++tile_x) {
+      auto it = std::lower_bound(m_tiles.begin(), m_tiles.end(), MapTileIndex{tile_x, first_y});
+      for (; (it != m_tiles.end()) && (it->x == tile_x) && (it->y <= last_y); ++it) {
+        const auto distance = m_layout.distance(*it, x, y);
+        if (distance > m_radius) {
+          continue;
+        }
+        const auto state_it = m_states.find(*it);
+        if (state_it == m_states.end()) {
+          m_states.emplace(*it, TileState::QUEUED);
+        } else if (TileState::CANCELLED == state_it->second) {
+          state_it->second = TileState::LOADING;
+        }
+      }
+    }
+
+    // Load the closest tiles first
+    for (const auto & state_it : m_states) {
+      if (TileState::QUEUED == state_it.second) {
+        queued.emplace_back(m_layout.distance(state_it.first, x, y), state_it.first);
+      }
+    }
+    std::sort(queued.begin(), queued.end());
+    m_queue.clear();
+    for (const auto & tile : queued) {
+      m_queue.push_back(tile.second);
+    }
+  }
+  if (!queued.empty()) {
+    m_condition.notify_one();
+  }
+}
+
+void MapTileLoader::take_updates(
+  std::vector<sensor_msgs::msg::PointCloud2> & messages, std::vector<std::string> & errors)
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  std::move(m_messages.begin(), m_messages.end(), std::back_inserter(messages));
+  std::move(m_errors.begin(), m_errors.end(), std::back_inserter(errors));
+  m_messages.clear();
+  m_errors.clear();
+}
+
+const MapTileLayout & MapTileLoader::layout() const noexcept
+{
+  return m_layout;
+}
+
+std::size_t MapTileLoader::max_resident_tiles() const noexcept
+{
+  // Resident tiles intersect a circle of the eviction radius, so they fit in its bounding box
+  const auto evict_diameter = (2.0 * m_radius) + m_layout.tile_size();
+  const auto tiles_per_axis =
+    static_cast<std::size_t>(std::ceil(evict_diameter / m_layout.tile_size())) + 1U;
+  return tiles_per_axis * tiles_per_axis;
+}
+
+void MapTileLoader::run()
+{
+  std::unique_lock<std::mutex> lock{m_mutex};
+  while (true) {
+    m_condition.wait(lock, [this] {return m_stop || !m_queue.empty();});
+    if (m_stop) {
+      return;
+    }
+    const auto tile = m_queue.front();
+    m_queue.pop_front();
+    m_states[tile] = TileState::LOADING;
+
+    lock.unlock();
+    sensor_msgs::msg::PointCloud2 msg;
+    std::string error{};
+    try {
+      read_map_tile(m_directory, tile, m_frame_id, msg);
+    } catch (const std::exception & ex) {
+      error = ex.what();
+    }
+    lock.lock();
+
+    auto & state = m_states[tile];
+    if (TileState::CANCELLED == state) {
+      (void) m_states.erase(tile);
+    } else if (error.empty()) {
+      state = TileState::RESIDENT;
+      m_messages.push_back(std::move(msg));
+    } else {
+      state = TileState::FAILED;
+      m_errors.push_back(std::move(error));
+    }
+  }
+}
+
+}  // namespace ndt
+}  // namespace localization
+}  // namespace autoware
@@ -0,0 +1,100 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <ndt/p2d_ndt_kernel.hpp>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "p2d_ndt_kernel_impl.hpp"
+
+namespace autoware
+{
+namespace localization
+{
+namespace ndt
+{
+namespace
+{
+/// One pair at a time, using the standard library exponential
+struct ScalarLane
+{
+  using Value = float64_t;
+  static constexpr std::size_t WIDTH = 1U;
+
+  static Value set1(const float64_t value) {return value;}
+  static Value load(const float64_t * const ptr) {return *ptr;}
+  static Value exp(const Value x) {return std::exp(x);}
+  static float64_t sum(const Value x) {return x;}
+  static Value keep_first(const Value x, const std::size_t) {return x;}
+  static Value valid_probability_or_zero(const Value p)
+  {
+    constexpr auto eps = std::numeric_limits<float64_t>::epsilon();
+    return ((p >= -eps) && (p <= (1.0 + eps))) ? p : 0.0;
+  }
+};
+
+void check_range(const P2DNDTBatch & batch, const std::size_t begin, const std::size_t end)
+{
+  if ((begin > end) || (end > batch.size())) {
+    throw std::out_of_range{"P2DNDTKernel: pair range is outside of the batch"};
+  }
+}
+}  // namespace
+
+bool8_t p2d_ndt_kernel_avx2_available() noexcept
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  static const bool8_t available = detail::p2d_ndt_kernel_avx2_compiled() &&
+    __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  return available;
+#else
+  return false;
+#endif
+}
+
+void evaluate_p2d_ndt_kernel(
+  const P2DNDTBatch & batch, const std::size_t begin, const std::size_t end,
+  const P2DNDTKernelParameters & params, P2DNDTKernelResult & result)
+{
+  const auto isa = p2d_ndt_kernel_avx2_available() ? P2DNDTKernelIsa::AVX2 :
+    P2DNDTKernelIsa::SCALAR;
+  evaluate_p2d_ndt_kernel(isa, batch, begin, end, params, result);
+}
+
+void evaluate_p2d_ndt_kernel(
+  const P2DNDTKernelIsa isa, const P2DNDTBatch & batch, const std::size_t begin,
+  const std::size_t end, const P2DNDTKernelParameters & params, P2DNDTKernelResult & result)
+{
+  check_range(batch, begin, end);
+  const float64_t * fields[P2DNDTBatch::NUM_FIELDS];
+  for (std::size_t field = 0U; field < P2DNDTBatch::NUM_FIELDS; ++field) {
+    fields[field] = batch.data(static_cast<P2DNDTBatch::Field>(field)) + begin;
+  }
+  switch (isa) {
+    case P2DNDTKernelIsa::SCALAR:
+      detail::evaluate_lanes<ScalarLane>(fields, end - begin, params, result);
+      break;
+    case P2DNDTKernelIsa::AVX2:
+      if (!p2d_ndt_kernel_avx2_available()) {
+        throw std::domain_error{"P2DNDTKernel: AVX2 is not available"};
+      }
+      detail::evaluate_p2d_ndt_kernel_avx2(fields, end - begin, params, result);
+      break;
+    default:
+      throw std::domain_error{"P2DNDTKernel: unknown instruction set"};
+  }
+}
+}  // namespace ndt
+}  // namespace localization
+}  // namespace autoware
@@ -0,0 +1,135 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// This translation unit is compiled with AVX2 and FMA enabled on x86 targets. It must not use
+// any inline function which is also used by the other translation units, since the linker could
+// pick the AVX2 version for them. Only call it after checking p2d_ndt_kernel_avx2_available().
+
+#include <cstddef>
+#include <stdexcept>
+#include "p2d_ndt_kernel_impl.hpp"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+namespace autoware
+{
+namespace localization
+{
+namespace ndt
+{
+namespace detail
+{
+#if defined(__AVX2__) && defined(__FMA__)
+namespace
+{
+/// Four pairs at a time. Arithmetic uses the vector extensions of GCC and clang.
+struct Avx2Lane
+{
+  using Value = __m256d;
+  static constexpr std::size_t WIDTH = 4U;
+
+  static Value set1(const float64_t value) {return _mm256_set1_pd(value);}
+  static Value load(const float64_t * const ptr) {return _mm256_loadu_pd(ptr);}
+
+  static float64_t sum(const Value x)
+  {
+    const __m128d pairs = _mm_add_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pairs, _mm_unpackhi_pd(pairs, pairs)));
+  }
+
+  static Value keep_first(const Value x, const std::size_t count)
+  {
+    if (count >= WIDTH) {
+      return x;
+    }
+    const __m256i lane = _mm256_set_epi64x(3, 2, 1, 0);
+    const __m256i mask = _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<int64_t>(count)), lane);
+    return _mm256_and_pd(x, _mm256_castsi256_pd(mask));
+  }
+
+  static Value valid_probability_or_zero(const Value p)
+  {
+    // Same bounds as is_valid_probability(), NaN fails both comparisons
+    constexpr float64_t eps = 2.220446049250313080847e-16;
+    const Value lower = _mm256_cmp_pd(p, _mm256_set1_pd(-eps), _CMP_GE_OQ);
+    const Value upper = _mm256_cmp_pd(p, _mm256_set1_pd(1.0 + eps), _CMP_LE_OQ);
+    return _mm256_and_pd(p, _mm256_and_pd(lower, upper));
+  }
+
+  /// Exponential using the range reduction and Pade approximation of the Cephes library, with a
+  /// relative error in the order of the machine epsilon. Results which would underflow are zero
+  /// and NaN is propagated.
+  static Value exp(const Value x)
+  {
+    constexpr float64_t max_log = 709.43613930310391424428;
+    constexpr float64_t min_log = -708.39641853226410622;
+    constexpr float64_t log2e = 1.4426950408889634073599;
+    constexpr float64_t ln2_hi = 6.93145751953125E-1;
+    constexpr float64_t ln2_lo = 1.42860682030941723212E-6;
+    // max(a, b) returns b if either operand is NaN, so NaN is kept by passing it second
+    const Value clamped = _mm256_min_pd(
+      _mm256_set1_pd(max_log), _mm256_max_pd(_mm256_set1_pd(min_log), x));
+    // x = n ln2 + r, |r| <= ln2 / 2
+    const Value n = _mm256_round_pd(
+      clamped * _mm256_set1_pd(log2e), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    const Value r = (clamped - (n * _mm256_set1_pd(ln2_hi))) - (n * _mm256_set1_pd(ln2_lo));
+    // e^r = 1 + 2 r P(r^2) / (Q(r^2) - r P(r^2))
+    const Value r2 = r * r;
+    const Value p = r * ((((_mm256_set1_pd(1.26177193074810590878E-4) * r2) +
+      _mm256_set1_pd(3.02994407707441961300E-2)) * r2) +
+      _mm256_set1_pd(9.99999999999999999910E-1));
+    const Value q = (((((_mm256_set1_pd(3.00198505138664455042E-6) * r2) +
+      _mm256_set1_pd(2.52448340349684104192E-3)) * r2) +
+      _mm256_set1_pd(2.27265548208155028766E-1)) * r2) + _mm256_set1_pd(2.0);
+    const Value e_r = _mm256_set1_pd(1.0) + (_mm256_set1_pd(2.0) * (p / (q - p)));
+    // 2^n by writing n + bias into the exponent bits
+    const __m256i exponent = _mm256_slli_epi64(
+      _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n)), _mm256_set1_epi64x(1023)),
+      52);
+    const Value result = e_r * _mm256_castsi256_pd(exponent);
+    return _mm256_blendv_pd(
+      result, _mm256_setzero_pd(), _mm256_cmp_pd(x, _mm256_set1_pd(min_log), _CMP_LT_OQ));
+  }
+};
+}  // namespace
+
+bool8_t p2d_ndt_kernel_avx2_compiled() noexcept
+{
+  return true;
+}
+
+void evaluate_p2d_ndt_kernel_avx2(
+  Fields fields, const std::size_t num_pairs,
+  const P2DNDTKernelParameters & params, P2DNDTKernelResult & result)
+{
+  evaluate_lanes<Avx2Lane>(fields, num_pairs, params, result);
+}
+#else
+bool8_t p2d_ndt_kernel_avx2_compiled() noexcept
+{
+  return false;
+}
+
+void evaluate_p2d_ndt_kernel_avx2(
+  Fields, const std::size_t, const P2DNDTKernelParameters &, P2DNDTKernelResult &)
+{
+  throw std::domain_error{"P2DNDTKernel: the AVX2 kernel was not compiled"};
+}
+#endif
+}  // namespace detail
+}  // namespace ndt
+}  // namespace localization
+}  // namespace autoware
@@ -0,0 +1,221 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Instruction set independent body of the P2D NDT kernel. This header is private to the
+///        ndt library: it is compiled once per instruction set, each time with a different lane
+///        type, and must therefore only contain templates and declarations.
+
+#ifndef P2D_NDT_KERNEL_IMPL_HPP_
+#define P2D_NDT_KERNEL_IMPL_HPP_
+
+#include <ndt/p2d_ndt_kernel.hpp>
+#include <cstddef>
+
+namespace autoware
+{
+namespace localization
+{
+namespace ndt
+{
+namespace detail
+{
+using Fields = const float64_t * const *;
+
+/// Whether the AVX2 translation unit was compiled with AVX2 and FMA enabled
+bool8_t p2d_ndt_kernel_avx2_compiled() noexcept;
+
+/// AVX2 kernel, only to be called if p2d_ndt_kernel_avx2_compiled() is true and the CPU
+/// supports AVX2 and FMA
+/// \param fields Pointers to the first pair to evaluate, one per P2DNDTBatch::Field
+/// \param num_pairs Number of pairs to evaluate
+/// \param params Parameters of the current pose
+/// \param result Result to accumulate into
+void evaluate_p2d_ndt_kernel_avx2(
+  Fields fields, std::size_t num_pairs,
+  const P2DNDTKernelParameters & params, P2DNDTKernelResult & result);
+
+template<typename V>
+inline V dot3(const V & ax, const V & ay, const V & az, const V & bx, const V & by, const V & bz)
+{
+  return (ax * bx) + (ay * by) + (az * bz);
+}
+
+/// Accumulate the contributions of LaneT::WIDTH consecutive pairs, of which only the first
+/// `num_active` are used.
+/// \tparam LaneT Lane type defining the vector type `Value`, `WIDTH`, `set1`, `load`, `exp`,
+///               `keep_first` and `valid_probability_or_zero`
+/// \tparam Accumulators Struct of LaneT::Value with `score`, `jacobian[6]` and `hessian[21]`
+template<typename LaneT, typename Accumulators>
+inline void evaluate_block(
+  Fields fields, const std::size_t offset, const std::size_t num_active,
+  const P2DNDTKernelParameters & params, Accumulators & acc)
+{
+  using V = typename LaneT::Value;
+  using Batch = P2DNDTBatch;
+  const auto load = [fields, offset](const Batch::Field field) {
+      return LaneT::load(&fields[field][offset]);
+    };
+  const V px = load(Batch::POINT_X);
+  const V py = load(Batch::POINT_Y);
+  const V pz = load(Batch::POINT_Z);
+  const V dx = load(Batch::TRANSFORMED_X) - load(Batch::MEAN_X);
+  const V dy = load(Batch::TRANSFORMED_Y) - load(Batch::MEAN_Y);
+  const V dz = load(Batch::TRANSFORMED_Z) - load(Batch::MEAN_Z);
+  const V cxx = load(Batch::INV_COV_XX);
+  const V cxy = load(Batch::INV_COV_XY);
+  const V cxz = load(Batch::INV_COV_XZ);
+  const V cyy = load(Batch::INV_COV_YY);
+  const V cyz = load(Batch::INV_COV_YZ);
+  const V czz = load(Batch::INV_COV_ZZ);
+
+  // s = Sigma_k^-1 (x_k - mu_k)
+  const V sx = dot3(cxx, cxy, cxz, dx, dy, dz);
+  const V sy = dot3(cxy, cyy, cyz, dx, dy, dz);
+  const V sz = dot3(cxz, cyz, czz, dx, dy, dz);
+  // e^(-d_2/2 * (x_k - mu_k)^T Sigma_k^-1 (x_k - mu_k)) Equation 6.9 [Magnusson 2009]
+  const V e_minus_half_d2_x_cov_x = LaneT::keep_first(
+    LaneT::exp(LaneT::set1(-0.5 * params.gauss_d2) * dot3(dx, dy, dz, sx, sy, sz)), num_active);
+  acc.score = acc.score - (LaneT::set1(params.gauss_d1) * e_minus_half_d2_x_cov_x);
+
+  if (!params.compute_jacobian && !params.compute_hessian) {
+    return;
+  }
+  // Invalid values are zeroed so that they do not contribute
+  const V d2_e_minus_half_d2_x_cov_x =
+    LaneT::valid_probability_or_zero(LaneT::set1(params.gauss_d2) * e_minus_half_d2_x_cov_x);
+  // Reusable portion of Equation 6.12 and 6.13 [Magnusson 2009]
+  const V d1_d2_e_minus_half_d2_x_cov_x = LaneT::set1(params.gauss_d1) *
+    d2_e_minus_half_d2_x_cov_x;
+
+  // Non constant entries of the point gradient (eq. 6.18) [Magnusson 2009]. The first three
+  // columns are the identity and the x component of the fourth column is zero.
+  const auto grad = [&params, &px, &py, &pz](const std::size_t row) {
+      return dot3(
+        px, py, pz, LaneT::set1(params.gradient[row][0U]), LaneT::set1(params.gradient[row][1U]),
+        LaneT::set1(params.gradient[row][2U]));
+    };
+  const V zero = LaneT::set1(0.0);
+  const V gx[3U] = {zero, grad(2U), grad(5U)};
+  const V gy[3U] = {grad(0U), grad(3U), grad(6U)};
+  const V gz[3U] = {grad(1U), grad(4U), grad(7U)};
+
+  // (x_k - mu_k)^T Sigma_k^-1 dx/dp_i
+  const V a[6U] = {sx, sy, sz, (sy * gy[0U]) + (sz * gz[0U]),
+    dot3(sx, sy, sz, gx[1U], gy[1U], gz[1U]), dot3(sx, sy, sz, gx[2U], gy[2U], gz[2U])};
+  if (params.compute_jacobian) {
+    for (std::size_t i = 0U; i < 6U; ++i) {
+      acc.jacobian[i] = acc.jacobian[i] + (a[i] * d1_d2_e_minus_half_d2_x_cov_x);
+    }
+  }
+  if (!params.compute_hessian) {
+    return;
+  }
+
+  // Sigma_k^-1 dx/dp_j, columns
+  V cg[6U][3U] = {{cxx, cxy, cxz}, {cxy, cyy, cyz}, {cxz, cyz, czz}};
+  for (std::size_t j = 3U; j < 6U; ++j) {
+    const V & x = gx[j - 3U];
+    const V & y = gy[j - 3U];
+    const V & z = gz[j - 3U];
+    cg[j][0U] = dot3(cxx, cxy, cxz, x, y, z);
+    cg[j][1U] = dot3(cxy, cyy, cyz, x, y, z);
+    cg[j][2U] = dot3(cxz, cyz, czz, x, y, z);
+  }
+
+  // (x_k - mu_k)^T Sigma_k^-1 d2x/dp_i dp_j, only non zero for i, j >= 3 (eq. 6.20)
+  const auto hess = [&params, &px, &py, &pz](const std::size_t row) {
+      return dot3(
+        px, py, pz, LaneT::set1(params.hessian[row][0U]), LaneT::set1(params.hessian[row][1U]),
+        LaneT::set1(params.hessian[row][2U]));
+    };
+  V sh[3U][3U];
+  // a, b and c have a zero x component
+  sh[0U][0U] = (sy * hess(0U)) + (sz * hess(1U));
+  sh[0U][1U] = (sy * hess(2U)) + (sz * hess(3U));
+  sh[0U][2U] = (sy * hess(4U)) + (sz * hess(5U));
+  sh[1U][1U] = dot3(sx, sy, sz, hess(6U), hess(7U), hess(8U));
+  sh[1U][2U] = dot3(sx, sy, sz, hess(9U), hess(10U), hess(11U));
+  sh[2U][2U] = dot3(sx, sy, sz, hess(12U), hess(13U), hess(14U));
+
+  const V minus_d2 = LaneT::set1(-params.gauss_d2);
+  std::size_t idx = 0U;
+  for (std::size_t i = 0U; i < 6U; ++i) {
+    for (std::size_t j = i; j < 6U; ++j) {
+      // dx/dp_j^T Sigma_k^-1 dx/dp_i
+      V term = (i < 3U) ? cg[j][i] : dot3(gx[i - 3U], gy[i - 3U], gz[i - 3U],
+          cg[j][0U], cg[j][1U], cg[j][2U]);
+      if (i >= 3U) {
+        term = term + sh[i - 3U][j - 3U];
+      }
+      term = term + ((minus_d2 * a[i]) * a[j]);
+      acc.hessian[idx] = acc.hessian[idx] + (d1_d2_e_minus_half_d2_x_cov_x * term);
+      ++idx;
+    }
+  }
+}
+
+/// Evaluate a contiguous range of pairs with the given lane type. The tail which does not fill a
+/// whole vector is zero padded.
+template<typename LaneT>
+void evaluate_lanes(
+  Fields fields, const std::size_t num_pairs,
+  const P2DNDTKernelParameters & params, P2DNDTKernelResult & result)
+{
+  using V = typename LaneT::Value;
+  constexpr std::size_t width = LaneT::WIDTH;
+  struct Accumulators
+  {
+    V score;
+    V jacobian[6U];
+    V hessian[P2DNDTKernelResult::NUM_HESSIAN_ENTRIES];
+  } acc;
+  acc.score = LaneT::set1(0.0);
+  for (auto & value : acc.jacobian) {
+    value = LaneT::set1(0.0);
+  }
+  for (auto & value : acc.hessian) {
+    value = LaneT::set1(0.0);
+  }
+
+  std::size_t offset = 0U;
+  for (; (offset + width) <= num_pairs; offset += width) {
+    evaluate_block<LaneT>(fields, offset, width, params, acc);
+  }
+  if (offset < num_pairs) {
+    float64_t tail[P2DNDTBatch::NUM_FIELDS][width] = {};
+    const float64_t * tail_fields[P2DNDTBatch::NUM_FIELDS];
+    for (std::size_t field = 0U; field < P2DNDTBatch::NUM_FIELDS; ++field) {
+      for (std::size_t idx = offset; idx < num_pairs; ++idx) {
+        tail[field][idx - offset] = fields[field][idx];
+      }
+      tail_fields[field] = &tail[field][0U];
+    }
+    evaluate_block<LaneT>(tail_fields, 0U, num_pairs - offset, params, acc);
+  }
+
+  result.score += LaneT::sum(acc.score);
+  for (std::size_t i = 0U; i < 6U; ++i) {
+    result.jacobian[i] += LaneT::sum(acc.jacobian[i]);
+  }
+  for (std::size_t i = 0U; i < P2DNDTKernelResult::NUM_HESSIAN_ENTRIES; ++i) {
+    result.hessian[i] += LaneT::sum(acc.hessian[i]);
+  }
+}
+}  // namespace detail
+}  // namespace ndt
+}  // namespace localization
+}  // namespace autoware
+
+#endif  // P2D_NDT_KERNEL_IMPL_HPP_
@@ -290,7 +290,7 @@ TEST_F(NDTMapTest, MapRepresentationBasics) {
 
     // For simplicity,
     // the inserted points already correspond to the centroids and there's point per voxel.
-    const auto & generating_voxel = generator_grid.cell(added_pt)[0U];
+    const auto generating_voxel = generator_grid.cell(added_pt)[0U];
     ASSERT_TRUE(
       generating_voxel.centroid().isApprox(
         added_pt,
@@ -335,6 +335,39 @@ TEST_F(NDTMapTest, MapRepresentationBasics) {
   EXPECT_EQ(map_grid.size(), 0U);
 }
 
+TEST_F(DenseNDTMapTest, StaticMapLookupMatchesDynamicMap) {
+  auto grid_config = Config(m_min_point, m_max_point, m_voxel_size, m_capacity);
+  DynamicNDTMap dynamic_map(grid_config);
+  build_pc(grid_config);
+  dynamic_map.insert(m_pc);
+
+  sensor_msgs::msg::PointCloud2 serialized_map;
+  dynamic_map.serialize_as<StaticNDTMap>(serialized_map);
+  StaticNDTMap static_map{};
+  static_map.set(serialized_map);
+
+  // Query inside, at the border of and outside of the occupied voxels
+  constexpr auto step = 0.25F;
+  for (auto x = -1.0F; x <= POINTS_PER_DIM + 2.0F; x += step) {
+    for (auto y = -1.0F; y <= POINTS_PER_DIM + 2.0F; y += step) {
+      for (auto z = -1.0F; z <= POINTS_PER_DIM + 2.0F; z += step) {
+        const auto & dynamic_cells = dynamic_map.cell(x, y, z);
+        const auto static_cells = static_map.cell(x, y, z);
+        ASSERT_EQ(dynamic_cells.size(), static_cells.size());
+        if (!dynamic_cells.empty()) {
+          EXPECT_TRUE(static_cells[0U].usable());
+          EXPECT_TRUE(
+            static_cells[0U].centroid().isApprox(
+              dynamic_cells[0U].centroid(), std::numeric_limits<Real>::epsilon()));
+        }
+      }
+    }
+  }
+
+  static_map.clear();
+  EXPECT_TRUE(static_map.cell(1.0F, 1.0F, 1.0F).empty());
+}
+
 
 ///////////////////////////// Function definitions:
 
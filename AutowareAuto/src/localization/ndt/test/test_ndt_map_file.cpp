@@ -0,0 +1,116 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <common/filesystem.hpp>
+#include <ndt/ndt_map_file.hpp>
+#include <ndt/utils.hpp>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include "test_ndt_map.hpp"
+
+using autoware::localization::ndt::NDTMapFile;
+using autoware::localization::ndt::NdtMapCloudView;
+using autoware::localization::ndt::StaticNDTMap;
+using autoware::localization::ndt::write_ndt_map_file;
+using autoware::perception::filters::voxel_grid::Config;
+
+class NDTMapFileTest : public DenseNDTMapContext, public ::testing::Test
+{
+protected:
+  NDTMapFileTest()
+  : m_file_name{(ghc::filesystem::temp_directory_path() / "ndt_map_file_test.bin").string()}
+  {
+    ghc::filesystem::remove(m_file_name);
+  }
+
+  ~NDTMapFileTest() override
+  {
+    ghc::filesystem::remove(m_file_name);
+  }
+
+  std::string m_file_name;
+};
+
+TEST_F(NDTMapFileTest, RoundTrip) {
+  const Config config{m_min_point, m_max_point, m_voxel_size, m_capacity};
+  build_pc(config);
+  DynamicNDTMap dynamic_map{config};
+  dynamic_map.insert(m_pc);
+  sensor_msgs::msg::PointCloud2 serialized_map;
+  dynamic_map.serialize_as<StaticNDTMap>(serialized_map);
+
+  write_ndt_map_file(m_file_name, serialized_map);
+  const NDTMapFile map_file{m_file_name};
+  const NdtMapCloudView msg_view{serialized_map};
+  ASSERT_EQ(map_file.size(), msg_view.size());
+  EXPECT_EQ(std::distance(map_file.begin(), map_file.end()), msg_view.size());
+  for (auto idx = 0U; idx < map_file.size(); ++idx) {
+    EXPECT_EQ(std::memcmp(&map_file[idx], &msg_view[idx], sizeof(map_file[idx])), 0);
+  }
+
+  // The message created from the file equals the serialized map
+  sensor_msgs::msg::PointCloud2 msg;
+  map_file.to_message("map", msg);
+  EXPECT_EQ(msg.header.frame_id, "map");
+  EXPECT_EQ(msg.data, serialized_map.data);
+
+  StaticNDTMap msg_map{};
+  msg_map.set(serialized_map);
+  StaticNDTMap file_map{};
+  file_map.set(map_file, "map");
+  EXPECT_TRUE(file_map.valid());
+  EXPECT_EQ(file_map.frame_id(), "map");
+  ASSERT_EQ(file_map.size(), msg_map.size());
+  for (auto x = 0.0F; x <= POINTS_PER_DIM + 1.0F; x += 0.5F) {
+    for (auto y = 0.0F; y <= POINTS_PER_DIM + 1.0F; y += 0.5F) {
+      for (auto z = 0.0F; z <= POINTS_PER_DIM + 1.0F; z += 0.5F) {
+        const auto msg_cells = msg_map.cell(x, y, z);
+        const auto file_cells = file_map.cell(x, y, z);
+        ASSERT_EQ(msg_cells.size(), file_cells.size());
+        if (!msg_cells.empty()) {
+          EXPECT_EQ(msg_cells[0U].centroid(), file_cells[0U].centroid());
+          EXPECT_EQ(msg_cells[0U].inverse_covariance(), file_cells[0U].inverse_covariance());
+        }
+      }
+    }
+  }
+}
+
+TEST_F(NDTMapFileTest, InvalidFiles) {
+  EXPECT_THROW(NDTMapFile{m_file_name}, std::runtime_error);
+
+  const auto write_file = [this](const std::string & content) {
+      std::ofstream file{m_file_name, std::ios::binary};
+      file << content;
+    };
+  // Too short for the header
+  write_file("NDTM");
+  EXPECT_THROW(NDTMapFile{m_file_name}, std::runtime_error);
+  // Wrong magic number
+  write_file(std::string(16U, '\0'));
+  EXPECT_THROW(NDTMapFile{m_file_name}, std::runtime_error);
+
+  const Config config{m_min_point, m_max_point, m_voxel_size, m_capacity};
+  build_pc(config);
+  DynamicNDTMap dynamic_map{config};
+  dynamic_map.insert(m_pc);
+  sensor_msgs::msg::PointCloud2 serialized_map;
+  dynamic_map.serialize_as<StaticNDTMap>(serialized_map);
+  write_ndt_map_file(m_file_name, serialized_map);
+  // Truncated points
+  ghc::filesystem::resize_file(m_file_name, ghc::filesystem::file_size(m_file_name) - 8U);
+  EXPECT_THROW(NDTMapFile{m_file_name}, std::runtime_error);
+}
@@ -0,0 +1,230 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <common/filesystem.hpp>
+#include <ndt/ndt_map_tiles.hpp>
+#include <ndt/utils.hpp>
+#include <cmath>
+#include <chrono>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+#include "test_ndt_map.hpp"
+
+using autoware::localization::ndt::MapTileIndex;
+using autoware::localization::ndt::MapTileLayout;
+using autoware::localization::ndt::MapTileLoader;
+using autoware::localization::ndt::NdtMapCloudView;
+using autoware::localization::ndt::Real;
+using autoware::localization::ndt::StaticNDTMap;
+using autoware::localization::ndt::make_map_tile_removal;
+using autoware::localization::ndt::read_map_tile;
+using autoware::localization::ndt::read_map_tile_header;
+using autoware::localization::ndt::read_map_tile_layout;
+using autoware::localization::ndt::write_map_tiles;
+using autoware::perception::filters::voxel_grid::Config;
+
+class MapTilesTest : public DenseNDTMapContext, public ::testing::Test
+{
+protected:
+  // Tiles of 2x2 voxels on the 5x5x5 voxel grid of the dense map context
+  static constexpr float64_t TILE_SIZE{2.0};
+
+  MapTilesTest()
+  : m_directory{(ghc::filesystem::temp_directory_path() / "ndt_map_tiles_test").string()}
+  {
+    ghc::filesystem::remove_all(m_directory);
+  }
+
+  ~MapTilesTest() override
+  {
+    ghc::filesystem::remove_all(m_directory);
+  }
+
+  // Wait until the loader has processed the expected number of tiles
+  std::vector<sensor_msgs::msg::PointCloud2> take_updates(
+    MapTileLoader & loader, const std::size_t num_expected)
+  {
+    std::vector<sensor_msgs::msg::PointCloud2> messages;
+    std::vector<std::string> errors;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+    while ((messages.size() < num_expected) && (std::chrono::steady_clock::now() < deadline)) {
+      loader.take_updates(messages, errors);
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    // Give a faulty loader the chance to produce more messages than expected
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    loader.take_updates(messages, errors);
+    EXPECT_TRUE(errors.empty());
+    return messages;
+  }
+
+  std::string m_directory;
+};
+
+constexpr float64_t MapTilesTest::TILE_SIZE;
+
+TEST_F(MapTilesTest, Layout) {
+  const Config config{m_min_point, m_max_point, m_voxel_size, m_capacity};
+  EXPECT_THROW(MapTileLayout(config, 0.0), std::domain_error);
+  EXPECT_THROW(MapTileLayout(config, 1.5), std::domain_error);
+  EXPECT_THROW(MapTileLayout(config, -2.0), std::domain_error);
+
+  const MapTileLayout layout{config, TILE_SIZE};
+  // Tile borders are at 0.5, 2.5 and 4.5
+  EXPECT_EQ(layout.tile_of({1.0, 1.0, 1.0}), (MapTileIndex{0, 0}));
+  EXPECT_EQ(layout.tile_of({2.4, 2.6, 3.0}), (MapTileIndex{0, 1}));
+  EXPECT_EQ(layout.tile_of({5.0, 4.0, 1.0}), (MapTileIndex{2, 1}));
+  // Points outside of the grid belong to the tile of the voxel they are clamped to
+  EXPECT_EQ(layout.tile_of({-10.0, 5.2, 1.0}), (MapTileIndex{0, 2}));
+
+  EXPECT_DOUBLE_EQ(layout.distance({0, 0}, 1.0, 1.0), 0.0);
+  EXPECT_DOUBLE_EQ(layout.distance({1, 0}, 1.0, 1.0), 1.5);
+  EXPECT_DOUBLE_EQ(layout.distance({1, 1}, 5.5, 5.5), std::hypot(1.0, 1.0));
+}
+
+TEST_F(MapTilesTest, TiledMapMatchesFullMap) {
+  const Config config{m_min_point, m_max_point, m_voxel_size, m_capacity};
+  build_pc(config);
+
+  DynamicNDTMap dynamic_map{config};
+  dynamic_map.insert(m_pc);
+  sensor_msgs::msg::PointCloud2 serialized_map;
+  dynamic_map.serialize_as<StaticNDTMap>(serialized_map);
+  StaticNDTMap full_map{};
+  full_map.set(serialized_map);
+
+  // 3x3 tiles, the last row and column being one voxel wide
+  ASSERT_EQ(write_map_tiles(m_pc, MapTileLayout{config, TILE_SIZE}, m_directory), 9U);
+  std::vector<MapTileIndex> tiles;
+  const auto layout = read_map_tile_layout(m_directory, tiles);
+  ASSERT_EQ(tiles.size(), 9U);
+  EXPECT_DOUBLE_EQ(layout.tile_size(), TILE_SIZE);
+
+  StaticNDTMap tiled_map{};
+  for (const auto & tile : tiles) {
+    sensor_msgs::msg::PointCloud2 msg;
+    read_map_tile(m_directory, tile, "map", msg);
+    MapTileIndex msg_tile{};
+    float64_t tile_size{0.0};
+    ASSERT_TRUE(read_map_tile_header(msg, msg_tile, tile_size));
+    EXPECT_EQ(msg_tile, tile);
+    EXPECT_DOUBLE_EQ(tile_size, TILE_SIZE);
+    tiled_map.set(msg);
+  }
+  EXPECT_EQ(tiled_map.size(), full_map.size());
+
+  const auto expect_same_cells = [&full_map, &tiled_map, &layout](const MapTileIndex & removed) {
+      constexpr auto step = 0.25F;
+      for (auto x = 0.0F; x <= POINTS_PER_DIM + 1.0F; x += step) {
+        for (auto y = 0.0F; y <= POINTS_PER_DIM + 1.0F; y += step) {
+          for (auto z = 0.0F; z <= POINTS_PER_DIM + 1.0F; z += step) {
+            const auto full_cells = full_map.cell(x, y, z);
+            const auto tiled_cells = tiled_map.cell(x, y, z);
+            if (layout.tile_of({x, y, z}) == removed) {
+              EXPECT_TRUE(tiled_cells.empty());
+              continue;
+            }
+            ASSERT_EQ(full_cells.size(), tiled_cells.size());
+            if (!full_cells.empty()) {
+              EXPECT_TRUE(
+                tiled_cells[0U].centroid().isApprox(
+                  full_cells[0U].centroid(), std::numeric_limits<Real>::epsilon()));
+              EXPECT_TRUE(
+                tiled_cells[0U].inverse_covariance().isApprox(
+                  full_cells[0U].inverse_covariance(), std::numeric_limits<Real>::epsilon()));
+            }
+          }
+        }
+      }
+    };
+  // No tile is removed yet
+  expect_same_cells(MapTileIndex{-1, -1});
+
+  // Setting a tile again replaces its voxels
+  sensor_msgs::msg::PointCloud2 msg;
+  read_map_tile(m_directory, MapTileIndex{1, 1}, "map", msg);
+  tiled_map.set(msg);
+  EXPECT_EQ(tiled_map.size(), full_map.size());
+
+  // An empty tile removes the voxels of the tile only
+  make_map_tile_removal(layout, MapTileIndex{1, 1}, "map", msg);
+  tiled_map.set(msg);
+  EXPECT_EQ(tiled_map.size(), full_map.size() - 4U * POINTS_PER_DIM);
+  expect_same_cells(MapTileIndex{1, 1});
+
+  // A full map replaces all tiles
+  tiled_map.set(serialized_map);
+  expect_same_cells(MapTileIndex{-1, -1});
+
+  // A tile message on top of a full map only removes the voxels of the tile
+  make_map_tile_removal(layout, MapTileIndex{1, 1}, "map", msg);
+  tiled_map.set(msg);
+  EXPECT_EQ(tiled_map.size(), full_map.size() - 4U * POINTS_PER_DIM);
+  EXPECT_EQ(
+    static_cast<std::size_t>(std::distance(tiled_map.begin(), tiled_map.end())),
+    tiled_map.size());
+  expect_same_cells(MapTileIndex{1, 1});
+}
+
+TEST_F(MapTilesTest, LoaderLoadsAndEvictsTiles) {
+  const Config config{m_min_point, m_max_point, m_voxel_size, m_capacity};
+  build_pc(config);
+  ASSERT_EQ(write_map_tiles(m_pc, MapTileLayout{config, TILE_SIZE}, m_directory), 9U);
+
+  EXPECT_THROW(MapTileLoader(m_directory, -1.0, "map"), std::domain_error);
+  EXPECT_THROW(MapTileLoader(m_directory + "_missing", 1.0, "map"), std::runtime_error);
+
+  MapTileLoader loader{m_directory, 1.5, "map"};
+  EXPECT_EQ(loader.max_resident_tiles(), 16U);
+
+  // Tiles (0, 0), (0, 1), (1, 0) and (1, 1) are within 1.5m of the center of tile (0, 0)
+  loader.update(1.5, 1.5);
+  auto messages = take_updates(loader, 4U);
+  ASSERT_EQ(messages.size(), 4U);
+  MapTileIndex tile{};
+  float64_t tile_size{0.0};
+  ASSERT_TRUE(read_map_tile_header(messages[0U], tile, tile_size));
+  // The closest tile is loaded first
+  EXPECT_EQ(tile, (MapTileIndex{0, 0}));
+  StaticNDTMap map{};
+  for (const auto & msg : messages) {
+    map.set(msg);
+  }
+  EXPECT_EQ(map.size(), 4U * 4U * POINTS_PER_DIM);
+
+  // Tiles which are still resident are not loaded again
+  loader.update(1.6, 1.5);
+  EXPECT_TRUE(take_updates(loader, 0U).empty());
+
+  // Moving to tile (2, 0) evicts tiles (0, 0) and (0, 1), which are more than 2.5m away, and
+  // loads tiles (2, 0) and (2, 1). Tiles (1, 0) and (1, 1) stay resident.
+  loader.update(5.5, 1.5);
+  messages = take_updates(loader, 4U);
+  ASSERT_EQ(messages.size(), 4U);
+  std::size_t num_removals = 0U;
+  for (const auto & msg : messages) {
+    map.set(msg);
+    if (NdtMapCloudView{msg}.size() == kNumConfigPoints) {
+      ++num_removals;
+    }
+  }
+  EXPECT_EQ(num_removals, 2U);
+  EXPECT_EQ(map.size(), (2U * 4U + 2U * 2U) * POINTS_PER_DIM);
+  EXPECT_TRUE(map.cell(1.0F, 1.0F, 1.0F).empty());
+  EXPECT_FALSE(map.cell(5.0F, 4.0F, 1.0F).empty());
+}
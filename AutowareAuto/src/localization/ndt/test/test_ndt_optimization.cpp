@@ -18,6 +18,7 @@
 #include <tf2_sensor_msgs/tf2_sensor_msgs.h>
 #include <geometry_msgs/msg/transform_stamped.hpp>
 #include <limits>
+#include <random>
 #include "common/types.hpp"
 
 namespace
@@ -30,6 +31,12 @@ using autoware::localization::ndt::P2DNDTScan;
 using autoware::localization::ndt::P2DNDTOptimizationProblem;
 using autoware::localization::ndt::P2DNDTOptimizationConfig;
 using autoware::localization::ndt::transform_adapters::pose_to_transform;
+using autoware::localization::ndt::P2DNDTBatch;
+using autoware::localization::ndt::P2DNDTKernelIsa;
+using autoware::localization::ndt::P2DNDTKernelParameters;
+using autoware::localization::ndt::P2DNDTKernelResult;
+using autoware::localization::ndt::evaluate_p2d_ndt_kernel;
+using autoware::localization::ndt::p2d_ndt_kernel_avx2_available;
 
 using P2DProblem = P2DNDTOptimizationProblem<autoware::localization::ndt::StaticNDTMap>;
 
@@ -50,6 +57,55 @@ sensor_msgs::msg::PointCloud2 create_xz_plane_point_cloud(
   }
   return msg;
 }
+
+// Random point/cell pairs with positive definite inverse covariances, and random angle parameters
+void fill_random_batch(P2DNDTBatch & batch, P2DNDTKernelParameters & params, std::size_t size)
+{
+  std::mt19937 gen{42U};
+  std::uniform_real_distribution<float64_t> dist{-1.0, 1.0};
+  params.gauss_d1 = -1.3;
+  params.gauss_d2 = 0.45;
+  params.compute_jacobian = true;
+  params.compute_hessian = true;
+  for (auto & row : params.gradient) {
+    for (auto & value : row) {
+      value = dist(gen);
+    }
+  }
+  for (auto & row : params.hessian) {
+    for (auto & value : row) {
+      value = dist(gen);
+    }
+  }
+  for (auto i = 0U; i < size; ++i) {
+    const Eigen::Vector3d point{10.0 * dist(gen), 10.0 * dist(gen), dist(gen)};
+    const Eigen::Vector3d transformed =
+      point + 0.3 * Eigen::Vector3d{dist(gen), dist(gen), dist(gen)};
+    const Eigen::Vector3d mean = transformed + Eigen::Vector3d{dist(gen), dist(gen), dist(gen)};
+    Eigen::Matrix3d sqrt_cov;
+    for (auto j = 0U; j < 9U; ++j) {
+      sqrt_cov(j) = dist(gen);
+    }
+    const Eigen::Matrix3d cov =
+      sqrt_cov * sqrt_cov.transpose() + 0.05 * Eigen::Matrix3d::Identity();
+    const Eigen::Matrix3d inv_cov = cov.inverse();
+    batch.push_back(point.data(), transformed.data(), mean.data(), inv_cov.data());
+  }
+}
+
+void expect_near(const P2DNDTKernelResult & a, const P2DNDTKernelResult & b)
+{
+  const auto near = [](float64_t x, float64_t y) {
+      EXPECT_NEAR(x, y, 1e-10 * std::max(1.0, std::fabs(y)));
+    };
+  near(a.score, b.score);
+  for (auto i = 0U; i < 6U; ++i) {
+    near(a.jacobian[i], b.jacobian[i]);
+  }
+  for (auto i = 0U; i < P2DNDTKernelResult::NUM_HESSIAN_ENTRIES; ++i) {
+    near(a.hessian[i], b.hessian[i]);
+  }
+}
 }  // namespace
 
 OptTestParams::OptTestParams(
@@ -122,6 +178,33 @@ TEST_P(P2DOptimizationNumericalTest, NumericalAnalysis) {
     }
   }
 }
+
+/// @test       The scan is split into several chunks, which are evaluated on different threads.
+///             The result must not depend on the number of threads.
+TEST_F(P2DOptimizationTest, ThreadCountIndependent) {
+  P2DNDTScan scan{m_pc, m_pc.width};
+  ASSERT_GT(scan.size(), 256U);
+  P2DProblem sequential{scan, m_static_map, P2DNDTOptimizationConfig{0.55}};
+  P2DProblem threaded{scan, m_static_map, P2DNDTOptimizationConfig{0.55, 4U}};
+
+  EigenPose<Real> pose;
+  pose << 0.1, -0.05, 0.02, 0.01, -0.02, 0.03;
+  for (auto i = 0U; i < 3U; ++i) {
+    pose(0U) += 0.01;
+    const autoware::common::optimization::ComputeMode mode{true, true, true};
+    sequential.evaluate(pose, mode);
+    threaded.evaluate(pose, mode);
+    P2DProblem::Jacobian sequential_jacobian, threaded_jacobian;
+    P2DProblem::Hessian sequential_hessian, threaded_hessian;
+    sequential.jacobian(pose, sequential_jacobian);
+    threaded.jacobian(pose, threaded_jacobian);
+    sequential.hessian(pose, sequential_hessian);
+    threaded.hessian(pose, threaded_hessian);
+    EXPECT_EQ(sequential(pose), threaded(pose));
+    EXPECT_EQ(sequential_jacobian, threaded_jacobian);
+    EXPECT_EQ(sequential_hessian, threaded_hessian);
+  }
+}
 /// @test       The shape is fitting exactly into a single voxel. Its copy is moved in different
 ///             directions and aligned with the original.
 TEST_P(AlignmentXyzTest, AlignShapesWithinOneVoxel) {
@@ -229,6 +312,58 @@ INSTANTIATE_TEST_CASE_P(
     // cppcheck-suppress syntaxError
   ), );
 
+/// @test       The AVX2 kernel matches the scalar one, including a batch size which is not a
+///             multiple of the vector width.
+TEST(P2DNDTKernel, InstructionSetsMatch) {
+  P2DNDTBatch batch;
+  P2DNDTKernelParameters params;
+  fill_random_batch(batch, params, 1003U);
+
+  P2DNDTKernelResult scalar_result;
+  evaluate_p2d_ndt_kernel(P2DNDTKernelIsa::SCALAR, batch, 0U, batch.size(), params, scalar_result);
+  EXPECT_GT(scalar_result.score, 0.0);
+
+  P2DNDTKernelResult avx2_result;
+  if (p2d_ndt_kernel_avx2_available()) {
+    evaluate_p2d_ndt_kernel(P2DNDTKernelIsa::AVX2, batch, 0U, batch.size(), params, avx2_result);
+    expect_near(avx2_result, scalar_result);
+  } else {
+    EXPECT_THROW(
+      evaluate_p2d_ndt_kernel(P2DNDTKernelIsa::AVX2, batch, 0U, batch.size(), params, avx2_result),
+      std::domain_error);
+  }
+
+  // Score only
+  params.compute_jacobian = false;
+  params.compute_hessian = false;
+  P2DNDTKernelResult score_result;
+  evaluate_p2d_ndt_kernel(batch, 0U, batch.size(), params, score_result);
+  EXPECT_NEAR(score_result.score, scalar_result.score, 1e-10 * std::fabs(scalar_result.score));
+  EXPECT_EQ(score_result.jacobian[0U], 0.0);
+  EXPECT_EQ(score_result.hessian[0U], 0.0);
+}
+
+/// @test       Evaluating a batch in parts accumulates to the same result.
+TEST(P2DNDTKernel, Ranges) {
+  P2DNDTBatch batch;
+  P2DNDTKernelParameters params;
+  fill_random_batch(batch, params, 101U);
+
+  P2DNDTKernelResult whole;
+  evaluate_p2d_ndt_kernel(batch, 0U, batch.size(), params, whole);
+  P2DNDTKernelResult parts;
+  evaluate_p2d_ndt_kernel(batch, 0U, 37U, params, parts);
+  evaluate_p2d_ndt_kernel(batch, 37U, 38U, params, parts);
+  evaluate_p2d_ndt_kernel(batch, 38U, batch.size(), params, parts);
+  expect_near(parts, whole);
+
+  P2DNDTKernelResult empty;
+  evaluate_p2d_ndt_kernel(batch, 5U, 5U, params, empty);
+  EXPECT_EQ(empty.score, 0.0);
+  EXPECT_THROW(
+    evaluate_p2d_ndt_kernel(batch, 0U, batch.size() + 1U, params, empty), std::out_of_range);
+  EXPECT_THROW(evaluate_p2d_ndt_kernel(batch, 6U, 5U, params, empty), std::out_of_range);
+}
 
 ////////////////////////////////////// Test function implementations
 
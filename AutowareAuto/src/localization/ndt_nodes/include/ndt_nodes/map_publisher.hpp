@@ -21,10 +21,16 @@
 #include <ndt/ndt_map_publisher.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <ndt/ndt_map.hpp>
+#include <ndt/ndt_map_file.hpp>
+#include <ndt/ndt_map_tiles.hpp>
+#include <geometry_msgs/msg/pose_with_covariance_stamped.hpp>
 #include <tf2_geometry_msgs/tf2_geometry_msgs.h>
 #include <tf2_msgs/msg/tf_message.hpp>
 #include <tf2_ros/static_transform_broadcaster.h>
 #include <voxel_grid_nodes/algorithm/voxel_cloud_centroid.hpp>
+#include <chrono>
+#include <deque>
+#include <map>
 #include <string>
 #include <memory>
 #include "common/types.hpp"
@@ -40,7 +46,9 @@ namespace ndt_nodes
 {
 
 /// Node to read pcd files, transform to ndt maps and publish the resulting maps in PointCloud2
-/// format
+/// format. If a binary ndt map file is configured, it is published directly without converting
+/// the pcd file, see `ndt::NDTMapFile`. If a directory of map tiles is configured, the tiles
+/// around the vehicle pose are published instead of the whole map, see `ndt::MapTileLoader`.
 class NDT_NODES_PUBLIC NDTMapPublisherNode : public rclcpp::Node
 {
 public:
@@ -72,6 +80,22 @@ private:
     const std::string & map_topic,
     const std::string & viz_map_topic);
 
+  /// Publish the map of the configured binary ndt map file.
+  /// \param map_frame Frame of the map
+  /// \param map_topic Topic name for ndt map
+  void init_map_file(const std::string & map_frame, const std::string & map_topic);
+
+  /// Start streaming the map tiles around the vehicle: the tiles are loaded in the background
+  /// whenever a pose is received, and loaded or evicted tiles are published periodically.
+  /// \param map_frame Frame of the map
+  /// \param map_topic Topic name for ndt map
+  void init_tiles(const std::string & map_frame, const std::string & map_topic);
+
+  /// Publish the tiles loaded or evicted since the last call, at most `tiles.max_per_update` per
+  /// call. The others are kept for the next call. If a subscriber joined since the last call, all
+  /// resident tiles are published again.
+  void publish_tiles();
+
   void publish_earth_to_map_transform(ndt::geocentric_pose_t pose);
 
   /// Publish the loaded map file. If no new map is loaded, it will publish the
@@ -93,6 +117,19 @@ private:
   const std::string m_pcl_file_name;
   const std::string m_yaml_file_name;
   const bool8_t m_viz_map;
+  const std::string m_map_file_name;
+  const std::string m_tiles_directory;
+  std::unique_ptr<ndt::MapTileLoader> m_tile_loader;
+  // Tile messages waiting to be published
+  std::deque<sensor_msgs::msg::PointCloud2> m_tile_queue;
+  // Latest message of each resident tile, sent again to joining subscribers
+  std::map<ndt::MapTileIndex, sensor_msgs::msg::PointCloud2> m_resident_tiles;
+  std::size_t m_max_tiles_per_update{0U};
+  std::size_t m_num_tile_subscribers{0U};
+  rclcpp::Subscription<geometry_msgs::msg::PoseWithCovarianceStamped>::SharedPtr m_pose_sub;
+  rclcpp::Subscription<geometry_msgs::msg::PoseWithCovarianceStamped>::SharedPtr
+    m_initial_pose_sub;
+  rclcpp::TimerBase::SharedPtr m_tile_timer{nullptr};
   rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr m_viz_pub;
   std::unique_ptr<MapConfig> m_map_config_ptr;
   std::unique_ptr<MapConfig> m_viz_map_config_ptr;
@@ -20,6 +20,7 @@
 #include <common/types.hpp>
 #include <ndt_nodes/visibility_control.hpp>
 #include <ndt/ndt_localizer.hpp>
+#include <ndt/ndt_map_file.hpp>
 #include <localization_nodes/localization_node.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <optimization/newtons_method_optimizer.hpp>
@@ -29,6 +30,7 @@
 #include <string>
 #include <memory>
 #include <limits>
+#include <stdexcept>
 
 using autoware::common::types::float32_t;
 using autoware::common::types::float64_t;
@@ -194,6 +196,13 @@ private:
 
     const auto outlier_ratio{this->declare_parameter(
         "localizer.optimization.outlier_ratio").template get<float64_t>()};
+    const auto num_threads_param{this->declare_parameter(
+        "localizer.optimization.num_threads", 0)};
+    if (num_threads_param < 0) {
+      throw std::domain_error{
+              "P2DNDTLocalizerNode: localizer.optimization.num_threads must not be negative"};
+    }
+    const auto num_threads{static_cast<std::size_t>(num_threads_param)};
 
     common::optimization::OptimizationOptions optimizer_options{
       static_cast<uint64_t>(
@@ -220,8 +229,19 @@ private:
               common::optimization::MoreThuenteLineSearch::OptimizationDirection::kMaximization},
             optimizer_options
           },
-      outlier_ratio);
+      outlier_ratio,
+      num_threads);
     auto map_ptr = std::make_unique<ndt::StaticNDTMap>();
+    // The map can be loaded from a binary ndt map file at startup instead of waiting for the map
+    // publisher. Maps received afterwards replace it.
+    const auto map_file = this->declare_parameter("map_file", std::string{});
+    const auto map_frame = this->declare_parameter("map_frame", std::string{"map"});
+    if (!map_file.empty()) {
+      map_ptr->set(ndt::NDTMapFile{map_file}, map_frame);
+      RCLCPP_INFO(
+        this->get_logger(), "Loaded %zu voxels from ndt map file %s.", map_ptr->size(),
+        map_file.c_str());
+    }
 
     this->set_localizer(std::move(localizer_ptr));
     this->set_map(std::move(map_ptr));
@@ -22,7 +22,10 @@
 #include <tf2/LinearMath/Quaternion.h>
 
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 using autoware::common::types::bool8_t;
 using autoware::common::types::float32_t;
@@ -45,10 +48,29 @@ NDTMapPublisherNode::NDTMapPublisherNode(
   const rclcpp::NodeOptions & node_options
 )
 : Node("ndt_map_publisher_node", node_options),
-  m_pcl_file_name(declare_parameter("map_pcd_file").get<std::string>()),
+  m_pcl_file_name(declare_parameter("map_pcd_file", std::string{})),
   m_yaml_file_name(declare_parameter("map_yaml_file").get<std::string>()),
-  m_viz_map(declare_parameter("viz_map", false))
+  m_viz_map(declare_parameter("viz_map", false)),
+  m_map_file_name(declare_parameter("map_file", std::string{})),
+  m_tiles_directory(declare_parameter("tiles.directory", std::string{}))
 {
+  const std::string map_frame = declare_parameter("map_frame").get<std::string>();
+  const std::string map_topic = "ndt_map";
+  const std::string viz_map_topic = "viz_ndt_map";
+
+  m_pub_earth_map = create_publisher<tf2_msgs::msg::TFMessage>(
+    "/tf_static",
+    rclcpp::QoS(rclcpp::KeepLast(5U)).transient_local());
+
+  if (!m_map_file_name.empty()) {
+    init_map_file(map_frame, map_topic);
+    return;
+  }
+  if (!m_tiles_directory.empty()) {
+    init_tiles(map_frame, map_topic);
+    return;
+  }
+
   using PointXYZ = perception::filters::voxel_grid::PointXYZ;
   PointXYZ min_point;
   min_point.x =
@@ -73,10 +95,6 @@ NDTMapPublisherNode::NDTMapPublisherNode(
     static_cast<float32_t>(declare_parameter("map_config.voxel_size.z").get<float32_t>());
   const std::size_t capacity =
     static_cast<std::size_t>(declare_parameter("map_config.capacity").get<std::size_t>());
-  const std::string map_frame = declare_parameter("map_frame").get<std::string>();
-  const std::string map_topic = "ndt_map";
-  const std::string viz_map_topic = "viz_ndt_map";
-
   m_map_config_ptr = std::make_unique<MapConfig>(min_point, max_point, voxel_size, capacity);
   init(map_frame, map_topic, viz_map_topic);
   run();
@@ -131,10 +149,110 @@ void NDTMapPublisherNode::init(
         }
       });
   }
+}
 
-  m_pub_earth_map = create_publisher<tf2_msgs::msg::TFMessage>(
-    "/tf_static",
+void NDTMapPublisherNode::init_map_file(
+  const std::string & map_frame, const std::string & map_topic)
+{
+  if (m_viz_map) {
+    RCLCPP_WARN(get_logger(), "Map visualization is not supported for binary ndt map files.");
+  }
+  m_pub = create_publisher<sensor_msgs::msg::PointCloud2>(
+    map_topic,
     rclcpp::QoS(rclcpp::KeepLast(5U)).transient_local());
+
+  publish_earth_to_map_transform(ndt::read_map_origin(m_yaml_file_name));
+  // The voxels are precomputed, so they are only copied into the message
+  const ndt::NDTMapFile map_file{m_map_file_name};
+  map_file.to_message(map_frame, m_map_pc);
+  m_map_pc.header.stamp = now();
+  publish();
+}
+
+void NDTMapPublisherNode::init_tiles(const std::string & map_frame, const std::string & map_topic)
+{
+  using geometry_msgs::msg::PoseWithCovarianceStamped;
+  const auto radius = declare_parameter("tiles.radius", 200.0);
+  const auto update_period_ms = declare_parameter("tiles.update_period_ms", 100);
+  if (update_period_ms < 1) {
+    throw std::domain_error{"NDTMapPublisherNode: tiles.update_period_ms must be positive"};
+  }
+  const std::chrono::milliseconds update_period{update_period_ms};
+  const auto max_tiles_per_update = declare_parameter("tiles.max_per_update", 4);
+  if (max_tiles_per_update < 1) {
+    throw std::domain_error{"NDTMapPublisherNode: tiles.max_per_update must be positive"};
+  }
+  m_max_tiles_per_update = static_cast<std::size_t>(max_tiles_per_update);
+  if (m_viz_map) {
+    RCLCPP_WARN(get_logger(), "Map visualization is not supported for tiled maps.");
+  }
+
+  m_tile_loader = std::make_unique<ndt::MapTileLoader>(m_tiles_directory, radius, map_frame);
+
+  // Each message adds or removes a single tile. At most tiles.max_per_update messages are
+  // published per period, so subscribers with at least that history depth do not drop tiles.
+  // Subscribers joining later receive all resident tiles again instead of relying on the history.
+  m_pub = create_publisher<sensor_msgs::msg::PointCloud2>(
+    map_topic,
+    rclcpp::QoS(rclcpp::KeepLast(m_max_tiles_per_update)).transient_local());
+
+  publish_earth_to_map_transform(ndt::read_map_origin(m_yaml_file_name));
+
+  const auto pose_callback =
+    [this, map_frame](const PoseWithCovarianceStamped::ConstSharedPtr msg) {
+      if (msg->header.frame_id != map_frame) {
+        RCLCPP_WARN(
+          get_logger(), "Ignoring pose in frame %s, expected frame %s.",
+          msg->header.frame_id.c_str(), map_frame.c_str());
+        return;
+      }
+      m_tile_loader->update(msg->pose.pose.position.x, msg->pose.pose.position.y);
+    };
+  m_pose_sub = create_subscription<PoseWithCovarianceStamped>(
+    "ndt_pose", rclcpp::QoS{rclcpp::KeepLast{1U}}, pose_callback);
+  m_initial_pose_sub = create_subscription<PoseWithCovarianceStamped>(
+    "initialpose", rclcpp::QoS{rclcpp::KeepLast{10U}}, pose_callback);
+
+  m_tile_timer = create_wall_timer(update_period, [this]() {publish_tiles();});
+}
+
+void NDTMapPublisherNode::publish_tiles()
+{
+  std::vector<sensor_msgs::msg::PointCloud2> tiles;
+  std::vector<std::string> errors;
+  m_tile_loader->take_updates(tiles, errors);
+  for (const auto & error : errors) {
+    RCLCPP_ERROR(get_logger(), "Failed to load map tile: %s", error.c_str());
+  }
+  for (auto & tile_msg : tiles) {
+    ndt::MapTileIndex tile{};
+    float64_t tile_size{0.0};
+    if (ndt::read_map_tile_header(tile_msg, tile, tile_size)) {
+      if (ndt::NdtMapCloudView{tile_msg}.size() > ndt::DynamicNDTMap::kNumConfigPoints) {
+        m_resident_tiles[tile] = tile_msg;
+      } else {
+        m_resident_tiles.erase(tile);
+      }
+    }
+    m_tile_queue.push_back(std::move(tile_msg));
+  }
+
+  // A joining subscriber may have missed tiles published earlier
+  const auto num_subscribers = m_pub->get_subscription_count();
+  if (num_subscribers > m_num_tile_subscribers) {
+    for (const auto & tile_it : m_resident_tiles) {
+      m_tile_queue.push_back(tile_it.second);
+    }
+  }
+  m_num_tile_subscribers = num_subscribers;
+
+  const auto stamp = now();
+  for (auto i = 0U; (i < m_max_tiles_per_update) && !m_tile_queue.empty(); ++i) {
+    auto & tile_msg = m_tile_queue.front();
+    tile_msg.header.stamp = stamp;
+    m_pub->publish(tile_msg);
+    m_tile_queue.pop_front();
+  }
 }
 
 void NDTMapPublisherNode::run()
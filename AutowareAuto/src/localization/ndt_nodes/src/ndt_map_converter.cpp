@@ -0,0 +1,92 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Offline tool converting a pcd map into a binary ndt map file which can be loaded by the
+///        map publisher and the localizer without computing the voxels again
+
+#include <common/types.hpp>
+#include <ndt/ndt_map.hpp>
+#include <ndt/ndt_map_file.hpp>
+#include <ndt/ndt_map_publisher.hpp>
+#include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
+#include <yaml-cpp/yaml.h>
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using autoware::common::types::float32_t;
+using autoware::localization::ndt::DynamicNDTMap;
+
+namespace
+{
+/// Read the map_config of the map publisher from its parameter file.
+DynamicNDTMap::Config read_map_config(const std::string & param_file_name)
+{
+  const auto params = YAML::LoadFile(param_file_name);
+  for (const auto & node : params) {
+    const auto ros_parameters = node.second["ros__parameters"];
+    if (!ros_parameters || !ros_parameters["map_config"]) {
+      continue;
+    }
+    const auto map_config = ros_parameters["map_config"];
+    const auto read_point = [&map_config](const std::string & name) {
+        return geometry_msgs::msg::Point32{}.
+               set__x(map_config[name]["x"].as<float32_t>()).
+               set__y(map_config[name]["y"].as<float32_t>()).
+               set__z(map_config[name]["z"].as<float32_t>());
+      };
+    return DynamicNDTMap::Config{
+      read_point("min_point"), read_point("max_point"), read_point("voxel_size"),
+      map_config["capacity"].as<uint64_t>()};
+  }
+  throw std::runtime_error("No map_config found in " + param_file_name);
+}
+}  // namespace
+
+int main(int argc, char * argv[])
+{
+  if (argc != 4) {
+    std::cerr << "Usage: " << argv[0] << " <map.pcd> <map_publisher.param.yaml> <output file>" <<
+      std::endl;
+    std::cerr << "The map_config of the parameter file is used for the voxel grid. The output " <<
+      "file can be used as the map_file parameter of the ndt map publisher and the localizer." <<
+      std::endl;
+    return 1;
+  }
+
+  try {
+    const std::string pcd_file{argv[1]};
+    const std::string param_file{argv[2]};
+    const std::string output_file{argv[3]};
+
+    // read_from_pcd() expects a cloud initialized with the x, y, z and intensity fields
+    sensor_msgs::msg::PointCloud2 cloud;
+    point_cloud_msg_wrapper::PointCloud2Modifier<autoware::common::types::PointXYZI>{cloud, "map"};
+    autoware::localization::ndt::read_from_pcd(pcd_file, &cloud);
+
+    DynamicNDTMap map{read_map_config(param_file)};
+    map.insert(cloud);
+    sensor_msgs::msg::PointCloud2 serialized_map;
+    map.serialize_as<autoware::localization::ndt::StaticNDTMap>(serialized_map);
+    autoware::localization::ndt::write_ndt_map_file(output_file, serialized_map);
+    std::cout << "Wrote " << (serialized_map.width - DynamicNDTMap::kNumConfigPoints) <<
+      " voxels to " << output_file << std::endl;
+  } catch (const std::exception & ex) {
+    std::cerr << "Failed to convert the map: " << ex.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
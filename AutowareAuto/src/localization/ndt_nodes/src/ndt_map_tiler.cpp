@@ -0,0 +1,105 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Offline tool cutting a pcd map into ndt map tiles which can be streamed by the map
+///        publisher node
+
+#include <common/types.hpp>
+#include <ndt/ndt_map_publisher.hpp>
+#include <ndt/ndt_map_tiles.hpp>
+#include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using autoware::localization::ndt::MapTileLayout;
+
+namespace
+{
+/// Get a grid configuration covering the point cloud, with tile borders at multiples of the tile
+/// size and voxel borders at multiples of the voxel size.
+MapTileLayout::Config make_map_config(
+  const sensor_msgs::msg::PointCloud2 & cloud, const float64_t tile_size,
+  const float64_t voxel_size)
+{
+  using autoware::common::types::PointXYZI;
+  using PointXYZ = geometry_msgs::msg::Point32;
+  constexpr auto inf = std::numeric_limits<float32_t>::infinity();
+  PointXYZ min_point = PointXYZ{}.set__x(inf).set__y(inf).set__z(inf);
+  PointXYZ max_point = PointXYZ{}.set__x(-inf).set__y(-inf).set__z(-inf);
+  for (const auto & pt : point_cloud_msg_wrapper::PointCloud2View<PointXYZI>{cloud}) {
+    min_point.set__x(std::min(min_point.x, pt.x)).set__y(std::min(min_point.y, pt.y)).
+    set__z(std::min(min_point.z, pt.z));
+    max_point.set__x(std::max(max_point.x, pt.x)).set__y(std::max(max_point.y, pt.y)).
+    set__z(std::max(max_point.z, pt.z));
+  }
+
+  // The upper bounds are moved up by a step, so that no point lies on the border of the grid
+  const auto lower = [](const float32_t value, const float64_t step) {
+      return static_cast<float32_t>(std::floor(value / step) * step);
+    };
+  const auto upper = [](const float32_t value, const float64_t step) {
+      return static_cast<float32_t>((std::floor(value / step) + 1.0) * step);
+    };
+  const auto size = static_cast<float32_t>(voxel_size);
+  const auto voxels_per_tile = static_cast<uint64_t>(std::round(tile_size / voxel_size));
+  const auto z_voxels = static_cast<uint64_t>(
+    std::round((upper(max_point.z, voxel_size) - lower(min_point.z, voxel_size)) / voxel_size));
+  return MapTileLayout::Config{
+    PointXYZ{}.set__x(lower(min_point.x, tile_size)).set__y(lower(min_point.y, tile_size)).
+    set__z(lower(min_point.z, voxel_size)),
+    PointXYZ{}.set__x(upper(max_point.x, tile_size)).set__y(upper(max_point.y, tile_size)).
+    set__z(upper(max_point.z, voxel_size)),
+    PointXYZ{}.set__x(size).set__y(size).set__z(size),
+    // Each tile is converted separately, so the capacity only needs to cover a tile
+    voxels_per_tile * voxels_per_tile * z_voxels};
+}
+}  // namespace
+
+int main(int argc, char * argv[])
+{
+  if (argc != 5) {
+    std::cerr << "Usage: " << argv[0] << " <map.pcd> <output directory> <tile size> " <<
+      "<voxel size>" << std::endl;
+    std::cerr << "The tile size has to be a multiple of the voxel size. The output directory " <<
+      "can be used as the tiles.directory parameter of the ndt map publisher." << std::endl;
+    return 1;
+  }
+
+  try {
+    const std::string pcd_file{argv[1]};
+    const std::string directory{argv[2]};
+    const auto tile_size = std::stod(argv[3]);
+    const auto voxel_size = std::stod(argv[4]);
+
+    // read_from_pcd() expects a cloud initialized with the x, y, z and intensity fields
+    sensor_msgs::msg::PointCloud2 cloud;
+    point_cloud_msg_wrapper::PointCloud2Modifier<autoware::common::types::PointXYZI>{cloud, "map"};
+    autoware::localization::ndt::read_from_pcd(pcd_file, &cloud);
+    const MapTileLayout layout{make_map_config(cloud, tile_size, voxel_size), tile_size};
+    const auto num_tiles = autoware::localization::ndt::write_map_tiles(cloud, layout, directory);
+    std::cout << "Wrote " << num_tiles << " map tiles to " << directory << std::endl;
+  } catch (const std::exception & ex) {
+    std::cerr << "Failed to tile the map: " << ex.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -219,7 +219,7 @@ TEST_F(MapPublisherTest, CoreFunctionality)
   for (const auto & expected_centroid_it : m_voxel_centers) {
     const auto expected_centroid = expected_centroid_it.second;
     const auto & received_cell = static_received_map.cell(expected_centroid)[0U];
-    const auto & reference_cell = dynamic_validation_map.cell(expected_centroid)[0U];
+    const auto reference_cell = dynamic_validation_map.cell(expected_centroid)[0U];
     EXPECT_TRUE(
       received_cell.centroid().isApprox(
         reference_cell.centroid(),
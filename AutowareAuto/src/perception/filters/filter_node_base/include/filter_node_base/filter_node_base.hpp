@@ -164,7 +164,7 @@ private:
    * \param msg Input point cloud message to be processed by the filter
    */
   FILTER_NODE_BASE_LOCAL void pointcloud_callback(
-    const sensor_msgs::msg::PointCloud2::SharedPtr msg);
+    const sensor_msgs::msg::PointCloud2::ConstSharedPtr msg);
 };
 }  // namespace filter_node_base
 }  // namespace filters
@@ -16,6 +16,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 
@@ -30,7 +31,7 @@ namespace filter_node_base
 
 using bool8_t = autoware::common::types::bool8_t;
 using PointCloud2 = sensor_msgs::msg::PointCloud2;
-using PointCloud2SharedPtr = sensor_msgs::msg::PointCloud2::SharedPtr;
+using PointCloud2ConstSharedPtr = sensor_msgs::msg::PointCloud2::ConstSharedPtr;
 
 FilterNodeBase::FilterNodeBase(
   const std::string & filter_name, const rclcpp::NodeOptions & options)
@@ -44,7 +45,7 @@ FilterNodeBase::FilterNodeBase(
     "output", rclcpp::SensorDataQoS().keep_last(max_queue_size_));
 
   // Set subscriber
-  std::function<void(const PointCloud2SharedPtr msg)> cb = std::bind(
+  std::function<void(const PointCloud2ConstSharedPtr msg)> cb = std::bind(
     &FilterNodeBase::pointcloud_callback, this, std::placeholders::_1);
   sub_input_ = create_subscription<PointCloud2>(
     "input", rclcpp::SensorDataQoS().keep_last(max_queue_size_), cb);
@@ -66,7 +67,7 @@ rcl_interfaces::msg::SetParametersResult FilterNodeBase::param_callback(
   return get_node_parameters(p);
 }
 
-void FilterNodeBase::pointcloud_callback(const PointCloud2SharedPtr msg)
+void FilterNodeBase::pointcloud_callback(const PointCloud2ConstSharedPtr msg)
 {
   if (!is_valid(msg)) {
     RCLCPP_ERROR_STREAM(this->get_logger(), "[" << filter_field_name_ << "]: Invalid input!");
@@ -80,12 +81,14 @@ void FilterNodeBase::pointcloud_callback(const PointCloud2SharedPtr msg)
     "received.",
     filter_field_name_, msg->width * msg->height, msg->header.frame_id.c_str());
 
-  PointCloud2 output;
+  // The output is handed over to the publisher, so that it is not copied when intra-process
+  // communication is used
+  auto output = std::make_unique<PointCloud2>();
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    filter(*msg, output);
+    filter(*msg, *output);
   }
-  pub_output_->publish(output);
+  pub_output_->publish(std::move(output));
 }
 
 }  // namespace filter_node_base
@@ -0,0 +1,234 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Measures the copies of a point cloud which passes through a chain of filter nodes, as in a
+// composed perception pipeline. Each node copies its input into its output like a filter which
+// keeps all points. Any other difference of the buffers between two nodes is a copy made by the
+// middleware.
+
+#include <benchmark/benchmark.h>
+#include <common/types.hpp>
+#include <filter_node_base/filter_node_base.hpp>
+#include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using autoware::common::types::PointXYZIF;
+using autoware::perception::filters::filter_node_base::FilterNodeBase;
+using sensor_msgs::msg::PointCloud2;
+
+constexpr auto kNumNodes = 6U;
+constexpr auto kCloudSize = 300000U;
+
+/// Buffers which the points of a frame were received in and published from, one per node
+struct BufferTrace
+{
+  std::vector<const uint8_t *> received;
+  std::vector<const uint8_t *> published;
+};
+
+rclcpp::NodeOptions make_options(const std::size_t idx, const bool use_intra_process_comms)
+{
+  rclcpp::NodeOptions options;
+  options.use_intra_process_comms(use_intra_process_comms);
+  options.parameter_overrides({rclcpp::Parameter{"max_queue_size", 1}});
+  options.arguments(
+    {"--ros-args",
+      "-r", "__node:=filter" + std::to_string(idx),
+      "-r", "input:=hop" + std::to_string(idx),
+      "-r", "output:=hop" + std::to_string(idx + 1U)});
+  return options;
+}
+
+/// Filter node which keeps all points, as implemented on top of FilterNodeBase
+class PassThroughFilterNode : public FilterNodeBase
+{
+public:
+  PassThroughFilterNode(const rclcpp::NodeOptions & options, BufferTrace & trace)
+  : FilterNodeBase("pass_through_filter", options), m_trace(trace)
+  {
+    set_param_callback();
+  }
+
+  std::size_t subscription_count() const
+  {
+    return pub_output_->get_subscription_count();
+  }
+
+protected:
+  void filter(const PointCloud2 & input, PointCloud2 & output) override
+  {
+    m_trace.received.push_back(input.data.data());
+    output = input;
+    m_trace.published.push_back(output.data.data());
+  }
+
+  rcl_interfaces::msg::SetParametersResult get_node_parameters(
+    const std::vector<rclcpp::Parameter> &) override
+  {
+    rcl_interfaces::msg::SetParametersResult result;
+    result.successful = true;
+    return result;
+  }
+
+private:
+  BufferTrace & m_trace;
+};
+
+/// Filter node which keeps all points, with the publishing path of FilterNodeBase before it
+/// published std::unique_ptr messages: the output is a local which is published by reference.
+/// This models the baseline chain in this benchmark, it is not the baseline library itself.
+class BaselineFilterNode : public rclcpp::Node
+{
+public:
+  BaselineFilterNode(const rclcpp::NodeOptions & options, BufferTrace & trace)
+  : Node("baseline_filter", options),
+    m_trace(trace),
+    m_pub{create_publisher<PointCloud2>("output", rclcpp::SensorDataQoS().keep_last(1U))},
+    m_sub{create_subscription<PointCloud2>(
+        "input", rclcpp::SensorDataQoS().keep_last(1U),
+        [this](const PointCloud2::SharedPtr msg) {
+          PointCloud2 output;
+          m_trace.received.push_back(msg->data.data());
+          output = *msg;
+          m_trace.published.push_back(output.data.data());
+          m_pub->publish(output);
+        })}
+  {
+  }
+
+  std::size_t subscription_count() const
+  {
+    return m_pub->get_subscription_count();
+  }
+
+private:
+  BufferTrace & m_trace;
+  rclcpp::Publisher<PointCloud2>::SharedPtr m_pub;
+  rclcpp::Subscription<PointCloud2>::SharedPtr m_sub;
+};
+
+template<typename NodeT>
+void run_chain(benchmark::State & state, const bool use_intra_process_comms)
+{
+  rclcpp::executors::SingleThreadedExecutor executor;
+  BufferTrace trace;
+  std::vector<std::shared_ptr<NodeT>> nodes;
+  for (std::size_t idx = 0U; idx < kNumNodes; ++idx) {
+    nodes.push_back(std::make_shared<NodeT>(make_options(idx, use_intra_process_comms), trace));
+    executor.add_node(nodes.back());
+  }
+  const auto io_node = std::make_shared<rclcpp::Node>(
+    "chain_io", rclcpp::NodeOptions{}.use_intra_process_comms(use_intra_process_comms));
+  const auto pub = io_node->create_publisher<PointCloud2>(
+    "hop0", rclcpp::SensorDataQoS().keep_last(1U));
+  const uint8_t * sink_buffer = nullptr;
+  const auto sub = io_node->create_subscription<PointCloud2>(
+    "hop" + std::to_string(kNumNodes), rclcpp::SensorDataQoS().keep_last(1U),
+    [&sink_buffer](const PointCloud2::ConstSharedPtr msg) {sink_buffer = msg->data.data();});
+  executor.add_node(io_node);
+
+  // Wait until all hops are connected
+  const auto connected = [&nodes, &pub]() {
+      for (const auto & node : nodes) {
+        if (node->subscription_count() == 0U) {
+          return false;
+        }
+      }
+      return pub->get_subscription_count() > 0U;
+    };
+  const auto discovery_deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+  while (!connected()) {
+    if (std::chrono::steady_clock::now() > discovery_deadline) {
+      state.SkipWithError("The chain was not connected in time");
+      return;
+    }
+    executor.spin_some();
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  }
+
+  PointCloud2 cloud;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZIF>{cloud, "base_link"}.resize(kCloudSize);
+
+  std::size_t num_copies = 0U;
+  std::size_t num_frames = 0U;
+  for (auto _ : state) {
+    state.PauseTiming();
+    trace.received.clear();
+    trace.published.clear();
+    sink_buffer = nullptr;
+    auto msg = std::make_unique<PointCloud2>(cloud);
+    const uint8_t * const sent = msg->data.data();
+    state.ResumeTiming();
+
+    pub->publish(std::move(msg));
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{1};
+    while (sink_buffer == nullptr) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        break;
+      }
+      executor.spin_once(std::chrono::milliseconds{10});
+    }
+    if ((sink_buffer == nullptr) || (trace.received.size() != kNumNodes)) {
+      state.SkipWithError("A frame was dropped");
+      break;
+    }
+
+    // A hop copied the points if they arrived in another buffer than they were published from
+    num_copies += (trace.received[0U] != sent) ? 1U : 0U;
+    for (std::size_t idx = 1U; idx < kNumNodes; ++idx) {
+      num_copies += (trace.received[idx] != trace.published[idx - 1U]) ? 1U : 0U;
+    }
+    num_copies += (sink_buffer != trace.published[kNumNodes - 1U]) ? 1U : 0U;
+    ++num_frames;
+  }
+  if (num_frames > 0U) {
+    state.counters["copies_per_frame"] =
+      static_cast<double>(num_copies) / static_cast<double>(num_frames);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(num_frames * cloud.data.size() * kNumNodes));
+}
+
+}  // namespace
+
+static void BenchFilterNodeChainIntraProcess(benchmark::State & state)
+{
+  run_chain<PassThroughFilterNode>(state, true);
+}
+
+static void BenchBaselineChainIntraProcess(benchmark::State & state)
+{
+  run_chain<BaselineFilterNode>(state, true);
+}
+
+BENCHMARK(BenchFilterNodeChainIntraProcess)->Unit(benchmark::kMillisecond);
+BENCHMARK(BenchBaselineChainIntraProcess)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  rclcpp::shutdown();
+  return 0;
+}
@@ -19,11 +19,13 @@
 #ifndef OUTLIER_FILTER__RADIUS_SEARCH_2D_FILTER_HPP_
 #define OUTLIER_FILTER__RADIUS_SEARCH_2D_FILTER_HPP_
 
+#include <cstdint>
 #include <vector>
 #include <memory>
 
 #include "outlier_filter/visibility_control.hpp"
 
+#include "helper_functions/worker_pool.hpp"
 #include "pcl/search/pcl_search.h"
 #include "sensor_msgs/msg/point_cloud2.hpp"
 
@@ -40,6 +42,18 @@ namespace outlier_filter
 namespace radius_search_2d_filter
 {
 
+/** \brief Algorithm used to count the neighbors of each point */
+enum class SearchEngine : uint8_t
+{
+  /** \brief Radius search of a PCL KdTree for every point */
+  KD_TREE = 0U,
+  /** \brief Uniform 2D grid with a cell size equal to the search radius, where only the
+   * neighboring cells of a point are searched and counting stops at the minimum number of
+   * neighbors
+   */
+  GRID
+};
+
 /** \class RadiusSearch2DFilter
  * \brief Library for using a radius based 2D filtering algorithm on a PCL pointcloud
  */
@@ -52,6 +66,16 @@ public:
    */
   OUTLIER_FILTER_PUBLIC RadiusSearch2DFilter(double search_radius, int min_neighbors);
 
+  /** \brief Constructor for the RadiusSearch2DFilter class
+   * \param search_radius Radius bounding a point's neighbors
+   * \param min_neighbors Minimum number of surrounding neighbors for a point
+   * \param engine Algorithm used to count the neighbors of each point
+   * \param num_threads Number of threads used by the SearchEngine::GRID engine, including the
+   *   calling thread
+   */
+  OUTLIER_FILTER_PUBLIC RadiusSearch2DFilter(
+    double search_radius, int min_neighbors, SearchEngine engine, std::size_t num_threads);
+
   /** \brief Filter function that runs the radius search algorithm.
    * \param input The input point cloud for filtering
    * \param output The output point cloud
@@ -71,6 +95,36 @@ public:
   }
 
 private:
+  /** \brief Points of the input cloud sorted by the grid cell they are in */
+  struct GridPoint
+  {
+    uint64_t cell;
+    float x;
+    float y;
+    std::size_t index;
+  };
+
+  /** \brief A grid cell, which holds the grid points in [begin, end) */
+  struct GridCell
+  {
+    uint64_t cell;
+    std::size_t begin;
+    std::size_t end;
+  };
+
+  /** \brief Count the neighbors of each point with a PCL KdTree */
+  void filter_kd_tree(
+    const pcl::PointCloud<pcl::PointXYZ> & input,
+    pcl::PointCloud<pcl::PointXYZ> & output);
+
+  /** \brief Count the neighbors of each point in a uniform grid */
+  void filter_grid(
+    const pcl::PointCloud<pcl::PointXYZ> & input,
+    pcl::PointCloud<pcl::PointXYZ> & output);
+
+  /** \brief Mark the points of the given grid cells which have enough neighbors */
+  void check_grid_cells(std::size_t first_cell, std::size_t last_cell);
+
   /** \brief Radius bounding a point's neighbors */
   double search_radius_;
 
@@ -79,6 +133,17 @@ private:
 
   /** \brief PCL Search object used to perform the radial search */
   std::shared_ptr<pcl::search::Search<pcl::PointXY>> kd_tree_;
+
+  /** \brief Algorithm used to count the neighbors of each point */
+  SearchEngine engine_;
+
+  /** \brief Threads sharing the grid cells, null if the calling thread does all the work */
+  std::unique_ptr<autoware::common::helper_functions::WorkerPool> worker_pool_;
+
+  /** \brief Buffers of the grid engine, kept between calls to avoid allocations */
+  std::vector<GridPoint> grid_points_;
+  std::vector<GridCell> grid_cells_;
+  std::vector<uint8_t> keep_;
 };
 }  // namespace radius_search_2d_filter
 }  // namespace outlier_filter
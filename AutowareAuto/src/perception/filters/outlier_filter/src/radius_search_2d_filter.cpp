@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <vector>
 #include <memory>
 
@@ -30,15 +33,51 @@ namespace outlier_filter
 namespace radius_search_2d_filter
 {
 
+namespace
+{
+// Grid coordinates are offset to be unsigned, points further away from the origin are outliers
+constexpr int64_t kGridOffset = 1LL << 30;
+
+// Number of tasks per thread, so that threads which finish early can take more cells
+constexpr std::size_t kTasksPerThread = 4U;
+
+uint64_t make_cell(const int64_t cell_x, const int64_t cell_y)
+{
+  return (static_cast<uint64_t>(cell_y + kGridOffset) << 32U) |
+         static_cast<uint64_t>(cell_x + kGridOffset);
+}
+}  // namespace
+
 RadiusSearch2DFilter::RadiusSearch2DFilter(double search_radius, int min_neighbors)
-: search_radius_(search_radius), min_neighbors_(min_neighbors)
+: RadiusSearch2DFilter(search_radius, min_neighbors, SearchEngine::KD_TREE, 1U)
+{
+}
+
+RadiusSearch2DFilter::RadiusSearch2DFilter(
+  double search_radius, int min_neighbors, SearchEngine engine, std::size_t num_threads)
+: search_radius_(search_radius), min_neighbors_(min_neighbors), engine_(engine)
 {
   kd_tree_ = std::make_shared<pcl::search::KdTree<pcl::PointXY>>(false);
+  if (num_threads > 1U) {
+    worker_pool_ = std::make_unique<autoware::common::helper_functions::WorkerPool>(num_threads);
+  }
 }
 
 void RadiusSearch2DFilter::filter(
   const pcl::PointCloud<pcl::PointXYZ> & input,
   pcl::PointCloud<pcl::PointXYZ> & output)
+{
+  // The grid needs a positive cell size
+  if ((engine_ == SearchEngine::GRID) && (search_radius_ > 0.0)) {
+    filter_grid(input, output);
+  } else {
+    filter_kd_tree(input, output);
+  }
+}
+
+void RadiusSearch2DFilter::filter_kd_tree(
+  const pcl::PointCloud<pcl::PointXYZ> & input,
+  pcl::PointCloud<pcl::PointXYZ> & output)
 {
   pcl::PointCloud<pcl::PointXY>::Ptr xy_cloud(new pcl::PointCloud<pcl::PointXY>());
   xy_cloud->points.resize(input.points.size());
@@ -58,6 +97,118 @@ void RadiusSearch2DFilter::filter(
   }
 }
 
+void RadiusSearch2DFilter::filter_grid(
+  const pcl::PointCloud<pcl::PointXYZ> & input,
+  pcl::PointCloud<pcl::PointXYZ> & output)
+{
+  // Sort the points into cells of the size of the search radius, so that all neighbors of a point
+  // are in the 3x3 cells around its cell
+  const double inv_cell_size = 1.0 / search_radius_;
+  const double max_cell = static_cast<double>(kGridOffset - 2);
+  grid_points_.clear();
+  keep_.assign(input.points.size(), 0U);
+  for (std::size_t i = 0U; i < input.points.size(); ++i) {
+    const auto & pt = input.points[i];
+    const double cell_x = std::floor(static_cast<double>(pt.x) * inv_cell_size);
+    const double cell_y = std::floor(static_cast<double>(pt.y) * inv_cell_size);
+    // Also false for NaN
+    if ((std::fabs(cell_x) < max_cell) && (std::fabs(cell_y) < max_cell)) {
+      grid_points_.push_back(
+        GridPoint{
+          make_cell(static_cast<int64_t>(cell_x), static_cast<int64_t>(cell_y)), pt.x, pt.y, i});
+    }
+  }
+  std::sort(
+    grid_points_.begin(), grid_points_.end(),
+    [](const GridPoint & a, const GridPoint & b) {return a.cell < b.cell;});
+
+  grid_cells_.clear();
+  for (std::size_t i = 0U; i < grid_points_.size(); ++i) {
+    if (grid_cells_.empty() || (grid_cells_.back().cell != grid_points_[i].cell)) {
+      grid_cells_.push_back(GridCell{grid_points_[i].cell, i, i});
+    }
+    grid_cells_.back().end = i + 1U;
+  }
+
+  const std::size_t num_cells = grid_cells_.size();
+  if (worker_pool_) {
+    const std::size_t num_tasks = std::min(num_cells, worker_pool_->size() * kTasksPerThread);
+    worker_pool_->run(
+      num_tasks, [this, num_cells, num_tasks](const std::size_t task) {
+        check_grid_cells((task * num_cells) / num_tasks, ((task + 1U) * num_cells) / num_tasks);
+      });
+  } else {
+    check_grid_cells(0U, num_cells);
+  }
+
+  // Keep the order of the input
+  for (std::size_t i = 0U; i < input.points.size(); ++i) {
+    if (keep_[i] != 0U) {
+      output.points.push_back(input.points[i]);
+    }
+  }
+}
+
+void RadiusSearch2DFilter::check_grid_cells(
+  const std::size_t first_cell,
+  const std::size_t last_cell)
+{
+  const float radius2 = static_cast<float>(search_radius_ * search_radius_);
+  const std::size_t min_neighbors =
+    (min_neighbors_ > 0) ? static_cast<std::size_t>(min_neighbors_) : 0U;
+  const auto cell_less = [](const GridCell & cell, const uint64_t key) {return cell.cell < key;};
+
+  for (std::size_t cell_idx = first_cell; cell_idx < last_cell; ++cell_idx) {
+    const auto & cell = grid_cells_[cell_idx];
+    // The neighboring cells of a row are next to each other in the sorted points, so there is
+    // one range of points per row, starting with the row of the cell
+    std::size_t range_begin[3U];
+    std::size_t range_end[3U];
+    std::size_t num_candidates = 0U;
+    const int64_t cell_x = static_cast<int64_t>(cell.cell & 0xFFFFFFFFU) - kGridOffset;
+    const int64_t cell_y = static_cast<int64_t>(cell.cell >> 32U) - kGridOffset;
+    const int64_t rows[3U] = {cell_y, cell_y - 1, cell_y + 1};
+    for (std::size_t row = 0U; row < 3U; ++row) {
+      const auto first = std::lower_bound(
+        grid_cells_.begin(), grid_cells_.end(), make_cell(cell_x - 1, rows[row]), cell_less);
+      const auto last = std::lower_bound(
+        first, grid_cells_.end(), make_cell(cell_x + 2, rows[row]), cell_less);
+      if (first == last) {
+        range_begin[row] = 0U;
+        range_end[row] = 0U;
+      } else {
+        range_begin[row] = first->begin;
+        range_end[row] = (last - 1)->end;
+      }
+      num_candidates += range_end[row] - range_begin[row];
+    }
+    // Every point of the cell fails if there are not enough points around it
+    if (num_candidates < min_neighbors) {
+      continue;
+    }
+
+    for (std::size_t i = cell.begin; i < cell.end; ++i) {
+      const auto & pt = grid_points_[i];
+      std::size_t count = 0U;
+      for (std::size_t row = 0U; (row < 3U) && (count < min_neighbors); ++row) {
+        for (std::size_t j = range_begin[row]; (j < range_end[row]) && (count < min_neighbors);
+          ++j)
+        {
+          const float dx = grid_points_[j].x - pt.x;
+          const float dy = grid_points_[j].y - pt.y;
+          // The point itself is counted, as in the KdTree radius search
+          if (((dx * dx) + (dy * dy)) < radius2) {
+            ++count;
+          }
+        }
+      }
+      if (count >= min_neighbors) {
+        keep_[pt.index] = 1U;
+      }
+    }
+  }
+}
+
 }  // namespace radius_search_2d_filter
 }  // namespace outlier_filter
 }  // namespace filters
@@ -12,8 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <vector>
 #include <memory>
+#include <random>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "pcl_conversions/pcl_conversions.h"
@@ -154,3 +155,33 @@ TEST(RadiusSearch2DFilter, TestDecreaseSearchRadius) {
   // Min neighbours increased, not enough neighbours all points should fail checks
   check_pc({}, output);
 }
+
+/* TEST 6: The grid engine keeps the same points as the KdTree engine
+ */
+TEST(RadiusSearch2DFilter, TestGridSameAsKdTree) {
+  using autoware::perception::filters::outlier_filter::radius_search_2d_filter::SearchEngine;
+  std::mt19937 gen{42};
+  std::uniform_real_distribution<float> dist{-10.0f, 10.0f};
+  std::vector<pcl::PointXYZ> points;
+  for (int i = 0; i < 2000; ++i) {
+    points.push_back(make_point(dist(gen), dist(gen), dist(gen)));
+  }
+  auto time0 = std::chrono::system_clock::now();
+  auto t0 = to_msg_time(time0);
+  auto input = make_pc(points, t0);
+
+  for (const int min_neighbors : {1, 3, 8}) {
+    RadiusSearch2DFilter kd_tree_filter{0.5, min_neighbors};
+    pcl::PointCloud<pcl::PointXYZ> expected;
+    kd_tree_filter.filter(input, expected);
+    std::vector<pcl::PointXYZ> expected_points{expected.points.begin(), expected.points.end()};
+    ASSERT_FALSE(expected_points.empty());
+
+    for (const std::size_t num_threads : {1U, 4U}) {
+      RadiusSearch2DFilter grid_filter{0.5, min_neighbors, SearchEngine::GRID, num_threads};
+      pcl::PointCloud<pcl::PointXYZ> output;
+      grid_filter.filter(input, output);
+      check_pc(expected_points, output);
+    }
+  }
+}
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <memory>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "outlier_filter_nodes/radius_search_2d_filter_node.hpp"
@@ -34,6 +36,30 @@ using float64_t = autoware::common::types::float64_t;
 using RadiusSearch2DFilter =
   autoware::perception::filters::outlier_filter::radius_search_2d_filter::
   RadiusSearch2DFilter;
+using SearchEngine =
+  autoware::perception::filters::outlier_filter::radius_search_2d_filter::SearchEngine;
+
+namespace
+{
+SearchEngine to_search_engine(const std::string & name)
+{
+  if (name == "kd_tree") {
+    return SearchEngine::KD_TREE;
+  } else if (name == "grid") {
+    return SearchEngine::GRID;
+  }
+  throw std::domain_error("Unknown search_engine: " + name + ", expected kd_tree or grid");
+}
+
+std::size_t to_num_threads(const int num_threads)
+{
+  if (num_threads < 0) {
+    throw std::domain_error(
+            "num_threads must not be negative, got: " + std::to_string(num_threads));
+  }
+  return static_cast<std::size_t>(num_threads);
+}
+}  // namespace
 
 RadiusSearch2DFilterNode::RadiusSearch2DFilterNode(const rclcpp::NodeOptions & options)
 :  FilterNodeBase("radius_search_2d_filter_node", options),
@@ -42,7 +68,9 @@ RadiusSearch2DFilterNode::RadiusSearch2DFilterNode(const rclcpp::NodeOptions & o
 {
   radius_search_2d_filter_ = std::make_shared<RadiusSearch2DFilter>(
     search_radius_,
-    min_neighbors_
+    min_neighbors_,
+    to_search_engine(declare_parameter("search_engine", std::string{"kd_tree"})),
+    to_num_threads(declare_parameter("num_threads", 1))
   );
 
   set_param_callback();
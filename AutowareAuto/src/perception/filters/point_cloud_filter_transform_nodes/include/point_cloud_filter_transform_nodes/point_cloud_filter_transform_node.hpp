@@ -71,7 +71,7 @@ protected:
 
   /// \brief Run main subscribe -> filter & transform -> publish loop
   void process_filtered_transformed_message(
-    const PointCloud2::SharedPtr msg);
+    const PointCloud2::ConstSharedPtr msg);
 
   template<typename PointType>
   /// \brief Check if the point is within the specified angle and radius limits
@@ -111,6 +111,9 @@ private:
   const size_t m_expected_num_publishers;
   const size_t m_expected_num_subscribers;
   const std::uint32_t m_pcl_size;
+  // Publish the filtered points as a std::unique_ptr, so that they are not copied when
+  // intra-process communication is used
+  const bool8_t m_publish_unique_ptr;
   PointCloud2 m_filtered_transformed_msg;
 };
 
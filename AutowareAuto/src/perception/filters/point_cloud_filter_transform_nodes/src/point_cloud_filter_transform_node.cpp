@@ -81,7 +81,8 @@ PointCloud2FilterTransformNode::PointCloud2FilterTransformNode(
     static_cast<size_t>(declare_parameter("expected_num_publishers").get<int32_t>())},
   m_expected_num_subscribers{
     static_cast<size_t>(declare_parameter("expected_num_subscribers").get<int32_t>())},
-  m_pcl_size{static_cast<std::uint32_t>(declare_parameter("pcl_size").get<uint32_t>())}
+  m_pcl_size{static_cast<std::uint32_t>(declare_parameter("pcl_size").get<uint32_t>())},
+  m_publish_unique_ptr{node_options.use_intra_process_comms()}
 {  /// Declare transform parameters with the namespace
   this->declare_parameter("static_transformer.quaternion.x");
   this->declare_parameter("static_transformer.quaternion.y");
@@ -195,10 +196,15 @@ const PointCloud2 & PointCloud2FilterTransformNode::filter_and_transform(const P
 
 void
 PointCloud2FilterTransformNode::process_filtered_transformed_message(
-  const PointCloud2::SharedPtr msg)
+  const PointCloud2::ConstSharedPtr msg)
 {
-  const auto filtered_transformed_msg = filter_and_transform(*msg);
-  m_pub_ptr->publish(filtered_transformed_msg);
+  const auto & filtered_transformed_msg = filter_and_transform(*msg);
+  if (m_publish_unique_ptr) {
+    m_pub_ptr->publish(
+      autoware::common::lidar_utils::take_point_cloud(m_filtered_transformed_msg));
+  } else {
+    m_pub_ptr->publish(filtered_transformed_msg);
+  }
 }
 
 }  // namespace point_cloud_filter_transform_nodes
@@ -0,0 +1,94 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef POINT_CLOUD_FUSION__EGO_MOTION_BUFFER_HPP_
+#define POINT_CLOUD_FUSION__EGO_MOTION_BUFFER_HPP_
+
+#include <point_cloud_fusion/visibility_control.hpp>
+
+#include <common/types.hpp>
+#include <Eigen/Geometry>
+
+#include <chrono>
+#include <vector>
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace point_cloud_fusion
+{
+using autoware::common::types::bool8_t;
+using autoware::common::types::float64_t;
+
+/// \brief A fixed size history of the poses of the vehicle in a fixed frame, e.g. from odometry,
+///        which can be queried for the pose at any time in between
+class POINT_CLOUD_FUSION_PUBLIC EgoMotionBuffer
+{
+public:
+  /// \brief     constructor
+  /// \param[in] capacity Number of poses kept, the oldest pose is dropped first
+  /// \param[in] max_extrapolation How far past the newest pose a pose can be extrapolated
+  /// \throw     std::domain_error if the capacity is less than two
+  EgoMotionBuffer(const std::size_t capacity, const std::chrono::nanoseconds max_extrapolation);
+
+  /// \brief     Add the newest pose. A pose which is older than the newest pose, e.g. after the
+  ///            time jumped back, clears the history.
+  /// \param[in] stamp Time since epoch of the pose
+  /// \param[in] pose Pose of the vehicle in a fixed frame
+  void push(const std::chrono::nanoseconds stamp, const Eigen::Isometry3d & pose);
+
+  /// \brief      Get the pose at some time, interpolated between the two closest poses. The
+  ///             translation is interpolated linearly, the rotation spherically.
+  /// \param[in]  stamp Time since epoch
+  /// \param[out] pose The pose at that time
+  /// \return     False if the time is older than the oldest pose, or newer than the newest pose
+  ///             plus the max extrapolation
+  bool8_t get_pose(const std::chrono::nanoseconds stamp, Eigen::Isometry3d & pose) const;
+
+  /// \brief Remove all poses
+  void clear() noexcept;
+
+  /// \brief Number of poses in the history
+  std::size_t size() const noexcept;
+
+private:
+  struct StampedPose
+  {
+    std::chrono::nanoseconds stamp;
+    Eigen::Quaterniond rotation;
+    Eigen::Vector3d translation;
+  };
+
+  const StampedPose & at(const std::size_t idx) const;
+  static Eigen::Isometry3d interpolate(
+    const StampedPose & first, const StampedPose & second,
+    const std::chrono::nanoseconds stamp);
+
+  // Ring buffer, the oldest pose is at m_head
+  std::vector<StampedPose> m_poses;
+  std::size_t m_head;
+  std::size_t m_size;
+  std::chrono::nanoseconds m_max_extrapolation;
+};
+
+}  // namespace point_cloud_fusion
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // POINT_CLOUD_FUSION__EGO_MOTION_BUFFER_HPP_
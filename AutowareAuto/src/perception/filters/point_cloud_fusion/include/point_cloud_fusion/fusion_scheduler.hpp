@@ -0,0 +1,112 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef POINT_CLOUD_FUSION__FUSION_SCHEDULER_HPP_
+#define POINT_CLOUD_FUSION__FUSION_SCHEDULER_HPP_
+
+#include <point_cloud_fusion/visibility_control.hpp>
+
+#include <common/types.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace point_cloud_fusion
+{
+using autoware::common::types::bool8_t;
+
+/// \brief Collects the messages of each source in a bounded queue, and hands out the messages
+///        to be fused at a deadline. Sources which have no message inside the window before the
+///        deadline are left out instead of holding back the others.
+class POINT_CLOUD_FUSION_PUBLIC FusionScheduler
+{
+public:
+  using PointCloudMsgT = sensor_msgs::msg::PointCloud2;
+  static constexpr std::size_t MAX_INPUTS = 8U;
+
+  /// \brief     constructor
+  /// \param[in] num_inputs Number of sources, between 1 and MAX_INPUTS
+  /// \param[in] queue_capacity Maximum number of messages queued per source. If the queue of a
+  ///            source is full, its oldest message is dropped.
+  /// \param[in] window Maximum age of a message at the deadline for it to be fused
+  /// \throw     std::domain_error if the number of inputs or the queue capacity is out of range
+  FusionScheduler(
+    const std::size_t num_inputs, const std::size_t queue_capacity,
+    const std::chrono::nanoseconds window);
+
+  /// \brief     Queue a message of a source
+  /// \param[in] input Index of the source
+  /// \param[in] msg The message
+  /// \throw     std::out_of_range if the index is not of a source
+  void push(const std::size_t input, const PointCloudMsgT::ConstSharedPtr & msg);
+
+  /// \brief      Take the newest message of each source which is inside the window before the
+  ///             deadline. Older messages are dropped, newer messages stay queued for the next
+  ///             deadline.
+  /// \param[in]  deadline Time since epoch to fuse at
+  /// \param[out] msgs The message of each source, or null if a source has no message in time
+  /// \return     Number of sources with a message
+  std::size_t pop(
+    const std::chrono::nanoseconds deadline,
+    std::array<PointCloudMsgT::ConstSharedPtr, MAX_INPUTS> & msgs);
+
+  /// \brief     How long ago the newest message of a source was stamped
+  /// \param[in] input Index of the source
+  /// \param[in] now Time since epoch
+  /// \return    The age of the newest message, or std::chrono::nanoseconds::max() if the source
+  ///            did not send a message yet
+  std::chrono::nanoseconds staleness(const std::size_t input, const std::chrono::nanoseconds now)
+  const;
+
+  /// \brief     Number of messages of a source which were dropped without being fused
+  /// \param[in] input Index of the source
+  std::size_t dropped(const std::size_t input) const;
+
+  /// \brief Number of sources
+  std::size_t num_inputs() const noexcept;
+
+private:
+  struct Queue
+  {
+    // Ring buffer, the oldest message is at head
+    std::vector<PointCloudMsgT::ConstSharedPtr> msgs;
+    std::size_t head;
+    std::size_t size;
+    bool8_t has_latest;
+    std::chrono::nanoseconds latest_stamp;
+    std::size_t dropped;
+  };
+
+  const Queue & queue(const std::size_t input) const;
+
+  std::vector<Queue> m_queues;
+  std::chrono::nanoseconds m_window;
+};
+
+}  // namespace point_cloud_fusion
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // POINT_CLOUD_FUSION__FUSION_SCHEDULER_HPP_
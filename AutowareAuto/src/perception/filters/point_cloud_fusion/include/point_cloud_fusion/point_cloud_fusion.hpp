@@ -17,11 +17,14 @@
 #ifndef POINT_CLOUD_FUSION__POINT_CLOUD_FUSION_HPP_
 #define POINT_CLOUD_FUSION__POINT_CLOUD_FUSION_HPP_
 
+#include <point_cloud_fusion/ego_motion_buffer.hpp>
 #include <point_cloud_fusion/visibility_control.hpp>
 
 #include <common/types.hpp>
 #include <lidar_utils/point_cloud_utils.hpp>
 #include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
+#include <array>
+#include <chrono>
 #include <vector>
 
 namespace autoware
@@ -41,28 +44,52 @@ public:
   {
     NONE = 0U,
     TOO_LARGE,
-    INSERT_FAILED
+    INSERT_FAILED,
+    NO_EGO_MOTION
   };  // enum class Error
   using PointCloudMsgT = sensor_msgs::msg::PointCloud2;
 
   /// \brief     constructor
   /// \param[in] cloud_capacity
   /// \param[in] input_topics_size
+  /// \param[in] deskew_resolution Points of a message which were measured less than this apart
+  ///            share the same ego motion correction in fuse_pc_msgs_deskewed()
   explicit PointCloudFusion(
     uint32_t cloud_capacity,
-    size_t input_topics_size);
+    size_t input_topics_size,
+    std::chrono::nanoseconds deskew_resolution = std::chrono::microseconds{100});
 
   /// \brief This function goes through all of the messages and adds them to the concatenated
   /// point cloud. If a pointcloud cannot be transformed to the output frame, it's ignored. If
   /// concatenation exceeds the maximum capacity, fusion stops and the partially concatenated cloud
   /// is still published.
-  /// \param[in]  msgs msgs to be fused.
+  /// \param[in]  msgs msgs to be fused. Null msgs, e.g. of sources which missed the deadline of
+  ///             a FusionScheduler, are skipped.
   /// \param[out] cloud_concatenated fused msgs.
   /// \return     Size of the concatenated pointcloud.
   uint32_t fuse_pc_msgs(
     const std::array<PointCloudMsgT::ConstSharedPtr, 8> & msgs,
     PointCloudMsgT & cloud_concatenated);
 
+  /// \brief This function merges all of the messages into the fused point cloud in the order in
+  /// which the points were measured, and moves each point to where it would have been measured at
+  /// the latest stamp of the messages, given the ego motion in between. The time of a point is the
+  /// stamp of its message, plus the optional float32 field `time` in seconds. Points of a message
+  /// are expected to be in the order in which they were measured. An intensity field of another
+  /// numeric type than float32 is converted, one of an unknown type is ignored. The fused point
+  /// cloud is resized once, and runs of points which need no correction are copied at once.
+  /// \param[in]  msgs msgs to be fused, in the frame of the vehicle. Null msgs are skipped.
+  /// \param[in]  ego_motion Poses of the vehicle, covering the times of all points.
+  /// \param[out] cloud_concatenated fused msgs.
+  /// \return     Size of the concatenated pointcloud.
+  /// \throw      Error::TOO_LARGE if the messages exceed the capacity, nothing is fused then
+  /// \throw      Error::INSERT_FAILED if a message has no float32 x, y and z fields
+  /// \throw      Error::NO_EGO_MOTION if there is no pose for the time of a point
+  uint32_t fuse_pc_msgs_deskewed(
+    const std::array<PointCloudMsgT::ConstSharedPtr, 8> & msgs,
+    const EgoMotionBuffer & ego_motion,
+    PointCloudMsgT & cloud_concatenated) const;
+
 private:
   void concatenate_pointcloud(
     const PointCloudMsgT & pc_in,
@@ -71,6 +98,7 @@ private:
 
   uint32_t m_cloud_capacity;
   size_t m_input_topics_size;
+  std::chrono::nanoseconds m_deskew_resolution;
 };
 
 }  // namespace point_cloud_fusion
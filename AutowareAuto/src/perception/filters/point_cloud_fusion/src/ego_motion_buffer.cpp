@@ -0,0 +1,126 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <point_cloud_fusion/ego_motion_buffer.hpp>
+
+#include <stdexcept>
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace point_cloud_fusion
+{
+
+EgoMotionBuffer::EgoMotionBuffer(
+  const std::size_t capacity,
+  const std::chrono::nanoseconds max_extrapolation)
+: m_poses(capacity),
+  m_head(0U),
+  m_size(0U),
+  m_max_extrapolation(max_extrapolation)
+{
+  if (capacity < 2U) {
+    throw std::domain_error("EgoMotionBuffer: capacity must be at least 2");
+  }
+}
+
+void EgoMotionBuffer::push(const std::chrono::nanoseconds stamp, const Eigen::Isometry3d & pose)
+{
+  if ((m_size > 0U) && (stamp < at(m_size - 1U).stamp)) {
+    clear();
+  }
+  StampedPose stamped_pose{stamp, Eigen::Quaterniond{pose.rotation()}, pose.translation()};
+  if (m_size < m_poses.size()) {
+    m_poses[(m_head + m_size) % m_poses.size()] = stamped_pose;
+    ++m_size;
+  } else {
+    // Overwrite the oldest pose
+    m_poses[m_head] = stamped_pose;
+    m_head = (m_head + 1U) % m_poses.size();
+  }
+}
+
+bool8_t EgoMotionBuffer::get_pose(
+  const std::chrono::nanoseconds stamp,
+  Eigen::Isometry3d & pose) const
+{
+  if ((m_size == 0U) || (stamp < at(0U).stamp)) {
+    return false;
+  }
+  const auto & newest = at(m_size - 1U);
+  if (stamp >= newest.stamp) {
+    if (stamp == newest.stamp) {
+      pose = interpolate(newest, newest, stamp);
+      return true;
+    }
+    if ((m_size < 2U) || ((stamp - newest.stamp) > m_max_extrapolation)) {
+      return false;
+    }
+    pose = interpolate(at(m_size - 2U), newest, stamp);
+    return true;
+  }
+  // Find the first pose newer than the stamp, there is one older or at the stamp before it
+  std::size_t first = 1U;
+  std::size_t count = m_size - 1U;
+  while (count > 0U) {
+    const auto step = count / 2U;
+    if (at(first + step).stamp <= stamp) {
+      first += step + 1U;
+      count -= step + 1U;
+    } else {
+      count = step;
+    }
+  }
+  pose = interpolate(at(first - 1U), at(first), stamp);
+  return true;
+}
+
+void EgoMotionBuffer::clear() noexcept
+{
+  m_head = 0U;
+  m_size = 0U;
+}
+
+std::size_t EgoMotionBuffer::size() const noexcept
+{
+  return m_size;
+}
+
+const EgoMotionBuffer::StampedPose & EgoMotionBuffer::at(const std::size_t idx) const
+{
+  return m_poses[(m_head + idx) % m_poses.size()];
+}
+
+Eigen::Isometry3d EgoMotionBuffer::interpolate(
+  const StampedPose & first, const StampedPose & second,
+  const std::chrono::nanoseconds stamp)
+{
+  const auto dt = second.stamp - first.stamp;
+  // Ratios above one extrapolate past the second pose
+  const auto ratio = (dt.count() > 0) ?
+    (static_cast<float64_t>((stamp - first.stamp).count()) / static_cast<float64_t>(dt.count())) :
+    0.0;
+  Eigen::Isometry3d ret{first.rotation.slerp(ratio, second.rotation).normalized()};
+  ret.translation() = first.translation + (ratio * (second.translation - first.translation));
+  return ret;
+}
+
+}  // namespace point_cloud_fusion
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
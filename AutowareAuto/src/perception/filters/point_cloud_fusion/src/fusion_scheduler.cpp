@@ -0,0 +1,154 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <point_cloud_fusion/fusion_scheduler.hpp>
+
+#include <stdexcept>
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace point_cloud_fusion
+{
+namespace
+{
+std::chrono::nanoseconds stamp_of(const sensor_msgs::msg::PointCloud2 & msg)
+{
+  return std::chrono::seconds{msg.header.stamp.sec} +
+         std::chrono::nanoseconds{msg.header.stamp.nanosec};
+}
+}  // namespace
+
+constexpr std::size_t FusionScheduler::MAX_INPUTS;
+
+FusionScheduler::FusionScheduler(
+  const std::size_t num_inputs, const std::size_t queue_capacity,
+  const std::chrono::nanoseconds window)
+: m_window(window)
+{
+  if ((num_inputs == 0U) || (num_inputs > MAX_INPUTS)) {
+    throw std::domain_error("FusionScheduler: number of inputs must be between 1 and 8");
+  }
+  if (queue_capacity == 0U) {
+    throw std::domain_error("FusionScheduler: queue capacity must be positive");
+  }
+  m_queues.resize(num_inputs);
+  for (auto & q : m_queues) {
+    q.msgs.resize(queue_capacity);
+    q.head = 0U;
+    q.size = 0U;
+    q.has_latest = false;
+    q.latest_stamp = std::chrono::nanoseconds{0};
+    q.dropped = 0U;
+  }
+}
+
+void FusionScheduler::push(const std::size_t input, const PointCloudMsgT::ConstSharedPtr & msg)
+{
+  auto & q = m_queues.at(input);
+  const auto stamp = stamp_of(*msg);
+  if (!q.has_latest || (stamp > q.latest_stamp)) {
+    q.has_latest = true;
+    q.latest_stamp = stamp;
+  }
+  const auto capacity = q.msgs.size();
+  if (q.size < capacity) {
+    q.msgs[(q.head + q.size) % capacity] = msg;
+    ++q.size;
+  } else {
+    // Overwrite the oldest message
+    q.msgs[q.head] = msg;
+    q.head = (q.head + 1U) % capacity;
+    ++q.dropped;
+  }
+}
+
+std::size_t FusionScheduler::pop(
+  const std::chrono::nanoseconds deadline,
+  std::array<PointCloudMsgT::ConstSharedPtr, MAX_INPUTS> & msgs)
+{
+  std::size_t num_msgs = 0U;
+  for (std::size_t i = 0U; i < MAX_INPUTS; ++i) {
+    msgs[i] = nullptr;
+    if (i >= m_queues.size()) {
+      continue;
+    }
+    auto & q = m_queues[i];
+    const auto capacity = q.msgs.size();
+    // Keep the messages after the deadline in order, at the front of the queue
+    std::size_t kept = 0U;
+    for (std::size_t idx = 0U; idx < q.size; ++idx) {
+      auto & msg = q.msgs[(q.head + idx) % capacity];
+      const auto stamp = stamp_of(*msg);
+      if (stamp > deadline) {
+        q.msgs[(q.head + kept) % capacity] = msg;
+        ++kept;
+        continue;
+      }
+      if ((stamp >= (deadline - m_window)) &&
+        (!msgs[i] || (stamp >= stamp_of(*msgs[i]))))
+      {
+        if (msgs[i]) {
+          ++q.dropped;
+        }
+        msgs[i] = msg;
+      } else {
+        ++q.dropped;
+      }
+    }
+    for (std::size_t idx = kept; idx < q.size; ++idx) {
+      q.msgs[(q.head + idx) % capacity] = nullptr;
+    }
+    q.size = kept;
+    if (msgs[i]) {
+      ++num_msgs;
+    }
+  }
+  return num_msgs;
+}
+
+std::chrono::nanoseconds FusionScheduler::staleness(
+  const std::size_t input,
+  const std::chrono::nanoseconds now) const
+{
+  const auto & q = queue(input);
+  if (!q.has_latest) {
+    return std::chrono::nanoseconds::max();
+  }
+  return now - q.latest_stamp;
+}
+
+std::size_t FusionScheduler::dropped(const std::size_t input) const
+{
+  return queue(input).dropped;
+}
+
+std::size_t FusionScheduler::num_inputs() const noexcept
+{
+  return m_queues.size();
+}
+
+const FusionScheduler::Queue & FusionScheduler::queue(const std::size_t input) const
+{
+  return m_queues.at(input);
+}
+
+}  // namespace point_cloud_fusion
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
@@ -18,6 +18,11 @@
 #include <point_cloud_fusion/point_cloud_fusion.hpp>
 #include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string>
+
 namespace autoware
 {
 namespace perception
@@ -27,11 +32,201 @@ namespace filters
 namespace point_cloud_fusion
 {
 
+namespace
+{
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+
+// Reads the points of a message to be deskewed, and keeps the ego motion correction of the last
+// point
+struct DeskewInput
+{
+  const uint8_t * data{nullptr};
+  std::size_t size{0U};
+  std::size_t next{0U};
+  uint32_t point_step{0U};
+  uint32_t x_offset{0U};
+  uint32_t y_offset{0U};
+  uint32_t z_offset{0U};
+  uint32_t intensity_offset{0U};
+  uint8_t intensity_datatype{sensor_msgs::msg::PointField::FLOAT32};
+  uint32_t time_offset{0U};
+  bool8_t has_intensity{false};
+  bool8_t has_time{false};
+  // The points can be copied as they are into the fused point cloud
+  bool8_t is_xyzi{false};
+  std::chrono::nanoseconds stamp{0};
+
+  bool8_t has_correction{false};
+  bool8_t correction_is_identity{false};
+  std::chrono::nanoseconds correction_stamp{0};
+  Eigen::Matrix3f correction_rotation{Eigen::Matrix3f::Identity()};
+  Eigen::Vector3f correction_translation{Eigen::Vector3f::Zero()};
+
+  float32_t read(const std::size_t idx, const uint32_t offset) const
+  {
+    float32_t ret;
+    //lint -e{925, 9110} Need to convert pointers and use bit for external API NOLINT
+    (void)std::memcpy(&ret, &data[(idx * point_step) + offset], sizeof(ret));
+    return ret;
+  }
+
+  template<typename ValueT>
+  float32_t read_as(const std::size_t idx, const uint32_t offset) const
+  {
+    ValueT ret;
+    //lint -e{925, 9110} Need to convert pointers and use bit for external API NOLINT
+    (void)std::memcpy(&ret, &data[(idx * point_step) + offset], sizeof(ret));
+    return static_cast<float32_t>(ret);
+  }
+
+  // The intensity of a point, converted to float32 from any numeric type
+  float32_t intensity_of(const std::size_t idx) const
+  {
+    using sensor_msgs::msg::PointField;
+    switch (intensity_datatype) {
+      case PointField::INT8:
+        return read_as<int8_t>(idx, intensity_offset);
+      case PointField::UINT8:
+        return read_as<uint8_t>(idx, intensity_offset);
+      case PointField::INT16:
+        return read_as<int16_t>(idx, intensity_offset);
+      case PointField::UINT16:
+        return read_as<uint16_t>(idx, intensity_offset);
+      case PointField::INT32:
+        return read_as<int32_t>(idx, intensity_offset);
+      case PointField::UINT32:
+        return read_as<uint32_t>(idx, intensity_offset);
+      case PointField::FLOAT64:
+        return read_as<float64_t>(idx, intensity_offset);
+      default:
+        return read(idx, intensity_offset);
+    }
+  }
+
+  std::chrono::nanoseconds time_of(const std::size_t idx) const
+  {
+    if (!has_time) {
+      return stamp;
+    }
+    return stamp + std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<float64_t>{static_cast<float64_t>(read(idx, time_offset))});
+  }
+};
+
+// Find a float32 field, which must fit into the point
+bool8_t find_field(
+  const sensor_msgs::msg::PointCloud2 & msg, const std::string & name,
+  uint32_t & offset)
+{
+  for (const auto & field : msg.fields) {
+    if (field.name == name) {
+      if ((field.datatype != sensor_msgs::msg::PointField::FLOAT32) ||
+        ((field.offset + sizeof(float32_t)) > msg.point_step))
+      {
+        throw PointCloudFusion::Error::INSERT_FAILED;
+      }
+      offset = field.offset;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Size of a numeric field type, zero for an unknown type
+uint32_t datatype_size(const uint8_t datatype)
+{
+  using sensor_msgs::msg::PointField;
+  switch (datatype) {
+    case PointField::INT8:
+    case PointField::UINT8:
+      return 1U;
+    case PointField::INT16:
+    case PointField::UINT16:
+      return 2U;
+    case PointField::INT32:
+    case PointField::UINT32:
+    case PointField::FLOAT32:
+      return 4U;
+    case PointField::FLOAT64:
+      return 8U;
+    default:
+      return 0U;
+  }
+}
+
+// Find the intensity field, which is converted to float32. An intensity of an unknown type or
+// which does not fit into the point is ignored, the points get an intensity of zero then.
+bool8_t find_intensity_field(const sensor_msgs::msg::PointCloud2 & msg, DeskewInput & input)
+{
+  for (const auto & field : msg.fields) {
+    if (field.name == "intensity") {
+      const auto size = datatype_size(field.datatype);
+      if ((size == 0U) || ((field.offset + size) > msg.point_step)) {
+        return false;
+      }
+      input.intensity_offset = field.offset;
+      input.intensity_datatype = field.datatype;
+      return true;
+    }
+  }
+  return false;
+}
+
+void init_deskew_input(const sensor_msgs::msg::PointCloud2 & msg, DeskewInput & input)
+{
+  input = DeskewInput{};
+  input.data = msg.data.data();
+  input.size = static_cast<std::size_t>(msg.width) * static_cast<std::size_t>(msg.height);
+  input.point_step = msg.point_step;
+  if (msg.data.size() < (input.size * input.point_step)) {
+    throw PointCloudFusion::Error::INSERT_FAILED;
+  }
+  if (!find_field(msg, "x", input.x_offset) || !find_field(msg, "y", input.y_offset) ||
+    !find_field(msg, "z", input.z_offset))
+  {
+    throw PointCloudFusion::Error::INSERT_FAILED;
+  }
+  input.has_intensity = find_intensity_field(msg, input);
+  input.has_time = find_field(msg, "time", input.time_offset);
+  input.is_xyzi = input.has_intensity && !input.has_time &&
+    (input.intensity_datatype == sensor_msgs::msg::PointField::FLOAT32) &&
+    (input.point_step == sizeof(PointXYZI)) && (input.x_offset == 0U) &&
+    (input.y_offset == 4U) && (input.z_offset == 8U) && (input.intensity_offset == 12U);
+  input.stamp = std::chrono::seconds{msg.header.stamp.sec} +
+    std::chrono::nanoseconds{msg.header.stamp.nanosec};
+}
+
+// Update the correction of the input for points measured at the given time
+void update_correction(
+  const std::chrono::nanoseconds stamp, const std::chrono::nanoseconds reference_stamp,
+  const Eigen::Isometry3d & reference_inverse, const EgoMotionBuffer & ego_motion,
+  DeskewInput & input)
+{
+  input.has_correction = true;
+  input.correction_stamp = stamp;
+  input.correction_is_identity = (stamp == reference_stamp);
+  if (input.correction_is_identity) {
+    return;
+  }
+  Eigen::Isometry3d pose;
+  if (!ego_motion.get_pose(stamp, pose)) {
+    throw PointCloudFusion::Error::NO_EGO_MOTION;
+  }
+  // Computed in double precision, as the poses can be far from the origin of the fixed frame
+  const Eigen::Isometry3d correction = reference_inverse * pose;
+  input.correction_rotation = correction.rotation().cast<float32_t>();
+  input.correction_translation = correction.translation().cast<float32_t>();
+}
+}  // namespace
+
 PointCloudFusion::PointCloudFusion(
   uint32_t cloud_capacity,
-  size_t input_topics_size)
+  size_t input_topics_size,
+  std::chrono::nanoseconds deskew_resolution)
 : m_cloud_capacity(cloud_capacity),
-  m_input_topics_size(input_topics_size)
+  m_input_topics_size(input_topics_size),
+  m_deskew_resolution(deskew_resolution)
 {
 }
 
@@ -45,12 +240,130 @@ uint32_t PointCloudFusion::fuse_pc_msgs(
   point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier{cloud_concatenated};
 
   for (size_t i = 0; i < m_input_topics_size; ++i) {
-    concatenate_pointcloud(*msgs[i], pc_concat_idx, modifier);
+    if (msgs[i]) {
+      concatenate_pointcloud(*msgs[i], pc_concat_idx, modifier);
+    }
   }
 
   return pc_concat_idx;
 }
 
+uint32_t PointCloudFusion::fuse_pc_msgs_deskewed(
+  const std::array<PointCloudMsgT::ConstSharedPtr, 8> & msgs,
+  const EgoMotionBuffer & ego_motion,
+  PointCloudMsgT & cloud_concatenated) const
+{
+  const auto num_inputs = std::min(m_input_topics_size, msgs.size());
+  std::array<DeskewInput, 8> inputs;
+  std::size_t total_size = 0U;
+  auto reference_stamp = std::chrono::nanoseconds::min();
+  for (std::size_t i = 0U; i < num_inputs; ++i) {
+    if (msgs[i]) {
+      init_deskew_input(*msgs[i], inputs[i]);
+      total_size += inputs[i].size;
+      reference_stamp = std::max(reference_stamp, inputs[i].stamp);
+    }
+  }
+  if (total_size > m_cloud_capacity) {
+    throw Error::TOO_LARGE;
+  }
+  using autoware::common::types::PointXYZI;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier{cloud_concatenated};
+  if (total_size == 0U) {
+    modifier.resize(0U);
+    return 0U;
+  }
+  Eigen::Isometry3d reference_pose;
+  if (!ego_motion.get_pose(reference_stamp, reference_pose)) {
+    throw Error::NO_EGO_MOTION;
+  }
+  const Eigen::Isometry3d reference_inverse = reference_pose.inverse();
+
+  modifier.resize(total_size);
+  PointXYZI * const output = &modifier[0U];
+
+  std::size_t output_idx = 0U;
+  while (output_idx < total_size) {
+    // The input with the oldest next point, ties go to the input with the lower index
+    std::size_t src = num_inputs;
+    auto src_stamp = std::chrono::nanoseconds::max();
+    for (std::size_t i = 0U; i < num_inputs; ++i) {
+      if (inputs[i].next < inputs[i].size) {
+        const auto stamp = inputs[i].time_of(inputs[i].next);
+        if ((src == num_inputs) || (stamp < src_stamp)) {
+          src = i;
+          src_stamp = stamp;
+        }
+      }
+    }
+    // The run of points of that input ends before the next point of any other input
+    auto end_before = std::chrono::nanoseconds::max();
+    auto end_after = std::chrono::nanoseconds::max();
+    for (std::size_t i = 0U; i < num_inputs; ++i) {
+      if ((i != src) && (inputs[i].next < inputs[i].size)) {
+        auto & end = (i < src) ? end_before : end_after;
+        end = std::min(end, inputs[i].time_of(inputs[i].next));
+      }
+    }
+    auto & input = inputs[src];
+    std::size_t run_end = input.size;
+    if (input.has_time) {
+      run_end = input.next + 1U;
+      while (run_end < input.size) {
+        const auto stamp = input.time_of(run_end);
+        if ((stamp >= end_before) || (stamp > end_after)) {
+          break;
+        }
+        ++run_end;
+      }
+    }
+
+    if (!input.has_time) {
+      // All points of the message share the same correction
+      update_correction(input.stamp, reference_stamp, reference_inverse, ego_motion, input);
+    }
+    if (input.is_xyzi && input.correction_is_identity) {
+      //lint -e{925, 9110} Need to convert pointers and use bit for external API NOLINT
+      (void)std::memcpy(
+        &output[output_idx], &input.data[input.next * input.point_step],
+        (run_end - input.next) * sizeof(PointXYZI));
+      output_idx += run_end - input.next;
+      input.next = run_end;
+      continue;
+    }
+    for (; input.next < run_end; ++input.next) {
+      if (input.has_time) {
+        const auto stamp = input.time_of(input.next);
+        const auto age = (stamp > input.correction_stamp) ?
+          (stamp - input.correction_stamp) : (input.correction_stamp - stamp);
+        if (!input.has_correction || (age > m_deskew_resolution)) {
+          update_correction(stamp, reference_stamp, reference_inverse, ego_motion, input);
+        }
+      }
+      const Eigen::Vector3f pt{
+        input.read(input.next, input.x_offset),
+        input.read(input.next, input.y_offset),
+        input.read(input.next, input.z_offset)};
+      auto & out = output[output_idx];
+      if (input.correction_is_identity) {
+        out.x = pt.x();
+        out.y = pt.y();
+        out.z = pt.z();
+      } else {
+        const Eigen::Vector3f corrected =
+          (input.correction_rotation * pt) + input.correction_translation;
+        out.x = corrected.x();
+        out.y = corrected.y();
+        out.z = corrected.z();
+      }
+      out.intensity = input.has_intensity ? input.intensity_of(input.next) : 0.0F;
+      ++output_idx;
+    }
+  }
+
+  return static_cast<uint32_t>(total_size);
+}
+
 void PointCloudFusion::concatenate_pointcloud(
   const sensor_msgs::msg::PointCloud2 & pc_in,
   uint32_t & concat_idx,
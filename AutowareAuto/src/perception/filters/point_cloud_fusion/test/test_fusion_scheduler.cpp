@@ -0,0 +1,103 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <point_cloud_fusion/fusion_scheduler.hpp>
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+
+using autoware::perception::filters::point_cloud_fusion::FusionScheduler;
+using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+using PointCloud2 = sensor_msgs::msg::PointCloud2;
+using Msgs = std::array<PointCloud2::ConstSharedPtr, FusionScheduler::MAX_INPUTS>;
+
+namespace
+{
+PointCloud2::ConstSharedPtr make_msg(const nanoseconds stamp)
+{
+  auto msg = std::make_shared<PointCloud2>();
+  msg->header.stamp.sec = static_cast<int32_t>(stamp.count() / 1000000000LL);
+  msg->header.stamp.nanosec = static_cast<uint32_t>(stamp.count() % 1000000000LL);
+  return msg;
+}
+}  // namespace
+
+TEST(FusionScheduler, Construction) {
+  EXPECT_THROW(FusionScheduler(0U, 2U, milliseconds{50}), std::domain_error);
+  EXPECT_THROW(FusionScheduler(9U, 2U, milliseconds{50}), std::domain_error);
+  EXPECT_THROW(FusionScheduler(2U, 0U, milliseconds{50}), std::domain_error);
+  FusionScheduler scheduler{2U, 2U, milliseconds{50}};
+  EXPECT_EQ(scheduler.num_inputs(), 2U);
+  EXPECT_THROW(scheduler.push(2U, make_msg(milliseconds{0})), std::out_of_range);
+}
+
+// A source without a message in the window does not hold back the others
+TEST(FusionScheduler, MissingInput) {
+  FusionScheduler scheduler{3U, 4U, milliseconds{50}};
+  const auto first = make_msg(milliseconds{1000});
+  const auto second = make_msg(milliseconds{1020});
+  scheduler.push(0U, first);
+  scheduler.push(1U, second);
+  // Too old for the deadline
+  scheduler.push(2U, make_msg(milliseconds{900}));
+  Msgs msgs;
+  EXPECT_EQ(scheduler.pop(milliseconds{1030}, msgs), 2U);
+  EXPECT_EQ(msgs[0U], first);
+  EXPECT_EQ(msgs[1U], second);
+  for (std::size_t i = 2U; i < msgs.size(); ++i) {
+    EXPECT_EQ(msgs[i], nullptr);
+  }
+  EXPECT_EQ(scheduler.dropped(2U), 1U);
+  EXPECT_EQ(scheduler.staleness(2U, milliseconds{1030}), milliseconds{130});
+  // Nothing is left for the next deadline
+  EXPECT_EQ(scheduler.pop(milliseconds{1130}, msgs), 0U);
+}
+
+// The newest message before the deadline is fused, newer messages wait for the next deadline
+TEST(FusionScheduler, Deadline) {
+  FusionScheduler scheduler{1U, 4U, milliseconds{50}};
+  EXPECT_EQ(scheduler.staleness(0U, milliseconds{0}), nanoseconds::max());
+  scheduler.push(0U, make_msg(milliseconds{1000}));
+  const auto newest = make_msg(milliseconds{1010});
+  scheduler.push(0U, newest);
+  const auto next = make_msg(milliseconds{1060});
+  scheduler.push(0U, next);
+  Msgs msgs;
+  EXPECT_EQ(scheduler.pop(milliseconds{1030}, msgs), 1U);
+  EXPECT_EQ(msgs[0U], newest);
+  EXPECT_EQ(scheduler.dropped(0U), 1U);
+  EXPECT_EQ(scheduler.pop(milliseconds{1100}, msgs), 1U);
+  EXPECT_EQ(msgs[0U], next);
+  EXPECT_EQ(scheduler.staleness(0U, milliseconds{1100}), milliseconds{40});
+}
+
+// The queue of a source never grows beyond its capacity
+TEST(FusionScheduler, Capacity) {
+  FusionScheduler scheduler{1U, 2U, milliseconds{1000}};
+  for (int32_t i = 0; i < 5; ++i) {
+    scheduler.push(0U, make_msg(milliseconds{1000 + i}));
+  }
+  EXPECT_EQ(scheduler.dropped(0U), 3U);
+  Msgs msgs;
+  EXPECT_EQ(scheduler.pop(milliseconds{1003}, msgs), 1U);
+  EXPECT_EQ(msgs[0U]->header.stamp.nanosec, 3000000U);
+  // The message after the deadline is still queued
+  EXPECT_EQ(scheduler.pop(milliseconds{1004}, msgs), 1U);
+  EXPECT_EQ(msgs[0U]->header.stamp.nanosec, 4000000U);
+}
@@ -0,0 +1,317 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <common/types.hpp>
+#include <point_cloud_fusion/ego_motion_buffer.hpp>
+#include <point_cloud_fusion/point_cloud_fusion.hpp>
+#include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using autoware::common::types::PointXYZI;
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using autoware::perception::filters::point_cloud_fusion::EgoMotionBuffer;
+using autoware::perception::filters::point_cloud_fusion::PointCloudFusion;
+using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+using PointCloud2 = sensor_msgs::msg::PointCloud2;
+
+namespace
+{
+Eigen::Isometry3d make_pose(const float64_t x, const float64_t yaw)
+{
+  Eigen::Isometry3d pose{Eigen::AngleAxisd{yaw, Eigen::Vector3d::UnitZ()}};
+  pose.translation() = Eigen::Vector3d{x, 0.0, 0.0};
+  return pose;
+}
+
+float64_t yaw_of(const Eigen::Isometry3d & pose)
+{
+  return std::atan2(pose.rotation()(1, 0), pose.rotation()(0, 0));
+}
+
+void set_stamp(PointCloud2 & msg, const nanoseconds stamp)
+{
+  msg.header.stamp.sec = static_cast<int32_t>(stamp.count() / 1000000000LL);
+  msg.header.stamp.nanosec = static_cast<uint32_t>(stamp.count() % 1000000000LL);
+}
+
+PointCloud2::ConstSharedPtr make_xyzi_cloud(
+  const std::vector<PointXYZI> & points, const nanoseconds stamp)
+{
+  auto msg = std::make_shared<PointCloud2>();
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier{*msg, "base_link"};
+  for (const auto & pt : points) {
+    modifier.push_back(pt);
+  }
+  set_stamp(*msg, stamp);
+  return msg;
+}
+
+// A cloud with a per point time in seconds after the stamp of the message
+PointCloud2::ConstSharedPtr make_timed_cloud(
+  const std::vector<PointXYZI> & points, const std::vector<float32_t> & times,
+  const nanoseconds stamp)
+{
+  auto msg = std::make_shared<PointCloud2>();
+  const std::array<std::string, 5U> names{"x", "y", "z", "intensity", "time"};
+  for (uint32_t i = 0U; i < names.size(); ++i) {
+    sensor_msgs::msg::PointField field;
+    field.name = names[i];
+    field.offset = i * sizeof(float32_t);
+    field.datatype = sensor_msgs::msg::PointField::FLOAT32;
+    field.count = 1U;
+    msg->fields.push_back(field);
+  }
+  msg->point_step = 5U * sizeof(float32_t);
+  msg->height = 1U;
+  msg->width = static_cast<uint32_t>(points.size());
+  msg->row_step = msg->width * msg->point_step;
+  msg->data.resize(msg->row_step);
+  for (std::size_t i = 0U; i < points.size(); ++i) {
+    const std::array<float32_t, 5U> values{
+      points[i].x, points[i].y, points[i].z, points[i].intensity, times[i]};
+    (void)std::memcpy(&msg->data[i * msg->point_step], values.data(), msg->point_step);
+  }
+  set_stamp(*msg, stamp);
+  return msg;
+}
+
+std::vector<PointXYZI> read_cloud(const PointCloud2 & msg)
+{
+  std::vector<PointXYZI> ret(msg.width);
+  (void)std::memcpy(ret.data(), msg.data.data(), ret.size() * sizeof(PointXYZI));
+  return ret;
+}
+}  // namespace
+
+TEST(EgoMotionBuffer, Interpolate) {
+  EgoMotionBuffer buffer{10U, milliseconds{50}};
+  Eigen::Isometry3d pose;
+  EXPECT_FALSE(buffer.get_pose(milliseconds{0}, pose));
+  buffer.push(milliseconds{1000}, make_pose(0.0, 0.0));
+  buffer.push(milliseconds{1100}, make_pose(1.0, 0.2));
+  buffer.push(milliseconds{1200}, make_pose(3.0, 0.2));
+  EXPECT_EQ(buffer.size(), 3U);
+
+  ASSERT_TRUE(buffer.get_pose(milliseconds{1050}, pose));
+  EXPECT_NEAR(pose.translation().x(), 0.5, 1.0e-9);
+  EXPECT_NEAR(yaw_of(pose), 0.1, 1.0e-9);
+  ASSERT_TRUE(buffer.get_pose(milliseconds{1150}, pose));
+  EXPECT_NEAR(pose.translation().x(), 2.0, 1.0e-9);
+  EXPECT_NEAR(yaw_of(pose), 0.2, 1.0e-9);
+  ASSERT_TRUE(buffer.get_pose(milliseconds{1000}, pose));
+  EXPECT_NEAR(pose.translation().x(), 0.0, 1.0e-9);
+  ASSERT_TRUE(buffer.get_pose(milliseconds{1200}, pose));
+  EXPECT_NEAR(pose.translation().x(), 3.0, 1.0e-9);
+
+  // Before the oldest pose
+  EXPECT_FALSE(buffer.get_pose(milliseconds{999}, pose));
+}
+
+TEST(EgoMotionBuffer, Extrapolate) {
+  EgoMotionBuffer buffer{10U, milliseconds{50}};
+  Eigen::Isometry3d pose;
+  buffer.push(milliseconds{1000}, make_pose(0.0, 0.0));
+  // A single pose can not be extrapolated
+  EXPECT_FALSE(buffer.get_pose(milliseconds{1010}, pose));
+  buffer.push(milliseconds{1100}, make_pose(1.0, 0.2));
+  ASSERT_TRUE(buffer.get_pose(milliseconds{1150}, pose));
+  EXPECT_NEAR(pose.translation().x(), 1.5, 1.0e-9);
+  EXPECT_NEAR(yaw_of(pose), 0.3, 1.0e-9);
+  EXPECT_FALSE(buffer.get_pose(milliseconds{1151}, pose));
+}
+
+TEST(EgoMotionBuffer, History) {
+  EXPECT_THROW(EgoMotionBuffer(1U, milliseconds{50}), std::domain_error);
+  EgoMotionBuffer buffer{3U, milliseconds{0}};
+  Eigen::Isometry3d pose;
+  for (int32_t i = 0; i < 5; ++i) {
+    buffer.push(milliseconds{100 * i}, make_pose(static_cast<float64_t>(i), 0.0));
+  }
+  // The oldest poses are dropped
+  EXPECT_EQ(buffer.size(), 3U);
+  EXPECT_FALSE(buffer.get_pose(milliseconds{150}, pose));
+  ASSERT_TRUE(buffer.get_pose(milliseconds{250}, pose));
+  EXPECT_NEAR(pose.translation().x(), 2.5, 1.0e-9);
+  // Time jumped back
+  buffer.push(milliseconds{0}, make_pose(0.0, 0.0));
+  EXPECT_EQ(buffer.size(), 1U);
+  buffer.clear();
+  EXPECT_EQ(buffer.size(), 0U);
+}
+
+// Without motion, clouds of the same stamp are fused the same as without deskewing
+TEST(PointCloudFusion, DeskewedWithoutMotion) {
+  const nanoseconds stamp{milliseconds{1000}};
+  std::array<PointCloud2::ConstSharedPtr, 8> msgs;
+  msgs[0U] = make_xyzi_cloud({{1.0F, 2.0F, 3.0F, 4.0F}, {5.0F, 6.0F, 7.0F, 8.0F}}, stamp);
+  msgs[1U] = make_xyzi_cloud({{9.0F, 10.0F, 11.0F, 12.0F}}, stamp);
+  EgoMotionBuffer ego_motion{10U, milliseconds{0}};
+  ego_motion.push(stamp, make_pose(10.0, 0.5));
+
+  PointCloudFusion fusion{10U, 2U};
+  PointCloud2 expected;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>{expected, "base_link"};
+  EXPECT_EQ(fusion.fuse_pc_msgs(msgs, expected), 3U);
+  PointCloud2 fused;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>{fused, "base_link"};
+  EXPECT_EQ(fusion.fuse_pc_msgs_deskewed(msgs, ego_motion, fused), 3U);
+  EXPECT_EQ(fused.width, 3U);
+  EXPECT_EQ(fused.data, expected.data);
+}
+
+// Null messages, e.g. of sources which missed the deadline, are skipped
+TEST(PointCloudFusion, MissingMessages) {
+  const nanoseconds stamp{milliseconds{1000}};
+  std::array<PointCloud2::ConstSharedPtr, 8> msgs;
+  msgs[1U] = make_xyzi_cloud({{9.0F, 10.0F, 11.0F, 12.0F}}, stamp);
+  EgoMotionBuffer ego_motion{10U, milliseconds{0}};
+  ego_motion.push(stamp, make_pose(0.0, 0.0));
+
+  PointCloudFusion fusion{10U, 3U};
+  PointCloud2 fused;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>{fused, "base_link"};
+  EXPECT_EQ(fusion.fuse_pc_msgs(msgs, fused), 1U);
+  EXPECT_EQ(fusion.fuse_pc_msgs_deskewed(msgs, ego_motion, fused), 1U);
+  EXPECT_FLOAT_EQ(read_cloud(fused)[0U].intensity, 12.0F);
+  msgs[1U] = nullptr;
+  EXPECT_EQ(fusion.fuse_pc_msgs_deskewed(msgs, ego_motion, fused), 0U);
+}
+
+// Points of all clouds are merged in the order in which they were measured
+TEST(PointCloudFusion, DeskewedTimeOrder) {
+  const nanoseconds stamp{milliseconds{1000}};
+  std::array<PointCloud2::ConstSharedPtr, 8> msgs;
+  msgs[0U] = make_timed_cloud(
+    {{0.0F, 0.0F, 0.0F, 0.0F}, {0.0F, 0.0F, 0.0F, 2.0F}, {0.0F, 0.0F, 0.0F, 4.0F},
+      {0.0F, 0.0F, 0.0F, 5.0F}},
+    {0.0F, 0.02F, 0.04F, 0.05F}, stamp);
+  msgs[1U] = make_timed_cloud(
+    {{0.0F, 0.0F, 0.0F, 1.0F}, {0.0F, 0.0F, 0.0F, 3.0F}, {0.0F, 0.0F, 0.0F, 6.0F}},
+    {0.01F, 0.03F, 0.05F}, stamp);
+  // No time field, all points were measured at the stamp
+  msgs[2U] = make_xyzi_cloud({{0.0F, 0.0F, 0.0F, 7.0F}}, stamp + milliseconds{60});
+  EgoMotionBuffer ego_motion{10U, milliseconds{0}};
+  ego_motion.push(stamp, make_pose(0.0, 0.0));
+  ego_motion.push(stamp + milliseconds{100}, make_pose(0.0, 0.0));
+
+  PointCloudFusion fusion{10U, 3U};
+  PointCloud2 fused;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>{fused, "base_link"};
+  EXPECT_EQ(fusion.fuse_pc_msgs_deskewed(msgs, ego_motion, fused), 8U);
+  const auto points = read_cloud(fused);
+  ASSERT_EQ(points.size(), 8U);
+  for (std::size_t i = 0U; i < points.size(); ++i) {
+    EXPECT_FLOAT_EQ(points[i].intensity, static_cast<float32_t>(i));
+  }
+}
+
+// Points are moved to where they would have been measured at the latest stamp
+TEST(PointCloudFusion, DeskewedMotion) {
+  const nanoseconds stamp{milliseconds{1000}};
+  std::array<PointCloud2::ConstSharedPtr, 8> msgs;
+  msgs[0U] = make_timed_cloud(
+    {{10.0F, 0.0F, 0.0F, 1.0F}, {10.0F, 0.0F, 0.0F, 2.0F}}, {0.0F, 0.05F}, stamp);
+  msgs[1U] = make_xyzi_cloud({{10.0F, 0.0F, 0.0F, 3.0F}}, stamp + milliseconds{100});
+  // Driving straight at 10 m/s
+  EgoMotionBuffer ego_motion{10U, milliseconds{0}};
+  ego_motion.push(stamp, make_pose(0.0, 0.0));
+  ego_motion.push(stamp + milliseconds{100}, make_pose(1.0, 0.0));
+
+  PointCloudFusion fusion{10U, 2U};
+  PointCloud2 fused;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>{fused, "base_link"};
+  EXPECT_EQ(fusion.fuse_pc_msgs_deskewed(msgs, ego_motion, fused), 3U);
+  const auto points = read_cloud(fused);
+  ASSERT_EQ(points.size(), 3U);
+  EXPECT_NEAR(points[0U].x, 9.0F, 1.0e-5F);
+  EXPECT_NEAR(points[1U].x, 9.5F, 1.0e-5F);
+  EXPECT_FLOAT_EQ(points[2U].x, 10.0F);
+  for (const auto & pt : points) {
+    EXPECT_NEAR(pt.y, 0.0F, 1.0e-5F);
+    EXPECT_NEAR(pt.z, 0.0F, 1.0e-5F);
+  }
+}
+
+// An intensity of another type than float32 is converted instead of dropping the message
+TEST(PointCloudFusion, DeskewedIntensityTypes) {
+  const nanoseconds stamp{milliseconds{1000}};
+  auto msg = std::make_shared<PointCloud2>(
+    *make_timed_cloud({{1.0F, 2.0F, 3.0F, 0.0F}, {5.0F, 6.0F, 7.0F, 0.0F}}, {0.0F, 0.0F}, stamp));
+  // Store a uint8 intensity in the first byte of the float32 intensity
+  msg->fields[3U].datatype = sensor_msgs::msg::PointField::UINT8;
+  msg->data[3U * sizeof(float32_t)] = 42U;
+  msg->data[msg->point_step + (3U * sizeof(float32_t))] = 255U;
+  std::array<PointCloud2::ConstSharedPtr, 8> msgs;
+  msgs[0U] = msg;
+  EgoMotionBuffer ego_motion{10U, milliseconds{0}};
+  ego_motion.push(stamp, make_pose(0.0, 0.0));
+
+  PointCloudFusion fusion{10U, 1U};
+  PointCloud2 fused;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>{fused, "base_link"};
+  ASSERT_EQ(fusion.fuse_pc_msgs_deskewed(msgs, ego_motion, fused), 2U);
+  auto points = read_cloud(fused);
+  EXPECT_FLOAT_EQ(points[0U].x, 1.0F);
+  EXPECT_FLOAT_EQ(points[0U].intensity, 42.0F);
+  EXPECT_FLOAT_EQ(points[1U].x, 5.0F);
+  EXPECT_FLOAT_EQ(points[1U].intensity, 255.0F);
+
+  // An intensity of an unknown type is ignored
+  msg->fields[3U].datatype = 0U;
+  ASSERT_EQ(fusion.fuse_pc_msgs_deskewed(msgs, ego_motion, fused), 2U);
+  points = read_cloud(fused);
+  EXPECT_FLOAT_EQ(points[1U].z, 7.0F);
+  EXPECT_FLOAT_EQ(points[1U].intensity, 0.0F);
+}
+
+TEST(PointCloudFusion, DeskewedErrors) {
+  const nanoseconds stamp{milliseconds{1000}};
+  std::array<PointCloud2::ConstSharedPtr, 8> msgs;
+  msgs[0U] = make_xyzi_cloud({{1.0F, 2.0F, 3.0F, 4.0F}, {5.0F, 6.0F, 7.0F, 8.0F}}, stamp);
+  EgoMotionBuffer ego_motion{10U, milliseconds{0}};
+  PointCloud2 fused;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>{fused, "base_link"};
+
+  PointCloudFusion small_fusion{1U, 1U};
+  EXPECT_THROW(
+    small_fusion.fuse_pc_msgs_deskewed(msgs, ego_motion, fused), PointCloudFusion::Error);
+  PointCloudFusion fusion{10U, 1U};
+  try {
+    fusion.fuse_pc_msgs_deskewed(msgs, ego_motion, fused);
+    FAIL() << "No ego motion";
+  } catch (const PointCloudFusion::Error error) {
+    EXPECT_EQ(error, PointCloudFusion::Error::NO_EGO_MOTION);
+  }
+  ego_motion.push(stamp, make_pose(0.0, 0.0));
+  auto no_xyz = std::make_shared<PointCloud2>(*msgs[0U]);
+  no_xyz->fields.clear();
+  msgs[0U] = no_xyz;
+  try {
+    fusion.fuse_pc_msgs_deskewed(msgs, ego_motion, fused);
+    FAIL() << "No xyz fields";
+  } catch (const PointCloudFusion::Error error) {
+    EXPECT_EQ(error, PointCloudFusion::Error::INSERT_FAILED);
+  }
+}
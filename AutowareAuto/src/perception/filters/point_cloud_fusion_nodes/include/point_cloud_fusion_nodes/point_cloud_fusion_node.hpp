@@ -20,10 +20,13 @@
 #include <message_filters/subscriber.h>
 #include <message_filters/sync_policies/approximate_time.h>
 #include <message_filters/synchronizer.h>
+#include <nav_msgs/msg/odometry.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <lidar_utils/point_cloud_utils.hpp>
 #include <tf2_ros/transform_listener.h>
 #include <rclcpp/rclcpp.hpp>
+#include <point_cloud_fusion/ego_motion_buffer.hpp>
+#include <point_cloud_fusion/fusion_scheduler.hpp>
 #include <point_cloud_fusion/point_cloud_fusion.hpp>
 #include <point_cloud_fusion_nodes/visibility_control.hpp>
 #include <common/types.hpp>
@@ -69,6 +72,14 @@ private:
     const PointCloudMsgT::ConstSharedPtr & msg5, const PointCloudMsgT::ConstSharedPtr & msg6,
     const PointCloudMsgT::ConstSharedPtr & msg7, const PointCloudMsgT::ConstSharedPtr & msg8);
 
+  void odometry_callback(const nav_msgs::msg::Odometry::ConstSharedPtr msg);
+
+  /// \brief Fuse whatever messages arrived inside the window before the deadline, and report
+  ///        stale inputs
+  void scheduler_callback();
+
+  void fuse_and_publish(const std::array<PointCloudMsgT::ConstSharedPtr, 8> & msgs);
+
   std::unique_ptr<point_cloud_fusion::PointCloudFusion> m_core;
   PointCloudT m_cloud_concatenated;
   std::unique_ptr<message_filters::Subscriber<PointCloudMsgT>> m_cloud_subscribers[8];
@@ -78,6 +89,21 @@ private:
   std::vector<std::string> m_input_topics;
   std::string m_output_frame_id;
   uint32_t m_cloud_capacity;
+  // Publish the fused points as a std::unique_ptr, so that they are not copied when intra-process
+  // communication is used
+  bool8_t m_publish_unique_ptr;
+  // Compensate the ego motion while the points were measured, using the odometry of the vehicle
+  bool8_t m_deskew_enabled;
+  std::unique_ptr<point_cloud_fusion::EgoMotionBuffer> m_ego_motion;
+  rclcpp::Subscription<nav_msgs::msg::Odometry>::SharedPtr m_odometry_subscriber;
+  // Fuse on a fixed cadence instead of waiting for a message of every input
+  bool8_t m_scheduler_enabled;
+  std::unique_ptr<point_cloud_fusion::FusionScheduler> m_scheduler;
+  std::vector<rclcpp::Subscription<PointCloudMsgT>::SharedPtr> m_scheduler_subscribers;
+  rclcpp::TimerBase::SharedPtr m_scheduler_timer;
+  std::chrono::nanoseconds m_scheduler_window;
+  // How long after its stamp a message is expected to arrive
+  std::chrono::nanoseconds m_scheduler_latency;
 };
 }  // namespace point_cloud_fusion_nodes
 }  // namespace filters
@@ -22,11 +22,13 @@
 
 #include <algorithm>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 using autoware::common::types::bool8_t;
 using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
 
 namespace autoware
 {
@@ -43,7 +45,12 @@ PointCloudFusionNode::PointCloudFusionNode(
   m_cloud_publisher(create_publisher<PointCloudMsgT>("output_topic", rclcpp::QoS(10))),
   m_input_topics(static_cast<std::size_t>(declare_parameter("number_of_sources").get<int>())),
   m_output_frame_id(declare_parameter("output_frame_id").get<std::string>()),
-  m_cloud_capacity(static_cast<uint32_t>(declare_parameter("cloud_size").get<int>()))
+  m_cloud_capacity(static_cast<uint32_t>(declare_parameter("cloud_size").get<int>())),
+  m_publish_unique_ptr(node_options.use_intra_process_comms()),
+  m_deskew_enabled(declare_parameter("deskew.enabled", false)),
+  m_scheduler_enabled(declare_parameter("scheduler.enabled", false)),
+  m_scheduler_window(std::chrono::milliseconds{declare_parameter("scheduler.window_ms", 100)}),
+  m_scheduler_latency(std::chrono::milliseconds{declare_parameter("scheduler.latency_ms", 100)})
 {
   for (size_t i = 0; i < m_input_topics.size(); ++i) {
     m_input_topics[i] = "input_topic" + std::to_string(i + 1);
@@ -53,9 +60,32 @@ PointCloudFusionNode::PointCloudFusionNode(
 
 void PointCloudFusionNode::init()
 {
+  const std::chrono::microseconds deskew_resolution{
+    declare_parameter("deskew.resolution_us", 100)};
+  if (deskew_resolution < std::chrono::microseconds::zero()) {
+    throw std::domain_error("PointCloudFusionNode: resolution_us must not be negative");
+  }
   m_core = std::make_unique<point_cloud_fusion::PointCloudFusion>(
     m_cloud_capacity,
-    m_input_topics.size());
+    m_input_topics.size(),
+    deskew_resolution);
+
+  if (m_deskew_enabled) {
+    const auto history_size = declare_parameter("deskew.odometry_history_size", 100);
+    if (history_size < 0) {
+      throw std::domain_error("PointCloudFusionNode: odometry_history_size must not be negative");
+    }
+    const std::chrono::milliseconds max_extrapolation{
+      declare_parameter("deskew.max_extrapolation_ms", 50)};
+    if (max_extrapolation < std::chrono::milliseconds::zero()) {
+      throw std::domain_error("PointCloudFusionNode: max_extrapolation_ms must not be negative");
+    }
+    m_ego_motion = std::make_unique<point_cloud_fusion::EgoMotionBuffer>(
+      static_cast<std::size_t>(history_size), max_extrapolation);
+    m_odometry_subscriber = create_subscription<nav_msgs::msg::Odometry>(
+      "odometry", rclcpp::QoS{100},
+      std::bind(&PointCloudFusionNode::odometry_callback, this, std::placeholders::_1));
+  }
 
   using autoware::common::types::PointXYZI;
   point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>{
@@ -67,6 +97,35 @@ void PointCloudFusionNode::init()
             " Found: " + std::to_string(m_input_topics.size()));
   }
 
+  if (m_scheduler_enabled) {
+    const auto queue_size_param = declare_parameter("scheduler.queue_size", 2);
+    if (queue_size_param < 0) {
+      throw std::domain_error("PointCloudFusionNode: queue_size must not be negative");
+    }
+    if (m_scheduler_latency < std::chrono::nanoseconds::zero()) {
+      throw std::domain_error("PointCloudFusionNode: latency_ms must not be negative");
+    }
+    if (m_scheduler_window <= std::chrono::nanoseconds::zero()) {
+      throw std::domain_error("PointCloudFusionNode: window_ms must be positive");
+    }
+    const auto queue_size = static_cast<std::size_t>(queue_size_param);
+    const std::chrono::milliseconds period{declare_parameter("scheduler.period_ms", 100)};
+    if (period <= std::chrono::milliseconds::zero()) {
+      throw std::domain_error("PointCloudFusionNode: period_ms must be positive");
+    }
+    m_scheduler = std::make_unique<point_cloud_fusion::FusionScheduler>(
+      m_input_topics.size(), queue_size, m_scheduler_window);
+    for (size_t i = 0; i < m_input_topics.size(); ++i) {
+      m_scheduler_subscribers.push_back(
+        create_subscription<PointCloudMsgT>(
+          m_input_topics[i], rclcpp::QoS{queue_size},
+          [this, i](const PointCloudMsgT::ConstSharedPtr msg) {m_scheduler->push(i, msg);}));
+    }
+    m_scheduler_timer = create_wall_timer(
+      period, std::bind(&PointCloudFusionNode::scheduler_callback, this));
+    return;
+  }
+
   for (size_t i = 0; i < 8; ++i) {
     if (i < m_input_topics.size()) {
       m_cloud_subscribers[i] = std::make_unique<message_filters::Subscriber<PointCloudMsgT>>(
@@ -100,20 +159,57 @@ PointCloudFusionNode::pointcloud_callback(
   const PointCloudMsgT::ConstSharedPtr & msg5, const PointCloudMsgT::ConstSharedPtr & msg6,
   const PointCloudMsgT::ConstSharedPtr & msg7, const PointCloudMsgT::ConstSharedPtr & msg8)
 {
-  std::array<PointCloudMsgT::ConstSharedPtr, 8> msgs{msg1, msg2, msg3, msg4, msg5, msg6, msg7,
-    msg8};
+  const std::array<PointCloudMsgT::ConstSharedPtr, 8> msgs{msg1, msg2, msg3, msg4, msg5, msg6,
+    msg7, msg8};
+  fuse_and_publish(msgs);
+}
+
+void PointCloudFusionNode::scheduler_callback()
+{
+  // Messages are stamped when their measurement started, and arrive some time after that
+  const auto deadline = std::chrono::nanoseconds{now().nanoseconds()} - m_scheduler_latency;
+  for (size_t i = 0; i < m_input_topics.size(); ++i) {
+    const auto staleness = m_scheduler->staleness(i, deadline);
+    if (staleness > m_scheduler_window) {
+      if (staleness == std::chrono::nanoseconds::max()) {
+        RCLCPP_WARN_THROTTLE(
+          get_logger(), *get_clock(), 1000 /*ms*/, "No pointcloud received on %s yet.",
+          m_input_topics[i].c_str());
+      } else {
+        RCLCPP_WARN_THROTTLE(
+          get_logger(), *get_clock(), 1000 /*ms*/,
+          "Pointclouds on %s are %.1f ms stale, %zu pointclouds were dropped.",
+          m_input_topics[i].c_str(),
+          std::chrono::duration<float64_t, std::milli>(staleness).count(),
+          m_scheduler->dropped(i));
+      }
+    }
+  }
+
+  std::array<PointCloudMsgT::ConstSharedPtr, 8> msgs;
+  if (m_scheduler->pop(deadline, msgs) > 0U) {
+    fuse_and_publish(msgs);
+  }
+}
 
+void PointCloudFusionNode::fuse_and_publish(
+  const std::array<PointCloudMsgT::ConstSharedPtr, 8> & msgs)
+{
   // reset pointcloud before using
   using autoware::common::types::PointXYZI;
   point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier{m_cloud_concatenated};
   modifier.clear();
   modifier.reserve(m_cloud_capacity);
 
-  auto latest_stamp = msgs[0]->header.stamp;
+  builtin_interfaces::msg::Time latest_stamp;
   auto total_size = 0U;
 
-  // Get the latest time stamp of the point clouds and find the total size after concatenation
+  // Get the latest time stamp of the point clouds and find the total size after concatenation.
+  // Inputs which missed the deadline of the scheduler have no message.
   for (uint32_t msg_idx = 0; msg_idx < m_input_topics.size(); ++msg_idx) {
+    if (!msgs[msg_idx]) {
+      continue;
+    }
     const auto & stamp = msgs[msg_idx]->header.stamp;
     if (convert_msg_time(stamp) > convert_msg_time(latest_stamp)) {
       latest_stamp = stamp;
@@ -130,12 +226,18 @@ PointCloudFusionNode::pointcloud_callback(
   // Go through all the messages and fuse them.
   uint32_t fused_cloud_size = 0;
   try {
-    fused_cloud_size = m_core->fuse_pc_msgs(msgs, m_cloud_concatenated);
+    if (m_deskew_enabled) {
+      fused_cloud_size = m_core->fuse_pc_msgs_deskewed(msgs, *m_ego_motion, m_cloud_concatenated);
+    } else {
+      fused_cloud_size = m_core->fuse_pc_msgs(msgs, m_cloud_concatenated);
+    }
   } catch (point_cloud_fusion::PointCloudFusion::Error fuse_error) {
     if (fuse_error == point_cloud_fusion::PointCloudFusion::Error::TOO_LARGE) {
       RCLCPP_WARN(get_logger(), "Pointcloud is too large to be fused and will be ignored.");
     } else if (fuse_error == point_cloud_fusion::PointCloudFusion::Error::INSERT_FAILED) {
       RCLCPP_ERROR(get_logger(), "Points could not be added correctly to the fused cloud.");
+    } else if (fuse_error == point_cloud_fusion::PointCloudFusion::Error::NO_EGO_MOTION) {
+      RCLCPP_WARN(get_logger(), "No odometry for the time of the pointclouds, dropping them.");
     } else {
       RCLCPP_ERROR(get_logger(), "Unknown error.");
     }
@@ -146,9 +248,25 @@ PointCloudFusionNode::pointcloud_callback(
     modifier.resize(fused_cloud_size);
 
     m_cloud_concatenated.header.stamp = latest_stamp;
-    m_cloud_publisher->publish(m_cloud_concatenated);
+    if (m_publish_unique_ptr) {
+      // The capacity is allocated again by the next callback
+      m_cloud_publisher->publish(
+        autoware::common::lidar_utils::take_point_cloud(m_cloud_concatenated));
+    } else {
+      m_cloud_publisher->publish(m_cloud_concatenated);
+    }
   }
 }
+
+void PointCloudFusionNode::odometry_callback(const nav_msgs::msg::Odometry::ConstSharedPtr msg)
+{
+  const auto & pose = msg->pose.pose;
+  const Eigen::Isometry3d ego_pose{
+    Eigen::Translation3d{pose.position.x, pose.position.y, pose.position.z} *
+    Eigen::Quaterniond{pose.orientation.w, pose.orientation.x, pose.orientation.y,
+      pose.orientation.z}};
+  m_ego_motion->push(convert_msg_time(msg->header.stamp), ego_pose);
+}
 }  // namespace point_cloud_fusion_nodes
 }  // namespace filters
 }  // namespace perception
@@ -203,4 +203,120 @@ TEST_F(TestPCF, TestBasicFusion) {
   EXPECT_TRUE(test_completed);
 }
 
+// The scheduler fuses the inputs which arrived in time, without waiting for the others
+TEST_F(TestPCF, TestSchedulerMissingInput) {
+  std::vector<rclcpp::Parameter> params;
+  params.emplace_back("number_of_sources", 2);
+  params.emplace_back("output_frame_id", "base_link");
+  params.emplace_back("cloud_size", static_cast<int64_t>(55000U));
+  params.emplace_back("scheduler.enabled", true);
+  params.emplace_back("scheduler.period_ms", 50);
+  params.emplace_back("scheduler.window_ms", 1000);
+
+  rclcpp::NodeOptions node_options;
+  node_options.parameter_overrides(params);
+
+  auto pcf_node =
+    std::make_shared<autoware::perception::filters::point_cloud_fusion_nodes::PointCloudFusionNode>(
+    node_options);
+
+  bool8_t test_completed = false;
+  const auto t0 = to_msg_time(std::chrono::system_clock::now());
+  auto pc1 = make_pc({1, 2, 3}, t0);
+  auto expected_result = make_pc({1, 2, 3}, t0);
+
+  auto pub_ptr1 = pcf_node->create_publisher<sensor_msgs::msg::PointCloud2>(
+    "input_topic1",
+    rclcpp::QoS(10));
+
+  auto handle_concat =
+    [&expected_result, &test_completed](const sensor_msgs::msg::PointCloud2::SharedPtr msg)
+    -> void {
+      check_pcl_eq(*msg, expected_result);
+      test_completed = true;
+    };
+
+  auto sub_ptr = pcf_node->create_subscription<sensor_msgs::msg::PointCloud2>(
+    "output_topic",
+    rclcpp::QoS(10), handle_concat);
+
+  pub_ptr1->publish(pc1);
+
+  auto start_time = std::chrono::system_clock::now();
+  auto max_test_dur = std::chrono::seconds(1);
+  auto timed_out = false;
+
+  while (rclcpp::ok() && !test_completed) {
+    rclcpp::spin_some(pcf_node);
+    rclcpp::sleep_for(std::chrono::milliseconds(10));
+    if (std::chrono::system_clock::now() - start_time > max_test_dur) {
+      timed_out = true;
+      break;
+    }
+  }
+  EXPECT_FALSE(timed_out);
+  EXPECT_TRUE(test_completed);
+}
+
+// Lidar drivers stamp a point cloud with the start of its scan, and publish it when the scan is
+// complete. With the default window and latency such a point cloud is still fused.
+TEST_F(TestPCF, TestSchedulerScanStartStamp) {
+  std::vector<rclcpp::Parameter> params;
+  params.emplace_back("number_of_sources", 2);
+  params.emplace_back("output_frame_id", "base_link");
+  params.emplace_back("cloud_size", static_cast<int64_t>(55000U));
+  params.emplace_back("scheduler.enabled", true);
+  params.emplace_back("scheduler.period_ms", 50);
+
+  rclcpp::NodeOptions node_options;
+  node_options.parameter_overrides(params);
+
+  auto pcf_node =
+    std::make_shared<autoware::perception::filters::point_cloud_fusion_nodes::PointCloudFusionNode>(
+    node_options);
+
+  bool8_t test_completed = false;
+  const auto scan_period = std::chrono::milliseconds(100);
+  const auto t0 = to_msg_time(std::chrono::system_clock::now() - scan_period);
+  auto pc1 = make_pc({1, 2, 3}, t0);
+  auto pc2 = make_pc({4, 5, 6}, t0);
+  auto expected_result = make_pc({1, 2, 3, 4, 5, 6}, t0);
+
+  auto pub_ptr1 = pcf_node->create_publisher<sensor_msgs::msg::PointCloud2>(
+    "input_topic1",
+    rclcpp::QoS(10));
+  auto pub_ptr2 = pcf_node->create_publisher<sensor_msgs::msg::PointCloud2>(
+    "input_topic2",
+    rclcpp::QoS(10));
+
+  auto handle_concat =
+    [&expected_result, &test_completed](const sensor_msgs::msg::PointCloud2::SharedPtr msg)
+    -> void {
+      check_pcl_eq(*msg, expected_result);
+      test_completed = true;
+    };
+
+  auto sub_ptr = pcf_node->create_subscription<sensor_msgs::msg::PointCloud2>(
+    "output_topic",
+    rclcpp::QoS(10), handle_concat);
+
+  pub_ptr1->publish(pc1);
+  pub_ptr2->publish(pc2);
+
+  auto start_time = std::chrono::system_clock::now();
+  auto max_test_dur = std::chrono::seconds(1);
+  auto timed_out = false;
+
+  while (rclcpp::ok() && !test_completed) {
+    rclcpp::spin_some(pcf_node);
+    rclcpp::sleep_for(std::chrono::milliseconds(10));
+    if (std::chrono::system_clock::now() - start_time > max_test_dur) {
+      timed_out = true;
+      break;
+    }
+  }
+  EXPECT_FALSE(timed_out);
+  EXPECT_TRUE(test_completed);
+}
+
 #endif  // TEST_POINT_CLOUD_FUSION_NODES_HPP_
@@ -0,0 +1,107 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+/// \copyright Copyright 2021 The Autoware Foundation
+/// \file
+/// \brief This file defines the PolygonEdgeTable class.
+
+#ifndef POLYGON_REMOVER__POLYGON_EDGE_TABLE_HPP_
+#define POLYGON_REMOVER__POLYGON_EDGE_TABLE_HPP_
+
+#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
+#include <polygon_remover/visibility_control.hpp>
+#include <common/types.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace polygon_remover
+{
+
+/// \brief Precomputed edges of a polygon, which classify batches of points as outside of the
+/// polygon or not with plain float loops the compiler can vectorize. Points close to an edge are
+/// classified with the exact predicates of CGAL, so the result is the same as
+/// CGAL::bounded_side_2(...) != CGAL::ON_UNBOUNDED_SIDE.
+class POLYGON_REMOVER_PUBLIC PolygonEdgeTable
+{
+public:
+  using K = CGAL::Exact_predicates_inexact_constructions_kernel;
+  using PointCgal = K::Point_2;
+  using PointXYZI = common::types::PointXYZI;
+  using float32_t = common::types::float32_t;
+  using float64_t = common::types::float64_t;
+  using bool8_t = common::types::bool8_t;
+
+  /// \brief Number of points whose edge crossings are counted at once
+  static constexpr std::size_t BATCH_SIZE = 64U;
+  /// \brief Default distance to an edge, in meters, below which a point is classified exactly
+  static constexpr float32_t DEFAULT_BOUNDARY_EPSILON = 1.0e-3F;
+
+  /// \brief Build the edge table of a polygon
+  /// \param polygon Vertices of the polygon, the last vertex connects to the first one
+  /// \param boundary_epsilon Points closer than this to an edge are classified exactly
+  /// \throw std::length_error if the polygon has less than 3 vertices
+  explicit PolygonEdgeTable(
+    const std::vector<PointCgal> & polygon,
+    float32_t boundary_epsilon = DEFAULT_BOUNDARY_EPSILON);
+
+  /// \brief Check for each point whether it is outside of the polygon
+  /// \param points Points to classify, only x and y are used
+  /// \param count Number of points
+  /// \param is_outside Gets set to 1 for each point which is outside of the polygon, and to 0 for
+  ///                   each point inside or on the polygon. Has to hold count entries.
+  /// \return Number of points which were classified with the exact predicates
+  std::size_t classify(const PointXYZI * points, std::size_t count, uint8_t * is_outside) const;
+
+private:
+  /// \brief Count the edge crossings of a batch of points in the bounding box
+  /// \return Number of points which were classified with the exact predicates
+  std::size_t classify_batch(
+    const PointXYZI * points, const uint32_t * indices, std::size_t count,
+    uint8_t * is_outside) const;
+
+  std::vector<PointCgal> m_polygon;
+  // Coordinates are relative to the center of the bounding box, so that floats are precise
+  float64_t m_origin_x;
+  float64_t m_origin_y;
+  // Bounding box grown by the boundary epsilon
+  float32_t m_min_x;
+  float32_t m_max_x;
+  float32_t m_min_y;
+  float32_t m_max_y;
+  float32_t m_epsilon2;
+  // One entry per edge from (x, y) to (x + dx, y + dy)
+  std::vector<float32_t> m_x;
+  std::vector<float32_t> m_y;
+  std::vector<float32_t> m_dx;
+  std::vector<float32_t> m_dy;
+  // dx / dy, 0 for horizontal edges
+  std::vector<float32_t> m_dx_per_dy;
+  // 1 / (dx * dx + dy * dy), 0 for edges of zero length
+  std::vector<float32_t> m_inv_length2;
+};
+
+}  // namespace polygon_remover
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // POLYGON_REMOVER__POLYGON_EDGE_TABLE_HPP_
@@ -21,6 +21,7 @@
 
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 #include <CGAL/Polygon_2_algorithms.h>
+#include <polygon_remover/polygon_edge_table.hpp>
 #include <polygon_remover/visibility_control.hpp>
 #include <common/types.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
@@ -86,6 +87,8 @@ public:
   void update_polygon(const Polygon::ConstSharedPtr & polygon_in);
 
   /// \brief Removes the stored polygon from the point cloud and returns the filtered point cloud.
+  /// Points are classified in batches with the edge table of the polygon built by
+  /// update_polygon, only points close to an edge are classified with CGAL.
   /// \param cloud_in Input Point Cloud Shared Pointer
   /// \return Filtered Point Cloud Shared Pointer
   PointCloud2::SharedPtr remove_updated_polygon_from_cloud(
@@ -105,6 +108,8 @@ private:
   bool8_t polygon_is_initialized_;
   bool8_t will_visualize_;
   std::vector<PointCgal> polygon_cgal_;
+  std::unique_ptr<PolygonEdgeTable> polygon_edge_table_;
+  std::vector<uint8_t> point_is_outside_;
   Marker marker_;
 };
 
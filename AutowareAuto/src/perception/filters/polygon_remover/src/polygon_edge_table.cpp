@@ -0,0 +1,184 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <CGAL/Polygon_2_algorithms.h>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "polygon_remover/polygon_edge_table.hpp"
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace polygon_remover
+{
+
+constexpr std::size_t PolygonEdgeTable::BATCH_SIZE;
+constexpr PolygonEdgeTable::float32_t PolygonEdgeTable::DEFAULT_BOUNDARY_EPSILON;
+
+PolygonEdgeTable::PolygonEdgeTable(
+  const std::vector<PointCgal> & polygon,
+  float32_t boundary_epsilon)
+: m_polygon{polygon}
+{
+  if (polygon.size() < 3U) {
+    throw std::length_error("Polygon vertex count should be larger than 2.");
+  }
+  float64_t min_x = std::numeric_limits<float64_t>::max();
+  float64_t max_x = std::numeric_limits<float64_t>::lowest();
+  float64_t min_y = std::numeric_limits<float64_t>::max();
+  float64_t max_y = std::numeric_limits<float64_t>::lowest();
+  for (const auto & vertex : polygon) {
+    min_x = std::min(min_x, vertex.x());
+    max_x = std::max(max_x, vertex.x());
+    min_y = std::min(min_y, vertex.y());
+    max_y = std::max(max_y, vertex.y());
+  }
+  m_origin_x = 0.5 * (min_x + max_x);
+  m_origin_y = 0.5 * (min_y + max_y);
+  m_min_x = static_cast<float32_t>(min_x - m_origin_x) - boundary_epsilon;
+  m_max_x = static_cast<float32_t>(max_x - m_origin_x) + boundary_epsilon;
+  m_min_y = static_cast<float32_t>(min_y - m_origin_y) - boundary_epsilon;
+  m_max_y = static_cast<float32_t>(max_y - m_origin_y) + boundary_epsilon;
+  m_epsilon2 = boundary_epsilon * boundary_epsilon;
+
+  const auto num_vertices = polygon.size();
+  m_x.reserve(num_vertices);
+  m_y.reserve(num_vertices);
+  m_dx.reserve(num_vertices);
+  m_dy.reserve(num_vertices);
+  m_dx_per_dy.reserve(num_vertices);
+  m_inv_length2.reserve(num_vertices);
+  for (std::size_t idx = 0U; idx < num_vertices; ++idx) {
+    const auto & start = polygon[idx];
+    const auto & end = polygon[(idx + 1U) % num_vertices];
+    const auto x = static_cast<float32_t>(start.x() - m_origin_x);
+    const auto y = static_cast<float32_t>(start.y() - m_origin_y);
+    // Take the difference of the rounded vertices, so that adjacent edges meet exactly
+    const float32_t dx = static_cast<float32_t>(end.x() - m_origin_x) - x;
+    const float32_t dy = static_cast<float32_t>(end.y() - m_origin_y) - y;
+    const float32_t length2 = (dx * dx) + (dy * dy);
+    // Edges of duplicated vertices cross no ray, and points near them are near the adjacent edges
+    if (length2 > 0.0F) {
+      m_x.push_back(x);
+      m_y.push_back(y);
+      m_dx.push_back(dx);
+      m_dy.push_back(dy);
+      m_dx_per_dy.push_back((dy != 0.0F) ? (dx / dy) : 0.0F);
+      m_inv_length2.push_back(1.0F / length2);
+    }
+  }
+}
+
+std::size_t PolygonEdgeTable::classify(
+  const PointXYZI * points, std::size_t count,
+  uint8_t * is_outside) const
+{
+  std::size_t exact_count = 0U;
+  // Only the points in the bounding box need their edge crossings counted, they are gathered
+  // into batches
+  uint32_t indices[BATCH_SIZE];
+  std::size_t batch_size = 0U;
+  for (std::size_t idx = 0U; idx < count; ++idx) {
+    const auto x = static_cast<float32_t>(static_cast<float64_t>(points[idx].x) - m_origin_x);
+    const auto y = static_cast<float32_t>(static_cast<float64_t>(points[idx].y) - m_origin_y);
+    // Points with a NaN coordinate are in the box, as CGAL decides about them
+    const bool8_t outside_box = (x < m_min_x) || (x > m_max_x) || (y < m_min_y) || (y > m_max_y);
+    is_outside[idx] = outside_box ? 1U : 0U;
+    if (!outside_box) {
+      indices[batch_size] = static_cast<uint32_t>(idx);
+      ++batch_size;
+      if (batch_size == BATCH_SIZE) {
+        exact_count += classify_batch(points, indices, batch_size, is_outside);
+        batch_size = 0U;
+      }
+    }
+  }
+  exact_count += classify_batch(points, indices, batch_size, is_outside);
+  return exact_count;
+}
+
+std::size_t PolygonEdgeTable::classify_batch(
+  const PointXYZI * points, const uint32_t * indices, std::size_t count,
+  uint8_t * is_outside) const
+{
+  if (count == 0U) {
+    return 0U;
+  }
+  float32_t px[BATCH_SIZE];
+  float32_t py[BATCH_SIZE];
+  uint32_t crossings[BATCH_SIZE];
+  uint32_t near_edge[BATCH_SIZE];
+  for (std::size_t i = 0U; i < count; ++i) {
+    px[i] = static_cast<float32_t>(static_cast<float64_t>(points[indices[i]].x) - m_origin_x);
+    py[i] = static_cast<float32_t>(static_cast<float64_t>(points[indices[i]].y) - m_origin_y);
+    crossings[i] = 0U;
+    near_edge[i] = 0U;
+  }
+
+  for (std::size_t edge = 0U; edge < m_x.size(); ++edge) {
+    const float32_t x0 = m_x[edge];
+    const float32_t y0 = m_y[edge];
+    const float32_t y1 = y0 + m_dy[edge];
+    const float32_t dx = m_dx[edge];
+    const float32_t dy = m_dy[edge];
+    const float32_t dx_per_dy = m_dx_per_dy[edge];
+    const float32_t inv_length2 = m_inv_length2[edge];
+    // Branch free, so that the compiler can vectorize the loop over the points
+    for (std::size_t i = 0U; i < count; ++i) {
+      const float32_t rx = px[i] - x0;
+      const float32_t ry = py[i] - y0;
+      // Ray to +x crosses the edge, which includes its lower end but not its upper end
+      const uint32_t straddles = static_cast<uint32_t>((y0 > py[i]) != (y1 > py[i]));
+      const uint32_t left_of_edge = static_cast<uint32_t>(rx < (ry * dx_per_dy));
+      crossings[i] ^= straddles & left_of_edge;
+      // Near the edge if near its line and projected between its ends, or near one of its ends.
+      // Written without selects, as clamping the projection would keep the loop from vectorizing
+      const float32_t t = ((rx * dx) + (ry * dy)) * inv_length2;
+      const float32_t cross = (rx * dy) - (ry * dx);
+      const float32_t ex = rx - dx;
+      const float32_t ey = ry - dy;
+      const uint32_t near_line = static_cast<uint32_t>((cross * cross * inv_length2) <= m_epsilon2);
+      const uint32_t between_ends = static_cast<uint32_t>(t >= 0.0F) &
+        static_cast<uint32_t>(t <= 1.0F);
+      const uint32_t near_ends = static_cast<uint32_t>(((rx * rx) + (ry * ry)) <= m_epsilon2) |
+        static_cast<uint32_t>(((ex * ex) + (ey * ey)) <= m_epsilon2);
+      near_edge[i] |= (near_line & between_ends) | near_ends;
+    }
+  }
+
+  std::size_t exact_count = 0U;
+  for (std::size_t i = 0U; i < count; ++i) {
+    const auto & point = points[indices[i]];
+    // NaN coordinates fail every comparison, so they are classified exactly as well
+    if ((near_edge[i] != 0U) || (px[i] != px[i]) || (py[i] != py[i])) {
+      ++exact_count;
+      const auto side = CGAL::bounded_side_2(
+        m_polygon.begin(), m_polygon.end(), PointCgal(point.x, point.y), K());
+      is_outside[indices[i]] = (side == CGAL::ON_UNBOUNDED_SIDE) ? 1U : 0U;
+    } else {
+      is_outside[indices[i]] = ((crossings[i] & 1U) == 0U) ? 1U : 0U;
+    }
+  }
+  return exact_count;
+}
+
+}  // namespace polygon_remover
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
@@ -112,6 +112,7 @@ std::vector<PointCgal> PolygonRemover::polygon_geometry_to_cgal(
 void PolygonRemover::update_polygon(const Polygon::ConstSharedPtr & polygon_in)
 {
   polygon_cgal_ = polygon_geometry_to_cgal(polygon_in);
+  polygon_edge_table_ = std::make_unique<PolygonEdgeTable>(polygon_cgal_);
   if (will_visualize_) {
     marker_.ns = "ns_polygon_remover";
     marker_.id = 0;
@@ -178,7 +179,32 @@ PointCloud2::SharedPtr PolygonRemover::remove_updated_polygon_from_cloud(
     throw std::runtime_error(
             "Polygon is not initialized. Please use `update_polygon` first.");
   }
-  return remove_polygon_cgal_from_cloud(cloud_in, polygon_cgal_);
+  PointCloud2::SharedPtr cloud_filtered_ptr = std::make_shared<PointCloud2>();
+
+  using CloudModifier = point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>;
+  using CloudView = point_cloud_msg_wrapper::PointCloud2View<PointXYZI>;
+
+  CloudModifier cloud_modifier_filtered(*cloud_filtered_ptr, "");
+  cloud_filtered_ptr->header = cloud_in->header;
+
+  CloudView cloud_view_in(*cloud_in);
+  if (cloud_view_in.size() == 0U) {
+    return cloud_filtered_ptr;
+  }
+  point_is_outside_.resize(cloud_view_in.size());
+  polygon_edge_table_->classify(
+    &cloud_view_in[0U], cloud_view_in.size(), point_is_outside_.data());
+
+  cloud_modifier_filtered.resize(static_cast<uint32_t>(cloud_view_in.size()));
+  std::size_t count_outside = 0U;
+  for (std::size_t idx = 0U; idx < cloud_view_in.size(); ++idx) {
+    if (point_is_outside_[idx] != 0U) {
+      cloud_modifier_filtered[count_outside] = cloud_view_in[idx];
+      ++count_outside;
+    }
+  }
+  cloud_modifier_filtered.resize(static_cast<uint32_t>(count_outside));
+  return cloud_filtered_ptr;
 }
 
 bool8_t PolygonRemover::polygon_is_initialized() const
@@ -0,0 +1,93 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <benchmark/benchmark.h>
+#include <common/types.hpp>
+#include <geometry_msgs/msg/polygon.hpp>
+#include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
+#include <polygon_remover/polygon_remover.hpp>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+using autoware::common::types::PointXYZI;
+using autoware::common::types::float32_t;
+using autoware::perception::filters::polygon_remover::PolygonRemover;
+using geometry_msgs::msg::Polygon;
+using sensor_msgs::msg::PointCloud2;
+
+constexpr auto kCloudSize = 100000U;
+
+// A concave polygon, a star with the given number of vertices
+Polygon::ConstSharedPtr create_polygon(const std::size_t num_vertices)
+{
+  auto polygon = std::make_shared<Polygon>();
+  for (std::size_t i = 0U; i < num_vertices; ++i) {
+    const float32_t angle =
+      6.2831853F * static_cast<float32_t>(i) / static_cast<float32_t>(num_vertices);
+    const float32_t radius = ((i % 2U) == 0U) ? 20.0F : 8.0F;
+    geometry_msgs::msg::Point32 vertex;
+    vertex.x = radius * std::cos(angle);
+    vertex.y = radius * std::sin(angle);
+    polygon->points.push_back(vertex);
+  }
+  return polygon;
+}
+
+PointCloud2::ConstSharedPtr create_cloud(const std::size_t size)
+{
+  auto cloud = std::make_shared<PointCloud2>();
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier{*cloud, "frame_id"};
+  modifier.reserve(size);
+  std::mt19937 mt(42);
+  std::uniform_real_distribution<float32_t> dist(-40.0F, 40.0F);
+  for (std::size_t i = 0U; i < size; ++i) {
+    modifier.push_back(PointXYZI{dist(mt), dist(mt), dist(mt), 0.0F});
+  }
+  return cloud;
+}
+
+}  // namespace
+
+static void BenchRemovePolygonCgal(benchmark::State & state)
+{
+  const auto polygon = PolygonRemover::polygon_geometry_to_cgal(
+    create_polygon(static_cast<std::size_t>(state.range(0))));
+  const auto cloud = create_cloud(kCloudSize);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(PolygonRemover::remove_polygon_cgal_from_cloud(cloud, polygon));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kCloudSize));
+}
+
+static void BenchRemovePolygonEdgeTable(benchmark::State & state)
+{
+  PolygonRemover polygon_remover{false};
+  polygon_remover.update_polygon(create_polygon(static_cast<std::size_t>(state.range(0))));
+  const auto cloud = create_cloud(kCloudSize);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(polygon_remover.remove_updated_polygon_from_cloud(cloud));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kCloudSize));
+}
+
+// Number of polygon vertices
+BENCHMARK(BenchRemovePolygonCgal)->Arg(8)->Arg(32)->Arg(128);
+BENCHMARK(BenchRemovePolygonEdgeTable)->Arg(8)->Arg(32)->Arg(128);
@@ -15,6 +15,7 @@
 #include <common/types.hpp>
 #include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
 #include <geometry_msgs/msg/polygon.hpp>
+#include <cmath>
 #include <random>
 #include <memory>
 #include "gtest/gtest.h"
@@ -180,3 +181,66 @@ TEST(TestPolygonRemover, ShapeToPolylinePolygon) {
   CloudModifier cloud_modifier_filtered(*cloud_filtered_ptr);
   EXPECT_EQ(cloud_modifier_filtered.size(), count_points_outside_rect);
 }
+
+// The edge table gives the same result as CGAL, also for points on the edges and vertices of a
+// concave polygon far from the origin
+TEST(TestPolygonRemover, EdgeTableSameAsCgal) {
+  using PolygonRemover = autoware::perception::filters::polygon_remover::PolygonRemover;
+  using CloudModifier = point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>;
+  using CloudView = point_cloud_msg_wrapper::PointCloud2View<PointXYZI>;
+  PolygonRemover polygon_remover(false);
+
+  // A star with a duplicated vertex, around (1000, -500)
+  Polygon::SharedPtr shape = std::make_shared<Polygon>();
+  const float32_t center_x = 1000.0F;
+  const float32_t center_y = -500.0F;
+  for (uint32_t i = 0U; i < 10U; ++i) {
+    const float32_t angle = 0.6283185F * static_cast<float32_t>(i);
+    const float32_t radius = ((i % 2U) == 0U) ? 10.0F : 4.0F;
+    shape->points.emplace_back(
+      make_point_geo(
+        center_x + (radius * std::cos(angle)), center_y + (radius * std::sin(angle)), 0.0F));
+  }
+  shape->points.emplace_back(shape->points.back());
+  polygon_remover.update_polygon(shape);
+
+  PointCloud2::SharedPtr cloud_input_ptr = std::make_shared<PointCloud2>();
+  CloudModifier cloud_modifier_input(*cloud_input_ptr, "");
+  std::mt19937 mt(19940426);
+  std::uniform_real_distribution<float32_t> dist(-12.0F, 12.0F);
+  for (uint32_t i = 0U; i < 5000U; ++i) {
+    cloud_modifier_input.push_back(
+      PointXYZI{center_x + dist(mt), center_y + dist(mt), 0.0F, static_cast<float32_t>(i)});
+  }
+  // Points on the vertices, the middle of the edges and a grid through horizontal edges
+  const auto & vertices = shape->points;
+  for (std::size_t i = 0U; i < vertices.size(); ++i) {
+    const auto & v0 = vertices[i];
+    const auto & v1 = vertices[(i + 1U) % vertices.size()];
+    cloud_modifier_input.push_back(PointXYZI{v0.x, v0.y, 0.0F, -1.0F});
+    cloud_modifier_input.push_back(
+      PointXYZI{0.5F * (v0.x + v1.x), 0.5F * (v0.y + v1.y), 0.0F, -2.0F});
+    cloud_modifier_input.push_back(PointXYZI{v0.x, v1.y, 0.0F, -3.0F});
+  }
+
+  const auto cloud_cgal_ptr = PolygonRemover::remove_polygon_cgal_from_cloud(
+    cloud_input_ptr, PolygonRemover::polygon_geometry_to_cgal(shape));
+  const auto cloud_edge_table_ptr = polygon_remover.remove_updated_polygon_from_cloud(
+    cloud_input_ptr);
+  const CloudView cloud_cgal(*cloud_cgal_ptr);
+  const CloudView cloud_edge_table(*cloud_edge_table_ptr);
+  ASSERT_GT(cloud_cgal.size(), 0U);
+  ASSERT_LT(cloud_cgal.size(), cloud_modifier_input.size());
+  ASSERT_EQ(cloud_edge_table.size(), cloud_cgal.size());
+  for (std::size_t i = 0U; i < cloud_cgal.size(); ++i) {
+    EXPECT_EQ(cloud_edge_table[i].x, cloud_cgal[i].x);
+    EXPECT_EQ(cloud_edge_table[i].y, cloud_cgal[i].y);
+    EXPECT_EQ(cloud_edge_table[i].intensity, cloud_cgal[i].intensity);
+  }
+
+  // An empty cloud stays empty
+  PointCloud2::SharedPtr cloud_empty_ptr = std::make_shared<PointCloud2>();
+  CloudModifier{*cloud_empty_ptr, ""};
+  EXPECT_EQ(
+    CloudView{*polygon_remover.remove_updated_polygon_from_cloud(cloud_empty_ptr)}.size(), 0U);
+}
@@ -161,6 +161,13 @@ private:
   /// \return Const reference to next ray ready for processing
   /// \throw std::runtime_error If no ray is ready
   const Ray & get_next_ray();
+  /// \brief Get next ray that is ready for partitioning, without sorting it. This allows the
+  ///        rays to be sorted and partitioned concurrently: the returned rays are distinct and
+  ///        stay valid until the next insertion. Not thread safe
+  /// \return Reference to next ray ready for processing, which has to be sorted before it is
+  ///         partitioned
+  /// \throw std::runtime_error If no ray is ready
+  Ray & get_next_unsorted_ray();
   /// \brief Clear all the ready rays so that is_ray_ready() return false
   void reset();
 
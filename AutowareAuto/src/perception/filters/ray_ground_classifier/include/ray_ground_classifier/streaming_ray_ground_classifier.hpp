@@ -0,0 +1,134 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief This file defines a ray ground classifier which partitions a scan while it is received
+
+#ifndef RAY_GROUND_CLASSIFIER__STREAMING_RAY_GROUND_CLASSIFIER_HPP_
+#define RAY_GROUND_CLASSIFIER__STREAMING_RAY_GROUND_CLASSIFIER_HPP_
+
+#include <common/types.hpp>
+#include <ray_ground_classifier/ray_aggregator.hpp>
+#include <ray_ground_classifier/ray_ground_classifier.hpp>
+#include <ray_ground_classifier/visibility_control.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace ray_ground_classifier
+{
+
+using autoware::common::types::PointXYZI;
+
+/// \brief Partitions a scan into ground and nonground points while its points are received, e.g.
+///        packet by packet from a driver. Every ray is partitioned as soon as the aggregator has
+///        it ready, so only the rays which are still open have to be partitioned once the end of
+///        the scan is received.
+///
+/// The aggregator and classifier refer to the points by pointer, so the points of the current
+/// scan are copied into a buffer which is preallocated on construction.
+class RAY_GROUND_CLASSIFIER_PUBLIC StreamingRayGroundClassifier
+{
+public:
+  /// \brief Constructor
+  /// \param[in] classifier_cfg Configuration of the ray ground classifier
+  /// \param[in] aggregator_cfg Configuration of the ray aggregator
+  /// \param[in] max_scan_points Maximum number of points of a single scan
+  StreamingRayGroundClassifier(
+    const Config & classifier_cfg,
+    const RayAggregator::Config & aggregator_cfg,
+    const std::size_t max_scan_points);
+
+  /// \brief Insert points of the current scan and partition all rays which get ready. Points
+  ///        which are (almost) at the origin are nonground. Stops after the end of scan point.
+  /// \param[in] first Beginning of the points
+  /// \param[in] last One past the last point
+  /// \param[inout] ground Gets appended with the ground points of the partitioned rays
+  /// \param[inout] nonground Gets appended with the nonground points of the partitioned rays
+  /// \tparam OutputT Container with a push_back(PointXYZI) method, e.g. a point cloud modifier
+  /// \return One past the last inserted point. If this is not last, the scan is complete and the
+  ///         remaining points belong to the next scan.
+  /// \throw std::runtime_error If the scan has more points than max_scan_points
+  template<typename OutputT>
+  const PointXYZIF * insert(
+    const PointXYZIF * first, const PointXYZIF * last, OutputT & ground, OutputT & nonground)
+  {
+    const PointXYZIF * it = first;
+    for (; (it != last) && !m_is_scan_complete; ++it) {
+      if (static_cast<uint16_t>(PointXYZIF::END_OF_SCAN_ID) == it->id) {
+        // All remaining rays are partitioned below
+        m_aggregator.end_of_scan();
+        m_is_scan_complete = true;
+      } else if (is_at_origin(*it)) {
+        // Too many of those points make the bin 0 overflow
+        nonground.push_back(PointXYZI{it->x, it->y, it->z, it->intensity});
+      } else {
+        insert_point(*it);
+      }
+    }
+    while (m_aggregator.is_ray_ready()) {
+      partition_next_ray();
+      for (const PointXYZIF * pt : m_ground_block) {
+        ground.push_back(PointXYZI{pt->x, pt->y, pt->z, pt->intensity});
+      }
+      for (const PointXYZIF * pt : m_nonground_block) {
+        nonground.push_back(PointXYZI{pt->x, pt->y, pt->z, pt->intensity});
+      }
+    }
+    return it;
+  }
+
+  /// \brief Whether the end of scan point of the current scan was inserted
+  /// \return Value
+  bool8_t is_scan_complete() const noexcept;
+
+  /// \brief Start the next scan. Drops all points of the current scan which are not partitioned
+  ///        yet.
+  void reset();
+
+private:
+  /// \brief Whether a point is too close to the origin to be binned into a ray
+  static bool8_t is_at_origin(const PointXYZIF & pt) noexcept
+  {
+    return (std::fabs(pt.x) <= std::numeric_limits<decltype(pt.x)>::epsilon()) &&
+           (std::fabs(pt.y) <= std::numeric_limits<decltype(pt.y)>::epsilon());
+  }
+  /// \brief Copy a point into the scan buffer and insert it into the aggregator
+  RAY_GROUND_CLASSIFIER_LOCAL void insert_point(const PointXYZIF & pt);
+  /// \brief Partition the next ready ray into the ground and nonground blocks
+  RAY_GROUND_CLASSIFIER_LOCAL void partition_next_ray();
+
+  RayGroundClassifier m_classifier;
+  RayAggregator m_aggregator;
+  // Points of the current scan, never reallocated as the aggregator points into it
+  std::vector<PointXYZIF> m_scan_points;
+  // Partition of the last ray
+  PointPtrBlock m_ground_block;
+  PointPtrBlock m_nonground_block;
+  bool8_t m_is_scan_complete{false};
+};  // class StreamingRayGroundClassifier
+}  // namespace ray_ground_classifier
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // RAY_GROUND_CLASSIFIER__STREAMING_RAY_GROUND_CLASSIFIER_HPP_
@@ -200,6 +200,14 @@ std::size_t RayAggregator::get_ready_ray_count() const
 }
 ////////////////////////////////////////////////////////////////////////////////
 const Ray & RayAggregator::get_next_ray()
+{
+  Ray & ret = get_next_unsorted_ray();
+  // Sort ray
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+////////////////////////////////////////////////////////////////////////////////
+Ray & RayAggregator::get_next_unsorted_ray()
 {
   // move the if out from the sequential section by nullifying the operations if false
   bool8_t is_ready = is_ray_ready();
@@ -214,8 +222,6 @@ const Ray & RayAggregator::get_next_ray()
   const std::size_t idx = m_ready_indices[local_start_idx];
 
   Ray & ret = m_rays[idx];
-  // Sort ray
-  std::sort(ret.begin(), ret.end());
   // ready to be reset on next insertion to this item
   m_ray_state[idx] = RayState::RESET;
 
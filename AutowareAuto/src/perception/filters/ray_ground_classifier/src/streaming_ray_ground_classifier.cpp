@@ -0,0 +1,79 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdexcept>
+
+#include "common/types.hpp"
+#include "ray_ground_classifier/streaming_ray_ground_classifier.hpp"
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace ray_ground_classifier
+{
+
+using autoware::common::types::POINT_BLOCK_CAPACITY;
+
+////////////////////////////////////////////////////////////////////////////////
+StreamingRayGroundClassifier::StreamingRayGroundClassifier(
+  const Config & classifier_cfg,
+  const RayAggregator::Config & aggregator_cfg,
+  const std::size_t max_scan_points)
+: m_classifier(classifier_cfg),
+  m_aggregator(aggregator_cfg)
+{
+  m_scan_points.reserve(max_scan_points);
+  m_ground_block.reserve(POINT_BLOCK_CAPACITY);
+  m_nonground_block.reserve(POINT_BLOCK_CAPACITY);
+}
+////////////////////////////////////////////////////////////////////////////////
+bool8_t StreamingRayGroundClassifier::is_scan_complete() const noexcept
+{
+  return m_is_scan_complete;
+}
+////////////////////////////////////////////////////////////////////////////////
+void StreamingRayGroundClassifier::reset()
+{
+  // Ready all open rays and drop them, so that no ray refers to the points of this scan
+  m_aggregator.end_of_scan();
+  m_aggregator.reset();
+  m_scan_points.clear();  // capacity unchanged
+  m_is_scan_complete = false;
+}
+////////////////////////////////////////////////////////////////////////////////
+void StreamingRayGroundClassifier::insert_point(const PointXYZIF & pt)
+{
+  if (m_scan_points.size() >= m_scan_points.capacity()) {
+    throw std::runtime_error("StreamingRayGroundClassifier: Scan has too many points");
+  }
+  m_scan_points.push_back(pt);
+  if (!m_aggregator.insert(&m_scan_points.back())) {
+    // Ray capacity overrun, partition everything received so far
+    m_aggregator.end_of_scan();
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+void StreamingRayGroundClassifier::partition_next_ray()
+{
+  m_ground_block.clear();
+  m_nonground_block.clear();
+  m_classifier.partition(m_aggregator.get_next_ray(), m_ground_block, m_nonground_block);
+}
+}  // namespace ray_ground_classifier
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
@@ -18,6 +18,7 @@
 #include <ray_ground_classifier/ray_aggregator.hpp>
 #include <ray_ground_classifier/ray_ground_point_classifier.hpp>
 #include <common/types.hpp>
+#include <algorithm>
 #include <vector>
 
 using autoware::common::types::PointXYZIF;
@@ -152,6 +153,45 @@ TEST(RayAggregator, MultiFlipped)
   EXPECT_EQ(total_points, num_points);
 }
 
+// unsorted rays are distinct and can be sorted outside of the aggregator
+TEST(RayAggregator, UnsortedRays)
+{
+  RayAggregator::Config cfg{1.14159F, -1.14159F, 0.2F, 50U};
+  RayAggregator agg{cfg};
+  const std::size_t num_points = 32U;
+  std::vector<PointXYZIF> all_points;
+  all_points.reserve(num_points);
+  for (uint32_t idx = 0U; idx < num_points; ++idx) {
+    // points in three rays, with decreasing radius
+    const float32_t r = static_cast<float32_t>(num_points - idx);
+    PointXYZIF pt;
+    pt.x = -r;
+    pt.y = r * (static_cast<float32_t>(idx % 3U) - 1.0F);
+    all_points.push_back(pt);
+    EXPECT_TRUE(agg.insert(&(all_points.back())));
+  }
+  agg.end_of_scan();
+  ASSERT_EQ(agg.get_ready_ray_count(), 3U);
+  std::vector<Ray *> rays;
+  while (agg.is_ray_ready()) {
+    rays.push_back(&agg.get_next_unsorted_ray());
+  }
+  EXPECT_THROW(agg.get_next_unsorted_ray(), std::runtime_error);
+  std::size_t total_points = 0U;
+  for (Ray * ray : rays) {
+    total_points += ray->size();
+    // points are in insertion order
+    EXPECT_LT(ray->front().get_point_pointer()->x, ray->back().get_point_pointer()->x);
+    std::sort(ray->begin(), ray->end());
+    const auto pt = ray->front().get_point_pointer();
+    check_ray(*ray, atan2f(pt->y, pt->x));
+  }
+  EXPECT_EQ(total_points, num_points);
+  EXPECT_NE(rays[0U], rays[1U]);
+  EXPECT_NE(rays[1U], rays[2U]);
+  EXPECT_NE(rays[0U], rays[2U]);
+}
+
 // test various forms of templated insert, multiple times, (0, y)
 TEST(RayAggregator, MultiInsert)
 {
@@ -0,0 +1,165 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <common/types.hpp>
+#include <ray_ground_classifier/ray_aggregator.hpp>
+#include <ray_ground_classifier/ray_ground_classifier.hpp>
+#include <ray_ground_classifier/streaming_ray_ground_classifier.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using autoware::common::types::PointXYZI;
+using autoware::common::types::PointXYZIF;
+using autoware::common::types::float32_t;
+using autoware::perception::filters::ray_ground_classifier::Config;
+using autoware::perception::filters::ray_ground_classifier::PointPtrBlock;
+using autoware::perception::filters::ray_ground_classifier::RayAggregator;
+using autoware::perception::filters::ray_ground_classifier::RayGroundClassifier;
+using autoware::perception::filters::ray_ground_classifier::StreamingRayGroundClassifier;
+
+class StreamingRayGroundClassifierTest : public ::testing::Test
+{
+public:
+  StreamingRayGroundClassifierTest()
+  : m_classifier_cfg{0.4F, 5.0F, 3.0F, 20.0F, 0.05F, 1.5F, 1.8F, 2.0F},
+    m_aggregator_cfg{-3.14159F, 3.14159F, 0.1F, 128U}
+  {
+    // A flat ground with a few obstacles, spread over all rays
+    for (uint16_t ray = 0U; ray < 60U; ++ray) {
+      const float32_t th = -3.0F + (0.1F * static_cast<float32_t>(ray)) + 0.05F;
+      for (uint16_t idx = 0U; idx < 20U; ++idx) {
+        const float32_t r = 1.0F + (0.5F * static_cast<float32_t>(idx));
+        PointXYZIF pt;
+        pt.x = r * std::cos(th);
+        pt.y = r * std::sin(th);
+        pt.z = ((idx % 7U) == 6U) ? 1.0F : -0.4F;
+        pt.intensity = static_cast<float32_t>(idx);
+        pt.id = idx;
+        m_scan.push_back(pt);
+      }
+    }
+    // A point at the origin, which is always nonground
+    m_scan.push_back(PointXYZIF{});
+    PointXYZIF eos;
+    eos.id = static_cast<uint16_t>(PointXYZIF::END_OF_SCAN_ID);
+    m_scan.push_back(eos);
+  }
+
+protected:
+  // Partition the whole scan at once, as the cloud node does
+  void partition_scan(std::vector<PointXYZI> & ground, std::vector<PointXYZI> & nonground) const
+  {
+    RayGroundClassifier classifier{m_classifier_cfg};
+    RayAggregator aggregator{m_aggregator_cfg};
+    for (const auto & pt : m_scan) {
+      if ((pt.x == 0.0F) && (pt.y == 0.0F)) {
+        if (static_cast<uint16_t>(PointXYZIF::END_OF_SCAN_ID) != pt.id) {
+          nonground.push_back(PointXYZI{pt.x, pt.y, pt.z, pt.intensity});
+        }
+      } else {
+        ASSERT_TRUE(aggregator.insert(&pt));
+      }
+    }
+    aggregator.end_of_scan();
+    while (aggregator.is_ray_ready()) {
+      PointPtrBlock ground_blk;
+      PointPtrBlock nonground_blk;
+      classifier.partition(aggregator.get_next_ray(), ground_blk, nonground_blk);
+      for (const auto * pt : ground_blk) {
+        ground.push_back(PointXYZI{pt->x, pt->y, pt->z, pt->intensity});
+      }
+      for (const auto * pt : nonground_blk) {
+        nonground.push_back(PointXYZI{pt->x, pt->y, pt->z, pt->intensity});
+      }
+    }
+  }
+
+  Config m_classifier_cfg;
+  RayAggregator::Config m_aggregator_cfg;
+  std::vector<PointXYZIF> m_scan;
+};
+
+// Feeding the scan packet by packet gives the same partition as partitioning it at once
+TEST_F(StreamingRayGroundClassifierTest, SameAsFullScan) {
+  std::vector<PointXYZI> expected_ground;
+  std::vector<PointXYZI> expected_nonground;
+  partition_scan(expected_ground, expected_nonground);
+  ASSERT_FALSE(expected_ground.empty());
+  ASSERT_FALSE(expected_nonground.empty());
+
+  StreamingRayGroundClassifier classifier{m_classifier_cfg, m_aggregator_cfg, m_scan.size()};
+  // Do this twice to exercise the reset logic
+  for (auto scan = 0U; scan < 2U; ++scan) {
+    std::vector<PointXYZI> ground;
+    std::vector<PointXYZI> nonground;
+    const auto packet_size = 37U;
+    for (std::size_t idx = 0U; idx < m_scan.size(); idx += packet_size) {
+      EXPECT_FALSE(classifier.is_scan_complete());
+      const auto first = &m_scan[idx];
+      const auto last = &m_scan[std::min(idx + packet_size, m_scan.size())];
+      EXPECT_EQ(classifier.insert(first, last, ground, nonground), last);
+    }
+    EXPECT_TRUE(classifier.is_scan_complete());
+    // No ray is full before the end of the scan, so the rays are partitioned in the same order
+    EXPECT_EQ(ground, expected_ground);
+    EXPECT_EQ(nonground, expected_nonground);
+    classifier.reset();
+  }
+}
+
+// Rays which are full are partitioned before the end of the scan
+TEST_F(StreamingRayGroundClassifierTest, EarlyRays) {
+  const RayAggregator::Config aggregator_cfg{-3.14159F, 3.14159F, 0.1F, 10U};
+  StreamingRayGroundClassifier classifier{m_classifier_cfg, aggregator_cfg, m_scan.size()};
+  std::vector<PointXYZI> ground;
+  std::vector<PointXYZI> nonground;
+  // The points of the first ray fill it twice, the second ray is still open
+  const auto last = &m_scan[25U];
+  EXPECT_EQ(classifier.insert(&m_scan[0U], last, ground, nonground), last);
+  EXPECT_EQ(ground.size() + nonground.size(), 20U);
+  EXPECT_FALSE(classifier.is_scan_complete());
+}
+
+// Points after the end of scan are left for the next scan
+TEST_F(StreamingRayGroundClassifierTest, EndOfScan) {
+  StreamingRayGroundClassifier classifier{m_classifier_cfg, m_aggregator_cfg, m_scan.size()};
+  auto scan = m_scan;
+  scan.insert(scan.end(), m_scan.begin(), m_scan.begin() + 10);
+  std::vector<PointXYZI> ground;
+  std::vector<PointXYZI> nonground;
+  const auto eos = &scan[m_scan.size()];
+  EXPECT_EQ(classifier.insert(scan.data(), scan.data() + scan.size(), ground, nonground), eos);
+  EXPECT_TRUE(classifier.is_scan_complete());
+  EXPECT_EQ(ground.size() + nonground.size(), m_scan.size() - 1U);
+  // Nothing is inserted until the next scan is started
+  EXPECT_EQ(classifier.insert(eos, scan.data() + scan.size(), ground, nonground), eos);
+  classifier.reset();
+  EXPECT_EQ(
+    classifier.insert(eos, scan.data() + scan.size(), ground, nonground),
+    scan.data() + scan.size());
+  EXPECT_FALSE(classifier.is_scan_complete());
+}
+
+TEST_F(StreamingRayGroundClassifierTest, TooManyPoints) {
+  StreamingRayGroundClassifier classifier{m_classifier_cfg, m_aggregator_cfg, 10U};
+  std::vector<PointXYZI> ground;
+  std::vector<PointXYZI> nonground;
+  EXPECT_THROW(
+    classifier.insert(m_scan.data(), m_scan.data() + 11U, ground, nonground),
+    std::runtime_error);
+}
@@ -21,6 +21,7 @@
 #define RAY_GROUND_CLASSIFIER_NODES__RAY_GROUND_CLASSIFIER_CLOUD_NODE_HPP_
 
 #include <common/types.hpp>
+#include <helper_functions/worker_pool.hpp>
 #include <lidar_utils/point_cloud_utils.hpp>
 #include <ray_ground_classifier_nodes/visibility_control.hpp>
 #include <ray_ground_classifier/ray_aggregator.hpp>
@@ -60,6 +61,11 @@ public:
 private:
   /// \brief Resets state of ray aggregator and messages
   RAY_GROUND_CLASSIFIER_NODES_LOCAL void reset();
+  /// \brief Partitions the ready rays of the aggregator on the worker pool, into the per ray
+  ///        output blocks
+  /// \param[in] num_rays Number of ready rays
+  /// \throw std::runtime_error If a ray cannot be partitioned
+  RAY_GROUND_CLASSIFIER_NODES_LOCAL void partition_rays_parallel(const std::size_t num_rays);
   // Algorithmic core
   ray_ground_classifier::RayGroundClassifier m_classifier;
   ray_ground_classifier::RayAggregator m_aggregator;
@@ -75,8 +81,19 @@ private:
   const rclcpp::Subscription<PointCloud2>::SharedPtr m_raw_sub_ptr;
   const std::shared_ptr<rclcpp::Publisher<PointCloud2>> m_ground_pub_ptr;
   const std::shared_ptr<rclcpp::Publisher<PointCloud2>> m_nonground_pub_ptr;
+  // Parallel mode, only used if num_threads is above zero
+  std::unique_ptr<common::helper_functions::WorkerPool> m_worker_pool;
+  // One classifier per worker task, as the classifiers keep state while partitioning a ray
+  std::vector<ray_ground_classifier::RayGroundClassifier> m_worker_classifiers;
+  // Ready rays of the current scan and their partitions, in the order the rays were ready
+  std::vector<ray_ground_classifier::Ray *> m_ready_rays;
+  std::vector<ray_ground_classifier::PointPtrBlock> m_ray_ground_blocks;
+  std::vector<ray_ground_classifier::PointPtrBlock> m_ray_nonground_blocks;
+  // Publish the classified points as std::unique_ptr, so that they are not copied when
+  // intra-process communication is used
+  const bool8_t m_publish_unique_ptr;
   /// \brief Read samples from the subscription
-  void callback(const PointCloud2::SharedPtr msg);
+  void callback(const PointCloud2::ConstSharedPtr msg);
 };  // class RayGroundFilterDriverNode
 }  // namespace ray_ground_classifier_nodes
 }  // namespace filters
@@ -21,7 +21,10 @@
 #include <rclcpp_components/register_node_macro.hpp>
 #include <stdlib.h>
 
+#include <algorithm>
+#include <atomic>
 #include <limits>
+#include <stdexcept>
 #include <string>
 
 namespace autoware
@@ -33,6 +36,7 @@ namespace filters
 namespace ray_ground_classifier_nodes
 {
 ////////////////////////////////////////////////////////////////////////////////
+using autoware::common::types::POINT_BLOCK_CAPACITY;
 using autoware::common::types::PointXYZI;
 using autoware::common::types::float32_t;
 using autoware::perception::filters::ray_ground_classifier::PointPtrBlock;
@@ -40,6 +44,31 @@ using autoware::perception::filters::ray_ground_classifier::PointPtrBlock;
 using std::placeholders::_1;
 
 using autoware::common::lidar_utils::has_intensity_and_throw_if_no_xyz;
+using autoware::common::lidar_utils::take_point_cloud;
+
+namespace
+{
+using PointCloudModifier = point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>;
+
+/// Add the partitioned points of a ray to the output point clouds
+void push_back_ray(
+  const PointPtrBlock & ground_blk, const PointPtrBlock & nonground_blk,
+  PointCloudModifier & ground_msg_modifier, PointCloudModifier & nonground_msg_modifier)
+{
+  for (auto & ground_point : ground_blk) {
+    ground_msg_modifier.push_back(
+      PointXYZI{
+              ground_point->x, ground_point->y, ground_point->z,
+              ground_point->intensity});
+  }
+  for (auto & nonground_point : nonground_blk) {
+    nonground_msg_modifier.push_back(
+      PointXYZI{
+              nonground_point->x, nonground_point->y, nonground_point->z,
+              nonground_point->intensity});
+  }
+}
+}  // namespace
 
 RayGroundClassifierCloudNode::RayGroundClassifierCloudNode(
   const rclcpp::NodeOptions & node_options)
@@ -80,26 +109,40 @@ RayGroundClassifierCloudNode::RayGroundClassifierCloudNode(
   m_ground_pub_ptr(create_publisher<PointCloud2>(
       "points_ground", rclcpp::QoS(10))),
   m_nonground_pub_ptr(create_publisher<PointCloud2>(
-      "points_nonground", rclcpp::QoS(10)))
+      "points_nonground", rclcpp::QoS(10))),
+  m_publish_unique_ptr(node_options.use_intra_process_comms())
 {
   // initialize messages
   point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>{
     m_ground_msg, m_frame_id}.reserve(m_pcl_size);
   point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>{
     m_nonground_msg, m_frame_id}.reserve(m_pcl_size);
+
+  // Rays are independent of each other, so they can be partitioned in parallel
+  const auto num_threads_param = declare_parameter("num_threads", 0);
+  if (num_threads_param < 0) {
+    throw std::domain_error{"RayGroundClassifierCloudNode: num_threads must not be negative"};
+  }
+  const auto num_threads = static_cast<std::size_t>(num_threads_param);
+  if (num_threads > 0U) {
+    m_worker_pool = std::make_unique<common::helper_functions::WorkerPool>(num_threads);
+    m_worker_classifiers.reserve(num_threads);
+    for (std::size_t idx = 0U; idx < num_threads; ++idx) {
+      m_worker_classifiers.emplace_back(m_classifier);
+    }
+  }
 }
 ////////////////////////////////////////////////////////////////////////////////
 void
-RayGroundClassifierCloudNode::callback(const PointCloud2::SharedPtr msg)
+RayGroundClassifierCloudNode::callback(const PointCloud2::ConstSharedPtr msg)
 {
   PointXYZIF pt_tmp;
   pt_tmp.id = static_cast<uint16_t>(PointXYZIF::END_OF_SCAN_ID);
   const ray_ground_classifier::PointXYZIFR eos_pt{&pt_tmp};
 
   try {
-    point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> ground_msg_modifier{m_ground_msg};
-    point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> nonground_msg_modifier{
-      m_nonground_msg};
+    PointCloudModifier ground_msg_modifier{m_ground_msg};
+    PointCloudModifier nonground_msg_modifier{m_nonground_msg};
 
     // Reset messages and aggregator to ensure they are in a good state
     reset();
@@ -116,7 +159,7 @@ RayGroundClassifierCloudNode::callback(const PointCloud2::SharedPtr msg)
       throw std::runtime_error("RayGroundClassifierCloudNode: Malformed PointCloud2");
     }
     // Verify the point cloud format and assign correct point_step
-    if (!has_intensity_and_throw_if_no_xyz(msg)) {
+    if (!has_intensity_and_throw_if_no_xyz(*msg)) {
       RCLCPP_WARN(
         this->get_logger(),
         "RayGroundClassifierNode Warning: PointCloud doesn't have intensity field");
@@ -178,31 +221,14 @@ RayGroundClassifierCloudNode::callback(const PointCloud2::SharedPtr msg)
       m_aggregator.end_of_scan();
       num_ready = m_aggregator.get_ready_ray_count();
 
-      // Partition each ray
-      for (size_t i = 0; i < num_ready; i++) {
-        if (abort) {
-          continue;
-        }
-        // Note: if an exception occurs in this loop, the aggregator can get into a bad state
-        // (e.g. overrun capacity)
-        PointPtrBlock ground_blk;
-        PointPtrBlock nonground_blk;
+      if (m_worker_pool) {
         try {
-          auto ray = m_aggregator.get_next_ray();
-          // partition: should never fail, guaranteed to have capacity via other checks
-          m_classifier.partition(ray, ground_blk, nonground_blk);
-
-          // Add ray to point clouds
-          for (auto & ground_point : ground_blk) {
-            ground_msg_modifier.push_back(
-              PointXYZI{
-                      ground_point->x, ground_point->y, ground_point->z, ground_point->intensity});
-          }
-          for (auto & nonground_point : nonground_blk) {
-            nonground_msg_modifier.push_back(
-              PointXYZI{
-                      nonground_point->x, nonground_point->y, nonground_point->z,
-                      nonground_point->intensity});
+          partition_rays_parallel(num_ready);
+          // Add rays to point clouds in order, so the output matches the sequential mode
+          for (size_t i = 0; i < num_ready; i++) {
+            push_back_ray(
+              m_ray_ground_blocks[i], m_ray_nonground_blocks[i], ground_msg_modifier,
+              nonground_msg_modifier);
           }
         } catch (const std::runtime_error & e) {
           m_has_failed = true;
@@ -219,6 +245,39 @@ RayGroundClassifierCloudNode::callback(const PointCloud2::SharedPtr msg)
           abort = true;
           has_encountered_unknown_exception = true;
         }
+      } else {
+        // Partition each ray
+        for (size_t i = 0; i < num_ready; i++) {
+          if (abort) {
+            continue;
+          }
+          // Note: if an exception occurs in this loop, the aggregator can get into a bad state
+          // (e.g. overrun capacity)
+          PointPtrBlock ground_blk;
+          PointPtrBlock nonground_blk;
+          try {
+            auto ray = m_aggregator.get_next_ray();
+            // partition: should never fail, guaranteed to have capacity via other checks
+            m_classifier.partition(ray, ground_blk, nonground_blk);
+
+            // Add ray to point clouds
+            push_back_ray(ground_blk, nonground_blk, ground_msg_modifier, nonground_msg_modifier);
+          } catch (const std::runtime_error & e) {
+            m_has_failed = true;
+            RCLCPP_INFO(this->get_logger(), e.what());
+            abort = true;
+          } catch (const std::exception & e) {
+            m_has_failed = true;
+            RCLCPP_INFO(this->get_logger(), e.what());
+            abort = true;
+          } catch (...) {
+            RCLCPP_INFO(
+              this->get_logger(),
+              "RayGroundClassifierCloudNode has encountered an unknown failure");
+            abort = true;
+            has_encountered_unknown_exception = true;
+          }
+        }
       }
     }
 
@@ -235,8 +294,17 @@ RayGroundClassifierCloudNode::callback(const PointCloud2::SharedPtr msg)
     }
 
     // publish: nonground first for the possible microseconds of latency
-    m_nonground_pub_ptr->publish(m_nonground_msg);
-    m_ground_pub_ptr->publish(m_ground_msg);
+    if (m_publish_unique_ptr) {
+      m_nonground_pub_ptr->publish(take_point_cloud(m_nonground_msg));
+      m_ground_pub_ptr->publish(take_point_cloud(m_ground_msg));
+      // The messages were handed over, allocate the next ones after publishing
+      point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>{m_ground_msg}.reserve(m_pcl_size);
+      point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>{
+        m_nonground_msg}.reserve(m_pcl_size);
+    } else {
+      m_nonground_pub_ptr->publish(m_nonground_msg);
+      m_ground_pub_ptr->publish(m_ground_msg);
+    }
   } catch (const std::runtime_error & e) {
     m_has_failed = true;
     RCLCPP_INFO(this->get_logger(), e.what());
@@ -251,6 +319,41 @@ RayGroundClassifierCloudNode::callback(const PointCloud2::SharedPtr msg)
   }
 }
 ////////////////////////////////////////////////////////////////////////////////
+void RayGroundClassifierCloudNode::partition_rays_parallel(const std::size_t num_rays)
+{
+  // Take all ready rays at once, they are sorted by the workers
+  m_ready_rays.clear();
+  for (std::size_t idx = 0U; idx < num_rays; ++idx) {
+    m_ready_rays.push_back(&m_aggregator.get_next_unsorted_ray());
+  }
+  // One output slot per ray, which can hold any partition of a ray
+  while (m_ray_ground_blocks.size() < num_rays) {
+    m_ray_ground_blocks.emplace_back();
+    m_ray_ground_blocks.back().reserve(POINT_BLOCK_CAPACITY);
+    m_ray_nonground_blocks.emplace_back();
+    m_ray_nonground_blocks.back().reserve(POINT_BLOCK_CAPACITY);
+  }
+
+  // Each task owns a classifier and takes rays until none are left
+  std::atomic<std::size_t> next_ray{0U};
+  m_worker_pool->run(
+    m_worker_classifiers.size(), [this, num_rays, &next_ray](const std::size_t task) {
+      auto & classifier = m_worker_classifiers[task];
+      for (std::size_t idx = next_ray.fetch_add(1U); idx < num_rays;
+      idx = next_ray.fetch_add(1U))
+      {
+        auto & ray = *m_ready_rays[idx];
+        auto & ground_blk = m_ray_ground_blocks[idx];
+        auto & nonground_blk = m_ray_nonground_blocks[idx];
+        ground_blk.clear();
+        nonground_blk.clear();
+        // Same sorting as RayAggregator::get_next_ray()
+        std::sort(ray.begin(), ray.end());
+        classifier.partition(ray, ground_blk, nonground_blk);
+      }
+    });
+}
+////////////////////////////////////////////////////////////////////////////////
 void RayGroundClassifierCloudNode::reset()
 {
   // reset aggregator: Needed in case an error is thrown during partitioning of cloud
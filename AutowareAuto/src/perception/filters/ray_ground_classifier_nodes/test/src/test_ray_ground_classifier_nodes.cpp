@@ -22,6 +22,7 @@
 #include <ray_ground_classifier_nodes/ray_ground_classifier_cloud_node.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <string>
+#include <utility>
 #include <vector>
 #include <memory>
 #include <cmath>
@@ -106,15 +107,12 @@ public:
   std::shared_ptr<rclcpp::Publisher<PointCloud2>> m_pub_raw_points;
 };
 
-TEST(RayGroundClassifierPclValidation, FilterTest)
-{
-  rclcpp::init(0, nullptr);
-
-  using autoware::perception::filters::ray_ground_classifier_nodes::RayGroundClassifierCloudNode;
-  std::shared_ptr<RayGroundClassifierCloudNode> ray_gnd_ptr;
-  std::shared_ptr<RayGroundPclValidationTester> ray_gnd_validation_tester;
-  const uint32_t mini_cloud_size = 10U;
+using autoware::perception::filters::ray_ground_classifier_nodes::RayGroundClassifierCloudNode;
 
+namespace
+{
+std::vector<rclcpp::Parameter> make_parameters(const int32_t num_threads)
+{
   const int32_t cloud_size{55000U};
   const char8_t * const frame_id{"base_link"};
 
@@ -126,6 +124,8 @@ TEST(RayGroundClassifierPclValidation, FilterTest)
 
   params.emplace_back("pcl_size", cloud_size);
 
+  params.emplace_back("num_threads", num_threads);
+
   params.emplace_back("classifier.sensor_height_m", 0.0);
   params.emplace_back("classifier.max_local_slope_deg", 20.0);
   params.emplace_back("classifier.max_global_slope_deg", 7.0);
@@ -141,9 +141,53 @@ TEST(RayGroundClassifierPclValidation, FilterTest)
   params.emplace_back("aggregator.max_ray_angle_rad", 3.14159);
   params.emplace_back("aggregator.ray_width_rad", 0.01);
   params.emplace_back("aggregator.max_ray_points", 512);
+  return params;
+}
 
+/// Classify a point cloud with a new node, and return the first ground and nonground clouds
+std::pair<sensor_msgs::msg::PointCloud2, sensor_msgs::msg::PointCloud2> classify(
+  const sensor_msgs::msg::PointCloud2 & cloud, const int32_t num_threads)
+{
   rclcpp::NodeOptions node_options;
-  node_options.parameter_overrides(params);
+  node_options.parameter_overrides(make_parameters(num_threads));
+  const auto ray_gnd_ptr = std::make_shared<RayGroundClassifierCloudNode>(node_options);
+  const auto ray_gnd_validation_tester = std::make_shared<RayGroundPclValidationTester>();
+
+  rclcpp::executors::SingleThreadedExecutor exec;
+  exec.add_node(ray_gnd_ptr->get_node_base_interface());
+  exec.add_node(ray_gnd_validation_tester);
+
+  while (ray_gnd_validation_tester->m_pub_raw_points->get_subscription_count() < 1) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1LL});
+  }
+  ray_gnd_validation_tester->m_pub_raw_points->publish(cloud);
+
+  // Wait up to 5s but return early if we can
+  for (auto iter = 0U; iter < 500U; ++iter) {
+    exec.spin_some();
+    if (!ray_gnd_validation_tester->m_ground_points.empty() &&
+      !ray_gnd_validation_tester->m_nonground_points.empty())
+    {
+      return std::make_pair(
+        ray_gnd_validation_tester->m_ground_points.front(),
+        ray_gnd_validation_tester->m_nonground_points.front());
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return {};
+}
+}  // namespace
+
+TEST(RayGroundClassifierPclValidation, FilterTest)
+{
+  rclcpp::init(0, nullptr);
+
+  std::shared_ptr<RayGroundClassifierCloudNode> ray_gnd_ptr;
+  std::shared_ptr<RayGroundPclValidationTester> ray_gnd_validation_tester;
+  const uint32_t mini_cloud_size = 10U;
+
+  rclcpp::NodeOptions node_options;
+  node_options.parameter_overrides(make_parameters(0));
 
   ray_gnd_ptr = std::make_shared<RayGroundClassifierCloudNode>(node_options);
 
@@ -212,3 +256,37 @@ TEST(RayGroundClassifierPclValidation, FilterTest)
       expected_nongnd_pcl_size, expected_num_received));
   rclcpp::shutdown();
 }
+
+TEST(RayGroundClassifierPclValidation, ParallelMatchesSequential)
+{
+  rclcpp::init(0, nullptr);
+
+  using autoware::common::types::PointXYZI;
+  sensor_msgs::msg::PointCloud2 cloud;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier{cloud, "base_link"};
+  // Rings of ground points over all rays, with an obstacle in front of half of the rays
+  const uint32_t num_angles = 600U;
+  for (uint32_t i = 0U; i < num_angles; i++) {
+    const float32_t angle = (i * autoware::common::types::TAU) / num_angles;
+    const float32_t c = std::cos(angle);
+    const float32_t s = std::sin(angle);
+    for (uint32_t ring = 1U; ring <= 10U; ring++) {
+      const float32_t radius = 1.0F * ring;
+      modifier.push_back(PointXYZI{c * radius, s * radius, 0.0F, 1.0F * ring});
+    }
+    if (0U == (i % 2U)) {
+      for (uint32_t level = 1U; level <= 4U; level++) {
+        modifier.push_back(PointXYZI{c * 5.5F, s * 5.5F, 0.5F * level, 20.0F});
+      }
+    }
+  }
+
+  const auto sequential = classify(cloud, 0);
+  const auto parallel = classify(cloud, 4);
+  ASSERT_FALSE(sequential.first.data.empty());
+  ASSERT_FALSE(sequential.second.data.empty());
+  // Rays are concatenated in the same order, so the clouds are identical
+  EXPECT_EQ(sequential.first.data, parallel.first.data);
+  EXPECT_EQ(sequential.second.data, parallel.second.data);
+  rclcpp::shutdown();
+}
@@ -0,0 +1,339 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief This file defines a voxel grid which downsamples a whole scan at once by sorting points
+///        by voxel index
+
+#ifndef VOXEL_GRID__SORTED_VOXEL_GRID_HPP_
+#define VOXEL_GRID__SORTED_VOXEL_GRID_HPP_
+
+#include <voxel_grid/config.hpp>
+#include <voxel_grid/voxels.hpp>
+#include <common/types.hpp>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using autoware::common::types::bool8_t;
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace voxel_grid
+{
+namespace detail
+{
+/// \brief Buffered points stored as one contiguous array per coordinate. Only point types with
+///        exactly the fields x, y and z are supported by default, so that no field is dropped
+/// \tparam PointT The point type. Assumed to have public float32_t members x, y, and z
+template<typename PointT>
+class PointColumns
+{
+  static_assert(
+    sizeof(PointT) == (3U * sizeof(float32_t)),
+    "PointColumns: point types with fields other than x, y, z need a specialization");
+
+public:
+  void reserve(const std::size_t capacity)
+  {
+    m_x.reserve(capacity);
+    m_y.reserve(capacity);
+    m_z.reserve(capacity);
+  }
+  void push_back(const PointT & pt)
+  {
+    m_x.push_back(pt.x);
+    m_y.push_back(pt.y);
+    m_z.push_back(pt.z);
+  }
+  PointT operator[](const std::size_t idx) const
+  {
+    PointT pt;
+    pt.x = m_x[idx];
+    pt.y = m_y[idx];
+    pt.z = m_z[idx];
+    return pt;
+  }
+  void clear()
+  {
+    m_x.clear();
+    m_y.clear();
+    m_z.clear();
+  }
+  std::size_t size() const
+  {
+    return m_x.size();
+  }
+  bool8_t empty() const
+  {
+    return m_x.empty();
+  }
+
+private:
+  std::vector<float32_t> m_x{};
+  std::vector<float32_t> m_y{};
+  std::vector<float32_t> m_z{};
+};  // class PointColumns
+
+/// \brief Column storage of PointXYZIF, which also carries the intensity and id fields
+template<>
+class PointColumns<autoware::common::types::PointXYZIF>
+{
+public:
+  using PointT = autoware::common::types::PointXYZIF;
+
+  void reserve(const std::size_t capacity)
+  {
+    m_x.reserve(capacity);
+    m_y.reserve(capacity);
+    m_z.reserve(capacity);
+    m_intensity.reserve(capacity);
+    m_id.reserve(capacity);
+  }
+  void push_back(const PointT & pt)
+  {
+    m_x.push_back(pt.x);
+    m_y.push_back(pt.y);
+    m_z.push_back(pt.z);
+    m_intensity.push_back(pt.intensity);
+    m_id.push_back(pt.id);
+  }
+  PointT operator[](const std::size_t idx) const
+  {
+    PointT pt;
+    pt.x = m_x[idx];
+    pt.y = m_y[idx];
+    pt.z = m_z[idx];
+    pt.intensity = m_intensity[idx];
+    pt.id = m_id[idx];
+    return pt;
+  }
+  void clear()
+  {
+    m_x.clear();
+    m_y.clear();
+    m_z.clear();
+    m_intensity.clear();
+    m_id.clear();
+  }
+  std::size_t size() const
+  {
+    return m_x.size();
+  }
+  bool8_t empty() const
+  {
+    return m_x.empty();
+  }
+
+private:
+  std::vector<float32_t> m_x{};
+  std::vector<float32_t> m_y{};
+  std::vector<float32_t> m_z{};
+  std::vector<float32_t> m_intensity{};
+  std::vector<uint16_t> m_id{};
+};  // class PointColumns<PointXYZIF>
+}  // namespace detail
+
+/// \brief A voxel grid that buffers a whole scan, then computes all voxels in one pass.
+///
+/// Voxel indices are computed on insertion and kept in a buffer separate from the points, which
+/// are stored with one contiguous array per field (see detail::PointColumns). The indices are then
+/// sorted with an LSD radix sort, which only moves index/position pairs, and voxels are reduced
+/// over each run of equal indices. Since the radix sort is stable, points are observed by each
+/// voxel in insertion order, so the result is identical to VoxelGrid with the same voxel type.
+/// All buffers are kept across scans and only grow if a scan is larger than any previous one.
+/// \tparam VoxelT The underlying voxel type, assumed to be a child class of Voxel with the
+///                addition of the add_observation(PointT) and configure(Config, uint64_t) methods
+template<typename VoxelT>
+class VOXEL_GRID_PUBLIC SortedVoxelGrid
+{
+public:
+  using point_t = typename VoxelT::point_t;
+
+  /// \brief Constructor
+  /// \param[in] cfg The configuration class. The capacity is the maximum number of voxels, and is
+  ///                also used as the initial number of points preallocated
+  explicit SortedVoxelGrid(const Config & cfg)
+  : m_config(cfg),
+    m_key_bits(key_bits(cfg))
+  {
+    m_keys.reserve(cfg.get_capacity());
+    m_keys_swap.reserve(cfg.get_capacity());
+    m_order.reserve(cfg.get_capacity());
+    m_order_swap.reserve(cfg.get_capacity());
+    m_points.reserve(cfg.get_capacity());
+    m_voxels.reserve(cfg.get_capacity());
+  }
+
+  /// \brief Buffers a point to be downsampled in the next call to get()
+  /// \param[in] pt The point to insert
+  void insert(const point_t & pt)
+  {
+    m_keys.push_back(m_config.index(pt));
+    m_points.push_back(pt);
+  }
+  /// \brief Buffers many points to be downsampled in the next call to get()
+  /// \tparam IT The iterator type
+  /// \param[in] begin The starting iterator
+  /// \param[in] end An iterator pointing one past the last element to be inserted.
+  template<typename IT>
+  void insert(const IT begin, const IT end)
+  {
+    for (IT it = begin; it != end; ++it) {
+      insert(*it);
+    }
+  }
+
+  /// \brief Downsample all buffered points, and reset the buffer for the next scan
+  /// \return The voxel points, ordered by voxel index. Valid until the next call to this method
+  /// \throw std::length_error If the buffered points occupy more voxels than the capacity. The
+  ///                          buffer is reset regardless
+  const std::vector<point_t> & get()
+  {
+    m_voxels.clear();
+    sort();
+    const std::size_t num_points = m_keys.size();
+    std::size_t idx = 0U;
+    while (idx < num_points) {
+      if (m_voxels.size() >= capacity()) {
+        clear();
+        throw std::length_error{"SortedVoxelGrid: points occupy more voxels than capacity"};
+      }
+      const uint64_t key = m_keys[idx];
+      VoxelT vx;
+      //lint -e{523} NOLINT This is to support multiple voxel implementations, see VoxelGrid
+      vx.configure(m_config, key);
+      for (; (idx < num_points) && (key == m_keys[idx]); ++idx) {
+        vx.add_observation(m_points[m_order[idx]]);
+      }
+      m_voxels.push_back(vx.get());
+    }
+    clear();
+    return m_voxels;
+  }
+
+  /// \brief Drops all buffered points
+  void clear()
+  {
+    m_keys.clear();
+    m_points.clear();
+  }
+  /// \brief Returns the number of buffered points
+  std::size_t size() const
+  {
+    return m_points.size();
+  }
+  /// \brief Returns the maximum number of voxels
+  /// \return The preallocated capacity
+  std::size_t capacity() const
+  {
+    return m_config.get_capacity();
+  }
+  /// \brief Whether there are no buffered points
+  /// \return True or false
+  bool8_t empty() const
+  {
+    return m_points.empty();
+  }
+
+private:
+  static constexpr uint32_t RADIX_BITS = 11U;
+  static constexpr uint32_t RADIX_SIZE = 1U << RADIX_BITS;
+
+  /// \brief Number of significant bits of the largest voxel index of a configuration
+  static uint32_t key_bits(const Config & cfg)
+  {
+    // Points are clamped into the receptive field, so the maximum corner has the largest index
+    uint64_t max_key = cfg.index(cfg.get_max_point());
+    uint32_t bits = 0U;
+    while (max_key > 0U) {
+      max_key >>= 1U;
+      ++bits;
+    }
+    return bits;
+  }
+
+  /// \brief Stable LSD radix sort of the keys, carrying the original point positions along
+  void sort()
+  {
+    const std::size_t num_points = m_keys.size();
+    m_order.resize(num_points);
+    for (std::size_t idx = 0U; idx < num_points; ++idx) {
+      m_order[idx] = static_cast<uint32_t>(idx);
+    }
+    m_keys_swap.resize(num_points);
+    m_order_swap.resize(num_points);
+    if (0U == num_points) {
+      return;
+    }
+    for (uint32_t shift = 0U; shift < m_key_bits; shift += RADIX_BITS) {
+      m_histogram.fill(0U);
+      for (const uint64_t key : m_keys) {
+        ++m_histogram[digit(key, shift)];
+      }
+      // Skip passes in which every key has the same digit, common for the upper digits
+      if (m_histogram[digit(m_keys.front(), shift)] == num_points) {
+        continue;
+      }
+      std::size_t offset = 0U;
+      for (auto & count : m_histogram) {
+        const std::size_t tmp = count;
+        count = offset;
+        offset += tmp;
+      }
+      for (std::size_t idx = 0U; idx < num_points; ++idx) {
+        const std::size_t jdx = m_histogram[digit(m_keys[idx], shift)]++;
+        m_keys_swap[jdx] = m_keys[idx];
+        m_order_swap[jdx] = m_order[idx];
+      }
+      std::swap(m_keys, m_keys_swap);
+      std::swap(m_order, m_order_swap);
+    }
+  }
+
+  static std::size_t digit(const uint64_t key, const uint32_t shift)
+  {
+    return static_cast<std::size_t>((key >> shift) & (RADIX_SIZE - 1U));
+  }
+
+  const Config m_config;
+  const uint32_t m_key_bits;
+  // Voxel index of each point, in insertion order until sorted
+  std::vector<uint64_t> m_keys{};
+  std::vector<uint64_t> m_keys_swap{};
+  // Position of each sorted key in the point buffer
+  std::vector<uint32_t> m_order{};
+  std::vector<uint32_t> m_order_swap{};
+  detail::PointColumns<point_t> m_points{};
+  std::vector<point_t> m_voxels{};
+  std::array<std::size_t, RADIX_SIZE> m_histogram{};
+};  // class SortedVoxelGrid
+
+template<typename VoxelT>
+constexpr uint32_t SortedVoxelGrid<VoxelT>::RADIX_BITS;
+template<typename VoxelT>
+constexpr uint32_t SortedVoxelGrid<VoxelT>::RADIX_SIZE;
+
+}  // namespace voxel_grid
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // VOXEL_GRID__SORTED_VOXEL_GRID_HPP_
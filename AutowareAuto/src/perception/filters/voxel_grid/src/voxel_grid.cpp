@@ -16,6 +16,7 @@
 
 #include "common/types.hpp"
 #include "voxel_grid/voxel_grid.hpp"
+#include "voxel_grid/sorted_voxel_grid.hpp"
 
 namespace autoware
 {
@@ -31,6 +32,10 @@ template class VoxelGrid<ApproximateVoxel<PointXYZ>>;
 template class VoxelGrid<ApproximateVoxel<autoware::common::types::PointXYZIF>>;
 template class VoxelGrid<CentroidVoxel<PointXYZ>>;
 template class VoxelGrid<CentroidVoxel<autoware::common::types::PointXYZIF>>;
+template class SortedVoxelGrid<ApproximateVoxel<PointXYZ>>;
+template class SortedVoxelGrid<ApproximateVoxel<autoware::common::types::PointXYZIF>>;
+template class SortedVoxelGrid<CentroidVoxel<PointXYZ>>;
+template class SortedVoxelGrid<CentroidVoxel<autoware::common::types::PointXYZIF>>;
 }  // namespace voxel_grid
 }  // namespace filters
 }  // namespace perception
@@ -19,8 +19,12 @@
 
 #include <common/types.hpp>
 #include <memory>
+#include <algorithm>
 #include <limits>
+#include <utility>
+#include <vector>
 #include "voxel_grid/voxel_grid.hpp"
+#include "voxel_grid/sorted_voxel_grid.hpp"
 
 using autoware::perception::filters::voxel_grid::PointXYZ;
 using autoware::perception::filters::voxel_grid::Config;
@@ -28,6 +32,7 @@ using autoware::perception::filters::voxel_grid::Voxel;
 using autoware::perception::filters::voxel_grid::ApproximateVoxel;
 using autoware::perception::filters::voxel_grid::CentroidVoxel;
 using autoware::perception::filters::voxel_grid::VoxelGrid;
+using autoware::perception::filters::voxel_grid::SortedVoxelGrid;
 using autoware::perception::filters::voxel_grid::PointXYZIF;
 using autoware::common::types::bool8_t;
 using autoware::common::types::float32_t;
@@ -762,4 +767,106 @@ TYPED_TEST(TypedVoxelGridTest, approximate_voxel_grid)
   EXPECT_THROW(grid.insert(*(this->obs_points1.end() - 1)), std::length_error);
   EXPECT_THROW(grid.insert(*(this->obs_points1.end() - 2)), std::length_error);
 }
+
+/// sorted voxel grid produces the same voxels as the hashed voxel grid
+template<typename VoxelT>
+void check_sorted_voxel_grid(const Config & cfg, const std::vector<PointXYZIF> & points)
+{
+  VoxelGrid<VoxelT> grid{cfg};
+  SortedVoxelGrid<VoxelT> sorted_grid{cfg};
+  EXPECT_TRUE(sorted_grid.empty());
+  // Run twice to make sure buffers are reset between scans
+  for (std::size_t scan = 0U; scan < 2U; ++scan) {
+    grid.clear();
+    grid.insert(points.begin(), points.end());
+    sorted_grid.insert(points.begin(), points.end());
+    EXPECT_EQ(sorted_grid.size(), points.size());
+    const auto & voxels = sorted_grid.get();
+    EXPECT_TRUE(sorted_grid.empty());
+    ASSERT_EQ(voxels.size(), grid.size());
+    // Voxels are ordered by index, so compare against the hashed voxels sorted by index
+    std::vector<std::pair<uint64_t, PointXYZIF>> expected;
+    for (const auto & it : grid) {
+      expected.emplace_back(it.first, it.second.get());
+    }
+    std::sort(
+      expected.begin(), expected.end(), [](const auto & lhs, const auto & rhs) {
+        return lhs.first < rhs.first;
+      });
+    for (std::size_t idx = 0U; idx < voxels.size(); ++idx) {
+      // Exactly the same result as the incremental update
+      EXPECT_EQ(voxels[idx].x, expected[idx].second.x);
+      EXPECT_EQ(voxels[idx].y, expected[idx].second.y);
+      EXPECT_EQ(voxels[idx].z, expected[idx].second.z);
+      EXPECT_EQ(voxels[idx].intensity, expected[idx].second.intensity);
+    }
+  }
+}
+
+TEST(SortedVoxelGrid, SameAsVoxelGrid)
+{
+  PointXYZ min_point;
+  min_point.x = -50.0F;
+  min_point.y = -50.0F;
+  min_point.z = -3.0F;
+  PointXYZ max_point;
+  max_point.x = 50.0F;
+  max_point.y = 50.0F;
+  max_point.z = 3.0F;
+  PointXYZ voxel_size;
+  voxel_size.x = 0.5F;
+  voxel_size.y = 0.5F;
+  voxel_size.z = 0.5F;
+  const Config cfg{min_point, max_point, voxel_size, 10000U};
+  // Deterministic pseudo-random scan, including points outside the receptive field
+  std::vector<PointXYZIF> points;
+  uint32_t state = 12345U;
+  const auto next = [&state](const float32_t scale) {
+      state = (state * 1103515245U) + 12345U;
+      return (static_cast<float32_t>((state >> 8U) & 0xFFFFU) / 65535.0F - 0.5F) * scale;
+    };
+  for (std::size_t idx = 0U; idx < 5000U; ++idx) {
+    PointXYZIF pt;
+    pt.x = next(30.0F);
+    pt.y = next(30.0F);
+    pt.z = next(8.0F);
+    pt.intensity = next(100.0F);
+    points.push_back(pt);
+  }
+  check_sorted_voxel_grid<CentroidVoxel<PointXYZIF>>(cfg, points);
+  check_sorted_voxel_grid<ApproximateVoxel<PointXYZIF>>(cfg, points);
+}
+
+TEST(SortedVoxelGrid, Capacity)
+{
+  PointXYZ min_point;
+  min_point.x = -1.0F;
+  min_point.y = -1.0F;
+  min_point.z = -1.0F;
+  PointXYZ max_point;
+  max_point.x = 1.0F;
+  max_point.y = 1.0F;
+  max_point.z = 1.0F;
+  PointXYZ voxel_size;
+  voxel_size.x = 1.0F;
+  voxel_size.y = 1.0F;
+  voxel_size.z = 1.0F;
+  SortedVoxelGrid<CentroidVoxel<PointXYZ>> grid{Config{min_point, max_point, voxel_size, 2U}};
+  EXPECT_TRUE(grid.get().empty());
+  PointXYZ pt;
+  pt.x = -0.5F;
+  grid.insert(pt);
+  pt.x = 0.5F;
+  grid.insert(pt);
+  grid.insert(pt);
+  EXPECT_EQ(grid.get().size(), 2U);
+  pt.y = 0.5F;
+  grid.insert(pt);
+  pt.y = -0.5F;
+  grid.insert(pt);
+  pt.x = -0.5F;
+  grid.insert(pt);
+  EXPECT_THROW(grid.get(), std::length_error);
+  EXPECT_TRUE(grid.empty());
+}
 #endif  // TEST_VOXEL_GRID_HPP_
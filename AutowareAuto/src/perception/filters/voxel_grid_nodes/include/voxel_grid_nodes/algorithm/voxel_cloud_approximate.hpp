@@ -48,6 +48,10 @@ public:
   /// \return The downsampled point cloud
   const sensor_msgs::msg::PointCloud2 & get() override;
 
+  /// \brief Same as get(), but the downsampled points are moved into a new message
+  /// \return The downsampled point cloud
+  std::unique_ptr<sensor_msgs::msg::PointCloud2> take() override;
+
 private:
   sensor_msgs::msg::PointCloud2 m_cloud;
   voxel_grid::VoxelGrid<voxel_grid::ApproximateVoxel<PointXYZIF>> m_grid;
@@ -23,6 +23,7 @@
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <voxel_grid/voxel_grid.hpp>
 #include <voxel_grid_nodes/visibility_control.hpp>
+#include <memory>
 #include <string>
 
 namespace autoware
@@ -53,6 +54,12 @@ public:
   /// \return The downsampled point cloud
   virtual const sensor_msgs::msg::PointCloud2 & get() = 0;
 
+  /// \brief Same as get(), but the downsampled points are moved into a new message instead of
+  ///        being kept in an internal buffer, so that they can be published as a
+  ///        std::unique_ptr without a copy
+  /// \return The downsampled point cloud
+  virtual std::unique_ptr<sensor_msgs::msg::PointCloud2> take() = 0;
+
 protected:
   using PointXYZIF = autoware::perception::filters::voxel_grid::PointXYZIF;
 };  // VoxelCloudBase
@@ -0,0 +1,70 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VOXEL_GRID_NODES__ALGORITHM__VOXEL_CLOUD_SORTED_HPP_
+#define VOXEL_GRID_NODES__ALGORITHM__VOXEL_CLOUD_SORTED_HPP_
+
+#include <voxel_grid/sorted_voxel_grid.hpp>
+#include <voxel_grid_nodes/algorithm/voxel_cloud_base.hpp>
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace voxel_grid_nodes
+{
+namespace algorithm
+{
+/// \brief Downsamples each cloud with a SortedVoxelGrid, gives the same points as the hashed
+///        algorithm with the same voxel type, ordered by voxel index
+/// \tparam VoxelT The voxel type, instantiated for the centroid and approximate voxels
+template<typename VoxelT>
+class VOXEL_GRID_NODES_PUBLIC VoxelCloudSorted : public VoxelCloudBase
+{
+public:
+  /// \brief Constructor
+  /// \param[in] cfg Configuration struct for the voxel grid
+  explicit VoxelCloudSorted(const voxel_grid::Config & cfg);
+
+  /// \brief Inserts points into the voxel grid data structure, overwrites internal header
+  /// \param[in] msg A point cloud to insert into the voxel grid. Assumed to have the structure XYZI
+  void insert(const sensor_msgs::msg::PointCloud2 & msg) override;
+
+  /// \brief Get accumulated downsampled points. Internally resets the internal grid. Header is
+  ///        taken from last insert
+  /// \return The downsampled point cloud
+  const sensor_msgs::msg::PointCloud2 & get() override;
+
+  /// \brief Same as get(), but the downsampled points are moved into a new message
+  /// \return The downsampled point cloud
+  std::unique_ptr<sensor_msgs::msg::PointCloud2> take() override;
+
+private:
+  sensor_msgs::msg::PointCloud2 m_cloud;
+  voxel_grid::SortedVoxelGrid<VoxelT> m_grid;
+};  // VoxelCloudSorted
+
+using VoxelCloudCentroidSorted =
+  VoxelCloudSorted<voxel_grid::CentroidVoxel<voxel_grid::PointXYZIF>>;
+using VoxelCloudApproximateSorted =
+  VoxelCloudSorted<voxel_grid::ApproximateVoxel<voxel_grid::PointXYZIF>>;
+}  // namespace algorithm
+}  // namespace voxel_grid_nodes
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // VOXEL_GRID_NODES__ALGORITHM__VOXEL_CLOUD_SORTED_HPP_
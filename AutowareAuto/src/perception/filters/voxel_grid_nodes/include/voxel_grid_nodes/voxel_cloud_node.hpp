@@ -50,13 +50,16 @@ public:
     const rclcpp::NodeOptions & node_options);
 
   /// \brief Core run loop
-  void callback(const sensor_msgs::msg::PointCloud2::SharedPtr msg);
+  void callback(const sensor_msgs::msg::PointCloud2::ConstSharedPtr msg);
 
 private:
   /// \brief Initialize state transition callbacks and voxel grid
   /// \param[in] cfg Configuration object for voxel grid
   /// \param[in] is_approximate whether to instantiate an approximate or centroid voxel grid
-  void VOXEL_GRID_NODES_LOCAL init(const voxel_grid::Config & cfg, const bool8_t is_approximate);
+  /// \param[in] is_sorted whether to use the radix sorted voxel grid instead of the hashed one
+  void VOXEL_GRID_NODES_LOCAL init(
+    const voxel_grid::Config & cfg, const bool8_t is_approximate,
+    const bool8_t is_sorted);
 
   using Message = sensor_msgs::msg::PointCloud2;
 
@@ -64,6 +67,9 @@ private:
   const std::shared_ptr<rclcpp::Publisher<Message>> m_pub_ptr;
   std::unique_ptr<algorithm::VoxelCloudBase> m_voxelgrid_ptr;
   bool8_t m_has_failed;
+  // Publish the downsampled points as a std::unique_ptr, so that they are not copied when
+  // intra-process communication is used
+  bool8_t m_publish_unique_ptr;
 };  // VoxelCloudNode
 }  // namespace voxel_grid_nodes
 }  // namespace filters
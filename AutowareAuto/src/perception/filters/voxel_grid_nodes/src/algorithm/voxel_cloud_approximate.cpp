@@ -94,6 +94,13 @@ const sensor_msgs::msg::PointCloud2 & VoxelCloudApproximate::get()
 
   return m_cloud;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+std::unique_ptr<sensor_msgs::msg::PointCloud2> VoxelCloudApproximate::take()
+{
+  (void)get();
+  return autoware::common::lidar_utils::take_point_cloud(m_cloud);
+}
 }  // namespace algorithm
 }  // namespace voxel_grid_nodes
 }  // namespace filters
@@ -20,6 +20,7 @@
 #include <voxel_grid_nodes/voxel_cloud_node.hpp>
 #include <voxel_grid_nodes/algorithm/voxel_cloud_approximate.hpp>
 #include <voxel_grid_nodes/algorithm/voxel_cloud_centroid.hpp>
+#include <voxel_grid_nodes/algorithm/voxel_cloud_sorted.hpp>
 #include <common/types.hpp>
 #include <rclcpp_components/register_node_macro.hpp>
 
@@ -66,7 +67,8 @@ VoxelCloudNode::VoxelCloudNode(
         )
       )
     )},
-  m_has_failed{false}
+  m_has_failed{false},
+  m_publish_unique_ptr{node_options.use_intra_process_comms()}
 {
   // Build config manually (messages only have default constructors)
   voxel_grid::PointXYZ min_point;
@@ -85,15 +87,21 @@ VoxelCloudNode::VoxelCloudNode(
     static_cast<std::size_t>(declare_parameter("config.capacity").get<std::size_t>());
   const voxel_grid::Config cfg{min_point, max_point, voxel_size, capacity};
   // Init
-  init(cfg, declare_parameter("is_approximate").get<bool8_t>());
+  init(
+    cfg, declare_parameter("is_approximate").get<bool8_t>(),
+    declare_parameter("is_sorted", false));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void VoxelCloudNode::callback(const sensor_msgs::msg::PointCloud2::SharedPtr msg)
+void VoxelCloudNode::callback(const sensor_msgs::msg::PointCloud2::ConstSharedPtr msg)
 {
   try {
     m_voxelgrid_ptr->insert(*msg);
-    m_pub_ptr->publish(m_voxelgrid_ptr->get());
+    if (m_publish_unique_ptr) {
+      m_pub_ptr->publish(m_voxelgrid_ptr->take());
+    } else {
+      m_pub_ptr->publish(m_voxelgrid_ptr->get());
+    }
   } catch (const std::exception & e) {
     std::string err_msg{get_name()};
     err_msg += ": " + std::string(e.what());
@@ -107,10 +115,18 @@ void VoxelCloudNode::callback(const sensor_msgs::msg::PointCloud2::SharedPtr msg
   }
 }
 ////////////////////////////////////////////////////////////////////////////////
-void VoxelCloudNode::init(const voxel_grid::Config & cfg, const bool8_t is_approximate)
+void VoxelCloudNode::init(
+  const voxel_grid::Config & cfg, const bool8_t is_approximate,
+  const bool8_t is_sorted)
 {
   // construct voxel grid
-  if (is_approximate) {
+  if (is_sorted) {
+    if (is_approximate) {
+      m_voxelgrid_ptr = std::make_unique<algorithm::VoxelCloudApproximateSorted>(cfg);
+    } else {
+      m_voxelgrid_ptr = std::make_unique<algorithm::VoxelCloudCentroidSorted>(cfg);
+    }
+  } else if (is_approximate) {
     m_voxelgrid_ptr = std::make_unique<algorithm::VoxelCloudApproximate>(cfg);
   } else {
     m_voxelgrid_ptr = std::make_unique<algorithm::VoxelCloudCentroid>(cfg);
@@ -19,6 +19,7 @@
 #include <rclcpp/rclcpp.hpp>
 #include <voxel_grid_nodes/algorithm/voxel_cloud_approximate.hpp>
 #include <voxel_grid_nodes/algorithm/voxel_cloud_centroid.hpp>
+#include <voxel_grid_nodes/algorithm/voxel_cloud_sorted.hpp>
 #include <voxel_grid_nodes/voxel_cloud_node.hpp>
 
 #include <gtest/gtest.h>
@@ -32,6 +33,8 @@ using autoware::perception::filters::voxel_grid::Config;
 using autoware::perception::filters::voxel_grid_nodes::algorithm::VoxelCloudBase;
 using autoware::perception::filters::voxel_grid_nodes::algorithm::VoxelCloudApproximate;
 using autoware::perception::filters::voxel_grid_nodes::algorithm::VoxelCloudCentroid;
+using autoware::perception::filters::voxel_grid_nodes::algorithm::VoxelCloudApproximateSorted;
+using autoware::perception::filters::voxel_grid_nodes::algorithm::VoxelCloudCentroidSorted;
 using autoware::perception::filters::voxel_grid::PointXYZIF;
 
 using autoware::common::types::bool8_t;
@@ -201,6 +204,81 @@ TEST_F(CloudAlgorithm, Centroid)
   EXPECT_EQ(alg_ptr->get().width, 0U);
 }
 
+TEST_F(CloudAlgorithm, ApproximateSorted)
+{
+  this->ref_points1[0U] = this->make(-0.5F, -0.5F, -0.5F);
+  this->ref_points1[1U] = this->make(0.5F, -0.5F, -0.5F);
+  this->ref_points1[2U] = this->make(-0.5F, 0.5F, -0.5F);
+  this->ref_points1[3U] = this->make(0.5F, 0.5F, -0.5F);
+  this->ref_points1[4U] = this->make(-0.5F, -0.5F, 0.5F);
+  this->ref_points1[5U] = this->make(0.5F, -0.5F, 0.5F);
+  this->ref_points1[6U] = this->make(-0.5F, 0.5F, 0.5F);
+  this->ref_points1[7U] = this->make(0.5F, 0.5F, 0.5F);
+  alg_ptr = std::make_unique<VoxelCloudApproximateSorted>(*cfg_ptr);
+  EXPECT_EQ(alg_ptr->get().width, 0U);
+  alg_ptr->insert(cloud1);
+  EXPECT_EQ(alg_ptr->get().width, 4U);
+  alg_ptr->insert(cloud1);
+  EXPECT_TRUE(check(alg_ptr->get(), 4U));
+  EXPECT_EQ(alg_ptr->get().width, 0U);
+  alg_ptr->insert(cloud1);
+  alg_ptr->insert(cloud2);
+  const auto & cloud = alg_ptr->get();
+  EXPECT_EQ(cloud.width, ref_points1.size());
+  EXPECT_TRUE(check(cloud, ref_points1.size()));
+  EXPECT_EQ(alg_ptr->get().width, 0U);
+}
+
+TEST_F(CloudAlgorithm, CentroidSorted)
+{
+  this->ref_points1[0U] = this->make(-0.75F, -0.75F, -0.75F);
+  this->ref_points1[1U] = this->make(0.75F, -0.75F, -0.75F);
+  this->ref_points1[2U] = this->make(-0.75F, 0.75F, -0.75F);
+  this->ref_points1[3U] = this->make(0.75F, 0.75F, -0.75F);
+  this->ref_points1[4U] = this->make(-0.75F, -0.75F, 0.75F);
+  this->ref_points1[5U] = this->make(0.75F, -0.75F, 0.75F);
+  this->ref_points1[6U] = this->make(-0.75F, 0.75F, 0.75F);
+  this->ref_points1[7U] = this->make(0.75F, 0.75F, 0.75F);
+  alg_ptr = std::make_unique<VoxelCloudCentroidSorted>(*cfg_ptr);
+  EXPECT_EQ(alg_ptr->get().width, 0U);
+  alg_ptr->insert(cloud1);
+  EXPECT_TRUE(check(alg_ptr->get(), 4U));
+  EXPECT_EQ(alg_ptr->get().width, 0U);
+  alg_ptr->insert(cloud1);
+  alg_ptr->insert(cloud2);
+  const auto & cloud = alg_ptr->get();
+  EXPECT_EQ(cloud.width, ref_points1.size());
+  EXPECT_TRUE(check(cloud, ref_points1.size()));
+  EXPECT_EQ(alg_ptr->get().width, 0U);
+}
+
+TEST_F(CloudAlgorithm, Take)
+{
+  this->ref_points1[0U] = this->make(-0.75F, -0.75F, -0.75F);
+  this->ref_points1[1U] = this->make(0.75F, -0.75F, -0.75F);
+  this->ref_points1[2U] = this->make(-0.75F, 0.75F, -0.75F);
+  this->ref_points1[3U] = this->make(0.75F, 0.75F, -0.75F);
+  this->ref_points1[4U] = this->make(-0.75F, -0.75F, 0.75F);
+  this->ref_points1[5U] = this->make(0.75F, -0.75F, 0.75F);
+  this->ref_points1[6U] = this->make(-0.75F, 0.75F, 0.75F);
+  this->ref_points1[7U] = this->make(0.75F, 0.75F, 0.75F);
+  alg_ptr = std::make_unique<VoxelCloudCentroid>(*cfg_ptr);
+  alg_ptr->insert(cloud1);
+  const auto taken = alg_ptr->take();
+  ASSERT_NE(taken, nullptr);
+  EXPECT_EQ(taken->width, 4U);
+  EXPECT_TRUE(check(*taken, 4U));
+  EXPECT_EQ(alg_ptr->get().width, 0U);
+  // The algorithm keeps working after the points were taken
+  alg_ptr->insert(cloud1);
+  alg_ptr->insert(cloud2);
+  const auto & cloud = alg_ptr->get();
+  EXPECT_EQ(cloud.width, ref_points1.size());
+  EXPECT_TRUE(check(cloud, ref_points1.size()));
+  // The points of the taken message are not touched
+  EXPECT_EQ(taken->width, 4U);
+}
+
 TEST(VoxelGridNodes, Instantiate)
 {
   // Basic test to ensure that VoxelCloudNode can be instantiated
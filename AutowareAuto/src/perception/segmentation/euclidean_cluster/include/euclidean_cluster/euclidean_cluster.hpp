@@ -25,6 +25,9 @@
 #include <geometry/spatial_hash.hpp>
 #include <euclidean_cluster/visibility_control.hpp>
 #include <common/types.hpp>
+#include <helper_functions/worker_pool.hpp>
+#include <atomic>
+#include <memory>
 #include <string>
 #include <vector>
 #include <utility>
@@ -104,19 +107,25 @@ public:
   ///                                    r = cluster_threshold_saturation_distance
   /// \param[in] cluster_threshold_saturation_distance_m The distance at which the cluster threshold
   ///                                                    is clamped to the maximum value
+  /// \param[in] num_threads The number of threads used by the parallel connected components mode.
+  ///                        0 selects the sequential region growing mode
   Config(
     const std::string & frame_id,
     const std::size_t min_cluster_size,
     const std::size_t max_num_clusters,
     const float32_t min_cluster_threshold_m,
     const float32_t max_cluster_threshold_m,
-    const float32_t cluster_threshold_saturation_distance_m);
+    const float32_t cluster_threshold_saturation_distance_m,
+    const std::size_t num_threads = 0U);
   /// \brief Gets minimum number of points needed for a cluster to not be considered noise
   /// \return Minimum cluster size
   std::size_t min_cluster_size() const;
   /// \brief Gets maximum preallocated number of clusters
   /// \return Maximum number of clusters
   std::size_t max_num_clusters() const;
+  /// \brief Gets the number of threads of the parallel connected components mode
+  /// \return Number of threads, 0 if the sequential mode is used
+  std::size_t num_threads() const;
   /// \brief Compute the connectivity threshold for a given point
   /// \param[in] pt The point whose connectivity criterion will be calculated
   /// \return The connectivity threshold, in meters
@@ -140,6 +149,7 @@ private:
   const float32_t m_min_thresh_m;
   const float32_t m_max_distance_m;
   const float32_t m_thresh_rate;
+  const std::size_t m_num_threads;
 };  // class Config
 
 /// \brief implementation of euclidean clustering for point cloud segmentation
@@ -147,6 +157,12 @@ private:
 /// according to euclidean distance. This can be thought of as a graph-based
 /// approach where points are vertices and edges are defined by euclidean distance
 /// The input to this should be nonground points pased through a voxel grid.
+///
+/// Two modes are available. The sequential mode grows one cluster at a time by removing near
+/// neighbors from the spatial hash. The parallel mode builds connected components over all points
+/// with a lock-free union-find, splitting the occupied bins across a pool of threads. In the
+/// parallel mode, clusters are ordered by the first inserted point they contain, and points within
+/// a cluster keep their insertion order, so the result does not depend on the number of threads.
 class EUCLIDEAN_CLUSTER_PUBLIC EuclideanCluster
 {
 public:
@@ -172,7 +188,7 @@ public:
   template<typename IT>
   void insert(const IT begin, const IT end)
   {
-    if ((static_cast<std::size_t>(std::distance(begin, end)) + m_hash.size()) > m_hash.capacity()) {
+    if ((static_cast<std::size_t>(std::distance(begin, end)) + size()) > m_hash.capacity()) {
       throw std::length_error{"EuclideanCluster: Multi insert would overrun capacity"};
     }
     for (auto it = begin; it != end; ++it) {
@@ -206,8 +222,24 @@ private:
     float32_t x = 0.0f;
     float32_t y = 0.0f;
   };  // struct PointXYZ
+  /// \brief Point and its bin, sorted by bin so that the points of a bin are contiguous
+  struct BinEntry
+  {
+    common::geometry::spatial_hash::Index bin;
+    std::size_t idx;
+  };  // struct BinEntry
+  /// \brief Number of points currently inserted in either mode
+  std::size_t size() const;
   /// \brief Do the clustering process, with no error checking
   EUCLIDEAN_CLUSTER_LOCAL void cluster_impl(Clusters & clusters);
+  /// \brief Do the clustering process as parallel connected components, with no error checking
+  EUCLIDEAN_CLUSTER_LOCAL void cluster_parallel(Clusters & clusters);
+  /// \brief Union all connected pairs of points whose first point lies in the given bin entries
+  EUCLIDEAN_CLUSTER_LOCAL void connect(const std::size_t begin, const std::size_t end);
+  /// \brief Find the root of a point in the union-find forest, with path halving
+  EUCLIDEAN_CLUSTER_LOCAL std::size_t find_root(std::size_t idx);
+  /// \brief Merge the components of two points, the root is always the smallest point index
+  EUCLIDEAN_CLUSTER_LOCAL void unite(std::size_t idx, std::size_t jdx);
   /// \brief Compute the next cluster, seeded by the given point, and grown using the remaining
   ///         points still contained in the hash
   EUCLIDEAN_CLUSTER_LOCAL void cluster(Clusters & clusters, const Hash::IT it);
@@ -223,9 +255,16 @@ private:
   EUCLIDEAN_CLUSTER_LOCAL static std::size_t last_cluster_size(const Clusters & clusters);
 
   const Config m_config;
+  const HashConfig m_hash_config;
   Hash m_hash;
   Error m_last_error;
   std::vector<bool8_t> m_seen;
+  // Parallel mode state, all preallocated to the hash capacity
+  std::unique_ptr<common::helper_functions::WorkerPool> m_pool;
+  std::vector<PointXYZIR> m_points;
+  std::vector<BinEntry> m_bins;
+  std::vector<std::atomic<std::size_t>> m_parent;
+  std::vector<std::size_t> m_cluster_offset;
 };  // class EuclideanCluster
 
 /// \brief Common euclidean cluster functions not intended for external use
@@ -249,6 +288,18 @@ enum class BboxMethod
 EUCLIDEAN_CLUSTER_PUBLIC
 BoundingBoxArray compute_bounding_boxes(
   Clusters & clusters, const BboxMethod method, const bool compute_height);
+/// \brief Compute bounding boxes from clusters, where the clusters are boxed in parallel. The
+///        boxes are the same and in the same order as with the sequential version
+/// \param[in] method Whether to use the eigenboxes or L-Fit algorithm.
+/// \param[in] compute_height Compute the height of the bounding box as well.
+/// \param[inout] clusters A set of clusters for which to compute the bounding boxes. Individual
+///                        clusters may get their points shuffled.
+/// \param[in] pool Worker pool whose threads box the clusters, one cluster per task
+/// \returns Bounding boxes
+EUCLIDEAN_CLUSTER_PUBLIC
+BoundingBoxArray compute_bounding_boxes(
+  Clusters & clusters, const BboxMethod method, const bool compute_height,
+  common::helper_functions::WorkerPool & pool);
 /// \brief Convert this bounding box to a DetectedObjects message
 /// \param[in] boxes A bounding box array
 /// \returns A DetectedObjects message with the bounding boxes inside
@@ -17,6 +17,7 @@
 #include <cstring>
 //lint -e537 NOLINT Repeated include file: pclint vs cpplint
 #include <algorithm>
+#include <limits>
 #include <string>
 //lint -e537 NOLINT Repeated include file: pclint vs cpplint
 #include <utility>
@@ -82,14 +83,16 @@ Config::Config(
   const std::size_t max_num_clusters,
   const float32_t min_cluster_threshold_m,
   const float32_t max_cluster_threshold_m,
-  const float32_t cluster_threshold_saturation_distance_m)
+  const float32_t cluster_threshold_saturation_distance_m,
+  const std::size_t num_threads)
 : m_frame_id(frame_id),
   m_min_cluster_size(min_cluster_size),
   m_max_num_clusters(max_num_clusters),
   m_min_thresh_m(min_cluster_threshold_m),
   m_max_distance_m(cluster_threshold_saturation_distance_m),
   m_thresh_rate((max_cluster_threshold_m - min_cluster_threshold_m) /
-    cluster_threshold_saturation_distance_m)
+    cluster_threshold_saturation_distance_m),
+  m_num_threads(num_threads)
 {
   // TODO(c.ho) sanity checking
 }
@@ -104,6 +107,11 @@ std::size_t Config::max_num_clusters() const
   return m_max_num_clusters;
 }
 ////////////////////////////////////////////////////////////////////////////////
+std::size_t Config::num_threads() const
+{
+  return m_num_threads;
+}
+////////////////////////////////////////////////////////////////////////////////
 float32_t Config::threshold(const PointXYZIR & pt) const
 {
   return threshold(pt.get_r());
@@ -122,9 +130,22 @@ const std::string & Config::frame_id() const
 ////////////////////////////////////////////////////////////////////////////////
 EuclideanCluster::EuclideanCluster(const Config & cfg, const HashConfig & hash_cfg)
 : m_config(cfg),
+  m_hash_config(hash_cfg),
   m_hash(hash_cfg),
-  m_last_error(Error::NONE)
-{}
+  m_last_error(Error::NONE),
+  m_pool(),
+  m_points(),
+  m_bins(),
+  m_parent((cfg.num_threads() > 0U) ? hash_cfg.get_capacity() : 0U),
+  m_cluster_offset()
+{
+  if (cfg.num_threads() > 0U) {
+    m_pool = std::make_unique<common::helper_functions::WorkerPool>(cfg.num_threads());
+    m_points.reserve(hash_cfg.get_capacity());
+    m_bins.reserve(hash_cfg.get_capacity());
+    m_cluster_offset.resize(hash_cfg.get_capacity());
+  }
+}
 ////////////////////////////////////////////////////////////////////////////////
 bool Config::match_clusters_size(const Clusters & clusters) const
 {
@@ -140,8 +161,20 @@ bool Config::match_clusters_size(const Clusters & clusters) const
 ////////////////////////////////////////////////////////////////////////////////
 void EuclideanCluster::insert(const PointXYZIR & pt)
 {
-  // can't do anything with return values
-  (void)m_hash.insert(pt);
+  if (m_pool) {
+    if (m_points.size() >= m_hash.capacity()) {
+      throw std::length_error{"EuclideanCluster: Cannot insert past capacity"};
+    }
+    m_points.push_back(pt);
+  } else {
+    // can't do anything with return values
+    (void)m_hash.insert(pt);
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+std::size_t EuclideanCluster::size() const
+{
+  return m_pool ? m_points.size() : m_hash.size();
 }
 ////////////////////////////////////////////////////////////////////////////////
 void EuclideanCluster::cluster(Clusters & clusters)
@@ -149,7 +182,11 @@ void EuclideanCluster::cluster(Clusters & clusters)
   // Clean the previous clustering result
   clusters.points.clear();
   clusters.cluster_boundary.clear();
-  cluster_impl(clusters);
+  if (m_pool) {
+    cluster_parallel(clusters);
+  } else {
+    cluster_impl(clusters);
+  }
 }
 ////////////////////////////////////////////////////////////////////////////////
 void EuclideanCluster::throw_stored_error() const
@@ -200,7 +237,7 @@ void EuclideanCluster::cluster(Clusters & clusters, const Hash::IT it)
       clusters.cluster_boundary.emplace_back(clusters.cluster_boundary.back());
     }
     // Seed cluster with new point
-    add_point_to_last_cluster(clusters, it->second);
+    add_point_to_last_cluster(clusters, *it);
     // Erase returns the element after the removed element but it is not useful here
     (void)m_hash.erase(it);
     // Start clustering process
@@ -243,6 +280,164 @@ void EuclideanCluster::add_neighbors_to_last_cluster(
   }
 }
 ////////////////////////////////////////////////////////////////////////////////
+void EuclideanCluster::cluster_parallel(Clusters & clusters)
+{
+  m_last_error = Error::NONE;
+  const std::size_t num_points = m_points.size();
+  // Enough tasks per thread to balance uneven point densities
+  const std::size_t num_tasks = std::min(num_points, m_pool->size() * 4U);
+  const auto task_range = [num_points, num_tasks](const std::size_t task) {
+      return std::make_pair(
+        (task * num_points) / num_tasks, ((task + 1U) * num_points) / num_tasks);
+    };
+  // Bin every point and reset the union-find forest
+  m_bins.resize(num_points);
+  m_pool->run(
+    num_tasks, [this, &task_range](const std::size_t task) {
+      const auto range = task_range(task);
+      for (std::size_t idx = range.first; idx < range.second; ++idx) {
+        const auto & pt = m_points[idx].get_point();
+        m_bins[idx] = BinEntry{m_hash_config.bin(pt.x, pt.y, pt.z), idx};
+        m_parent[idx].store(idx);
+      }
+    });
+  // Make the points of each bin contiguous; ties are broken by index so the order is unique
+  std::sort(
+    m_bins.begin(), m_bins.end(), [](const BinEntry & lhs, const BinEntry & rhs) {
+      return (lhs.bin < rhs.bin) || ((lhs.bin == rhs.bin) && (lhs.idx < rhs.idx));
+    });
+  // Connect points, with every task owning a contiguous set of whole bins
+  m_pool->run(
+    num_tasks, [this, &task_range](const std::size_t task) {
+      const auto range = task_range(task);
+      const auto bin_start = [this](std::size_t bdx) {
+          while ((bdx > 0U) && (bdx < m_bins.size()) && (m_bins[bdx - 1U].bin == m_bins[bdx].bin)) {
+            ++bdx;
+          }
+          return bdx;
+        };
+      const std::size_t begin = bin_start(range.first);
+      connect(begin, std::max(begin, bin_start(range.second)));
+    });
+  // Flatten the forest so that every point points to its root
+  m_pool->run(
+    num_tasks, [this, &task_range](const std::size_t task) {
+      const auto range = task_range(task);
+      for (std::size_t idx = range.first; idx < range.second; ++idx) {
+        m_parent[idx].store(find_root(idx));
+      }
+    });
+  // Count component sizes at the root, i.e. the smallest point index of each component
+  std::fill(
+    m_cluster_offset.begin(), m_cluster_offset.begin() + static_cast<std::ptrdiff_t>(num_points),
+    0U);
+  for (std::size_t idx = 0U; idx < num_points; ++idx) {
+    ++m_cluster_offset[m_parent[idx].load()];
+  }
+  // Assign clusters in root order, turning sizes into output offsets
+  constexpr std::size_t REJECTED = std::numeric_limits<std::size_t>::max();
+  std::size_t num_cluster_points = 0U;
+  for (std::size_t idx = 0U; idx < num_points; ++idx) {
+    if (m_parent[idx].load() == idx) {
+      const std::size_t cluster_size = m_cluster_offset[idx];
+      if (cluster_size < m_config.min_cluster_size()) {
+        m_cluster_offset[idx] = REJECTED;
+      } else if (clusters.cluster_boundary.size() >= m_config.max_num_clusters()) {
+        m_last_error = Error::TOO_MANY_CLUSTERS;
+        m_cluster_offset[idx] = REJECTED;
+      } else {
+        m_cluster_offset[idx] = num_cluster_points;
+        num_cluster_points += cluster_size;
+        clusters.cluster_boundary.emplace_back(num_cluster_points);
+      }
+    }
+  }
+  // Scatter points into their clusters in insertion order
+  clusters.points.resize(num_cluster_points);
+  for (std::size_t idx = 0U; idx < num_points; ++idx) {
+    std::size_t & offset = m_cluster_offset[m_parent[idx].load()];
+    if (REJECTED != offset) {
+      clusters.points[offset] = static_cast<autoware_auto_msgs::msg::PointXYZIF>(m_points[idx]);
+      ++offset;
+    }
+  }
+  // Points are consumed by clustering, same as in the sequential mode
+  m_points.clear();
+}
+////////////////////////////////////////////////////////////////////////////////
+void EuclideanCluster::connect(const std::size_t begin, const std::size_t end)
+{
+  using common::geometry::spatial_hash::details::BinRange;
+  using common::geometry::spatial_hash::details::Index3;
+  for (std::size_t bdx = begin; bdx < end; ++bdx) {
+    const std::size_t idx = m_bins[bdx].idx;
+    const PointXYZIR & pt = m_points[idx];
+    const float32_t x = pt.get_point().x;
+    const float32_t y = pt.get_point().y;
+    const float32_t thresh1 = m_config.threshold(pt);
+    const Index3 ref_bin = m_hash_config.index3(x, y, pt.get_point().z);
+    const BinRange bin_range = m_hash_config.bin_range(ref_bin, thresh1);
+    Index3 query_bin = bin_range.first;
+    do {
+      if (m_hash_config.is_candidate_bin(ref_bin, query_bin, thresh1 * thresh1)) {
+        const auto key = m_hash_config.index(query_bin);
+        auto it = std::lower_bound(
+          m_bins.begin(), m_bins.end(), key, [](const BinEntry & entry, const decltype(key) bin) {
+            return entry.bin < bin;
+          });
+        for (; (it != m_bins.end()) && (it->bin == key); ++it) {
+          // Every pair is considered from both sides, only handle it from the smaller index
+          const std::size_t jdx = it->idx;
+          if (jdx > idx) {
+            const PointXYZIR & qt = m_points[jdx];
+            const float32_t dist2 = m_hash_config.distance_squared(x, y, 0.0F, qt);
+            // Threshold must be satisfied bidirectionally, same as the sequential mode
+            const float32_t thresh = std::min(thresh1, m_config.threshold(qt));
+            if (dist2 <= (thresh * thresh)) {
+              unite(idx, jdx);
+            }
+          }
+        }
+      }
+    } while (m_hash_config.next_bin(bin_range, query_bin));
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+std::size_t EuclideanCluster::find_root(std::size_t idx)
+{
+  std::size_t parent = m_parent[idx].load();
+  while (parent != idx) {
+    // Path halving: point to the grandparent. Losing the race is harmless, it only skips a
+    // shortcut
+    std::size_t grandparent = m_parent[parent].load();
+    (void)m_parent[idx].compare_exchange_weak(parent, grandparent);
+    idx = grandparent;
+    parent = m_parent[idx].load();
+  }
+  return idx;
+}
+////////////////////////////////////////////////////////////////////////////////
+void EuclideanCluster::unite(std::size_t idx, std::size_t jdx)
+{
+  while (true) {
+    idx = find_root(idx);
+    jdx = find_root(jdx);
+    if (idx == jdx) {
+      return;
+    }
+    // Link the larger root below the smaller one, so every root is the smallest index of its
+    // component regardless of the order in which threads merge
+    if (idx < jdx) {
+      std::swap(idx, jdx);
+    }
+    std::size_t expected = idx;
+    if (m_parent[idx].compare_exchange_strong(expected, jdx)) {
+      return;
+    }
+    // idx stopped being a root in the meantime, retry from the new roots
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
 void EuclideanCluster::add_point_to_last_cluster(Clusters & clusters, const PointXYZIR & pt)
 {
   // If there are non-valid points in the container due to rejecting small clusters,
@@ -282,39 +477,84 @@ std::size_t EuclideanCluster::last_cluster_size(const Clusters & clusters)
 ////////////////////////////////////////////////////////////////////////////////
 namespace details
 {
+namespace
+{
+// Box a single cluster, return false if the cluster is empty or could not be boxed
+bool8_t compute_bounding_box(
+  Clusters & clusters, const std::size_t cls_id, const BboxMethod method,
+  const bool compute_height, BoundingBox & box)
+{
+  try {
+    const auto iter_pair = common::lidar_utils::get_cluster(clusters, cls_id);
+    if (iter_pair.first == iter_pair.second) {
+      return false;
+    }
+
+    switch (method) {
+      case BboxMethod::Eigenbox: box =
+          common::geometry::bounding_box::eigenbox_2d(
+          iter_pair.first,
+          iter_pair.second);
+        break;
+      case BboxMethod::LFit:     box =
+          common::geometry::bounding_box::lfit_bounding_box_2d(
+          iter_pair.first,
+          iter_pair.second);
+        break;
+    }
+
+    if (compute_height) {
+      common::geometry::bounding_box::compute_height(iter_pair.first, iter_pair.second, box);
+    }
+  } catch (const std::exception & e) {
+    std::cerr << e.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
 BoundingBoxArray compute_bounding_boxes(
   Clusters & clusters, const BboxMethod method,
   const bool compute_height)
 {
   BoundingBoxArray boxes;
+  boxes.boxes.reserve(clusters.cluster_boundary.size());
+  BoundingBox box;
   for (uint32_t cls_id = 0U; cls_id < clusters.cluster_boundary.size(); cls_id++) {
-    try {
-      const auto iter_pair = common::lidar_utils::get_cluster(clusters, cls_id);
-      if (iter_pair.first == iter_pair.second) {
-        continue;
-      }
-
-      switch (method) {
-        case BboxMethod::Eigenbox: boxes.boxes.push_back(
-            common::geometry::bounding_box::eigenbox_2d(
-              iter_pair.first,
-              iter_pair.second));
-          break;
-        case BboxMethod::LFit:     boxes.boxes.push_back(
-            common::geometry::bounding_box::lfit_bounding_box_2d(
-              iter_pair.first,
-              iter_pair.second));
-          break;
-      }
-
-      if (compute_height) {
-        common::geometry::bounding_box::compute_height(
-          iter_pair.first, iter_pair.second, boxes.boxes.back());
+    if (compute_bounding_box(clusters, cls_id, method, compute_height, box)) {
+      boxes.boxes.push_back(box);
+    }
+  }
+  return boxes;
+}
+////////////////////////////////////////////////////////////////////////////////
+BoundingBoxArray compute_bounding_boxes(
+  Clusters & clusters, const BboxMethod method,
+  const bool compute_height, common::helper_functions::WorkerPool & pool)
+{
+  const std::size_t num_clusters = clusters.cluster_boundary.size();
+  BoundingBoxArray boxes;
+  boxes.boxes.resize(num_clusters);
+  // Not std::vector<bool> since each task writes its own flag
+  std::vector<uint8_t> is_valid(num_clusters, 0U);
+  // The clusters own disjoint ranges of points, so each one can be boxed independently
+  pool.run(
+    num_clusters, [&clusters, &boxes, &is_valid, method, compute_height](const std::size_t cls_id) {
+      is_valid[cls_id] = compute_bounding_box(
+        clusters, cls_id, method, compute_height, boxes.boxes[cls_id]) ? 1U : 0U;
+    });
+  // Drop the empty clusters while keeping the order of the sequential version
+  std::size_t num_boxes = 0U;
+  for (std::size_t cls_id = 0U; cls_id < num_clusters; ++cls_id) {
+    if (0U != is_valid[cls_id]) {
+      if (num_boxes != cls_id) {
+        boxes.boxes[num_boxes] = boxes.boxes[cls_id];
       }
-    } catch (const std::exception & e) {
-      std::cerr << e.what() << std::endl;
+      ++num_boxes;
     }
   }
+  boxes.boxes.resize(num_boxes);
   return boxes;
 }
 ////////////////////////////////////////////////////////////////////////////////
@@ -202,5 +202,32 @@ TEST_F(BoundingBoxComputationTest, BasicEigen3d)
   }
 }
 
+// Boxing the clusters in parallel gives the same boxes in the same order, empty clusters are
+// dropped in both versions
+TEST_F(BoundingBoxComputationTest, Parallel)
+{
+  std::vector<std::vector<Pt>> points_list;
+  for (uint32_t cls_id = 0U; cls_id < 64U; ++cls_id) {
+    if ((cls_id % 7U) == 3U) {
+      points_list.emplace_back();
+      continue;
+    }
+    auto points = pt_vector;
+    for (auto & pt : points) {
+      pt.x += static_cast<float>(cls_id);
+      pt.z = static_cast<float>(cls_id % 5U);
+    }
+    points_list.push_back(points);
+  }
+  autoware::common::helper_functions::WorkerPool pool{4U};
+  for (const auto method : {BboxMethod::LFit, BboxMethod::Eigenbox}) {
+    auto clusters = make_clusters(points_list);
+    const BoundingBoxArray expected = compute_bounding_boxes(clusters, method, true);
+    clusters = make_clusters(points_list);
+    const BoundingBoxArray boxes_msg = compute_bounding_boxes(clusters, method, true, pool);
+    ASSERT_EQ(boxes_msg.boxes.size(), 55U);
+    ASSERT_EQ(boxes_msg.boxes, expected.boxes);
+  }
+}
 
 #endif   // TEST_BOUNDING_BOX_COMPUTATION_HPP_
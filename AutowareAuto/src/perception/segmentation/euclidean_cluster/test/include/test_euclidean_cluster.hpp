@@ -154,4 +154,64 @@ TEST(EuclideanCluster, NoCluster)
   EXPECT_EQ(res.cluster_boundary.size(), 0U);
   EXPECT_EQ(cls.get_error(), EuclideanCluster::Error::NONE);
 }
+
+/// parallel mode finds the same clusters, in the same order for any number of threads
+TEST(EuclideanCluster, Parallel)
+{
+  HashConfig hcfg{-130.0F, 130.0F, -130.0F, 130.0F, 1.0F, 10000U};
+  std::vector<Clusters> results;
+  for (const std::size_t num_threads : {1U, 2U, 4U}) {
+    Config cfg{"bar", 10U, 100U, 1.0F, 1.0F, 10.0F, num_threads};
+    EuclideanCluster cls{cfg, hcfg};
+    Clusters res;
+    std::vector<std::pair<float, float>> output1;
+    std::vector<std::pair<float, float>> output2;
+    std::vector<std::pair<float, float>> output3;
+    std::vector<std::pair<float, float>> empty;
+    insert_line(output1, cls, 11.0F, 16.0F, 16.0F, 21.0F, 0.9F);
+    insert_ring(cls, 70.0F, 30U);  // noise ring
+    insert_line(output1, cls, 5.0F, 20.0F, 11.0F, 16.0F, 0.9F);
+    insert_line(output2, cls, 5.0F, 10.0F, 0.0F, 5.0F, 0.3F);
+    insert_mesh(output3, cls, -10.0F, -10.0F, -20.0F, -20.0F, 0.5F, 0.5F);
+    insert_mesh(empty, cls, 30.0F, 30.0F, 40.0F, 40.0F, 2.0F, 2.0F);  // noise
+    cls.cluster(res);
+    ASSERT_EQ(res.cluster_boundary.size(), 3U);
+    // Clusters come in order of their first inserted point
+    EXPECT_TRUE(check_cluster(res, 0U, output1));
+    EXPECT_TRUE(check_cluster(res, 1U, output2));
+    EXPECT_TRUE(check_cluster(res, 2U, output3));
+    EXPECT_EQ(res.points.size(), output1.size() + output2.size() + output3.size());
+    EXPECT_EQ(cls.get_error(), EuclideanCluster::Error::NONE);
+    results.push_back(res);
+
+    // points are consumed by clustering
+    insert_point(cls, 0.0F, 0.0F);
+    cls.cluster(res);
+    EXPECT_EQ(res.cluster_boundary.size(), 0U);
+  }
+  for (const auto & res : results) {
+    ASSERT_EQ(res.points.size(), results.front().points.size());
+    EXPECT_EQ(res.cluster_boundary, results.front().cluster_boundary);
+    for (std::size_t idx = 0U; idx < res.points.size(); ++idx) {
+      EXPECT_EQ(res.points[idx].x, results.front().points[idx].x);
+      EXPECT_EQ(res.points[idx].y, results.front().points[idx].y);
+    }
+  }
+}
+
+/// parallel mode respects the maximum number of clusters
+TEST(EuclideanCluster, ParallelTooManyClusters)
+{
+  Config cfg{"bar", 1U, 2U, 1.0F, 1.0F, 10.0F, 2U};
+  HashConfig hcfg{-130.0F, 130.0F, -130.0F, 130.0F, 1.0F, 10000U};
+  EuclideanCluster cls{cfg, hcfg};
+  Clusters res;
+  insert_point(cls, 0.0F, 0.0F);
+  insert_point(cls, 10.0F, 0.0F);
+  insert_point(cls, 20.0F, 0.0F);
+  cls.cluster(res);
+  EXPECT_EQ(res.cluster_boundary.size(), 2U);
+  EXPECT_EQ(cls.get_error(), EuclideanCluster::Error::TOO_MANY_CLUSTERS);
+  EXPECT_THROW(cls.throw_stored_error(), std::runtime_error);
+}
 #endif  // TEST_EUCLIDEAN_CLUSTER_HPP_
@@ -90,6 +90,8 @@ private:
   std::unique_ptr<VoxelAlgorithm> m_voxel_ptr;
   const bool8_t m_use_lfit;
   const bool8_t m_use_z;
+  // Boxes the clusters in parallel, only created if more than one thread is configured
+  std::unique_ptr<common::helper_functions::WorkerPool> m_box_pool;
 };  // class EuclideanClusterNode
 }  // namespace euclidean_cluster_nodes
 }  // namespace segmentation
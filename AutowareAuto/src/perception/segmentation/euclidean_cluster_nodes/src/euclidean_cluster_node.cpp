@@ -27,6 +27,7 @@
 #include <rclcpp/rclcpp.hpp>
 
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <utility>
 
@@ -44,6 +45,19 @@ namespace segmentation
 {
 namespace euclidean_cluster_nodes
 {
+namespace
+{
+/// \brief Declare an optional thread count parameter, which defaults to 0
+/// \throw std::domain_error If the thread count is negative
+std::size_t declare_num_threads(rclcpp::Node & node, const std::string & name)
+{
+  const auto num_threads = node.declare_parameter(name, 0);
+  if (num_threads < 0) {
+    throw std::domain_error{"EuclideanClusterNode: " + name + " must not be negative"};
+  }
+  return static_cast<std::size_t>(num_threads);
+}
+}  // namespace
 ////////////////////////////////////////////////////////////////////////////////
 EuclideanClusterNode::EuclideanClusterNode(
   const rclcpp::NodeOptions & node_options)
@@ -76,7 +90,8 @@ m_cluster_alg{
     static_cast<float32_t>(declare_parameter("cluster.min_cluster_threshold_m").get<float32_t>()),
     static_cast<float32_t>(declare_parameter("cluster.max_cluster_threshold_m").get<float32_t>()),
     static_cast<float32_t>(declare_parameter("cluster.threshold_saturation_distance_m")
-    .get<float32_t>())
+    .get<float32_t>()),
+    declare_num_threads(*this, "cluster.num_threads")
   },
   euclidean_cluster::HashConfig{
     static_cast<float32_t>(declare_parameter("hash.min_x").get<float32_t>()),
@@ -90,12 +105,17 @@ m_cluster_alg{
 m_clusters{},
 m_voxel_ptr{nullptr},  // Because voxel config's Point types don't accept positional arguments
 m_use_lfit{declare_parameter("use_lfit").get<bool8_t>()},
-m_use_z{declare_parameter("use_z").get<bool8_t>()}
+m_use_z{declare_parameter("use_z").get<bool8_t>()},
+m_box_pool{}
 {
   // Sanity check
   if ((!m_detected_objects_pub_ptr) && (!m_box_pub_ptr) && (!m_cluster_pub_ptr)) {
     throw std::domain_error{"EuclideanClusterNode: No publisher topics provided"};
   }
+  const auto box_num_threads = declare_num_threads(*this, "box_num_threads");
+  if (box_num_threads > 1U) {
+    m_box_pool = std::make_unique<common::helper_functions::WorkerPool>(box_num_threads);
+  }
   // Initialize voxel grid
   if (declare_parameter("downsample").get<bool8_t>()) {
     filters::voxel_grid::PointXYZ min_point;
@@ -184,12 +204,12 @@ void EuclideanClusterNode::handle_clusters(
   }
 
   BoundingBoxArray boxes;
-  if (m_use_lfit) {
-    boxes = euclidean_cluster::details::compute_bounding_boxes(clusters, BboxMethod::LFit, m_use_z);
-  } else {
+  const auto method = m_use_lfit ? BboxMethod::LFit : BboxMethod::Eigenbox;
+  if (m_box_pool) {
     boxes = euclidean_cluster::details::compute_bounding_boxes(
-      clusters, BboxMethod::Eigenbox,
-      m_use_z);
+      clusters, method, m_use_z, *m_box_pool);
+  } else {
+    boxes = euclidean_cluster::details::compute_bounding_boxes(clusters, method, m_use_z);
   }
   boxes.header.stamp = header.stamp;
   boxes.header.frame_id = header.frame_id;
@@ -18,12 +18,15 @@
 
 #include <autoware_auto_msgs/msg/detected_objects.hpp>
 #include <common/types.hpp>
+#include <helper_functions/worker_pool.hpp>
 #include <hungarian_assigner/hungarian_assigner.hpp>
+#include <hungarian_assigner/jv_assigner.hpp>
 #include <tracking/tracked_object.hpp>
 #include <tracking/tracker_types.hpp>
 
 #include <experimental/optional>
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace autoware
@@ -35,6 +38,16 @@ namespace tracking
 
 using assigner_idx_t = autoware::fusion::hungarian_assigner::index_t;
 
+/// \brief Algorithm used to solve the assignment of detections to tracks
+enum class AssignerType
+{
+  /// Hungarian algorithm on dense weights, for up to MAX_NUM_TRACKS tracks and detections
+  Hungarian,
+  /// Jonker-Volgenant algorithm on the gated weights only, for up to MAX_NUM_TRACKS_JV tracks and
+  /// detections
+  JonkerVolgenant
+};
+
 /// \brief Class to create configuration parameters for data association
 class TRACKING_PUBLIC DataAssociationConfig
 {
@@ -47,9 +60,14 @@ public:
   /// \param consider_edge_for_big_detections When true, the shortest edge of the detection will
   ///                                         be used as the max distance threshold if it is
   ///                                         greater than the configured threshold
+  /// \param assigner_type Algorithm used to solve the assignment
+  /// \param num_threads Number of threads which compute the weights of the gated pairs. 0 or 1
+  ///                    computes them on the calling thread only
   DataAssociationConfig(
     const float32_t max_distance, const float32_t max_area_ratio,
-    const bool consider_edge_for_big_detections);
+    const bool consider_edge_for_big_detections,
+    const AssignerType assigner_type = AssignerType::Hungarian,
+    const std::size_t num_threads = 0U);
 
   inline float32_t get_max_distance() const {return m_max_distance;}
 
@@ -61,20 +79,28 @@ public:
 
   inline bool consider_edge_for_big_detections() const {return m_consider_edge_for_big_detections;}
 
+  inline AssignerType get_assigner_type() const {return m_assigner_type;}
+
+  inline std::size_t get_num_threads() const {return m_num_threads;}
+
 private:
   float32_t m_max_distance;
   float32_t m_max_distance_squared;
   float32_t m_max_area_ratio;
   float32_t m_max_area_ratio_inv;
   bool m_consider_edge_for_big_detections;
+  AssignerType m_assigner_type;
+  std::size_t m_num_threads;
 };
 
 /// \brief Class to perform data association between existing tracks and new detections using
-///        mahalanobis distance and hungarian assigner
+///        mahalanobis distance and the hungarian or Jonker-Volgenant assigner. Only the pairs whose
+///        track lies in the grid cells around a detection are checked against the gates
 class TRACKING_PUBLIC DetectedObjectAssociator
 {
 public:
   using Assigner = autoware::fusion::hungarian_assigner::hungarian_assigner_c<MAX_NUM_TRACKS>;
+  using JvAssigner = autoware::fusion::hungarian_assigner::jv_assigner_c;
   /// \brief Constructor
   /// \param association_cfg Config object containing parameters to be used
   explicit DetectedObjectAssociator(const DataAssociationConfig & association_cfg);
@@ -90,27 +116,92 @@ private:
   /// \brief Reset internal states of the associator
   void reset();
 
-  /// \brief Loop through all detections and tracks and set weights between them in the assigner
+  /// \brief Set the weights of all gated pairs of detections and tracks in the assigner
   void compute_weights(
     const autoware_auto_msgs::msg::DetectedObjects & detections, const TrackedObjects & tracks);
 
-  /// \brief Check if the given track and detection are similar enough to compute weight
-  bool consider_associating(
-    const autoware_auto_msgs::msg::DetectedObject & detection, const TrackedObject & track) const;
+  /// \brief Compute the gating data of the detections, i.e. centroid, area and distance threshold
+  void prepare_detections(const autoware_auto_msgs::msg::DetectedObjects & detections);
+
+  /// \brief Compute the gating data and inverse covariance of the tracks, and sort them into a
+  ///        grid of their centroids
+  void prepare_tracks(const TrackedObjects & tracks);
+
+  /// \brief Compute the weights of the tracks gated with a detection, in increasing track order.
+  ///        Weights which the assigner does not accept are left out and counted
+  void compute_detection_weights(const std::size_t det_idx);
 
   /// Set weight in the assigner (Has to determine which idx is row and which is column)
   void set_weight(const float32_t weight, const size_t det_idx, const size_t track_idx);
 
+  /// \brief Get the assignment of a row from the configured assigner
+  assigner_idx_t get_assignment(const size_t row_idx) const;
+
   /// \brief Extract result from the assigner and populate the AssociatorResult container
   AssociatorResult extract_result() const;
 
   DataAssociationConfig m_association_cfg;
-  Assigner m_assigner;
-  // Hungarian assigner expects a fat matrix (not tall). Bool tracks if tracks are rows or cols
+  // Only the configured assigner is created. The hungarian assigner is kept in place, as Eigen
+  // must not allocate its matrices
+  std::experimental::optional<Assigner> m_assigner;
+  std::experimental::optional<JvAssigner> m_jv_assigner;
+  // Hungarian assigner expects a fat matrix (not tall). Bool tracks if tracks are rows or cols.
+  // The Jonker-Volgenant assigner takes any shape, but is faster with fewer rows
   bool m_are_tracks_rows;
   size_t m_num_tracks;
   size_t m_num_detections;
   bool m_had_errors = false;
+
+  /// \brief Track gated with a detection
+  struct GatedTrack
+  {
+    std::size_t track_idx;
+    float32_t weight;
+  };
+  // Gating data of the detections, the distance threshold is negative for invalid detections
+  std::vector<float32_t> m_det_x;
+  std::vector<float32_t> m_det_y;
+  std::vector<float32_t> m_det_area;
+  std::vector<float32_t> m_det_max_distance_squared;
+  // Gated tracks and squared distance scratch of each detection, the capacity is kept across calls
+  std::vector<std::vector<GatedTrack>> m_det_gated_tracks;
+  std::vector<std::vector<float32_t>> m_det_scratch;
+  // Number of gated pairs of each detection whose weight was not finite or too big
+  std::vector<std::size_t> m_det_num_invalid_weights;
+  /// \brief Gating data of a valid track
+  struct TrackGating
+  {
+    std::size_t track_idx;
+    float32_t x;
+    float32_t y;
+    float32_t area;
+    float32_t inv_cov_00;
+    float32_t inv_cov_01;
+    float32_t inv_cov_10;
+    float32_t inv_cov_11;
+  };
+  std::vector<TrackGating> m_track_staging;
+  // Gating data of the valid tracks, sorted by grid cell in row major order. Structure of arrays so
+  // that the tracks of consecutive cells can be checked against a detection in a vectorized loop
+  std::vector<std::size_t> m_track_idx;
+  std::vector<float32_t> m_track_x;
+  std::vector<float32_t> m_track_y;
+  std::vector<float32_t> m_track_area;
+  // Inverse of the position covariance, row major
+  std::vector<float32_t> m_track_inv_cov_00;
+  std::vector<float32_t> m_track_inv_cov_01;
+  std::vector<float32_t> m_track_inv_cov_10;
+  std::vector<float32_t> m_track_inv_cov_11;
+  // Grid of the track centroids, the tracks of cell i are [m_cell_offsets[i], m_cell_offsets[i+1])
+  std::vector<std::size_t> m_cell_offsets;
+  std::vector<std::size_t> m_cell_cursors;
+  float32_t m_grid_min_x = 0.0F;
+  float32_t m_grid_min_y = 0.0F;
+  float32_t m_grid_cell_size = 1.0F;
+  std::size_t m_grid_num_cols = 0U;
+  std::size_t m_grid_num_rows = 0U;
+  // Only created if more than one thread is configured
+  std::unique_ptr<common::helper_functions::WorkerPool> m_pool;
 };
 
 
@@ -23,6 +23,7 @@
 
 #include <tracking/detected_object_associator.hpp>
 #include <tracking/greedy_roi_associator.hpp>
+#include <tracking/track_batch_predictor.hpp>
 #include <tracking/track_creator.hpp>
 #include <tracking/tracked_object.hpp>
 #include <tracking/visibility_control.hpp>
@@ -103,6 +104,9 @@ struct TRACKING_PUBLIC MultiObjectTrackerOptions
   std::size_t pruning_ticks_threshold = std::numeric_limits<std::size_t>::max();
   /// The frame in which to do tracking.
   std::string frame = "map";
+  /// Number of threads over which the prediction of the tracks is split, 0 or 1 predicts them on
+  /// the calling thread only.
+  std::size_t prediction_num_threads = 0U;
 };
 
 /// \brief A class for multi-object tracking.
@@ -155,6 +159,9 @@ private:
   /// Configuration values.
   MultiObjectTrackerOptions m_options;
 
+  /// Predictor for extrapolating all tracks forward.
+  TrackBatchPredictor m_track_predictor;
+
   /// Associator for matching observations to tracks.
   DetectedObjectAssociator m_object_associator;
 
@@ -0,0 +1,89 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief This file defines the batched prediction of all tracks.
+
+#ifndef TRACKING__TRACK_BATCH_PREDICTOR_HPP_
+#define TRACKING__TRACK_BATCH_PREDICTOR_HPP_
+
+#include <common/types.hpp>
+#include <helper_functions/worker_pool.hpp>
+#include <tracking/tracked_object.hpp>
+#include <tracking/visibility_control.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace autoware
+{
+namespace perception
+{
+namespace tracking
+{
+
+/// \brief Predicts all tracks forward in one batch. The filter states and covariances of the tracks
+///        are kept in a structure of arrays with one contiguous array per entry, so that each step
+///        of the constant acceleration prediction is a loop over all tracks which the compiler
+///        vectorizes. The result is the same as calling TrackedObject::predict() on every track,
+///        up to floating point rounding.
+class TRACKING_PUBLIC TrackBatchPredictor
+{
+public:
+  /// \brief Constructor
+  /// \param num_threads Number of threads over which the tracks are split. 0 or 1 predicts them
+  ///                    on the calling thread only
+  explicit TrackBatchPredictor(const std::size_t num_threads = 0U);
+
+  /// \brief Extrapolate all tracks forward
+  /// \param[inout] tracks The tracks to predict
+  /// \param[in] dt Time to extrapolate by
+  void predict(std::vector<TrackedObject> & tracks, const std::chrono::nanoseconds dt);
+
+private:
+  using float64_t = common::types::float64_t;
+
+  /// Predict the tracks [first, last), which includes copying them from and back to the tracks
+  void predict_range(
+    std::vector<TrackedObject> & tracks, const std::size_t first, const std::size_t last,
+    const float64_t dt_s);
+
+  /// Pointer to the first track of an entry of the state vector
+  float64_t * state(const std::size_t entry) {return &m_state[entry * m_capacity];}
+  /// Pointer to the first track of an entry of the covariance matrix, row major
+  float64_t * covariance(const std::size_t row, const std::size_t col)
+  {
+    return &m_covariance[((row * NUM_STATES) + col) * m_capacity];
+  }
+
+  static constexpr std::size_t NUM_STATES = 6U;
+  // Number of tracks each array has room for
+  std::size_t m_capacity = 0U;
+  // NUM_STATES arrays of m_capacity entries, in the order of the state vector
+  std::vector<float64_t> m_state;
+  // NUM_STATES * NUM_STATES arrays of m_capacity entries, row major
+  std::vector<float64_t> m_covariance;
+  // Acceleration noise of each track
+  std::vector<float64_t> m_noise_variance;
+  // Only created if more than one thread is configured
+  std::unique_ptr<common::helper_functions::WorkerPool> m_pool;
+};
+
+}  // namespace tracking
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // TRACKING__TRACK_BATCH_PREDICTOR_HPP_
@@ -44,6 +44,8 @@ namespace perception
 namespace tracking
 {
 
+class TrackBatchPredictor;
+
 /// \brief Internal class containing the object state and other information.
 class TRACKING_PUBLIC TrackedObject
 {
@@ -121,8 +123,13 @@ private:
   /// All variables will initially have this variance where the detection
   /// does not contain one.
   common::types::float64_t m_default_variance = -1.0;
+  /// The sigma for the acceleration noise.
+  common::types::float64_t m_noise_variance = -1.0;
   /// Track class classifier.
   ClassificationTracker m_classifier;
+  /// Predicts the filter state of all tracks in a batch.
+  friend class TrackBatchPredictor;
+
   public:
   /// Unfiltered orientation used to track objects
   geometry_msgs::msg::Quaternion unfiltered_orientation;
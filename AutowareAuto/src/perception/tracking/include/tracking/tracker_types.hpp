@@ -34,6 +34,9 @@ namespace tracking
 /// \brief Maximum number of tracks possible in every timestep
 constexpr uint16_t MAX_NUM_TRACKS = 256U;
 
+/// \brief Maximum number of tracks possible in every timestep with the Jonker-Volgenant assigner
+constexpr uint16_t MAX_NUM_TRACKS_JV = 4096U;
+
 /// \brief Number of dimensions needed to represent object position for tracking (x and y)
 constexpr uint16_t NUM_OBJ_POSE_DIM = 2U;
 
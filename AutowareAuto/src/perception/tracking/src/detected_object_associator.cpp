@@ -18,10 +18,15 @@
 
 #include <common/types.hpp>
 #include <geometry/common_2d.hpp>
-#include <helper_functions/mahalanobis_distance.hpp>
+#include <helper_functions/float_comparisons.hpp>
+
+#include <Eigen/Cholesky>
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
+#include <numeric>
+#include <stdexcept>
 #include <vector>
 
 namespace autoware
@@ -40,13 +45,27 @@ constexpr std::size_t AssociatorResult::UNASSIGNED;
 DataAssociationConfig::DataAssociationConfig(
   const float32_t max_distance,
   const float32_t max_area_ratio,
-  const bool consider_edge_for_big_detections)
+  const bool consider_edge_for_big_detections,
+  const AssignerType assigner_type,
+  const std::size_t num_threads)
 : m_max_distance(max_distance), m_max_distance_squared(max_distance * max_distance),
   m_max_area_ratio(max_area_ratio), m_max_area_ratio_inv(1.F / max_area_ratio),
-  m_consider_edge_for_big_detections(consider_edge_for_big_detections) {}
+  m_consider_edge_for_big_detections(consider_edge_for_big_detections),
+  m_assigner_type(assigner_type), m_num_threads(num_threads) {}
 
 DetectedObjectAssociator::DetectedObjectAssociator(const DataAssociationConfig & association_cfg)
-: m_association_cfg(association_cfg) {}
+: m_association_cfg(association_cfg)
+{
+  if (association_cfg.get_assigner_type() == AssignerType::JonkerVolgenant) {
+    m_jv_assigner.emplace(MAX_NUM_TRACKS_JV, MAX_NUM_TRACKS_JV);
+  } else {
+    m_assigner.emplace();
+  }
+  if (association_cfg.get_num_threads() > 1U) {
+    m_pool = std::make_unique<common::helper_functions::WorkerPool>(
+      association_cfg.get_num_threads());
+  }
+}
 
 AssociatorResult DetectedObjectAssociator::assign(
   const autoware_auto_msgs::msg::DetectedObjects & detections,
@@ -60,26 +79,31 @@ AssociatorResult DetectedObjectAssociator::assign(
   m_num_detections = detections.objects.size();
   m_num_tracks = tracks.objects.size();
   m_are_tracks_rows = (m_num_tracks <= m_num_detections);
-  if (m_are_tracks_rows) {
-    m_assigner.set_size(
-      static_cast<assigner_idx_t>(tracks.objects.size()),
-      static_cast<assigner_idx_t>(detections.objects.size()));
+  const auto num_rows = static_cast<assigner_idx_t>(std::min(m_num_tracks, m_num_detections));
+  const auto num_cols = static_cast<assigner_idx_t>(std::max(m_num_tracks, m_num_detections));
+  if (m_association_cfg.get_assigner_type() == AssignerType::JonkerVolgenant) {
+    m_jv_assigner->set_size(num_rows, num_cols);
+    compute_weights(detections, tracks);
+    // Rows without an assignment are UNASSIGNED, which is handled in extract_result()
+    (void)m_jv_assigner->assign();
   } else {
-    m_assigner.set_size(
-      static_cast<assigner_idx_t>(detections.objects.size()),
-      static_cast<assigner_idx_t>(tracks.objects.size()));
+    m_assigner->set_size(num_rows, num_cols);
+    compute_weights(detections, tracks);
+    // TODO(gowtham.ranganathan): Revisit this after #979 since till then assigner will always
+    //  return true
+    (void)m_assigner->assign();
   }
-  compute_weights(detections, tracks);
-  // TODO(gowtham.ranganathan): Revisit this after #979 since till then assigner will always
-  //  return true
-  (void)m_assigner.assign();
 
   return extract_result();
 }
 
 void DetectedObjectAssociator::reset()
 {
-  m_assigner.reset();
+  if (m_association_cfg.get_assigner_type() == AssignerType::JonkerVolgenant) {
+    m_jv_assigner->reset();
+  } else {
+    m_assigner->reset();
+  }
 
   m_num_tracks = 0U;
   m_num_detections = 0U;
@@ -91,111 +115,283 @@ void DetectedObjectAssociator::compute_weights(
   const autoware_auto_msgs::msg::DetectedObjects & detections,
   const TrackedObjects & tracks)
 {
-  for (size_t det_idx = 0U; det_idx < detections.objects.size(); ++det_idx) {
-    for (size_t track_idx = 0U; track_idx < tracks.objects.size(); ++track_idx) {
-      const auto & track = tracks.objects[track_idx];
-      const auto & detection = detections.objects[det_idx];
-
-      try {
-        if (consider_associating(detection, track)) {
-          Eigen::Matrix<float32_t, NUM_OBJ_POSE_DIM, 1> sample;
-          sample(0, 0) = static_cast<float32_t>(detection.kinematics.centroid_position.x);
-          sample(1, 0) = static_cast<float32_t>(detection.kinematics.centroid_position.y);
-
-          Eigen::Matrix<float32_t, NUM_OBJ_POSE_DIM,
-            1> mean{track.centroid().cast<float32_t>()};
-
-          Eigen::Matrix<float32_t, NUM_OBJ_POSE_DIM,
-            NUM_OBJ_POSE_DIM> cov = track.position_covariance().cast<float32_t>();
-
-          const auto dist = autoware::common::helper_functions::calculate_mahalanobis_distance(
-            sample, mean, cov);
-
-          set_weight(dist, det_idx, track_idx);
-        }
-      } catch (const std::runtime_error & e) {
-        m_had_errors = true;
-      } catch (const std::domain_error & e) {
-        m_had_errors = true;
-      }
+  prepare_detections(detections);
+  prepare_tracks(tracks);
+  const auto num_detections = detections.objects.size();
+  if (m_pool) {
+    m_pool->run(
+      num_detections, [this](const std::size_t det_idx) {compute_detection_weights(det_idx);});
+  } else {
+    for (size_t det_idx = 0U; det_idx < num_detections; ++det_idx) {
+      compute_detection_weights(det_idx);
+    }
+  }
+  // The assigners are not thread safe, the weights are set in the same order as a full scan
+  for (size_t det_idx = 0U; det_idx < num_detections; ++det_idx) {
+    m_had_errors = m_had_errors || (m_det_num_invalid_weights[det_idx] > 0U);
+    for (const auto & gated : m_det_gated_tracks[det_idx]) {
+      set_weight(gated.weight, det_idx, gated.track_idx);
     }
   }
 }
 
-bool DetectedObjectAssociator::consider_associating(
-  const autoware_auto_msgs::msg::DetectedObject & detection,
-  const TrackedObject & track) const
+void DetectedObjectAssociator::prepare_detections(
+  const autoware_auto_msgs::msg::DetectedObjects & detections)
 {
-  const auto get_shortest_edge_size_squared = [&]() -> float32_t {
-      float32_t retval = std::numeric_limits<float32_t>::max();
-      for (auto current = detection.shape.polygon.points.begin();
-        current != detection.shape.polygon.points.end(); ++current)
-      {
-        auto next = common::geometry::details::circular_next(
-          detection.shape.polygon.points.begin(), detection.shape.polygon.points.end(), current);
-        retval = std::min(retval, common::geometry::squared_distance_2d(*current, *next));
+  const auto num_detections = detections.objects.size();
+  m_det_x.resize(num_detections);
+  m_det_y.resize(num_detections);
+  m_det_area.resize(num_detections);
+  m_det_max_distance_squared.resize(num_detections);
+  if (m_det_gated_tracks.size() < num_detections) {
+    m_det_gated_tracks.resize(num_detections);
+    m_det_scratch.resize(num_detections);
+  }
+  m_det_num_invalid_weights.assign(num_detections, 0U);
+  static constexpr float32_t kAreaEps = 1e-3F;
+  for (size_t det_idx = 0U; det_idx < num_detections; ++det_idx) {
+    const auto & detection = detections.objects[det_idx];
+    const auto & points = detection.shape.polygon.points;
+    m_det_x[det_idx] = static_cast<float32_t>(detection.kinematics.centroid_position.x);
+    m_det_y[det_idx] = static_cast<float32_t>(detection.kinematics.centroid_position.y);
+    m_det_max_distance_squared[det_idx] = -1.0F;
+    try {
+      m_det_area[det_idx] = common::geometry::area_checked_2d(points.begin(), points.end());
+      if (common::helper_functions::comparisons::abs_eq_zero(m_det_area[det_idx], kAreaEps)) {
+        throw std::runtime_error("Detection area is zero");
       }
-      return retval;
-    };
-
-  const float32_t det_area = common::geometry::area_checked_2d(
-    detection.shape.polygon.points.begin(), detection.shape.polygon.points.end());
+    } catch (const std::exception &) {
+      // Such a detection can't be associated with any track
+      m_had_errors = m_had_errors || (m_num_tracks > 0U);
+      continue;
+    }
+    float32_t max_distance_squared = m_association_cfg.get_max_distance_squared();
+    if (m_association_cfg.consider_edge_for_big_detections()) {
+      float32_t shortest_edge_squared = std::numeric_limits<float32_t>::max();
+      for (auto current = points.begin(); current != points.end(); ++current) {
+        const auto next = common::geometry::details::circular_next(
+          points.begin(), points.end(), current);
+        shortest_edge_squared = std::min(
+          shortest_edge_squared, common::geometry::squared_distance_2d(*current, *next));
+      }
+      max_distance_squared = std::max(max_distance_squared, shortest_edge_squared);
+    }
+    m_det_max_distance_squared[det_idx] = max_distance_squared;
+  }
+}
 
-  // TODO(gowtham.ranganathan): Add support for articulated objects
-  const float32_t track_area = common::geometry::area_checked_2d(
-    track.shape().polygon.points.begin(), track.shape().polygon.points.end());
+void DetectedObjectAssociator::prepare_tracks(const TrackedObjects & tracks)
+{
   static constexpr float32_t kAreaEps = 1e-3F;
+  // Gating data of the valid tracks in track order first
+  m_track_staging.clear();
+  for (size_t track_idx = 0U; track_idx < tracks.objects.size(); ++track_idx) {
+    const auto & track = tracks.objects[track_idx];
+    const auto & points = track.shape().polygon.points;
+    TrackGating gating;
+    try {
+      // TODO(gowtham.ranganathan): Add support for articulated objects
+      gating.area = common::geometry::area_checked_2d(points.begin(), points.end());
+      if (common::helper_functions::comparisons::abs_eq_zero(gating.area, kAreaEps)) {
+        throw std::runtime_error("Track area is zero");
+      }
+    } catch (const std::exception &) {
+      // Such a track can't be associated with any detection
+      m_had_errors = m_had_errors || (m_num_detections > 0U);
+      continue;
+    }
+    const auto centroid = track.centroid();
+    gating.x = static_cast<float32_t>(centroid.x());
+    gating.y = static_cast<float32_t>(centroid.y());
+    if (!std::isfinite(gating.x) || !std::isfinite(gating.y)) {
+      m_had_errors = m_had_errors || (m_num_detections > 0U);
+      continue;
+    }
+    // The weight is the norm of the solution of cov * x = diff, which is linear in diff. So it is
+    // the same as applying the inverse which is computed once by the same solver.
+    const Eigen::Matrix<float32_t, NUM_OBJ_POSE_DIM, NUM_OBJ_POSE_DIM> cov =
+      track.position_covariance().cast<float32_t>();
+    const Eigen::Matrix<float32_t, NUM_OBJ_POSE_DIM, NUM_OBJ_POSE_DIM> inv_cov =
+      cov.ldlt().solve(Eigen::Matrix<float32_t, NUM_OBJ_POSE_DIM, NUM_OBJ_POSE_DIM>::Identity());
+    gating.inv_cov_00 = inv_cov(0, 0);
+    gating.inv_cov_01 = inv_cov(0, 1);
+    gating.inv_cov_10 = inv_cov(1, 0);
+    gating.inv_cov_11 = inv_cov(1, 1);
+    gating.track_idx = track_idx;
+    m_track_staging.push_back(gating);
+  }
 
-  if (common::helper_functions::comparisons::abs_eq_zero(det_area, kAreaEps) ||
-    common::helper_functions::comparisons::abs_eq_zero(track_area, kAreaEps))
+  // Grid over the valid tracks with cells of the max distance. The cells get coarser if the tracks
+  // are too spread out, so that the grid stays in the order of the number of tracks
+  const auto num_valid = m_track_staging.size();
+  m_grid_num_cols = 0U;
+  m_grid_num_rows = 0U;
+  if (0U == num_valid) {
+    return;
+  }
+  const auto x_range = std::minmax_element(
+    m_track_staging.begin(), m_track_staging.end(),
+    [](const TrackGating & a, const TrackGating & b) {return a.x < b.x;});
+  const auto y_range = std::minmax_element(
+    m_track_staging.begin(), m_track_staging.end(),
+    [](const TrackGating & a, const TrackGating & b) {return a.y < b.y;});
+  m_grid_min_x = x_range.first->x;
+  m_grid_min_y = y_range.first->y;
+  const float32_t width = x_range.second->x - m_grid_min_x;
+  const float32_t height = y_range.second->y - m_grid_min_y;
+  const auto max_num_cells = static_cast<float32_t>((4U * num_valid) + 16U);
+  m_grid_cell_size = std::max(m_association_cfg.get_max_distance(), 1.0e-3F);
+  while ((((width / m_grid_cell_size) + 1.0F) * ((height / m_grid_cell_size) + 1.0F)) >
+    max_num_cells)
   {
-    throw std::runtime_error("Detection or track area is zero");
+    m_grid_cell_size *= 2.0F;
   }
+  m_grid_num_cols = static_cast<std::size_t>(width / m_grid_cell_size) + 1U;
+  m_grid_num_rows = static_cast<std::size_t>(height / m_grid_cell_size) + 1U;
+  const auto cell_of = [this](const TrackGating & gating) -> std::size_t {
+      const auto col = std::min(
+        static_cast<std::size_t>((gating.x - m_grid_min_x) / m_grid_cell_size),
+        m_grid_num_cols - 1U);
+      const auto row = std::min(
+        static_cast<std::size_t>((gating.y - m_grid_min_y) / m_grid_cell_size),
+        m_grid_num_rows - 1U);
+      return (row * m_grid_num_cols) + col;
+    };
 
-  const float32_t area_ratio = det_area / track_area;
-
-  geometry_msgs::msg::Point track_centroid{};
-  track_centroid.x = track.centroid().x();
-  track_centroid.y = track.centroid().y();
+  // Counting sort of the tracks by cell, which keeps the track order within a cell
+  const auto num_cells = m_grid_num_cols * m_grid_num_rows;
+  m_cell_offsets.assign(num_cells + 1U, 0U);
+  for (const auto & gating : m_track_staging) {
+    ++m_cell_offsets[cell_of(gating) + 1U];
+  }
+  std::partial_sum(m_cell_offsets.begin(), m_cell_offsets.end(), m_cell_offsets.begin());
+  m_cell_cursors.assign(m_cell_offsets.begin(), m_cell_offsets.end() - 1);
+  m_track_idx.resize(num_valid);
+  m_track_x.resize(num_valid);
+  m_track_y.resize(num_valid);
+  m_track_area.resize(num_valid);
+  m_track_inv_cov_00.resize(num_valid);
+  m_track_inv_cov_01.resize(num_valid);
+  m_track_inv_cov_10.resize(num_valid);
+  m_track_inv_cov_11.resize(num_valid);
+  for (const auto & gating : m_track_staging) {
+    const auto idx = m_cell_cursors[cell_of(gating)]++;
+    m_track_idx[idx] = gating.track_idx;
+    m_track_x[idx] = gating.x;
+    m_track_y[idx] = gating.y;
+    m_track_area[idx] = gating.area;
+    m_track_inv_cov_00[idx] = gating.inv_cov_00;
+    m_track_inv_cov_01[idx] = gating.inv_cov_01;
+    m_track_inv_cov_10[idx] = gating.inv_cov_10;
+    m_track_inv_cov_11[idx] = gating.inv_cov_11;
+  }
+}
 
-  const auto compute_distance_threshold = [&get_shortest_edge_size_squared, this]() -> float32_t {
-      if (m_association_cfg.consider_edge_for_big_detections()) {
-        return std::max(
-          m_association_cfg.get_max_distance_squared(),
-          get_shortest_edge_size_squared());
-      } else {
-        return m_association_cfg.get_max_distance_squared();
+void DetectedObjectAssociator::compute_detection_weights(const std::size_t det_idx)
+{
+  auto & gated_tracks = m_det_gated_tracks[det_idx];
+  gated_tracks.clear();
+  const float32_t max_distance_squared = m_det_max_distance_squared[det_idx];
+  if ((max_distance_squared < 0.0F) || (0U == m_grid_num_cols)) {
+    return;
+  }
+  const float32_t det_x = m_det_x[det_idx];
+  const float32_t det_y = m_det_y[det_idx];
+  const float32_t det_area = m_det_area[det_idx];
+  const float32_t max_area_ratio = m_association_cfg.get_max_area_ratio();
+  const float32_t max_area_ratio_inv = m_association_cfg.get_max_area_ratio_inv();
+  const float32_t max_weight =
+    (m_association_cfg.get_assigner_type() == AssignerType::JonkerVolgenant) ?
+    static_cast<float32_t>(JvAssigner::MAX_WEIGHT) : static_cast<float32_t>(Assigner::MAX_WEIGHT);
+
+  // Range of cells which can hold gated tracks, with a margin for the rounding of the cell index
+  const float32_t radius = std::sqrt(max_distance_squared) + (0.01F * m_grid_cell_size);
+  const auto cell_range = [this, radius](
+    const float32_t center, const float32_t min, const std::size_t num_cells,
+    std::size_t & first, std::size_t & last) -> bool {
+      const float32_t first_f = std::floor((center - radius - min) / m_grid_cell_size);
+      const float32_t last_f = std::floor((center + radius - min) / m_grid_cell_size);
+      if ((last_f < 0.0F) || (first_f >= static_cast<float32_t>(num_cells))) {
+        return false;
       }
+      first = static_cast<std::size_t>(std::max(first_f, 0.0F));
+      last = std::min(static_cast<std::size_t>(last_f), num_cells - 1U);
+      return true;
     };
-
-  if (common::geometry::squared_distance_2d(
-      detection.kinematics.centroid_position,
-      track_centroid) > compute_distance_threshold())
+  std::size_t first_col, last_col, first_row, last_row;
+  if (!cell_range(det_x, m_grid_min_x, m_grid_num_cols, first_col, last_col) ||
+    !cell_range(det_y, m_grid_min_y, m_grid_num_rows, first_row, last_row))
   {
-    return false;
+    return;
   }
 
-  if (area_ratio < m_association_cfg.get_max_area_ratio()) {
-    if (area_ratio > m_association_cfg.get_max_area_ratio_inv()) {
-      return true;
+  auto & squared_weights = m_det_scratch[det_idx];
+  for (std::size_t row = first_row; row <= last_row; ++row) {
+    // The cells of a row are consecutive, so are their tracks
+    const std::size_t begin = m_cell_offsets[(row * m_grid_num_cols) + first_col];
+    const std::size_t end = m_cell_offsets[(row * m_grid_num_cols) + last_col + 1U];
+    const std::size_t count = end - begin;
+    squared_weights.resize(std::max(squared_weights.size(), count));
+    const float32_t * const track_x = &m_track_x[begin];
+    const float32_t * const track_y = &m_track_y[begin];
+    const float32_t * const track_area = &m_track_area[begin];
+    const float32_t * const inv_cov_00 = &m_track_inv_cov_00[begin];
+    const float32_t * const inv_cov_01 = &m_track_inv_cov_01[begin];
+    const float32_t * const inv_cov_10 = &m_track_inv_cov_10[begin];
+    const float32_t * const inv_cov_11 = &m_track_inv_cov_11[begin];
+    float32_t * const out = squared_weights.data();
+    // Branch free so that it is vectorized, gated out pairs get a negative weight
+    for (std::size_t idx = 0U; idx < count; ++idx) {
+      const float32_t dx = det_x - track_x[idx];
+      const float32_t dy = det_y - track_y[idx];
+      const float32_t area_ratio = det_area / track_area[idx];
+      const uint32_t is_gated =
+        static_cast<uint32_t>(((dx * dx) + (dy * dy)) <= max_distance_squared) &
+        static_cast<uint32_t>(area_ratio < max_area_ratio) &
+        static_cast<uint32_t>(area_ratio > max_area_ratio_inv);
+      const float32_t solved_x = (inv_cov_00[idx] * dx) + (inv_cov_01[idx] * dy);
+      const float32_t solved_y = (inv_cov_10[idx] * dx) + (inv_cov_11[idx] * dy);
+      const float32_t squared_weight = (solved_x * solved_x) + (solved_y * solved_y);
+      out[idx] = (0U != is_gated) ? squared_weight : -1.0F;
+    }
+    for (std::size_t idx = 0U; idx < count; ++idx) {
+      if (out[idx] < 0.0F) {
+        continue;
+      }
+      // A singular covariance gives an infinite or NaN weight, which the assigners do not accept
+      const float32_t weight = std::sqrt(out[idx]);
+      if (!(weight < max_weight)) {
+        ++m_det_num_invalid_weights[det_idx];
+        continue;
+      }
+      gated_tracks.push_back(GatedTrack{m_track_idx[begin + idx], weight});
     }
   }
-  return false;
+  std::sort(
+    gated_tracks.begin(), gated_tracks.end(),
+    [](const GatedTrack & a, const GatedTrack & b) {return a.track_idx < b.track_idx;});
 }
 
 void DetectedObjectAssociator::set_weight(
   const float32_t weight,
   const size_t det_idx, const size_t track_idx)
 {
-  if (m_are_tracks_rows) {
-    m_assigner.set_weight(
-      weight, static_cast<assigner_idx_t>(track_idx),
-      static_cast<assigner_idx_t>(det_idx));
+  const auto row_idx = static_cast<assigner_idx_t>(m_are_tracks_rows ? track_idx : det_idx);
+  const auto col_idx = static_cast<assigner_idx_t>(m_are_tracks_rows ? det_idx : track_idx);
+  if (m_association_cfg.get_assigner_type() == AssignerType::JonkerVolgenant) {
+    m_jv_assigner->set_weight(weight, row_idx, col_idx);
   } else {
-    m_assigner.set_weight(
-      weight, static_cast<assigner_idx_t>(det_idx),
-      static_cast<assigner_idx_t>(track_idx));
+    m_assigner->set_weight(weight, row_idx, col_idx);
+  }
+}
+
+assigner_idx_t DetectedObjectAssociator::get_assignment(const size_t row_idx) const
+{
+  if (m_association_cfg.get_assigner_type() == AssignerType::JonkerVolgenant) {
+    const auto col_idx = m_jv_assigner->get_assignment(static_cast<assigner_idx_t>(row_idx));
+    return (col_idx == JvAssigner::UNASSIGNED) ? Assigner::UNASSIGNED : col_idx;
   }
+  return m_assigner->get_assignment(static_cast<assigner_idx_t>(row_idx));
 }
 
 AssociatorResult DetectedObjectAssociator::extract_result() const
@@ -209,8 +405,7 @@ AssociatorResult DetectedObjectAssociator::extract_result() const
   if (m_are_tracks_rows) {
     std::vector<common::types::bool8_t> detections_assigned(m_num_detections, false);
     for (size_t track_idx = 0U; track_idx < m_num_tracks; track_idx++) {
-      const auto det_idx =
-        static_cast<size_t>(m_assigner.get_assignment(static_cast<assigner_idx_t>(track_idx)));
+      const auto det_idx = static_cast<size_t>(get_assignment(track_idx));
       if (det_idx != Assigner::UNASSIGNED) {
         ret.track_assignments[track_idx] = det_idx;
         detections_assigned[det_idx] = true;
@@ -227,8 +422,7 @@ AssociatorResult DetectedObjectAssociator::extract_result() const
   } else {
     std::vector<common::types::bool8_t> tracks_assigned(m_num_tracks, false);
     for (size_t det_idx = 0U; det_idx < m_num_detections; det_idx++) {
-      const auto track_idx =
-        static_cast<size_t>(m_assigner.get_assignment(static_cast<assigner_idx_t>(det_idx)));
+      const auto track_idx = static_cast<size_t>(get_assignment(det_idx));
       if (track_idx != Assigner::UNASSIGNED) {
         ret.track_assignments[track_idx] = det_idx;
         tracks_assigned[track_idx] = true;
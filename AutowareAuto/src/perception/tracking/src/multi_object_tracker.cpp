@@ -77,6 +77,7 @@ geometry_msgs::msg::TransformStamped to_transform(const nav_msgs::msg::Odometry
 MultiObjectTracker::MultiObjectTracker(
   MultiObjectTrackerOptions options, const tf2::BufferCore & buffer)
 : m_options{options},
+  m_track_predictor{options.prediction_num_threads},
   m_object_associator{options.object_association_config},
   m_vision_associator{options.vision_association_config, buffer},
   m_track_creator{options.track_creator_config, buffer}
@@ -105,9 +106,7 @@ DetectedObjectsUpdateResult MultiObjectTracker::update(
   // TODO(nikolai.morin): Simplify after #1002
   const auto target_time = time_utils::from_message(detection_in_tracker_frame.header.stamp);
   const auto dt = target_time - m_last_update;
-  for (auto & object : m_tracks.objects) {
-    object.predict(dt);
-  }
+  m_track_predictor.predict(m_tracks.objects, dt);
 
   // ==================================
   // Associate observations with tracks
@@ -0,0 +1,192 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tracking/track_batch_predictor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <type_traits>
+#include <vector>
+
+namespace autoware
+{
+namespace perception
+{
+namespace tracking
+{
+
+namespace
+{
+
+using common::types::float64_t;
+
+// The state consists of one block of position, velocity and acceleration per axis, the same
+// layout as assumed by the linear motion model and the Wiener noise
+constexpr std::size_t BLOCK_SIZE = 3U;
+constexpr std::size_t NUM_AXES = 2U;
+static_assert(
+  TrackedObject::CA::size() == static_cast<Eigen::Index>(BLOCK_SIZE * NUM_AXES),
+  "The batch prediction only supports a constant acceleration state in two axes");
+// predict_range() writes the state and covariance of the EKF and the noise variance directly, so
+// it must be changed together with the models of TrackedObject
+static_assert(
+  std::is_same<TrackedObject::MotionModel,
+  common::motion_model::LinearMotionModel<TrackedObject::CA>>::value,
+  "The batch prediction only supports the linear motion model");
+static_assert(
+  std::is_same<TrackedObject::NoiseModel,
+  common::state_estimation::WienerNoise<TrackedObject::CA>>::value,
+  "The batch prediction only supports the Wiener noise model");
+
+/// \brief dst[i] += (t * a[i]) + (h * b[i]) for all tracks i in [first, last)
+inline void add_scaled(
+  float64_t * const dst, const float64_t * const a, const float64_t * const b,
+  const float64_t t, const float64_t h, const std::size_t first, const std::size_t last)
+{
+  for (std::size_t i = first; i < last; ++i) {
+    dst[i] += (t * a[i]) + (h * b[i]);
+  }
+}
+
+/// \brief dst[i] += t * a[i] for all tracks i in [first, last)
+inline void add_scaled(
+  float64_t * const dst, const float64_t * const a, const float64_t t,
+  const std::size_t first, const std::size_t last)
+{
+  for (std::size_t i = first; i < last; ++i) {
+    dst[i] += t * a[i];
+  }
+}
+
+}  // anonymous namespace
+
+constexpr std::size_t TrackBatchPredictor::NUM_STATES;
+
+TrackBatchPredictor::TrackBatchPredictor(const std::size_t num_threads)
+{
+  if (num_threads > 1U) {
+    m_pool = std::make_unique<common::helper_functions::WorkerPool>(num_threads);
+  }
+}
+
+void TrackBatchPredictor::predict(
+  std::vector<TrackedObject> & tracks, const std::chrono::nanoseconds dt)
+{
+  const auto num_tracks = tracks.size();
+  if (num_tracks > m_capacity) {
+    m_capacity = num_tracks;
+    m_state.resize(NUM_STATES * m_capacity);
+    m_covariance.resize(NUM_STATES * NUM_STATES * m_capacity);
+    m_noise_variance.resize(m_capacity);
+  }
+  const auto dt_s = std::chrono::duration<float64_t>{dt}.count();
+  if (m_pool) {
+    // Chunks of a multiple of 8 tracks, i.e. 64 bytes of each array. The arrays are not aligned to
+    // cache lines, so neighbouring chunks may still share one line of each array at their border
+    constexpr std::size_t kAlignment = 8U;
+    const auto num_chunks = m_pool->size();
+    const auto chunk_size =
+      ((((num_tracks + num_chunks) - 1U) / num_chunks) + kAlignment - 1U) / kAlignment *
+      kAlignment;
+    m_pool->run(
+      num_chunks, [this, &tracks, num_tracks, chunk_size, dt_s](const std::size_t chunk) {
+        const auto first = std::min(chunk * chunk_size, num_tracks);
+        const auto last = std::min(first + chunk_size, num_tracks);
+        predict_range(tracks, first, last, dt_s);
+      });
+  } else {
+    predict_range(tracks, 0U, num_tracks, dt_s);
+  }
+  for (auto & track : tracks) {
+    track.m_time_since_last_seen += dt;
+  }
+}
+
+void TrackBatchPredictor::predict_range(
+  std::vector<TrackedObject> & tracks, const std::size_t first, const std::size_t last,
+  const float64_t dt_s)
+{
+  if (first == last) {
+    return;
+  }
+  for (std::size_t i = first; i < last; ++i) {
+    const auto & ekf = tracks[i].m_ekf;
+    for (std::size_t row = 0U; row < NUM_STATES; ++row) {
+      const auto r = static_cast<Eigen::Index>(row);
+      state(row)[i] = ekf.state().vector()(r);
+      for (std::size_t col = 0U; col < NUM_STATES; ++col) {
+        covariance(row, col)[i] = ekf.covariance()(r, static_cast<Eigen::Index>(col));
+      }
+    }
+    m_noise_variance[i] = tracks[i].m_noise_variance;
+  }
+
+  // The transition of each axis is A = [1, t, h; 0, 1, t; 0, 0, 1] with h = t^2 / 2. It is applied
+  // in place, updating each row (column) before the rows (columns) it depends on are changed.
+  const float64_t t = dt_s;
+  const float64_t h = 0.5 * (t * t);
+  for (std::size_t axis = 0U; axis < NUM_AXES; ++axis) {
+    const auto pos = axis * BLOCK_SIZE;
+    add_scaled(state(pos), state(pos + 1U), state(pos + 2U), t, h, first, last);
+    add_scaled(state(pos + 1U), state(pos + 2U), t, first, last);
+  }
+  // covariance = A * covariance * A^T, first the rows and then the columns of each block
+  for (std::size_t axis = 0U; axis < NUM_AXES; ++axis) {
+    const auto pos = axis * BLOCK_SIZE;
+    for (std::size_t col = 0U; col < NUM_STATES; ++col) {
+      add_scaled(
+        covariance(pos, col), covariance(pos + 1U, col), covariance(pos + 2U, col), t, h,
+        first, last);
+      add_scaled(covariance(pos + 1U, col), covariance(pos + 2U, col), t, first, last);
+    }
+  }
+  for (std::size_t axis = 0U; axis < NUM_AXES; ++axis) {
+    const auto pos = axis * BLOCK_SIZE;
+    for (std::size_t row = 0U; row < NUM_STATES; ++row) {
+      add_scaled(
+        covariance(row, pos), covariance(row, pos + 1U), covariance(row, pos + 2U), t, h,
+        first, last);
+      add_scaled(covariance(row, pos + 1U), covariance(row, pos + 2U), t, first, last);
+    }
+  }
+  // Wiener noise gain * gain^T * sigma^2 on the block of each axis, with gain = [h, t, 1]
+  const float64_t gain[BLOCK_SIZE] = {h, t, 1.0};
+  for (std::size_t axis = 0U; axis < NUM_AXES; ++axis) {
+    const auto pos = axis * BLOCK_SIZE;
+    for (std::size_t row = 0U; row < BLOCK_SIZE; ++row) {
+      for (std::size_t col = 0U; col < BLOCK_SIZE; ++col) {
+        const float64_t noise_gain = gain[row] * gain[col];
+        float64_t * const dst = covariance(pos + row, pos + col);
+        for (std::size_t i = first; i < last; ++i) {
+          dst[i] += (noise_gain * m_noise_variance[i]) * m_noise_variance[i];
+        }
+      }
+    }
+  }
+
+  for (std::size_t i = first; i < last; ++i) {
+    auto & ekf = tracks[i].m_ekf;
+    for (std::size_t row = 0U; row < NUM_STATES; ++row) {
+      const auto r = static_cast<Eigen::Index>(row);
+      ekf.state().vector()(r) = state(row)[i];
+      for (std::size_t col = 0U; col < NUM_STATES; ++col) {
+        ekf.covariance()(r, static_cast<Eigen::Index>(col)) = covariance(row, col)[i];
+      }
+    }
+  }
+}
+
+}  // namespace tracking
+}  // namespace perception
+}  // namespace autoware
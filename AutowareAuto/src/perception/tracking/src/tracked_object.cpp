@@ -113,7 +113,8 @@ TrackedObject::TrackedObject(
   float64_t noise_variance)
 : m_msg{},
   m_ekf{init_ekf(detection, default_variance, noise_variance)},
-  m_default_variance{default_variance}
+  m_default_variance{default_variance},
+  m_noise_variance{noise_variance}
 {
   static uint64_t object_id = 0;
   m_msg.object_id = ++object_id;
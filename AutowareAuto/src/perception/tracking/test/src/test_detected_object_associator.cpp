@@ -242,3 +242,159 @@ TEST_F(AssociationTester, AreaGatingFails)
     }
   }
 }
+
+// More tracks and detections than the hungarian assigner supports, in a crowded parking lot
+TEST_F(AssociationTester, JonkerVolgenantManyObjects)
+{
+  const tracking::DataAssociationConfig association_cfg{
+    10.0F, 2.0F, true, tracking::AssignerType::JonkerVolgenant};
+  tracking::DetectedObjectAssociator associator{association_cfg};
+  const auto num_tracks = 2U * tracking::MAX_NUM_TRACKS;
+
+  std::vector<tracking::TrackedObject> tracked_object_vec{};
+  DetectedObjects detections_msg;
+  for (size_t i = 0U; i < num_tracks; ++i) {
+    DetectedObject current_track;
+    current_track.shape = create_square(4.0F);
+    // Parking spots 3 m apart, so that each detection is gated with several tracks
+    current_track.kinematics.centroid_position.x = 3.0 * static_cast<double>(i % 32U);
+    current_track.kinematics.centroid_position.y = 6.0 * static_cast<double>(i / 32U);
+    current_track.kinematics.position_covariance = m_some_covariance;
+    current_track.kinematics.has_position_covariance = true;
+    tracked_object_vec.emplace_back(current_track, 0.0, 0.0);
+
+    // Every third track is not detected
+    if ((i % 3U) != 2U) {
+      DetectedObject current_detection = current_track;
+      current_detection.kinematics.centroid_position.x += 0.3;
+      current_detection.kinematics.centroid_position.y -= 0.2;
+      detections_msg.objects.push_back(current_detection);
+    }
+  }
+  detections_msg.header.frame_id = kTrackerFrame;
+
+  tracking::TrackedObjects tracks{tracked_object_vec, kTrackerFrame};
+  const auto ret = associator.assign(detections_msg, tracks);
+  ASSERT_EQ(ret.track_assignments.size(), num_tracks);
+  EXPECT_TRUE(ret.unassigned_detection_indices.empty());
+  size_t det_idx = 0U;
+  for (size_t i = 0U; i < num_tracks; ++i) {
+    if ((i % 3U) != 2U) {
+      EXPECT_EQ(ret.track_assignments[i], det_idx);
+      ++det_idx;
+    } else {
+      EXPECT_EQ(ret.track_assignments[i], tracking::AssociatorResult::UNASSIGNED);
+      EXPECT_TRUE(ret.unassigned_track_indices.find(i) != ret.unassigned_track_indices.end());
+    }
+  }
+}
+
+// The weights computed by several threads give the same assignment as the sequential computation
+TEST_F(AssociationTester, ParallelManyObjects)
+{
+  const tracking::DataAssociationConfig sequential_cfg{
+    10.0F, 2.0F, true, tracking::AssignerType::JonkerVolgenant};
+  const tracking::DataAssociationConfig parallel_cfg{
+    10.0F, 2.0F, true, tracking::AssignerType::JonkerVolgenant, 4U};
+  tracking::DetectedObjectAssociator sequential_associator{sequential_cfg};
+  tracking::DetectedObjectAssociator parallel_associator{parallel_cfg};
+  const auto num_tracks = 2U * tracking::MAX_NUM_TRACKS;
+
+  std::vector<tracking::TrackedObject> tracked_object_vec{};
+  DetectedObjects detections_msg;
+  for (size_t i = 0U; i < num_tracks; ++i) {
+    DetectedObject current_track;
+    current_track.shape = create_square(4.0F);
+    // A dense cluster and tracks spread far apart, so that the grid cells get coarser
+    const bool is_dense = (i < (num_tracks / 2U));
+    const double spacing = is_dense ? 3.0 : 40.0;
+    current_track.kinematics.centroid_position.x =
+      spacing * static_cast<double>(i % 16U) + (is_dense ? 0.0 : 1000.0);
+    current_track.kinematics.centroid_position.y =
+      spacing * static_cast<double>((i / 16U) % 16U) - 100.0;
+    current_track.kinematics.position_covariance = m_some_covariance;
+    current_track.kinematics.has_position_covariance = true;
+    tracked_object_vec.emplace_back(current_track, 0.0, 0.0);
+
+    if ((i % 3U) != 2U) {
+      DetectedObject current_detection = current_track;
+      current_detection.kinematics.centroid_position.x += 0.3;
+      current_detection.kinematics.centroid_position.y -= 0.2;
+      detections_msg.objects.push_back(current_detection);
+    }
+  }
+  detections_msg.header.frame_id = kTrackerFrame;
+
+  tracking::TrackedObjects tracks{tracked_object_vec, kTrackerFrame};
+  const auto expected = sequential_associator.assign(detections_msg, tracks);
+  // Run twice to make sure that no state of the previous call is kept
+  for (size_t run = 0U; run < 2U; ++run) {
+    const auto ret = parallel_associator.assign(detections_msg, tracks);
+    EXPECT_EQ(ret.track_assignments, expected.track_assignments);
+    EXPECT_EQ(ret.unassigned_track_indices, expected.unassigned_track_indices);
+    EXPECT_EQ(ret.unassigned_detection_indices, expected.unassigned_detection_indices);
+  }
+}
+
+// A big detection is gated with a track further away than the max distance but closer than its
+// shortest edge
+TEST_F(AssociationTester, BigDetectionGate)
+{
+  DetectedObject current_track;
+  current_track.shape = create_square(400.0F);
+  current_track.kinematics.position_covariance = m_some_covariance;
+  current_track.kinematics.has_position_covariance = true;
+  std::vector<tracking::TrackedObject> tracked_object_vec{{current_track, 0.0, 0.0}};
+  tracking::TrackedObjects tracks{tracked_object_vec, kTrackerFrame};
+
+  DetectedObjects detections_msg;
+  detections_msg.header.frame_id = kTrackerFrame;
+  DetectedObject current_detection = current_track;
+  current_detection.kinematics.centroid_position.x = 15.0;
+  detections_msg.objects.push_back(current_detection);
+
+  const auto ret = m_associator.assign(detections_msg, tracks);
+  EXPECT_EQ(ret.track_assignments[0U], 0U);
+
+  const tracking::DataAssociationConfig association_cfg{10.0F, 2.0F, false};
+  tracking::DetectedObjectAssociator associator{association_cfg};
+  const auto ret_no_edge = associator.assign(detections_msg, tracks);
+  EXPECT_EQ(ret_no_edge.track_assignments[0U], tracking::AssociatorResult::UNASSIGNED);
+}
+
+// A weight which the assigners do not accept leaves the pair unassigned instead of throwing
+TEST_F(AssociationTester, HugeWeight)
+{
+  std::vector<tracking::TrackedObject> tracked_object_vec{};
+  DetectedObjects detections_msg;
+  detections_msg.header.frame_id = kTrackerFrame;
+  for (size_t i = 0U; i < 2U; ++i) {
+    DetectedObject current_track;
+    current_track.shape = create_square(4.0F);
+    current_track.kinematics.centroid_position.x = 20.0 * static_cast<double>(i);
+    current_track.kinematics.position_covariance = m_some_covariance;
+    current_track.kinematics.has_position_covariance = true;
+    DetectedObject current_detection = current_track;
+    current_detection.kinematics.centroid_position.y = 1.0;
+    detections_msg.objects.push_back(current_detection);
+    if (1U == i) {
+      // The weight of this pair is far above MAX_WEIGHT
+      current_track.kinematics.position_covariance = {1.0e-6, 0.0, 0.0, 0.0, 1.0e-6};
+    }
+    tracked_object_vec.emplace_back(current_track, 0.0, 0.0);
+  }
+  tracking::TrackedObjects tracks{tracked_object_vec, kTrackerFrame};
+
+  for (const auto assigner_type :
+    {tracking::AssignerType::Hungarian, tracking::AssignerType::JonkerVolgenant})
+  {
+    const tracking::DataAssociationConfig association_cfg{10.0F, 2.0F, true, assigner_type};
+    tracking::DetectedObjectAssociator associator{association_cfg};
+    tracking::AssociatorResult ret;
+    EXPECT_NO_THROW(ret = associator.assign(detections_msg, tracks));
+    EXPECT_EQ(ret.track_assignments[0U], 0U);
+    EXPECT_EQ(ret.track_assignments[1U], tracking::AssociatorResult::UNASSIGNED);
+    EXPECT_TRUE(
+      ret.unassigned_detection_indices.find(1U) != ret.unassigned_detection_indices.end());
+  }
+}
@@ -0,0 +1,106 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <vector>
+
+#include "autoware_auto_msgs/msg/detected_object.hpp"
+#include "gtest/gtest.h"
+#include "tracking/track_batch_predictor.hpp"
+#include "tracking/tracked_object.hpp"
+
+using autoware::perception::tracking::TrackBatchPredictor;
+using autoware::perception::tracking::TrackedObject;
+using DetectedObjectMsg = autoware_auto_msgs::msg::DetectedObject;
+
+namespace
+{
+std::vector<TrackedObject> make_tracks(const std::size_t num_tracks)
+{
+  std::vector<TrackedObject> tracks;
+  for (std::size_t i = 0U; i < num_tracks; ++i) {
+    const auto offset = static_cast<double>(i);
+    DetectedObjectMsg msg;
+    msg.kinematics.centroid_position.x = 3.0 * offset;
+    msg.kinematics.centroid_position.y = -2.0 * offset;
+    msg.kinematics.has_twist = true;
+    msg.kinematics.twist.twist.linear.x = 1.0 + (0.1 * offset);
+    msg.kinematics.twist.twist.linear.y = -0.5;
+    msg.kinematics.has_position_covariance = true;
+    msg.kinematics.position_covariance[0] = 0.5 + (0.01 * offset);
+    msg.kinematics.position_covariance[1] = 0.1;
+    msg.kinematics.position_covariance[3] = 0.1;
+    msg.kinematics.position_covariance[4] = 0.7;
+    tracks.emplace_back(msg, 1.0 + (0.02 * offset), 2.0 + (0.05 * offset));
+  }
+  return tracks;
+}
+
+void expect_near(
+  const TrackedObject::TrackedObjectMsg & a, const TrackedObject::TrackedObjectMsg & b)
+{
+  constexpr double kTolerance = 1.0e-9;
+  EXPECT_NEAR(a.kinematics.centroid_position.x, b.kinematics.centroid_position.x, kTolerance);
+  EXPECT_NEAR(a.kinematics.centroid_position.y, b.kinematics.centroid_position.y, kTolerance);
+  EXPECT_NEAR(a.kinematics.twist.twist.linear.x, b.kinematics.twist.twist.linear.x, kTolerance);
+  EXPECT_NEAR(a.kinematics.twist.twist.linear.y, b.kinematics.twist.twist.linear.y, kTolerance);
+  EXPECT_NEAR(
+    a.kinematics.acceleration.accel.linear.x, b.kinematics.acceleration.accel.linear.x,
+    kTolerance);
+  for (const std::size_t idx : {0U, 1U, 3U, 4U}) {
+    EXPECT_NEAR(
+      a.kinematics.position_covariance[idx], b.kinematics.position_covariance[idx], kTolerance);
+  }
+  for (const std::size_t idx : {0U, 1U, 6U, 7U}) {
+    EXPECT_NEAR(a.kinematics.twist.covariance[idx], b.kinematics.twist.covariance[idx], kTolerance);
+  }
+}
+
+void test_same_as_single_prediction(const std::size_t num_threads, const std::size_t num_tracks)
+{
+  auto expected = make_tracks(num_tracks);
+  auto tracks = make_tracks(num_tracks);
+  TrackBatchPredictor predictor{num_threads};
+  // Several steps, so that the full covariance gets populated
+  for (const auto dt : {std::chrono::milliseconds(100), std::chrono::milliseconds(250)}) {
+    for (auto & track : expected) {
+      track.predict(dt);
+    }
+    predictor.predict(tracks, dt);
+  }
+  for (std::size_t i = 0U; i < num_tracks; ++i) {
+    expect_near(tracks[i].msg(), expected[i].msg());
+    EXPECT_TRUE(tracks[i].should_be_removed(std::chrono::milliseconds(350), 100U));
+    EXPECT_FALSE(tracks[i].should_be_removed(std::chrono::milliseconds(351), 100U));
+  }
+}
+}  // namespace
+
+TEST(TestTrackBatchPredictor, SameAsSinglePrediction)
+{
+  test_same_as_single_prediction(0U, 37U);
+}
+
+TEST(TestTrackBatchPredictor, SameAsSinglePredictionParallel)
+{
+  test_same_as_single_prediction(3U, 37U);
+  test_same_as_single_prediction(4U, 2U);
+}
+
+TEST(TestTrackBatchPredictor, NoTracks)
+{
+  std::vector<TrackedObject> tracks;
+  TrackBatchPredictor predictor{2U};
+  EXPECT_NO_THROW(predictor.predict(tracks, std::chrono::milliseconds(100)));
+}
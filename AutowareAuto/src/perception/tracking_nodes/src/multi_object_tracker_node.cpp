@@ -28,6 +28,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -61,6 +62,17 @@ constexpr std::chrono::milliseconds kMaxVisionEgoStateStampDiff{100};
 constexpr std::int64_t kDefaultHistoryDepth{20};
 constexpr std::int64_t kDefaultPoseHistoryDepth{100};
 
+/// \brief Declare an optional thread count parameter, which defaults to 0
+/// \throw std::domain_error If the thread count is negative
+std::size_t declare_num_threads(rclcpp::Node & node, const std::string & name)
+{
+  const auto num_threads = node.declare_parameter(name, 0);
+  if (num_threads < 0) {
+    throw std::domain_error(name + " must not be negative");
+  }
+  return static_cast<std::size_t>(num_threads);
+}
+
 MultiObjectTracker init_tracker(
   rclcpp::Node & node,
   const bool8_t use_vision,
@@ -74,6 +86,19 @@ MultiObjectTracker init_tracker(
       "object_association.max_area_ratio").get<float64_t>());
   const bool consider_edge_for_big_detections = node.declare_parameter(
     "object_association.consider_edge_for_big_detection").get<bool>();
+  const std::string assigner = node.declare_parameter(
+    "object_association.assigner", "hungarian");
+  perception::tracking::AssignerType assigner_type;
+  if (assigner == "hungarian") {
+    assigner_type = perception::tracking::AssignerType::Hungarian;
+  } else if (assigner == "jonker_volgenant") {
+    assigner_type = perception::tracking::AssignerType::JonkerVolgenant;
+  } else {
+    throw std::domain_error(
+            "object_association.assigner must be either hungarian or jonker_volgenant");
+  }
+  const auto association_num_threads =
+    declare_num_threads(node, "object_association.num_threads");
 
   auto creation_policy = perception::tracking::TrackCreationPolicy::LidarClusterOnly;
   const auto default_variance = node.declare_parameter(
@@ -88,6 +113,7 @@ MultiObjectTracker init_tracker(
     static_cast<std::size_t>(node.declare_parameter(
       "pruning_ticks_threshold").get<int64_t>());
   const std::string frame = node.declare_parameter("track_frame_id", "odom");
+  const auto prediction_num_threads = declare_num_threads(node, "prediction_num_threads");
 
   TrackCreatorConfig creator_config{};
   GreedyRoiAssociatorConfig vision_config{};
@@ -129,8 +155,11 @@ MultiObjectTracker init_tracker(
   creator_config.noise_variance = noise_variance;
 
   MultiObjectTrackerOptions options{
-    {max_distance, max_area_ratio, consider_edge_for_big_detections}, vision_config,
-    creator_config, pruning_time_threshold, pruning_ticks_threshold, frame};
+    {max_distance, max_area_ratio, consider_edge_for_big_detections, assigner_type,
+      association_num_threads},
+    vision_config,
+    creator_config, pruning_time_threshold, pruning_ticks_threshold, frame,
+    prediction_num_threads};
   return MultiObjectTracker{options, tf_buffer};
 }
 
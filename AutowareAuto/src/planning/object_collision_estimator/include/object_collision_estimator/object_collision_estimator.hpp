@@ -26,6 +26,7 @@
 #include <vector>
 #include <cmath>
 
+#include "object_collision_estimator/obstacle_index.hpp"
 #include "object_collision_estimator/visibility_control.hpp"
 
 namespace motion
@@ -98,9 +99,28 @@ public:
   BoundingBoxArray getTrajectoryBoundingBox() const {return m_trajectory_bboxes;}
 
 private:
+  /// \brief Update the bounding boxes around each waypoint in the trajectory. The boxes of the
+  ///        waypoints which are the same as in the previous trajectory are not computed again.
+  /// \param trajectory Planned trajectory of ego vehicle.
+  void updateFootprints(const Trajectory & trajectory);
+
+  /// \brief Detect possible collision between a trajectory and the obstacles.
+  ///        Return the index in the trajectory where the first collision happens.
+  /// \param trajectory Planned trajectory of ego vehicle.
+  /// \return int32_t The index into the trajectory points where the first collision happens. If no
+  ///         collision is detected, -1 is returned.
+  int32_t detectCollision(const Trajectory & trajectory);
+
   ObjectCollisionEstimatorConfig m_config;
+  // obstacles farther away than this from a waypoint can't collide with the ego vehicle there
+  float32_t m_distance_threshold{};
   BoundingBoxArray m_obstacles{};
+  ObstacleIndex m_obstacle_index{};
   BoundingBoxArray m_trajectory_bboxes{};
+  // the waypoints the bounding boxes were computed for, and the boxes prepared for the collision
+  // check
+  std::vector<TrajectoryPoint> m_footprint_waypoints{};
+  std::vector<CollisionBox> m_footprints{};
   TrajectorySmoother m_smoother;
 };
 
@@ -0,0 +1,137 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+/// \file
+/// \brief This file defines the broad and narrow phase of the collision detection.
+
+#ifndef OBJECT_COLLISION_ESTIMATOR__OBSTACLE_INDEX_HPP_
+#define OBJECT_COLLISION_ESTIMATOR__OBSTACLE_INDEX_HPP_
+
+#include <autoware_auto_msgs/msg/bounding_box.hpp>
+#include <autoware_auto_msgs/msg/bounding_box_array.hpp>
+#include <common/types.hpp>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "object_collision_estimator/visibility_control.hpp"
+
+namespace motion
+{
+namespace planning
+{
+namespace object_collision_estimator
+{
+
+using autoware_auto_msgs::msg::BoundingBox;
+using autoware_auto_msgs::msg::BoundingBoxArray;
+using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
+
+/// \brief A bounding box prepared for the separating axis test. The face normals of the box and
+///        the extent of the box along them are computed once, so that testing a pair of boxes does
+///        not allocate.
+struct OBJECT_COLLISION_ESTIMATOR_PUBLIC CollisionBox
+{
+  static constexpr std::size_t NUM_CORNERS = 4U;
+  /// The corners of the bounding box, in the same order
+  std::array<float32_t, NUM_CORNERS> corner_x;
+  std::array<float32_t, NUM_CORNERS> corner_y;
+  /// The normals of the faces of the convex hull of the corners, not normalized
+  std::array<float32_t, NUM_CORNERS> normal_x;
+  std::array<float32_t, NUM_CORNERS> normal_y;
+  std::size_t num_faces;
+  /// Range of the own corners projected on each normal
+  std::array<float32_t, NUM_CORNERS> min_projection;
+  std::array<float32_t, NUM_CORNERS> max_projection;
+  /// False if a face is too short to project on. Such boxes are tested with
+  /// geometry::intersect() instead, which reports them.
+  bool8_t is_regular;
+  /// The original bounding box, only needed for boxes which are not regular
+  BoundingBox box;
+};
+
+/// \brief Prepare a bounding box for the separating axis test
+/// \param box The bounding box
+/// \return CollisionBox The prepared box
+OBJECT_COLLISION_ESTIMATOR_PUBLIC CollisionBox makeCollisionBox(const BoundingBox & box);
+
+/// \brief Check if two boxes overlap. The result is the same as geometry::intersect() on the
+///        corners of the boxes, as the same projections are computed.
+/// \param box1 The first box
+/// \param box2 The second box
+/// \return bool8_t True if the boxes overlap
+OBJECT_COLLISION_ESTIMATOR_PUBLIC bool8_t intersect(
+  const CollisionBox & box1, const CollisionBox & box2);
+
+/// \brief Index of the obstacles to find those which are close to a waypoint. It is a uniform grid
+///        over the axis aligned bounds of the obstacles, which is built once per obstacle update.
+class OBJECT_COLLISION_ESTIMATOR_PUBLIC ObstacleIndex
+{
+public:
+  /// \brief Replace the indexed obstacles
+  /// \param obstacles The obstacles
+  /// \param distance_threshold Obstacles whose corners are all at least this far away from a
+  ///                           waypoint are never considered to collide with the ego vehicle at
+  ///                           that waypoint
+  void build(const BoundingBoxArray & obstacles, const float32_t distance_threshold);
+
+  /// \brief Check if the ego vehicle collides with any obstacle at a waypoint
+  /// \param x The x coordinate of the waypoint
+  /// \param y The y coordinate of the waypoint
+  /// \param footprint The box occupied by the ego vehicle at the waypoint
+  /// \return bool8_t True if an obstacle has a corner closer than the distance threshold to the
+  ///         waypoint and overlaps with the footprint
+  bool8_t collides(const float32_t x, const float32_t y, const CollisionBox & footprint);
+
+private:
+  /// Check the distance threshold and overlap of a single obstacle
+  bool8_t collidesWith(
+    const float32_t x, const float32_t y, const CollisionBox & footprint,
+    const std::size_t obstacle_idx) const;
+
+  /// Column of the grid cell containing x, clamped to the grid
+  std::size_t colOf(const float32_t x) const;
+  /// Row of the grid cell containing y, clamped to the grid
+  std::size_t rowOf(const float32_t y) const;
+
+  float32_t m_distance_threshold = 0.0F;
+  float32_t m_distance_threshold_squared = 0.0F;
+  std::vector<CollisionBox> m_obstacles;
+  // Obstacles with corners that are not finite, they are checked for every waypoint
+  std::vector<std::size_t> m_unindexed_obstacles;
+  // The obstacles overlapping cell i are [m_cell_offsets[i], m_cell_offsets[i+1]) in
+  // m_cell_obstacles, the cells are in row major order
+  std::vector<std::size_t> m_cell_offsets;
+  std::vector<std::size_t> m_cell_obstacles;
+  // Number of the last query which checked an obstacle, so that obstacles overlapping several
+  // cells are checked once per query
+  std::vector<std::size_t> m_obstacle_query;
+  std::size_t m_query = 0U;
+  float32_t m_grid_min_x = 0.0F;
+  float32_t m_grid_min_y = 0.0F;
+  float32_t m_grid_max_x = 0.0F;
+  float32_t m_grid_max_y = 0.0F;
+  float32_t m_grid_cell_size = 1.0F;
+  std::size_t m_grid_num_cols = 0U;
+  std::size_t m_grid_num_rows = 0U;
+};
+
+}  // namespace object_collision_estimator
+}  // namespace planning
+}  // namespace motion
+
+#endif  // OBJECT_COLLISION_ESTIMATOR__OBSTACLE_INDEX_HPP_
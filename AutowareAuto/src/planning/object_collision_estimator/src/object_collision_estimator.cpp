@@ -19,7 +19,7 @@
 #include <geometry/bounding_box/rotating_calipers.hpp>
 #include <common/types.hpp>
 #include <algorithm>
-#include <list>
+#include <array>
 #include <vector>
 
 #include "object_collision_estimator/object_collision_estimator.hpp"
@@ -32,6 +32,7 @@ namespace object_collision_estimator
 {
 
 using autoware::common::geometry::bounding_box::minimum_perimeter_bounding_box;
+using autoware::common::geometry::convex_hull;
 using autoware::common::geometry::get_normal;
 using autoware::common::geometry::minus_2d;
 using autoware::common::geometry::plus_2d;
@@ -67,119 +68,37 @@ BoundingBox waypointToBox(
   lr *= safety_factor;
   wh *= safety_factor;
 
-  // Create a list of corners for the vehicle
-  std::list<Point32> vehicle_corners;
+  // Create a buffer of corners for the vehicle
+  std::array<Point32, 4U> vehicle_corners;
 
   {     // Front left
     auto p = Point32{};
     p.x = pt.x + (lf * ch) - (wh * sh);
     p.y = pt.y + (lf * sh) + (wh * ch);
-    vehicle_corners.push_back(p);
+    vehicle_corners[0U] = p;
   }
   {     // Front right
     auto p = Point32{};
     p.x = pt.x + (lf * ch) + (wh * sh);
     p.y = pt.y + (lf * sh) - (wh * ch);
-    vehicle_corners.push_back(p);
+    vehicle_corners[1U] = p;
   }
   {     // Rear right
     auto p = Point32{};
     p.x = pt.x - (lr * ch) + (wh * sh);
     p.y = pt.y - (lr * sh) - (wh * ch);
-    vehicle_corners.push_back(p);
+    vehicle_corners[2U] = p;
   }
   {     // Rear left
     auto p = Point32{};
     p.x = pt.x - (lr * ch) - (wh * sh);
     p.y = pt.y - (lr * sh) + (wh * ch);
-    vehicle_corners.push_back(p);
+    vehicle_corners[3U] = p;
   }
 
-  return minimum_perimeter_bounding_box(vehicle_corners);
-}
-
-/// \brief Determine if a obstacle is too far away from a way point given a distance threshold
-/// \param way_point a trajectory way point
-/// \param obstacle_bbox a bounding box with 4 corners representing the obstacle
-/// \param distance_threshold the minimum distance for a obstacle to be determined too far away
-/// \return bool8_t Return true if the bounding box of the obstacle is at least distance_threshold
-///         away from the way point.
-bool8_t isTooFarAway(
-  const TrajectoryPoint & way_point, const BoundingBox & obstacle_bbox,
-  const float32_t distance_threshold)
-{
-  bool is_too_far_away{true};
-  auto distance_threshold_squared = distance_threshold * distance_threshold;
-
-  for (const auto & corner : obstacle_bbox.corners) {
-    auto dx = corner.x - way_point.x;
-    auto dy = corner.y - way_point.y;
-    auto distance_squared = (dx * dx) + (dy * dy);
-
-    if (distance_threshold_squared > distance_squared) {
-      is_too_far_away = false;
-      break;
-    }
-  }
-
-  return is_too_far_away;
-}
-
-/// \brief Detect possible collision between a trajectory and a list of obstacle bounding boxes.
-///        Return the index in the trajectory where the first collision happens.
-/// \param trajectory Planned trajectory of ego vehicle.
-/// \param obstacles Array of bounding boxes of detected obstacles.
-/// \param vehicle_param Configuration regarding the dimensions of the ego vehicle
-/// \param safety_factor A factor to inflate the size of the vehicle so to avoid getting too close
-///                      to obstacles.
-/// \param waypoint_bboxes A list of bounding boxes around each waypoint in the trajectory
-/// \return int32_t The index into the trajectory points where the first collision happens. If no
-///         collision is detected, -1 is returned.
-int32_t detectCollision(
-  const Trajectory & trajectory,
-  const BoundingBoxArray & obstacles,
-  const VehicleConfig & vehicle_param,
-  const float32_t safety_factor,
-  BoundingBoxArray & waypoint_bboxes)
-{
-  // find the dimension of the ego vehicle.
-  const auto vehicle_length =
-    vehicle_param.front_overhang() + vehicle_param.length_cg_front_axel() +
-    vehicle_param.length_cg_rear_axel() + vehicle_param.rear_overhang();
-  const auto vehicle_width = vehicle_param.width();
-  const auto vehicle_diagonal = sqrtf(
-    (vehicle_width * vehicle_width) + (vehicle_length * vehicle_length));
-
-  // define a distance threshold to filter obstacles that are too far away to cause any collision.
-  const float32_t distance_threshold{vehicle_diagonal * safety_factor};
-
-  int32_t collision_index = -1;
-
-  waypoint_bboxes.boxes.clear();
-  for (std::size_t i = 0; i < trajectory.points.size(); ++i) {
-    waypoint_bboxes.boxes.push_back(
-      waypointToBox(trajectory.points[i], vehicle_param, safety_factor));
-  }
-  for (std::size_t i = 0; (i < trajectory.points.size()) && (collision_index == -1); ++i) {
-    // calculate a bounding box given a trajectory point
-    const auto & waypoint_bbox = waypoint_bboxes.boxes.at(i);
-
-    // Check for collisions with all perceived obstacles
-    for (const auto & obstacle_bbox : obstacles.boxes) {
-      if (!isTooFarAway(
-          trajectory.points[i], obstacle_bbox,
-          distance_threshold) && autoware::common::geometry::intersect(
-          waypoint_bbox.corners.begin(), waypoint_bbox.corners.end(),
-          obstacle_bbox.corners.begin(), obstacle_bbox.corners.end()))
-      {
-        // Collision detected, set end index (non-inclusive), this will end outer loop immediately
-        collision_index = static_cast<decltype(collision_index)>(i);
-        break;
-      }
-    }
-  }
-
-  return collision_index;
+  // Form the hull in place, so that no memory is allocated
+  const auto hull_end = convex_hull(vehicle_corners.begin(), vehicle_corners.end());
+  return minimum_perimeter_bounding_box(vehicle_corners.begin(), hull_end);
 }
 
 /// \brief Returns the index that vehicle should stop when the object colliding index
@@ -223,14 +142,64 @@ ObjectCollisionEstimator::ObjectCollisionEstimator(
   if (m_config.safety_factor < 1.0f) {
     m_config.safety_factor = 1.0f;
   }
+
+  // find the dimension of the ego vehicle.
+  const auto & vehicle_param = m_config.vehicle_config;
+  const auto vehicle_length =
+    vehicle_param.front_overhang() + vehicle_param.length_cg_front_axel() +
+    vehicle_param.length_cg_rear_axel() + vehicle_param.rear_overhang();
+  const auto vehicle_width = vehicle_param.width();
+  const auto vehicle_diagonal = sqrtf(
+    (vehicle_width * vehicle_width) + (vehicle_length * vehicle_length));
+
+  // define a distance threshold to filter obstacles that are too far away to cause any collision.
+  m_distance_threshold = vehicle_diagonal * m_config.safety_factor;
+}
+
+void ObjectCollisionEstimator::updateFootprints(const Trajectory & trajectory)
+{
+  // The footprints of the unchanged prefix of the trajectory are kept
+  const auto same_pose = [](const TrajectoryPoint & a, const TrajectoryPoint & b) {
+      return (a.x == b.x) && (a.y == b.y) && (a.heading.real == b.heading.real) &&
+             (a.heading.imag == b.heading.imag);
+    };
+  const auto num_points = trajectory.points.size();
+  std::size_t num_unchanged = 0U;
+  while ((num_unchanged < num_points) && (num_unchanged < m_footprint_waypoints.size()) &&
+    same_pose(trajectory.points[num_unchanged], m_footprint_waypoints[num_unchanged]))
+  {
+    ++num_unchanged;
+  }
+
+  m_footprint_waypoints.resize(num_unchanged);
+  m_footprints.resize(num_unchanged);
+  m_trajectory_bboxes.boxes.resize(num_unchanged);
+  for (std::size_t i = num_unchanged; i < num_points; ++i) {
+    const auto & pt = trajectory.points[i];
+    m_footprint_waypoints.push_back(pt);
+    m_trajectory_bboxes.boxes.push_back(
+      waypointToBox(pt, m_config.vehicle_config, m_config.safety_factor));
+    m_footprints.push_back(makeCollisionBox(m_trajectory_bboxes.boxes.back()));
+  }
+}
+
+int32_t ObjectCollisionEstimator::detectCollision(const Trajectory & trajectory)
+{
+  updateFootprints(trajectory);
+  for (std::size_t i = 0; i < trajectory.points.size(); ++i) {
+    // Check for collisions with the perceived obstacles close to the waypoint
+    const auto & pt = trajectory.points[i];
+    if (m_obstacle_index.collides(pt.x, pt.y, m_footprints[i])) {
+      return static_cast<int32_t>(i);
+    }
+  }
+  return -1;
 }
 
 void ObjectCollisionEstimator::updatePlan(Trajectory & trajectory) noexcept
 {
   // Collision detection
-  auto collision_index = detectCollision(
-    trajectory, m_obstacles, m_config.vehicle_config,
-    m_config.safety_factor, m_trajectory_bboxes);
+  auto collision_index = detectCollision(trajectory);
 
   auto trajectory_end_idx = getStopIndex(trajectory, collision_index, m_config.stop_margin);
 
@@ -287,6 +256,7 @@ std::vector<BoundingBox> ObjectCollisionEstimator::updateObstacles(
       modified_obstacles.push_back(box);
     }
   }
+  m_obstacle_index.build(m_obstacles, m_distance_threshold);
 
   return modified_obstacles;
 }
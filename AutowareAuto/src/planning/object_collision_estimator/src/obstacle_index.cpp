@@ -0,0 +1,350 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <geometry/common_2d.hpp>
+#include <geometry/convex_hull.hpp>
+#include <geometry/intersection.hpp>
+#include <geometry_msgs/msg/point32.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "object_collision_estimator/obstacle_index.hpp"
+
+namespace motion
+{
+namespace planning
+{
+namespace object_collision_estimator
+{
+
+namespace
+{
+
+using geometry_msgs::msg::Point32;
+
+constexpr std::size_t NUM_CORNERS = CollisionBox::NUM_CORNERS;
+
+/// \brief Position of a point along the line of a normal. This is the same arithmetic as in
+///        geometry::intersect(), which projects the point on the line with closest_line_point_2d()
+///        and then takes the dot product with the normal.
+inline float32_t project(
+  const float32_t normal_x, const float32_t normal_y, const float32_t x, const float32_t y)
+{
+  const float32_t qp_x = 0.0F - normal_x;
+  const float32_t qp_y = 0.0F - normal_y;
+  const float32_t len2 = (qp_x * qp_x) + (qp_y * qp_y);
+  const float32_t t = (((x - normal_x) * qp_x) + ((y - normal_y) * qp_y)) / len2;
+  const float32_t projected_x = normal_x + (qp_x * t);
+  const float32_t projected_y = normal_y + (qp_y * t);
+  return (normal_x * projected_x) + (normal_y * projected_y);
+}
+
+/// \brief Check if the projections of the corners of a box on a normal are separated from a range
+inline bool8_t is_separated(
+  const float32_t normal_x, const float32_t normal_y, const CollisionBox & box,
+  const float32_t min_projection, const float32_t max_projection, const bool8_t range_is_first)
+{
+  std::array<float32_t, NUM_CORNERS> positions;
+  for (std::size_t k = 0U; k < NUM_CORNERS; ++k) {
+    positions[k] = project(normal_x, normal_y, box.corner_x[k], box.corner_y[k]);
+  }
+  float32_t box_min = positions[0U];
+  float32_t box_max = positions[0U];
+  for (std::size_t k = 0U; k < NUM_CORNERS; ++k) {
+    box_min = std::min(box_min, positions[k]);
+    box_max = std::max(box_max, positions[k]);
+  }
+  // The same comparison as geometry::intersect(), with the first box on the left
+  constexpr auto eps = std::numeric_limits<float32_t>::epsilon();
+  const auto min_1 = range_is_first ? min_projection : box_min;
+  const auto max_1 = range_is_first ? max_projection : box_max;
+  const auto min_2 = range_is_first ? box_min : min_projection;
+  const auto max_2 = range_is_first ? box_max : max_projection;
+  return (min_1 > (max_2 + eps)) || (min_2 > (max_1 + eps));
+}
+
+bool8_t is_finite(const CollisionBox & box)
+{
+  for (std::size_t k = 0U; k < NUM_CORNERS; ++k) {
+    if (!std::isfinite(box.corner_x[k]) || !std::isfinite(box.corner_y[k])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // anonymous namespace
+
+constexpr std::size_t CollisionBox::NUM_CORNERS;
+
+CollisionBox makeCollisionBox(const BoundingBox & box)
+{
+  CollisionBox ret{};
+  ret.box = box;
+  for (std::size_t k = 0U; k < NUM_CORNERS; ++k) {
+    ret.corner_x[k] = box.corners[k].x;
+    ret.corner_y[k] = box.corners[k].y;
+  }
+  ret.num_faces = 0U;
+  ret.is_regular = false;
+  // The convex hull is not defined for corners which are not finite
+  if (!is_finite(ret)) {
+    return ret;
+  }
+  // The faces between consecutive points of the hull, in the same way as
+  // geometry::details::get_sorted_face_list() but without allocating
+  auto hull = box.corners;
+  const auto hull_end = autoware::common::geometry::convex_hull(hull.begin(), hull.end());
+  std::array<std::pair<Point32, Point32>, NUM_CORNERS> faces;
+  std::size_t num_faces = 0U;
+  auto face_begin = hull.begin();
+  auto face_end = std::next(face_begin);
+  do {
+    faces[num_faces] = {*face_begin, *face_end};
+    ++num_faces;
+    face_begin = face_end;
+    ++face_end;
+  } while ((face_end != hull_end) && (face_end != hull.end()));
+  faces[num_faces] = {*face_begin, hull.front()};
+  ++num_faces;
+
+  ret.is_regular = true;
+  for (std::size_t face_idx = 0U; face_idx < num_faces; ++face_idx) {
+    const auto & face = faces[face_idx];
+    const auto normal = autoware::common::geometry::get_normal(
+      autoware::common::geometry::minus_2d(face.second, face.first));
+    // closest_line_point_2d() throws for such a normal
+    if (((normal.x * normal.x) + (normal.y * normal.y)) <=
+      std::numeric_limits<float32_t>::epsilon())
+    {
+      ret.is_regular = false;
+      return ret;
+    }
+    ret.normal_x[face_idx] = normal.x;
+    ret.normal_y[face_idx] = normal.y;
+    ret.min_projection[face_idx] = project(normal.x, normal.y, ret.corner_x[0U], ret.corner_y[0U]);
+    ret.max_projection[face_idx] = ret.min_projection[face_idx];
+    for (std::size_t k = 0U; k < NUM_CORNERS; ++k) {
+      const auto position = project(normal.x, normal.y, ret.corner_x[k], ret.corner_y[k]);
+      ret.min_projection[face_idx] = std::min(ret.min_projection[face_idx], position);
+      ret.max_projection[face_idx] = std::max(ret.max_projection[face_idx], position);
+    }
+  }
+  ret.num_faces = num_faces;
+  return ret;
+}
+
+bool8_t intersect(const CollisionBox & box1, const CollisionBox & box2)
+{
+  if (!box1.is_regular || !box2.is_regular) {
+    return autoware::common::geometry::intersect(
+      box1.box.corners.begin(), box1.box.corners.end(),
+      box2.box.corners.begin(), box2.box.corners.end());
+  }
+  for (std::size_t face = 0U; face < box1.num_faces; ++face) {
+    if (is_separated(
+        box1.normal_x[face], box1.normal_y[face], box2,
+        box1.min_projection[face], box1.max_projection[face], true))
+    {
+      return false;
+    }
+  }
+  for (std::size_t face = 0U; face < box2.num_faces; ++face) {
+    if (is_separated(
+        box2.normal_x[face], box2.normal_y[face], box1,
+        box2.min_projection[face], box2.max_projection[face], false))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ObstacleIndex::build(const BoundingBoxArray & obstacles, const float32_t distance_threshold)
+{
+  m_distance_threshold = distance_threshold;
+  m_distance_threshold_squared = distance_threshold * distance_threshold;
+  m_obstacles.clear();
+  m_unindexed_obstacles.clear();
+  m_cell_offsets.clear();
+  m_cell_obstacles.clear();
+  m_obstacle_query.assign(obstacles.boxes.size(), 0U);
+  m_query = 0U;
+  m_grid_num_cols = 0U;
+  m_grid_num_rows = 0U;
+
+  m_grid_min_x = std::numeric_limits<float32_t>::max();
+  m_grid_min_y = std::numeric_limits<float32_t>::max();
+  m_grid_max_x = std::numeric_limits<float32_t>::lowest();
+  m_grid_max_y = std::numeric_limits<float32_t>::lowest();
+  std::size_t num_indexed = 0U;
+  for (std::size_t idx = 0U; idx < obstacles.boxes.size(); ++idx) {
+    m_obstacles.push_back(makeCollisionBox(obstacles.boxes[idx]));
+    const auto & obstacle = m_obstacles.back();
+    if (!is_finite(obstacle)) {
+      m_unindexed_obstacles.push_back(idx);
+      continue;
+    }
+    ++num_indexed;
+    for (std::size_t k = 0U; k < NUM_CORNERS; ++k) {
+      m_grid_min_x = std::min(m_grid_min_x, obstacle.corner_x[k]);
+      m_grid_min_y = std::min(m_grid_min_y, obstacle.corner_y[k]);
+      m_grid_max_x = std::max(m_grid_max_x, obstacle.corner_x[k]);
+      m_grid_max_y = std::max(m_grid_max_y, obstacle.corner_y[k]);
+    }
+  }
+  if (0U == num_indexed) {
+    return;
+  }
+
+  // Cells of the distance threshold, so that a waypoint only visits the cells around it. The cells
+  // get coarser if the obstacles are too spread out, so that the grid stays in the order of the
+  // number of obstacles
+  constexpr float32_t kMinCellSize = 1.0e-3F;
+  const float32_t width = m_grid_max_x - m_grid_min_x;
+  const float32_t height = m_grid_max_y - m_grid_min_y;
+  const auto max_num_cells = static_cast<float32_t>((4U * num_indexed) + 16U);
+  m_grid_cell_size = std::max(kMinCellSize, distance_threshold);
+  while ((((width / m_grid_cell_size) + 1.0F) * ((height / m_grid_cell_size) + 1.0F)) >
+    max_num_cells)
+  {
+    m_grid_cell_size *= 2.0F;
+  }
+  m_grid_num_cols = static_cast<std::size_t>(width / m_grid_cell_size) + 1U;
+  m_grid_num_rows = static_cast<std::size_t>(height / m_grid_cell_size) + 1U;
+
+  // Each obstacle goes into all cells overlapped by the bounds of its corners
+  const auto for_each_cell = [this](const CollisionBox & obstacle, auto && fn) {
+      const auto min_x = *std::min_element(obstacle.corner_x.begin(), obstacle.corner_x.end());
+      const auto max_x = *std::max_element(obstacle.corner_x.begin(), obstacle.corner_x.end());
+      const auto min_y = *std::min_element(obstacle.corner_y.begin(), obstacle.corner_y.end());
+      const auto max_y = *std::max_element(obstacle.corner_y.begin(), obstacle.corner_y.end());
+      for (auto row = rowOf(min_y); row <= rowOf(max_y); ++row) {
+        for (auto col = colOf(min_x); col <= colOf(max_x); ++col) {
+          fn((row * m_grid_num_cols) + col);
+        }
+      }
+    };
+  m_cell_offsets.assign((m_grid_num_cols * m_grid_num_rows) + 1U, 0U);
+  for (const auto & obstacle : m_obstacles) {
+    if (is_finite(obstacle)) {
+      for_each_cell(obstacle, [this](const std::size_t cell) {++m_cell_offsets[cell + 1U];});
+    }
+  }
+  for (std::size_t cell = 1U; cell < m_cell_offsets.size(); ++cell) {
+    m_cell_offsets[cell] += m_cell_offsets[cell - 1U];
+  }
+  m_cell_obstacles.resize(m_cell_offsets.back());
+  std::vector<std::size_t> cursors(m_cell_offsets.begin(), m_cell_offsets.end() - 1);
+  for (std::size_t idx = 0U; idx < m_obstacles.size(); ++idx) {
+    if (is_finite(m_obstacles[idx])) {
+      for_each_cell(
+        m_obstacles[idx], [this, &cursors, idx](const std::size_t cell) {
+          m_cell_obstacles[cursors[cell]] = idx;
+          ++cursors[cell];
+        });
+    }
+  }
+}
+
+bool8_t ObstacleIndex::collides(
+  const float32_t x, const float32_t y, const CollisionBox & footprint)
+{
+  // No corner is closer than the distance threshold to such a waypoint
+  if (!std::isfinite(x) || !std::isfinite(y)) {
+    return false;
+  }
+  ++m_query;
+  for (const auto idx : m_unindexed_obstacles) {
+    if (collidesWith(x, y, footprint, idx)) {
+      return true;
+    }
+  }
+  // A corner closer than the distance threshold lies in the square of that size around the
+  // waypoint, and in the bounds of its obstacle
+  const auto d = m_distance_threshold;
+  if ((0U == m_grid_num_cols) ||
+    ((x + d) < m_grid_min_x) || ((x - d) > m_grid_max_x) ||
+    ((y + d) < m_grid_min_y) || ((y - d) > m_grid_max_y))
+  {
+    return false;
+  }
+  const auto last_row = rowOf(y + d);
+  const auto last_col = colOf(x + d);
+  for (auto row = rowOf(y - d); row <= last_row; ++row) {
+    for (auto col = colOf(x - d); col <= last_col; ++col) {
+      const auto cell = (row * m_grid_num_cols) + col;
+      for (auto it = m_cell_offsets[cell]; it < m_cell_offsets[cell + 1U]; ++it) {
+        const auto idx = m_cell_obstacles[it];
+        if (m_obstacle_query[idx] == m_query) {
+          continue;
+        }
+        m_obstacle_query[idx] = m_query;
+        if (collidesWith(x, y, footprint, idx)) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+bool8_t ObstacleIndex::collidesWith(
+  const float32_t x, const float32_t y, const CollisionBox & footprint,
+  const std::size_t obstacle_idx) const
+{
+  const auto & obstacle = m_obstacles[obstacle_idx];
+  bool8_t is_close = false;
+  for (std::size_t k = 0U; k < NUM_CORNERS; ++k) {
+    const auto dx = obstacle.corner_x[k] - x;
+    const auto dy = obstacle.corner_y[k] - y;
+    is_close = is_close || (m_distance_threshold_squared > ((dx * dx) + (dy * dy)));
+  }
+  return is_close && intersect(footprint, obstacle);
+}
+
+std::size_t ObstacleIndex::colOf(const float32_t x) const
+{
+  const float32_t position = (x - m_grid_min_x) / m_grid_cell_size;
+  if (!(position > 0.0F)) {
+    return 0U;
+  }
+  if (position >= static_cast<float32_t>(m_grid_num_cols - 1U)) {
+    return m_grid_num_cols - 1U;
+  }
+  return static_cast<std::size_t>(position);
+}
+
+std::size_t ObstacleIndex::rowOf(const float32_t y) const
+{
+  const float32_t position = (y - m_grid_min_y) / m_grid_cell_size;
+  if (!(position > 0.0F)) {
+    return 0U;
+  }
+  if (position >= static_cast<float32_t>(m_grid_num_rows - 1U)) {
+    return m_grid_num_rows - 1U;
+  }
+  return static_cast<std::size_t>(position);
+}
+
+}  // namespace object_collision_estimator
+}  // namespace planning
+}  // namespace motion
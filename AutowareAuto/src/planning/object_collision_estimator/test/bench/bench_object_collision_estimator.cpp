@@ -0,0 +1,138 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <benchmark/benchmark.h>
+#include <common/types.hpp>
+#include <trajectory_smoother/trajectory_smoother.hpp>
+
+#include <cmath>
+#include <cstdint>
+
+#include "object_collision_estimator/object_collision_estimator.hpp"
+
+namespace
+{
+
+using autoware::common::types::float32_t;
+using autoware_auto_msgs::msg::BoundingBox;
+using autoware_auto_msgs::msg::BoundingBoxArray;
+using autoware_auto_msgs::msg::Trajectory;
+using autoware_auto_msgs::msg::TrajectoryPoint;
+using motion::planning::object_collision_estimator::ObjectCollisionEstimator;
+using motion::planning::object_collision_estimator::ObjectCollisionEstimatorConfig;
+using motion::planning::trajectory_smoother::TrajectorySmoother;
+
+constexpr std::size_t kTrajectoryLength = 100U;
+
+ObjectCollisionEstimator make_estimator()
+{
+  const ObjectCollisionEstimatorConfig config{
+    {1.2F, 1.5F, 0.0F, 0.0F, 1500.0F, 0.0F, 1.8F, 0.8F, 0.6F},
+    1.1F,  // safety factor
+    0.0F,  // stop_margin
+    0.5F,  // min_obstacle_dimension_m
+  };
+  return ObjectCollisionEstimator{config, TrajectorySmoother{{5.0F, 25U}}};
+}
+
+// A trajectory along the aisle of the parking lot, which does not hit any car
+Trajectory make_trajectory(const float32_t lateral_offset)
+{
+  Trajectory trajectory;
+  for (std::size_t i = 0U; i < kTrajectoryLength; ++i) {
+    TrajectoryPoint pt;
+    pt.x = static_cast<float32_t>(i);
+    pt.y = lateral_offset;
+    pt.heading.real = 1.0F;
+    pt.longitudinal_velocity_mps = 5.0F;
+    trajectory.points.push_back(pt);
+  }
+  return trajectory;
+}
+
+// Rows of parked cars on both sides of the aisle, and behind them
+BoundingBoxArray make_parking_lot(const std::size_t num_cars)
+{
+  BoundingBoxArray obstacles;
+  constexpr float32_t kCarWidth = 1.9F;
+  constexpr float32_t kCarLength = 4.5F;
+  constexpr float32_t kSpotWidth = 2.5F;
+  constexpr std::size_t kNumRows = 4U;
+  const std::size_t cars_per_row = (num_cars + kNumRows - 1U) / kNumRows;
+  for (std::size_t car = 0U; car < num_cars; ++car) {
+    const auto row = car / cars_per_row;
+    BoundingBox box;
+    box.centroid.x = static_cast<float32_t>(car % cars_per_row) * kSpotWidth;
+    box.centroid.y = ((row % 2U) == 0U ? 1.0F : -1.0F) *
+      (5.0F + (static_cast<float32_t>(row / 2U) * 6.0F));
+    box.size.x = kCarWidth;
+    box.size.y = kCarLength;
+    box.orientation.w = 1.0F;
+    const float32_t dx = kCarWidth * 0.5F;
+    const float32_t dy = kCarLength * 0.5F;
+    const float32_t corner_dx[4U] = {-dx, dx, dx, -dx};
+    const float32_t corner_dy[4U] = {-dy, -dy, dy, dy};
+    for (std::size_t k = 0U; k < 4U; ++k) {
+      box.corners[k].x = box.centroid.x + corner_dx[k];
+      box.corners[k].y = box.centroid.y + corner_dy[k];
+    }
+    obstacles.boxes.push_back(box);
+  }
+  return obstacles;
+}
+
+}  // namespace
+
+// Replan the same trajectory against the parking lot of state.range(0) cars
+static void BenchUpdatePlanSameTrajectory(benchmark::State & state)
+{
+  auto estimator = make_estimator();
+  estimator.updateObstacles(make_parking_lot(static_cast<std::size_t>(state.range(0))));
+  const auto trajectory = make_trajectory(0.0F);
+  for (auto _ : state) {
+    auto plan = trajectory;
+    estimator.updatePlan(plan);
+    benchmark::DoNotOptimize(plan.points.data());
+  }
+}
+
+// Plan a different trajectory every time against the parking lot of state.range(0) cars
+static void BenchUpdatePlanNewTrajectory(benchmark::State & state)
+{
+  auto estimator = make_estimator();
+  estimator.updateObstacles(make_parking_lot(static_cast<std::size_t>(state.range(0))));
+  const Trajectory trajectories[2U] = {make_trajectory(0.0F), make_trajectory(0.1F)};
+  std::size_t idx = 0U;
+  for (auto _ : state) {
+    auto plan = trajectories[idx];
+    idx = 1U - idx;
+    estimator.updatePlan(plan);
+    benchmark::DoNotOptimize(plan.points.data());
+  }
+}
+
+// Update the obstacles to a parking lot of state.range(0) cars
+static void BenchUpdateObstacles(benchmark::State & state)
+{
+  auto estimator = make_estimator();
+  const auto obstacles = make_parking_lot(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(estimator.updateObstacles(obstacles));
+  }
+}
+
+BENCHMARK(BenchUpdatePlanSameTrajectory)->Arg(64)->Arg(256);
+BENCHMARK(BenchUpdatePlanNewTrajectory)->Arg(64)->Arg(256);
+BENCHMARK(BenchUpdateObstacles)->Arg(64)->Arg(256);
@@ -14,9 +14,11 @@
 
 #include <trajectory_smoother/trajectory_smoother.hpp>
 #include <motion_testing/motion_testing.hpp>
+#include <geometry/intersection.hpp>
 #include <common/types.hpp>
 #include <gtest/gtest.h>
 #include <chrono>
+#include <random>
 
 #include "object_collision_estimator/object_collision_estimator.hpp"
 
@@ -161,3 +163,176 @@ TEST(ObjectCollisionEstimator, NoObstacle) {
 TEST(ObjectCollisionEstimator, SmallObstacle) {
   object_collision_estimator_test(100, 40, 0.0003);
 }
+
+namespace
+{
+using motion::planning::object_collision_estimator::CollisionBox;
+using motion::planning::object_collision_estimator::makeCollisionBox;
+
+BoundingBox make_box(
+  const float32_t x, const float32_t y, const float32_t angle, const float32_t size_x,
+  const float32_t size_y)
+{
+  BoundingBox box{};
+  box.centroid = make_point(x, y);
+  box.size = make_point(size_x, size_y);
+  box.orientation.w = cosf(angle / 2.0F);
+  box.orientation.z = sinf(angle / 2.0F);
+  const float32_t c = cosf(angle);
+  const float32_t s = sinf(angle);
+  const float32_t corner_x[4U] = {-0.5F, 0.5F, 0.5F, -0.5F};
+  const float32_t corner_y[4U] = {-0.5F, -0.5F, 0.5F, 0.5F};
+  for (std::size_t k = 0U; k < 4U; ++k) {
+    const float32_t dx = corner_x[k] * size_x;
+    const float32_t dy = corner_y[k] * size_y;
+    box.corners[k] = make_point(x + (c * dx) - (s * dy), y + (s * dx) + (c * dy));
+  }
+  return box;
+}
+
+ObjectCollisionEstimatorConfig make_config()
+{
+  return ObjectCollisionEstimatorConfig{
+    {1.2, 1.5, 0, 0, 1500, 0, 1.8, 0.8, 0.6},
+    1.1,  // safety factor
+    0.0,  // stop_margin
+    0.3,  // min_obstacle_dimension_m
+  };
+}
+
+// A trajectory which winds through the obstacles
+Trajectory make_winding_trajectory(const float32_t lateral_offset)
+{
+  Trajectory trajectory;
+  for (std::size_t i = 0U; i < 100U; ++i) {
+    TrajectoryPoint pt;
+    const float32_t s = static_cast<float32_t>(i) * 0.5F;
+    const float32_t heading = 0.3F * cosf(0.1F * s);
+    pt.x = s;
+    pt.y = (3.0F * sinf(0.1F * s)) + lateral_offset;
+    pt.heading.real = cosf(heading / 2.0F);
+    pt.heading.imag = sinf(heading / 2.0F);
+    pt.longitudinal_velocity_mps = 5.0F;
+    trajectory.points.push_back(pt);
+  }
+  return trajectory;
+}
+
+// Index of the first waypoint which collides with an obstacle, by checking every pair
+int32_t brute_force_collision_index(
+  const ObjectCollisionEstimatorConfig & config, const Trajectory & trajectory,
+  const BoundingBoxArray & waypoint_boxes, const BoundingBoxArray & obstacles)
+{
+  const auto & vehicle = config.vehicle_config;
+  const auto length = vehicle.front_overhang() + vehicle.length_cg_front_axel() +
+    vehicle.length_cg_rear_axel() + vehicle.rear_overhang();
+  const auto threshold =
+    sqrtf((vehicle.width() * vehicle.width()) + (length * length)) * config.safety_factor;
+  for (std::size_t i = 0U; i < trajectory.points.size(); ++i) {
+    const auto & pt = trajectory.points[i];
+    const auto & footprint = waypoint_boxes.boxes[i];
+    for (const auto & obstacle : obstacles.boxes) {
+      bool is_close = false;
+      for (const auto & corner : obstacle.corners) {
+        const auto dx = corner.x - pt.x;
+        const auto dy = corner.y - pt.y;
+        is_close = is_close || ((threshold * threshold) > ((dx * dx) + (dy * dy)));
+      }
+      if (is_close &&
+        autoware::common::geometry::intersect(
+          footprint.corners.begin(), footprint.corners.end(),
+          obstacle.corners.begin(), obstacle.corners.end()))
+      {
+        return static_cast<int32_t>(i);
+      }
+    }
+  }
+  return -1;
+}
+}  // namespace
+
+TEST(ObjectCollisionEstimator, ManyObstacles) {
+  std::mt19937 gen{42U};
+  std::uniform_real_distribution<float32_t> uniform{0.0F, 1.0F};
+  const auto config = make_config();
+  for (std::size_t trial = 0U; trial < 50U; ++trial) {
+    ObjectCollisionEstimator estimator{config, TrajectorySmoother{{5, 25}}};
+    BoundingBoxArray obstacles{};
+    const auto num_obstacles = 1U + static_cast<std::size_t>(40.0F * uniform(gen));
+    for (std::size_t idx = 0U; idx < num_obstacles; ++idx) {
+      obstacles.boxes.push_back(
+        make_box(
+          60.0F * uniform(gen), 60.0F * (uniform(gen) - 0.5F), 6.0F * uniform(gen),
+          0.5F + (4.0F * uniform(gen)), 0.5F + (2.0F * uniform(gen))));
+    }
+    estimator.updateObstacles(obstacles);
+    auto trajectory = make_winding_trajectory(20.0F * (uniform(gen) - 0.5F));
+    const auto original = trajectory;
+    estimator.updatePlan(trajectory);
+
+    const auto expected = brute_force_collision_index(
+      config, original, estimator.getTrajectoryBoundingBox(), obstacles);
+    if (expected < 0) {
+      EXPECT_EQ(trajectory.points.size(), original.points.size());
+    } else {
+      EXPECT_EQ(trajectory.points.size(), static_cast<std::size_t>(expected));
+    }
+  }
+}
+
+TEST(ObjectCollisionEstimator, ReplanWithSamePrefix) {
+  const auto config = make_config();
+  BoundingBoxArray obstacles{};
+  obstacles.boxes.push_back(make_box(40.0F, 0.0F, 0.0F, 2.0F, 2.0F));
+  auto first = make_winding_trajectory(10.0F);
+  // Only the tail of the second trajectory differs, and it hits the obstacle
+  auto second = first;
+  for (std::size_t i = 60U; i < second.points.size(); ++i) {
+    second.points[i].y = 0.0F;
+    second.points[i].heading.real = 1.0F;
+    second.points[i].heading.imag = 0.0F;
+  }
+
+  ObjectCollisionEstimator replanned{config, TrajectorySmoother{{5, 25}}};
+  replanned.updateObstacles(obstacles);
+  replanned.updatePlan(first);
+  EXPECT_EQ(first.points.size(), 100U);
+  auto second_replanned = second;
+  replanned.updatePlan(second_replanned);
+
+  ObjectCollisionEstimator fresh{config, TrajectorySmoother{{5, 25}}};
+  fresh.updateObstacles(obstacles);
+  auto second_fresh = second;
+  fresh.updatePlan(second_fresh);
+
+  EXPECT_LT(second_fresh.points.size(), 100U);
+  EXPECT_EQ(second_replanned.points.size(), second_fresh.points.size());
+  const auto replanned_boxes = replanned.getTrajectoryBoundingBox().boxes;
+  const auto fresh_boxes = fresh.getTrajectoryBoundingBox().boxes;
+  ASSERT_EQ(replanned_boxes.size(), second.points.size());
+  ASSERT_EQ(fresh_boxes.size(), second.points.size());
+  for (std::size_t i = 0U; i < fresh_boxes.size(); ++i) {
+    for (std::size_t k = 0U; k < 4U; ++k) {
+      EXPECT_EQ(replanned_boxes[i].corners[k].x, fresh_boxes[i].corners[k].x);
+      EXPECT_EQ(replanned_boxes[i].corners[k].y, fresh_boxes[i].corners[k].y);
+    }
+  }
+}
+
+TEST(CollisionBox, SameAsIntersect) {
+  std::mt19937 gen{7U};
+  std::uniform_real_distribution<float32_t> uniform{0.0F, 1.0F};
+  for (std::size_t trial = 0U; trial < 1000U; ++trial) {
+    const auto box1 = make_box(
+      0.0F, 0.0F, 6.0F * uniform(gen), 0.1F + (4.0F * uniform(gen)),
+      0.1F + (2.0F * uniform(gen)));
+    const auto box2 = make_box(
+      8.0F * (uniform(gen) - 0.5F), 8.0F * (uniform(gen) - 0.5F), 6.0F * uniform(gen),
+      0.1F + (4.0F * uniform(gen)), 0.1F + (2.0F * uniform(gen)));
+    const bool expected = autoware::common::geometry::intersect(
+      box1.corners.begin(), box1.corners.end(), box2.corners.begin(), box2.corners.end());
+    EXPECT_EQ(
+      motion::planning::object_collision_estimator::intersect(
+        makeCollisionBox(box1), makeCollisionBox(box2)), expected);
+  }
+}